@@ -0,0 +1,566 @@
+/*
+ * dmaibench.c
+ *
+ * Synthetic microbenchmark of the DMAI/Codec Engine stand-in library.
+ * The scenarios are hand-written replicas of the DMAI call sequences of
+ * some plugin elements; no code from src/ is built or run, so the numbers
+ * describe the stand-in and the replicas, and a change to the elements
+ * is not seen here until the matching scenario is updated by hand:
+ *
+ *   decode   like TIViddec2 into TIDmaiVideoSink: Vdec2_process, Framecopy
+ *            into a display buffer, Display_put
+ *   encode   like a capture BufTab resized by TIDmaiResizer, then
+ *            Venc1_process
+ *   resize   like TIDmaiResizer alone
+ *   sink     like the render path of TIDmaiVideoSink for upstream buffers:
+ *            contiguous ones (-C) wrapped in one reference buffer, others
+ *            copied into a contiguous temporary buffer
+ *
+ * Latencies of the calls that wait for a coprocessor are set through
+ * FAKEDMAI_LATENCY, see host/README.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/osal/Memory.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/BufTab.h>
+#include <ti/sdo/dmai/Display.h>
+#include <ti/sdo/dmai/Framecopy.h>
+#include <ti/sdo/dmai/Resize.h>
+#include <ti/sdo/dmai/ce/Vdec2.h>
+#include <ti/sdo/dmai/ce/Venc1.h>
+
+#include "../fakedmai/fakedmai.h"
+
+/* Use masks, as the decoder sets them on its output buffers */
+#define CODEC_FREE      0x1
+#define DISPLAY_FREE    0x2
+
+typedef struct bench_stage {
+    const char         *name;
+    unsigned long       calls;
+    unsigned long long  total;
+    unsigned long long  max;
+} bench_stage;
+
+typedef struct bench_opts {
+    const char *scenario;
+    int         frames;
+    int         rate;
+    int         width;
+    int         height;
+    int         outWidth;
+    int         outHeight;
+    int         numBufs;
+    int         contiguous;
+} bench_opts;
+
+#define MAX_STAGES  8
+
+static bench_stage stages[MAX_STAGES];
+static int         numStages;
+
+/******************************************************************************
+ * stage_get
+ ******************************************************************************/
+static bench_stage *stage_get(const char *name)
+{
+    int i;
+
+    for (i = 0; i < numStages; i++) {
+        if (!strcmp(stages[i].name, name)) {
+            return &stages[i];
+        }
+    }
+
+    stages[numStages].name = name;
+    return &stages[numStages++];
+}
+
+/******************************************************************************
+ * stage_add
+ ******************************************************************************/
+static void stage_add(const char *name, unsigned long long start)
+{
+    bench_stage        *stage = stage_get(name);
+    unsigned long long  elapsed = fakedmai_now() - start;
+
+    stage->calls++;
+    stage->total += elapsed;
+    if (elapsed > stage->max) {
+        stage->max = elapsed;
+    }
+}
+
+#define STAGE(name, ...) do {                                          \
+    unsigned long long __start = fakedmai_now();                       \
+    __VA_ARGS__;                                                       \
+    stage_add(name, __start);                                          \
+} while (0)
+
+/******************************************************************************
+ * pace
+ *    Waits for the time of the given frame at the configured rate, like a
+ *    live source would deliver it.
+ ******************************************************************************/
+static void pace(const bench_opts *opts, unsigned long long start, int frame)
+{
+    unsigned long long due, now;
+
+    if (opts->rate <= 0) {
+        return;
+    }
+
+    due = start + (unsigned long long)frame * 1000000ULL / opts->rate;
+    now = fakedmai_now();
+    if (due > now) {
+        struct timespec ts;
+
+        ts.tv_sec = (due - now) / 1000000;
+        ts.tv_nsec = (due - now) % 1000000 * 1000;
+        nanosleep(&ts, NULL);
+    }
+}
+
+/******************************************************************************
+ * gfx_attrs
+ ******************************************************************************/
+static BufferGfx_Attrs gfx_attrs(int width, int height, ColorSpace_Type cs,
+                           UInt16 useMask)
+{
+    BufferGfx_Attrs gfxAttrs = BufferGfx_Attrs_DEFAULT;
+
+    gfxAttrs.colorSpace = cs;
+    gfxAttrs.dim.width = width;
+    gfxAttrs.dim.height = height;
+    gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(width, cs);
+    gfxAttrs.bAttrs.useMask = useMask;
+
+    return gfxAttrs;
+}
+
+/******************************************************************************
+ * display_open
+ ******************************************************************************/
+static Display_Handle display_open(const bench_opts *opts, ColorSpace_Type cs)
+{
+    Display_Attrs dAttrs = Display_Attrs_DM6467_VID_DEFAULT;
+
+    dAttrs.numBufs = opts->numBufs;
+    dAttrs.videoStd = opts->rate > 50 ? VideoStd_720P_60 : VideoStd_1080P_30;
+    dAttrs.colorSpace = cs;
+    dAttrs.width = opts->outWidth;
+    dAttrs.height = opts->outHeight;
+
+    return Display_create(NULL, &dAttrs);
+}
+
+/******************************************************************************
+ * display_frame
+ *    What the sink does with a frame: wait for a free display buffer, copy
+ *    the frame into it and queue it.
+ ******************************************************************************/
+static int display_frame(Display_Handle hDisplay, Framecopy_Handle hFc,
+               Buffer_Handle hSrcBuf)
+{
+    Buffer_Handle hDispBuf = NULL;
+    int           ret = 0;
+
+    STAGE("Display_get", ret = Display_get(hDisplay, &hDispBuf));
+    if (ret < 0 || !hDispBuf) {
+        fprintf(stderr, "Display_get failed\n");
+        return -1;
+    }
+
+    STAGE("Framecopy", ret = Framecopy_config(hFc, hSrcBuf, hDispBuf) < 0 ||
+                             Framecopy_execute(hFc, hSrcBuf, hDispBuf) < 0);
+    if (ret) {
+        fprintf(stderr, "Framecopy failed\n");
+        return -1;
+    }
+
+    STAGE("Display_put", ret = Display_put(hDisplay, hDispBuf));
+    if (ret < 0) {
+        fprintf(stderr, "Display_put failed\n");
+        return -1;
+    }
+
+    return 0;
+}
+
+/******************************************************************************
+ * bench_decode
+ ******************************************************************************/
+static int bench_decode(const bench_opts *opts, Engine_Handle hEngine,
+               Display_Handle *hDisplayPtr)
+{
+    VIDDEC2_Params        params = Vdec2_Params_DEFAULT;
+    VIDDEC2_DynamicParams dynParams = Vdec2_DynamicParams_DEFAULT;
+    Framecopy_Attrs       fcAttrs = Framecopy_Attrs_DEFAULT;
+    BufferGfx_Attrs       gfxAttrs;
+    Buffer_Attrs          bAttrs = Buffer_Attrs_DEFAULT;
+    Vdec2_Handle          hVd;
+    BufTab_Handle         hOutBufTab;
+    Buffer_Handle         hInBuf, hDstBuf, hBuf;
+    Framecopy_Handle      hFc;
+    unsigned long long    start;
+    int                   i, ret = 0;
+
+    params.maxWidth = opts->width;
+    params.maxHeight = opts->height;
+    params.forceChromaFormat = XDM_YUV_420SP;
+
+    hVd = Vdec2_create(hEngine, "h264dec", &params, &dynParams);
+    gfxAttrs = gfx_attrs(opts->width, opts->height, ColorSpace_YUV420PSEMI,
+                   CODEC_FREE | DISPLAY_FREE);
+    hOutBufTab = BufTab_create(opts->numBufs + 2, Vdec2_getOutBufSize(hVd),
+                     BufferGfx_getBufferAttrs(&gfxAttrs));
+    hInBuf = Buffer_create(Vdec2_getInBufSize(hVd), &bAttrs);
+    *hDisplayPtr = display_open(opts, ColorSpace_YUV420PSEMI);
+    hFc = Framecopy_create(&fcAttrs);
+
+    if (!hVd || !hOutBufTab || !hInBuf || !*hDisplayPtr || !hFc) {
+        fprintf(stderr, "failed to set up the decoder\n");
+        return -1;
+    }
+    Vdec2_setBufTab(hVd, hOutBufTab);
+    Buffer_setNumBytesUsed(hInBuf, Vdec2_getInBufSize(hVd) / 8);
+
+    start = fakedmai_now();
+    for (i = 0; i < opts->frames && ret == 0; i++) {
+        pace(opts, start, i);
+
+        /* The decoder waits for the sink to give back a buffer */
+        STAGE("BufTab_getFreeBuf", {
+            while (!(hDstBuf = BufTab_getFreeBuf(hOutBufTab))) {
+                struct timespec ts = { 0, 500000 };
+                nanosleep(&ts, NULL);
+            }
+        });
+
+        STAGE("Vdec2_process", ret = Vdec2_process(hVd, hInBuf, hDstBuf));
+        if (ret < 0) {
+            fprintf(stderr, "Vdec2_process failed\n");
+            break;
+        }
+
+        while ((hBuf = Vdec2_getDisplayBuf(hVd))) {
+            ret = display_frame(*hDisplayPtr, hFc, hBuf);
+            Buffer_freeUseMask(hBuf, DISPLAY_FREE);
+        }
+
+        while ((hBuf = Vdec2_getFreeBuf(hVd))) {
+            Buffer_freeUseMask(hBuf, CODEC_FREE);
+        }
+    }
+
+    Framecopy_delete(hFc);
+    Buffer_delete(hInBuf);
+    Vdec2_delete(hVd);
+    BufTab_delete(hOutBufTab);
+
+    return ret;
+}
+
+/******************************************************************************
+ * bench_encode
+ ******************************************************************************/
+static int bench_encode(const bench_opts *opts, Engine_Handle hEngine,
+               int encode)
+{
+    VIDENC1_Params        params = Venc1_Params_DEFAULT;
+    VIDENC1_DynamicParams dynParams = Venc1_DynamicParams_DEFAULT;
+    Resize_Attrs          rszAttrs = Resize_Attrs_DEFAULT;
+    BufferGfx_Attrs       capAttrs, rszBufAttrs;
+    Buffer_Attrs          bAttrs = Buffer_Attrs_DEFAULT;
+    Venc1_Handle          hVe = NULL;
+    BufTab_Handle         hCapBufTab, hRszBufTab;
+    Buffer_Handle         hCapBuf, hRszBuf, hOutBuf = NULL;
+    Resize_Handle         hRsz;
+    unsigned long long    start, bytes = 0;
+    int                   i, ret = 0;
+
+    capAttrs = gfx_attrs(opts->width, opts->height, ColorSpace_UYVY, 1);
+    hCapBufTab = BufTab_create(opts->numBufs,
+                     BufferGfx_calcFrameSize(opts->width, opts->height,
+                         ColorSpace_UYVY),
+                     BufferGfx_getBufferAttrs(&capAttrs));
+    rszBufAttrs = gfx_attrs(opts->outWidth, opts->outHeight, ColorSpace_UYVY,
+                      1);
+    hRszBufTab = BufTab_create(2,
+                     BufferGfx_calcFrameSize(opts->outWidth, opts->outHeight,
+                         ColorSpace_UYVY),
+                     BufferGfx_getBufferAttrs(&rszBufAttrs));
+    hRsz = Resize_create(&rszAttrs);
+
+    if (encode) {
+        params.maxWidth = opts->outWidth;
+        params.maxHeight = opts->outHeight;
+        dynParams.inputWidth = opts->outWidth;
+        dynParams.inputHeight = opts->outHeight;
+        dynParams.targetFrameRate = (opts->rate > 0 ? opts->rate : 30) * 1000;
+        dynParams.refFrameRate = dynParams.targetFrameRate;
+        hVe = Venc1_create(hEngine, "h264enc", &params, &dynParams);
+        if (hVe) {
+            hOutBuf = Buffer_create(Venc1_getOutBufSize(hVe), &bAttrs);
+        }
+    }
+
+    if (!hCapBufTab || !hRszBufTab || !hRsz || (encode && !hOutBuf)) {
+        fprintf(stderr, "failed to set up the %s\n",
+            encode ? "encoder" : "resizer");
+        return -1;
+    }
+
+    start = fakedmai_now();
+    for (i = 0; i < opts->frames && ret == 0; i++) {
+        pace(opts, start, i);
+
+        hCapBuf = BufTab_getBuf(hCapBufTab, i % opts->numBufs);
+        hRszBuf = BufTab_getBuf(hRszBufTab, i % 2);
+
+        STAGE("Resize", ret = Resize_config(hRsz, hCapBuf, hRszBuf) < 0 ||
+                              Resize_execute(hRsz, hCapBuf, hRszBuf) < 0);
+        if (ret) {
+            fprintf(stderr, "Resize failed\n");
+            break;
+        }
+
+        if (encode) {
+            STAGE("Venc1_process",
+                ret = Venc1_process(hVe, hRszBuf, hOutBuf));
+            if (ret < 0) {
+                fprintf(stderr, "Venc1_process failed\n");
+                break;
+            }
+            bytes += Buffer_getNumBytesUsed(hOutBuf);
+        }
+    }
+
+    if (encode) {
+        printf("encoded bytes: %llu\n", bytes);
+        Buffer_delete(hOutBuf);
+        Venc1_delete(hVe);
+    }
+    Resize_delete(hRsz);
+    BufTab_delete(hRszBufTab);
+    BufTab_delete(hCapBufTab);
+
+    return ret;
+}
+
+/******************************************************************************
+ * bench_sink
+ *    The frames come from upstream memory.  Contiguous frames are wrapped
+ *    in a reference buffer created once, user memory is copied into a
+ *    contiguous buffer ahead of the frame copy.
+ ******************************************************************************/
+static int bench_sink(const bench_opts *opts, Display_Handle *hDisplayPtr)
+{
+    Framecopy_Attrs     fcAttrs = Framecopy_Attrs_DEFAULT;
+    BufferGfx_Attrs     gfxAttrs;
+    Buffer_Handle       hInBuf;
+    Framecopy_Handle    hFc;
+    Int32               size;
+    Int8               *frames[2];
+    unsigned long long  start;
+    int                 i, ret = 0;
+
+    size = BufferGfx_calcFrameSize(opts->width, opts->height,
+               ColorSpace_UYVY);
+    for (i = 0; i < 2; i++) {
+        frames[i] = opts->contiguous ? Memory_contigAlloc(size, 128) :
+                                       malloc(size);
+        if (!frames[i]) {
+            fprintf(stderr, "failed to allocate the input frames\n");
+            return -1;
+        }
+        memset(frames[i], 0x80, size);
+    }
+
+    gfxAttrs = gfx_attrs(opts->width, opts->height, ColorSpace_UYVY, 1);
+    gfxAttrs.bAttrs.reference = opts->contiguous;
+    hInBuf = Buffer_create(size, BufferGfx_getBufferAttrs(&gfxAttrs));
+    *hDisplayPtr = display_open(opts, ColorSpace_UYVY);
+    hFc = Framecopy_create(&fcAttrs);
+
+    if (!hInBuf || !*hDisplayPtr || !hFc) {
+        fprintf(stderr, "failed to set up the sink\n");
+        return -1;
+    }
+
+    start = fakedmai_now();
+    for (i = 0; i < opts->frames && ret == 0; i++) {
+        Int8   *data = frames[i % 2];
+        Bool    contig = FALSE;
+
+        pace(opts, start, i);
+
+        STAGE("import", {
+            Memory_getBufferPhysicalAddress(data, size, &contig);
+            if (contig) {
+                Buffer_setUserPtr(hInBuf, data);
+            } else {
+                memcpy(Buffer_getUserPtr(hInBuf), data, size);
+                fakedmai_add_copy_bytes(size);
+            }
+            Buffer_setNumBytesUsed(hInBuf, size);
+        });
+
+        ret = display_frame(*hDisplayPtr, hFc, hInBuf);
+    }
+
+    Framecopy_delete(hFc);
+    Buffer_delete(hInBuf);
+    for (i = 0; i < 2; i++) {
+        if (opts->contiguous) {
+            Memory_contigFree(frames[i], size);
+        }
+        else {
+            free(frames[i]);
+        }
+    }
+
+    return ret;
+}
+
+/******************************************************************************
+ * usage
+ ******************************************************************************/
+static void usage(const char *prog)
+{
+    fprintf(stderr,
+        "usage: %s [options] decode|encode|resize|sink\n"
+        "  -n frames   frames to process (300)\n"
+        "  -r rate     frames per second of the source, 0 for as fast as\n"
+        "              possible (30)\n"
+        "  -w width    input width (1280)\n"
+        "  -h height   input height (720)\n"
+        "  -W width    output width (720)\n"
+        "  -H height   output height (480)\n"
+        "  -b bufs     buffers of the capture/display tables (3)\n"
+        "  -C          sink: the input frames are contiguous\n", prog);
+}
+
+/******************************************************************************
+ * main
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    bench_opts          opts = { NULL, 300, 30, 1280, 720, 720, 480, 3, 0 };
+    Engine_Handle       hEngine;
+    Display_Handle      hDisplay = NULL;
+    fakedmai_mem_stats  mem;
+    unsigned long long  start, wall;
+    unsigned long       shown, repeated;
+    int                 c, i, ret;
+
+    while ((c = getopt(argc, argv, "n:r:w:h:W:H:b:C")) != -1) {
+        switch (c) {
+            case 'n': opts.frames = atoi(optarg); break;
+            case 'r': opts.rate = atoi(optarg); break;
+            case 'w': opts.width = atoi(optarg); break;
+            case 'h': opts.height = atoi(optarg); break;
+            case 'W': opts.outWidth = atoi(optarg); break;
+            case 'H': opts.outHeight = atoi(optarg); break;
+            case 'b': opts.numBufs = atoi(optarg); break;
+            case 'C': opts.contiguous = 1; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (optind != argc - 1 || opts.frames <= 0 || opts.numBufs <= 0 ||
+        opts.width <= 0 || opts.height <= 0 || opts.outWidth <= 0 ||
+        opts.outHeight <= 0) {
+        usage(argv[0]);
+        return 1;
+    }
+    opts.scenario = argv[optind];
+
+    CERuntime_init();
+    Dmai_init();
+
+    hEngine = Engine_open("codecServer", NULL, NULL);
+    if (!hEngine) {
+        fprintf(stderr, "failed to open the engine\n");
+        return 1;
+    }
+
+    start = fakedmai_now();
+    if (!strcmp(opts.scenario, "decode")) {
+        ret = bench_decode(&opts, hEngine, &hDisplay);
+    }
+    else if (!strcmp(opts.scenario, "encode")) {
+        ret = bench_encode(&opts, hEngine, 1);
+    }
+    else if (!strcmp(opts.scenario, "resize")) {
+        ret = bench_encode(&opts, hEngine, 0);
+    }
+    else if (!strcmp(opts.scenario, "sink")) {
+        ret = bench_sink(&opts, &hDisplay);
+    }
+    else {
+        usage(argv[0]);
+        return 1;
+    }
+    wall = fakedmai_now() - start;
+
+    printf("%s: %d frames in %.3f s, %.1f fps\n", opts.scenario, opts.frames,
+        wall / 1e6, wall ? opts.frames * 1e6 / wall : 0.0);
+    printf("%-20s %8s %10s %10s\n", "stage", "calls", "mean us", "max us");
+    for (i = 0; i < numStages; i++) {
+        printf("%-20s %8lu %10.1f %10llu\n", stages[i].name, stages[i].calls,
+            stages[i].calls ? (double)stages[i].total / stages[i].calls : 0.0,
+            stages[i].max);
+    }
+    printf("copied: %.1f MB\n", fakedmai_copy_bytes() / 1e6);
+
+    if (hDisplay) {
+        fakedmai_display_stats(hDisplay, &shown, &repeated);
+        printf("display: %lu frames shown, %lu vsyncs repeated a frame\n",
+            shown, repeated);
+        Display_delete(hDisplay);
+    }
+
+    fakedmai_mem_get_stats(&mem);
+    printf("cmem: %lu allocs, %lu frees, %lu failures, peak %lu of %lu "
+        "bytes, %lu ranges still registered\n", mem.allocs, mem.frees,
+        mem.failures, mem.peak, mem.size, mem.registered);
+
+    Engine_close(hEngine);
+    CERuntime_exit();
+
+    return ret ? 1 : 0;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
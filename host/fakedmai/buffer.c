@@ -0,0 +1,917 @@
+/*
+ * buffer.c
+ *
+ * Buffers, buffer tables and the small helper modules of the host
+ * stand-in: Buffer, BufferGfx, BufTab, ColorSpace, VideoStd, Fifo, Cpu and
+ * Dmai.  Buffer memory comes from the contiguous arena unless the buffer
+ * is a reference.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/resource.h>
+
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/BufTab.h>
+#include <ti/sdo/dmai/ColorSpace.h>
+#include <ti/sdo/dmai/Cpu.h>
+#include <ti/sdo/dmai/Fifo.h>
+#include <ti/sdo/dmai/VideoStd.h>
+#include <ti/sdo/dmai/priv/_Buffer.h>
+
+#include "fakedmai.h"
+
+typedef struct _BufTab_Object {
+    Int              numBufs;
+    Int32            size;
+    BufferGfx_Attrs  attrs;
+    Buffer_Handle   *bufs;
+} _BufTab_Object;
+
+/* The use masks are shared between the threads of the pipeline */
+static pthread_mutex_t bufMutex = PTHREAD_MUTEX_INITIALIZER;
+
+const Buffer_Attrs Buffer_Attrs_DEFAULT = {
+    1,
+    Buffer_Type_BASIC,
+    { Memory_CONTIGPOOL, Memory_NONCACHED, Memory_DEFAULTALIGNMENT, 0 },
+    FALSE
+};
+
+const BufferGfx_Attrs BufferGfx_Attrs_DEFAULT = {
+    {
+        1,
+        Buffer_Type_GRAPHICS,
+        { Memory_CONTIGPOOL, Memory_NONCACHED, Memory_DEFAULTALIGNMENT, 0 },
+        FALSE
+    },
+    ColorSpace_UYVY,
+    { 0, 0, 0, 0, 0 }
+};
+
+/******************************************************************************
+ * Dmai_init
+ ******************************************************************************/
+Void Dmai_init(Void)
+{
+}
+
+/******************************************************************************
+ * Dmai_setLogLevel
+ ******************************************************************************/
+Void Dmai_setLogLevel(Int level)
+{
+    fakedmai_debug = level > 0;
+}
+
+/******************************************************************************
+ * ColorSpace_getBpp
+ ******************************************************************************/
+Int ColorSpace_getBpp(ColorSpace_Type colorSpace)
+{
+    switch (colorSpace) {
+        case ColorSpace_UYVY:
+        case ColorSpace_RGB565:
+            return 16;
+        case ColorSpace_RGB888:
+            return 24;
+        case ColorSpace_2BIT:
+            return 2;
+        case ColorSpace_YUV420PSEMI:
+        case ColorSpace_YUV422PSEMI:
+        case ColorSpace_YUV420P:
+        case ColorSpace_YUV422P:
+        case ColorSpace_YUV444P:
+        case ColorSpace_GRAY:
+            return 8;
+        default:
+            return -1;
+    }
+}
+
+/******************************************************************************
+ * VideoStd_getResolution
+ ******************************************************************************/
+Int VideoStd_getResolution(VideoStd_Type videoStd, Int32 *width,
+        Int32 *height)
+{
+    static const Int32 res[VideoStd_COUNT][2] = {
+        [VideoStd_CIF]       = { 352, 288 },
+        [VideoStd_SIF_NTSC]  = { 352, 240 },
+        [VideoStd_SIF_PAL]   = { 352, 288 },
+        [VideoStd_VGA]       = { 640, 480 },
+        [VideoStd_D1_NTSC]   = { 720, 480 },
+        [VideoStd_D1_PAL]    = { 720, 576 },
+        [VideoStd_480P]      = { 720, 480 },
+        [VideoStd_576P]      = { 720, 576 },
+        [VideoStd_720P_60]   = { 1280, 720 },
+        [VideoStd_720P_50]   = { 1280, 720 },
+        [VideoStd_720P_30]   = { 1280, 720 },
+        [VideoStd_1080I_30]  = { 1920, 1080 },
+        [VideoStd_1080I_25]  = { 1920, 1080 },
+        [VideoStd_1080P_30]  = { 1920, 1080 },
+        [VideoStd_1080P_25]  = { 1920, 1080 },
+        [VideoStd_1080P_24]  = { 1920, 1080 },
+        [VideoStd_1080P_60]  = { 1920, 1080 },
+        [VideoStd_1080P_50]  = { 1920, 1080 },
+        [VideoStd_QVGA]      = { 320, 240 },
+    };
+
+    if (videoStd <= VideoStd_AUTO || videoStd >= VideoStd_COUNT) {
+        return Dmai_EINVAL;
+    }
+
+    *width = res[videoStd][0];
+    *height = res[videoStd][1];
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * VideoStd_getRefreshRate
+ *    Frames per second, fields are not modelled.
+ ******************************************************************************/
+Int VideoStd_getRefreshRate(VideoStd_Type videoStd)
+{
+    switch (videoStd) {
+        case VideoStd_SIF_PAL:
+        case VideoStd_D1_PAL:
+        case VideoStd_1080I_25:
+        case VideoStd_1080P_25:
+            return 25;
+        case VideoStd_1080P_24:
+            return 24;
+        case VideoStd_576P:
+        case VideoStd_720P_50:
+        case VideoStd_1080P_50:
+            return 50;
+        case VideoStd_VGA:
+        case VideoStd_480P:
+        case VideoStd_720P_60:
+        case VideoStd_1080P_60:
+            return 60;
+        default:
+            return 30;
+    }
+}
+
+/******************************************************************************
+ * _Buffer_init
+ ******************************************************************************/
+Int _Buffer_init(Buffer_Handle hBuf, Int32 size, Buffer_Attrs *attrs)
+{
+    hBuf->type = attrs->type;
+    hBuf->numBytes = size;
+    hBuf->numBytesUsed = size;
+    hBuf->reference = attrs->reference;
+    hBuf->useMask = 0;
+    hBuf->defaultUseMask = attrs->useMask;
+    hBuf->memParams = attrs->memParams;
+    hBuf->id = 0;
+    hBuf->hBufTab = NULL;
+
+    if (attrs->reference) {
+        hBuf->userPtr = NULL;
+        hBuf->physPtr = 0;
+        return Dmai_EOK;
+    }
+
+    hBuf->userPtr = Memory_alloc(size, &hBuf->memParams);
+    if (!hBuf->userPtr) {
+        return Dmai_ENOMEM;
+    }
+    hBuf->physPtr = Memory_getBufferPhysicalAddress(hBuf->userPtr, size,
+                        NULL);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * _Buffer_setBufTab / _Buffer_setId / _Buffer_getOriginalSize
+ ******************************************************************************/
+Int _Buffer_setBufTab(Buffer_Handle hBuf, BufTab_Handle hBufTab)
+{
+    hBuf->hBufTab = hBufTab;
+    return Dmai_EOK;
+}
+
+Int _Buffer_setId(Buffer_Handle hBuf, Int id)
+{
+    hBuf->id = id;
+    return Dmai_EOK;
+}
+
+Int _Buffer_getOriginalSize(Buffer_Handle hBuf)
+{
+    return hBuf->numBytes;
+}
+
+/******************************************************************************
+ * Buffer_create
+ ******************************************************************************/
+Buffer_Handle Buffer_create(Int32 size, Buffer_Attrs *attrs)
+{
+    Buffer_Handle hBuf;
+
+    if (!attrs) {
+        attrs = (Buffer_Attrs *)&Buffer_Attrs_DEFAULT;
+    }
+
+    if (attrs->type == Buffer_Type_GRAPHICS) {
+        BufferGfx_Attrs   *gfxAttrs = (BufferGfx_Attrs *)attrs;
+        _BufferGfx_Object *gfx = calloc(1, sizeof(*gfx));
+
+        gfx->dim = gfxAttrs->dim;
+        gfx->origDim = gfxAttrs->dim;
+        gfx->colorSpace = gfxAttrs->colorSpace;
+        gfx->frameType = (UInt32)BufferGfx_FrameType_NOTSET;
+        hBuf = &gfx->bufObject;
+    }
+    else {
+        hBuf = calloc(1, sizeof(*hBuf));
+    }
+
+    if (_Buffer_init(hBuf, size, attrs) < 0) {
+        free(hBuf);
+        return NULL;
+    }
+
+    return hBuf;
+}
+
+/******************************************************************************
+ * Buffer_delete
+ ******************************************************************************/
+Int Buffer_delete(Buffer_Handle hBuf)
+{
+    if (!hBuf) {
+        return Dmai_EOK;
+    }
+
+    if (!hBuf->reference && hBuf->userPtr) {
+        Memory_free(hBuf->userPtr, hBuf->numBytes, &hBuf->memParams);
+    }
+    free(hBuf);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Buffer accessors
+ ******************************************************************************/
+Int8 *Buffer_getUserPtr(Buffer_Handle hBuf)
+{
+    return hBuf->userPtr;
+}
+
+Int32 Buffer_getPhysicalPtr(Buffer_Handle hBuf)
+{
+    return hBuf->physPtr;
+}
+
+Int32 Buffer_getSize(Buffer_Handle hBuf)
+{
+    return hBuf->numBytes;
+}
+
+Int32 Buffer_getNumBytesUsed(Buffer_Handle hBuf)
+{
+    return hBuf->numBytesUsed;
+}
+
+Int Buffer_getId(Buffer_Handle hBuf)
+{
+    return hBuf->id;
+}
+
+Buffer_Type Buffer_getType(Buffer_Handle hBuf)
+{
+    return hBuf->type;
+}
+
+BufTab_Handle Buffer_getBufTab(Buffer_Handle hBuf)
+{
+    return hBuf->hBufTab;
+}
+
+Bool Buffer_isReference(Buffer_Handle hBuf)
+{
+    return hBuf->reference;
+}
+
+Int Buffer_setUserPtr(Buffer_Handle hBuf, Int8 *ptr)
+{
+    if (!hBuf->reference) {
+        return Dmai_EINVAL;
+    }
+
+    hBuf->userPtr = ptr;
+    hBuf->physPtr = ptr ? Memory_getBufferPhysicalAddress(ptr,
+                              hBuf->numBytes, NULL) : 0;
+    return Dmai_EOK;
+}
+
+Int Buffer_setSize(Buffer_Handle hBuf, Int32 numBytes)
+{
+    if (!hBuf->reference) {
+        return Dmai_EINVAL;
+    }
+
+    hBuf->numBytes = numBytes;
+    return Dmai_EOK;
+}
+
+Void Buffer_setNumBytesUsed(Buffer_Handle hBuf, Int32 numBytes)
+{
+    hBuf->numBytesUsed = numBytes;
+}
+
+/******************************************************************************
+ * Use masks
+ ******************************************************************************/
+UInt16 Buffer_getUseMask(Buffer_Handle hBuf)
+{
+    UInt16 useMask;
+
+    pthread_mutex_lock(&bufMutex);
+    useMask = hBuf->useMask;
+    pthread_mutex_unlock(&bufMutex);
+
+    return useMask;
+}
+
+Void Buffer_setUseMask(Buffer_Handle hBuf, UInt16 useMask)
+{
+    pthread_mutex_lock(&bufMutex);
+    hBuf->useMask = useMask;
+    pthread_mutex_unlock(&bufMutex);
+}
+
+Void Buffer_freeUseMask(Buffer_Handle hBuf, UInt16 useMask)
+{
+    pthread_mutex_lock(&bufMutex);
+    hBuf->useMask &= ~useMask;
+    pthread_mutex_unlock(&bufMutex);
+}
+
+Void Buffer_resetUseMask(Buffer_Handle hBuf)
+{
+    pthread_mutex_lock(&bufMutex);
+    hBuf->useMask = hBuf->defaultUseMask;
+    pthread_mutex_unlock(&bufMutex);
+}
+
+/******************************************************************************
+ * Buffer_copy
+ *    Copies the attributes of a buffer, not its data.
+ ******************************************************************************/
+Int Buffer_copy(Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf)
+{
+    if (!hDstBuf->reference) {
+        return Dmai_EINVAL;
+    }
+
+    hDstBuf->userPtr = hSrcBuf->userPtr;
+    hDstBuf->physPtr = hSrcBuf->physPtr;
+    hDstBuf->numBytes = hSrcBuf->numBytes;
+    hDstBuf->numBytesUsed = hSrcBuf->numBytesUsed;
+
+    if (hSrcBuf->type == Buffer_Type_GRAPHICS &&
+        hDstBuf->type == Buffer_Type_GRAPHICS) {
+        _BufferGfx_Object *src = (_BufferGfx_Object *)hSrcBuf;
+        _BufferGfx_Object *dst = (_BufferGfx_Object *)hDstBuf;
+
+        dst->dim = src->dim;
+        dst->colorSpace = src->colorSpace;
+        dst->frameType = src->frameType;
+    }
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Buffer_print
+ ******************************************************************************/
+Void Buffer_print(Buffer_Handle hBuf)
+{
+    fprintf(stderr, "Buffer %p: id %d ptr %p phys 0x%lx size %ld used %ld "
+        "mask 0x%x\n", (void *)hBuf, hBuf->id, (void *)hBuf->userPtr,
+        (unsigned long)hBuf->physPtr, (long)hBuf->numBytes,
+        (long)hBuf->numBytesUsed, hBuf->useMask);
+}
+
+/******************************************************************************
+ * BufferGfx
+ ******************************************************************************/
+Int BufferGfx_getDimensions(Buffer_Handle hBuf, BufferGfx_Dimensions *dimPtr)
+{
+    if (hBuf->type != Buffer_Type_GRAPHICS) {
+        return Dmai_EINVAL;
+    }
+
+    *dimPtr = ((_BufferGfx_Object *)hBuf)->dim;
+    return Dmai_EOK;
+}
+
+Int BufferGfx_setDimensions(Buffer_Handle hBuf, BufferGfx_Dimensions *dimPtr)
+{
+    if (hBuf->type != Buffer_Type_GRAPHICS) {
+        return Dmai_EINVAL;
+    }
+
+    ((_BufferGfx_Object *)hBuf)->dim = *dimPtr;
+    return Dmai_EOK;
+}
+
+Int BufferGfx_resetDimensions(Buffer_Handle hBuf)
+{
+    _BufferGfx_Object *gfx = (_BufferGfx_Object *)hBuf;
+
+    if (hBuf->type != Buffer_Type_GRAPHICS) {
+        return Dmai_EINVAL;
+    }
+
+    gfx->dim = gfx->origDim;
+    return Dmai_EOK;
+}
+
+ColorSpace_Type BufferGfx_getColorSpace(Buffer_Handle hBuf)
+{
+    if (hBuf->type != Buffer_Type_GRAPHICS) {
+        return ColorSpace_NOTSET;
+    }
+
+    return ((_BufferGfx_Object *)hBuf)->colorSpace;
+}
+
+Int BufferGfx_setColorSpace(Buffer_Handle hBuf, ColorSpace_Type colorSpace)
+{
+    if (hBuf->type != Buffer_Type_GRAPHICS) {
+        return Dmai_EINVAL;
+    }
+
+    ((_BufferGfx_Object *)hBuf)->colorSpace = colorSpace;
+    return Dmai_EOK;
+}
+
+UInt32 BufferGfx_getFrameType(Buffer_Handle hBuf)
+{
+    return ((_BufferGfx_Object *)hBuf)->frameType;
+}
+
+Void BufferGfx_setFrameType(Buffer_Handle hBuf, UInt32 frameType)
+{
+    ((_BufferGfx_Object *)hBuf)->frameType = frameType;
+}
+
+Int32 BufferGfx_calcLineLength(Int32 width, ColorSpace_Type colorSpace)
+{
+    Int bpp = ColorSpace_getBpp(colorSpace);
+
+    if (bpp < 0) {
+        return Dmai_EINVAL;
+    }
+
+    return (width * bpp + 7) / 8;
+}
+
+Int32 BufferGfx_calcFrameSize(Int32 width, Int32 height,
+          ColorSpace_Type colorSpace)
+{
+    Int32 plane = BufferGfx_calcLineLength(width, colorSpace) * height;
+
+    switch (colorSpace) {
+        case ColorSpace_YUV420PSEMI:
+        case ColorSpace_YUV420P:
+            return plane * 3 / 2;
+        case ColorSpace_YUV422PSEMI:
+        case ColorSpace_YUV422P:
+            return plane * 2;
+        case ColorSpace_YUV444P:
+            return plane * 3;
+        default:
+            return plane;
+    }
+}
+
+Int BufferGfx_calcDimensions(VideoStd_Type videoStd,
+        ColorSpace_Type colorSpace, BufferGfx_Dimensions *dimPtr)
+{
+    if (VideoStd_getResolution(videoStd, &dimPtr->width,
+            &dimPtr->height) < 0) {
+        return Dmai_EINVAL;
+    }
+
+    dimPtr->x = 0;
+    dimPtr->y = 0;
+    dimPtr->lineLength = BufferGfx_calcLineLength(dimPtr->width, colorSpace);
+    return Dmai_EOK;
+}
+
+Int32 BufferGfx_calcSize(VideoStd_Type videoStd, ColorSpace_Type colorSpace)
+{
+    Int32 width, height;
+
+    if (VideoStd_getResolution(videoStd, &width, &height) < 0) {
+        return Dmai_EINVAL;
+    }
+
+    return BufferGfx_calcFrameSize(width, height, colorSpace);
+}
+
+/******************************************************************************
+ * buftab_add
+ ******************************************************************************/
+static Int buftab_add(BufTab_Handle hBufTab, Int numBufs)
+{
+    Buffer_Handle *bufs;
+    Int            i;
+
+    bufs = realloc(hBufTab->bufs,
+               (hBufTab->numBufs + numBufs) * sizeof(Buffer_Handle));
+    if (!bufs) {
+        return Dmai_ENOMEM;
+    }
+    hBufTab->bufs = bufs;
+
+    for (i = 0; i < numBufs; i++) {
+        Buffer_Handle hBuf = Buffer_create(hBufTab->size,
+                                 BufferGfx_getBufferAttrs(&hBufTab->attrs));
+
+        if (!hBuf) {
+            return Dmai_ENOMEM;
+        }
+        _Buffer_setId(hBuf, hBufTab->numBufs);
+        _Buffer_setBufTab(hBuf, hBufTab);
+        hBufTab->bufs[hBufTab->numBufs++] = hBuf;
+    }
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * BufTab_create
+ ******************************************************************************/
+BufTab_Handle BufTab_create(Int numBufs, Int32 size, Buffer_Attrs *attrs)
+{
+    BufTab_Handle hBufTab = calloc(1, sizeof(*hBufTab));
+
+    if (!attrs) {
+        attrs = (Buffer_Attrs *)&Buffer_Attrs_DEFAULT;
+    }
+
+    hBufTab->size = size;
+    if (attrs->type == Buffer_Type_GRAPHICS) {
+        hBufTab->attrs = *(BufferGfx_Attrs *)attrs;
+    }
+    else {
+        hBufTab->attrs.bAttrs = *attrs;
+    }
+
+    if (buftab_add(hBufTab, numBufs) < 0) {
+        BufTab_delete(hBufTab);
+        return NULL;
+    }
+
+    return hBufTab;
+}
+
+/******************************************************************************
+ * BufTab_delete
+ ******************************************************************************/
+Int BufTab_delete(BufTab_Handle hBufTab)
+{
+    Int i;
+
+    if (!hBufTab) {
+        return Dmai_EOK;
+    }
+
+    for (i = 0; i < hBufTab->numBufs; i++) {
+        Buffer_delete(hBufTab->bufs[i]);
+    }
+    free(hBufTab->bufs);
+    free(hBufTab);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * BufTab_chunk / BufTab_collapse
+ *    Not used by the plugin.
+ ******************************************************************************/
+Int BufTab_chunk(BufTab_Handle hBufTab, Int numBufs, Int32 size)
+{
+    return Dmai_ENOTIMPL;
+}
+
+Int BufTab_collapse(BufTab_Handle hBufTab)
+{
+    return Dmai_ENOTIMPL;
+}
+
+/******************************************************************************
+ * BufTab_expand
+ ******************************************************************************/
+Int BufTab_expand(BufTab_Handle hBufTab, Int numBufs)
+{
+    Int ret;
+
+    pthread_mutex_lock(&bufMutex);
+    ret = buftab_add(hBufTab, numBufs);
+    pthread_mutex_unlock(&bufMutex);
+
+    return ret;
+}
+
+/******************************************************************************
+ * BufTab accessors
+ ******************************************************************************/
+Int BufTab_getNumBufs(BufTab_Handle hBufTab)
+{
+    return hBufTab->numBufs;
+}
+
+Buffer_Handle BufTab_getBuf(BufTab_Handle hBufTab, Int bufIdx)
+{
+    if (bufIdx < 0 || bufIdx >= hBufTab->numBufs) {
+        return NULL;
+    }
+
+    return hBufTab->bufs[bufIdx];
+}
+
+/******************************************************************************
+ * BufTab_getFreeBuf
+ ******************************************************************************/
+Buffer_Handle BufTab_getFreeBuf(BufTab_Handle hBufTab)
+{
+    Buffer_Handle hBuf = NULL;
+    Int           i;
+
+    pthread_mutex_lock(&bufMutex);
+    for (i = 0; i < hBufTab->numBufs; i++) {
+        if (hBufTab->bufs[i]->useMask == 0) {
+            hBuf = hBufTab->bufs[i];
+            hBuf->useMask = hBuf->defaultUseMask;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&bufMutex);
+
+    return hBuf;
+}
+
+/******************************************************************************
+ * BufTab_freeBuf / BufTab_freeAll
+ ******************************************************************************/
+Void BufTab_freeBuf(Buffer_Handle hBuf)
+{
+    Buffer_setUseMask(hBuf, 0);
+}
+
+Void BufTab_freeAll(BufTab_Handle hBufTab)
+{
+    Int i;
+
+    pthread_mutex_lock(&bufMutex);
+    for (i = 0; i < hBufTab->numBufs; i++) {
+        hBufTab->bufs[i]->useMask = 0;
+    }
+    pthread_mutex_unlock(&bufMutex);
+}
+
+/******************************************************************************
+ * BufTab_print
+ ******************************************************************************/
+Void BufTab_print(BufTab_Handle hBufTab)
+{
+    Int i;
+
+    for (i = 0; i < hBufTab->numBufs; i++) {
+        Buffer_print(hBufTab->bufs[i]);
+    }
+}
+
+/******************************************************************************
+ * Fifo
+ *    Fifo_get blocks until an entry is available, or returns Dmai_EEOF
+ *    once the fifo has been flushed.
+ ******************************************************************************/
+typedef struct fifo_entry {
+    Ptr                 ptr;
+    struct fifo_entry  *next;
+} fifo_entry;
+
+typedef struct Fifo_Object {
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    fifo_entry         *head;
+    fifo_entry         *tail;
+    Int                 numEntries;
+    Bool                flushed;
+} Fifo_Object;
+
+const Fifo_Attrs Fifo_Attrs_DEFAULT = { 0 };
+
+Fifo_Handle Fifo_create(Fifo_Attrs *attrs)
+{
+    Fifo_Handle hFifo = calloc(1, sizeof(*hFifo));
+
+    pthread_mutex_init(&hFifo->mutex, NULL);
+    pthread_cond_init(&hFifo->cond, NULL);
+    return hFifo;
+}
+
+Int Fifo_delete(Fifo_Handle hFifo)
+{
+    fifo_entry *e;
+
+    if (!hFifo) {
+        return Dmai_EOK;
+    }
+
+    while ((e = hFifo->head)) {
+        hFifo->head = e->next;
+        free(e);
+    }
+    pthread_cond_destroy(&hFifo->cond);
+    pthread_mutex_destroy(&hFifo->mutex);
+    free(hFifo);
+    return Dmai_EOK;
+}
+
+Int Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr)
+{
+    fifo_entry *e;
+
+    pthread_mutex_lock(&hFifo->mutex);
+    while (!hFifo->head && !hFifo->flushed) {
+        pthread_cond_wait(&hFifo->cond, &hFifo->mutex);
+    }
+
+    if (!hFifo->head) {
+        pthread_mutex_unlock(&hFifo->mutex);
+        return Dmai_EEOF;
+    }
+
+    e = hFifo->head;
+    hFifo->head = e->next;
+    if (!hFifo->head) {
+        hFifo->tail = NULL;
+    }
+    hFifo->numEntries--;
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    *(Ptr *)ptrPtr = e->ptr;
+    free(e);
+    return Dmai_EOK;
+}
+
+Int Fifo_put(Fifo_Handle hFifo, Ptr ptr)
+{
+    fifo_entry *e = malloc(sizeof(*e));
+
+    e->ptr = ptr;
+    e->next = NULL;
+
+    pthread_mutex_lock(&hFifo->mutex);
+    if (hFifo->tail) {
+        hFifo->tail->next = e;
+    }
+    else {
+        hFifo->head = e;
+    }
+    hFifo->tail = e;
+    hFifo->numEntries++;
+    pthread_cond_signal(&hFifo->cond);
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    return Dmai_EOK;
+}
+
+Int Fifo_flush(Fifo_Handle hFifo)
+{
+    pthread_mutex_lock(&hFifo->mutex);
+    hFifo->flushed = TRUE;
+    pthread_cond_broadcast(&hFifo->cond);
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    return Dmai_EOK;
+}
+
+Int Fifo_getNumEntries(Fifo_Handle hFifo)
+{
+    Int numEntries;
+
+    pthread_mutex_lock(&hFifo->mutex);
+    numEntries = hFifo->numEntries;
+    pthread_mutex_unlock(&hFifo->mutex);
+
+    return numEntries;
+}
+
+/******************************************************************************
+ * Cpu
+ *    The load is the CPU time of the process over the wall time elapsed
+ *    since the previous call.
+ ******************************************************************************/
+typedef struct Cpu_Object {
+    Cpu_Device          device;
+    unsigned long long  lastWall;
+    unsigned long long  lastCpu;
+} Cpu_Object;
+
+const Cpu_Attrs Cpu_Attrs_DEFAULT = { 0 };
+
+static unsigned long long cpu_time(void)
+{
+    struct rusage ru;
+
+    getrusage(RUSAGE_SELF, &ru);
+    return (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) * 1000000ULL +
+           ru.ru_utime.tv_usec + ru.ru_stime.tv_usec;
+}
+
+Cpu_Handle Cpu_create(Cpu_Attrs *attrs)
+{
+    static const struct {
+        const char *name;
+        Cpu_Device  device;
+    } devices[] = {
+        { "dm6467",   Cpu_Device_DM6467 },
+        { "dm6446",   Cpu_Device_DM6446 },
+        { "dm355",    Cpu_Device_DM355 },
+        { "dm357",    Cpu_Device_DM357 },
+        { "dm365",    Cpu_Device_DM365 },
+        { "omap3530", Cpu_Device_OMAP3530 },
+        { "omapl137", Cpu_Device_OMAPL137 },
+        { "omapl138", Cpu_Device_OMAPL138 },
+        { "dm3730",   Cpu_Device_DM3730 },
+    };
+    Cpu_Handle  hCpu = calloc(1, sizeof(*hCpu));
+    const char *env = getenv("FAKEDMAI_DEVICE");
+    size_t      i;
+
+    hCpu->device = Cpu_Device_DM6467;
+    for (i = 0; env && i < sizeof(devices) / sizeof(devices[0]); i++) {
+        if (!strcasecmp(env, devices[i].name)) {
+            hCpu->device = devices[i].device;
+        }
+    }
+    hCpu->lastWall = fakedmai_now();
+    hCpu->lastCpu = cpu_time();
+
+    return hCpu;
+}
+
+Int Cpu_delete(Cpu_Handle hCpu)
+{
+    free(hCpu);
+    return Dmai_EOK;
+}
+
+Int Cpu_getLoad(Cpu_Handle hCpu, Int *cpuLoad)
+{
+    unsigned long long wall = fakedmai_now();
+    unsigned long long cpu = cpu_time();
+
+    *cpuLoad = wall > hCpu->lastWall ?
+        (Int)((cpu - hCpu->lastCpu) * 100 / (wall - hCpu->lastWall)) : 0;
+    hCpu->lastWall = wall;
+    hCpu->lastCpu = cpu;
+
+    return Dmai_EOK;
+}
+
+Int Cpu_getDevice(Cpu_Handle hCpu, Cpu_Device *device)
+{
+    Cpu_Handle hTmp = hCpu ? hCpu : Cpu_create(NULL);
+
+    *device = hTmp->device;
+    if (!hCpu) {
+        Cpu_delete(hTmp);
+    }
+    return Dmai_EOK;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,761 @@
+/*
+ * codecs.c
+ *
+ * Codecs of the host stand-in.  They don't decode or encode anything: a
+ * process call waits the latency configured for it, like the ARM does
+ * while the DSP works, and moves the buffers and their use masks the way
+ * the real codecs do so the elements' buffer management gets exercised.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/BufTab.h>
+#include <ti/sdo/dmai/ce/Vdec2.h>
+#include <ti/sdo/dmai/ce/Venc1.h>
+#include <ti/sdo/dmai/ce/Adec1.h>
+#include <ti/sdo/dmai/ce/Aenc1.h>
+#include <ti/sdo/dmai/ce/Idec1.h>
+#include <ti/sdo/dmai/ce/Ienc1.h>
+#include <ti/sdo/dmai/priv/_Buffer.h>
+
+#include "fakedmai.h"
+
+/******************************************************************************
+ * chroma_to_colorspace
+ ******************************************************************************/
+static ColorSpace_Type chroma_to_colorspace(XDAS_Int32 chromaFormat)
+{
+    switch (chromaFormat) {
+        case XDM_YUV_422ILE:
+            return ColorSpace_UYVY;
+        case XDM_YUV_422P:
+            return ColorSpace_YUV422PSEMI;
+        case XDM_GRAY:
+            return ColorSpace_GRAY;
+        default:
+            return ColorSpace_YUV420PSEMI;
+    }
+}
+
+/******************************************************************************
+ * buf_list_push / buf_list_pop
+ *    Small bounded queues of buffers, the codecs never hold more than the
+ *    buffer table they were given.
+ ******************************************************************************/
+#define MAX_CODEC_BUFS  XDM_MAX_IO_BUFFERS
+
+typedef struct buf_list {
+    Buffer_Handle   bufs[MAX_CODEC_BUFS];
+    Int             num;
+} buf_list;
+
+static void buf_list_push(buf_list *list, Buffer_Handle hBuf)
+{
+    if (list->num < MAX_CODEC_BUFS) {
+        list->bufs[list->num++] = hBuf;
+    }
+}
+
+static Buffer_Handle buf_list_pop(buf_list *list)
+{
+    Buffer_Handle hBuf;
+
+    if (list->num == 0) {
+        return NULL;
+    }
+
+    hBuf = list->bufs[0];
+    memmove(list->bufs, list->bufs + 1, --list->num * sizeof(Buffer_Handle));
+    return hBuf;
+}
+
+/******************************************************************************
+ * Vdec2
+ ******************************************************************************/
+typedef struct VIDDEC2_Obj {
+    struct Vdec2_Object    *hVd;
+} VIDDEC2_Obj;
+
+typedef struct Vdec2_Object {
+    VIDDEC2_Obj             visa;
+    VIDDEC2_Params          params;
+    VIDDEC2_DynamicParams   dynParams;
+    BufTab_Handle           hOutBufTab;
+    Buffer_Handle           hRefBuf;
+    buf_list                displayBufs;
+    buf_list                freeBufs;
+    Bool                    flushing;
+    Int32                   inBufSize;
+    Int32                   outBufSize;
+    pthread_mutex_t         mutex;
+} Vdec2_Object;
+
+const VIDDEC2_Params Vdec2_Params_DEFAULT = {
+    sizeof(IVIDDEC2_Params),
+    576,
+    720,
+    30000,
+    6000000,
+    XDM_BYTE,
+    XDM_YUV_420SP
+};
+
+const VIDDEC2_DynamicParams Vdec2_DynamicParams_DEFAULT = {
+    sizeof(IVIDDEC2_DynamicParams),
+    XDM_DECODE_AU,
+    0,
+    IVIDEO_NO_SKIP,
+    IVIDEO_DISPLAY_ORDER,
+    XDAS_FALSE,
+    XDAS_FALSE
+};
+
+Vdec2_Handle Vdec2_create(Engine_Handle hEngine, Char *codecName,
+                 VIDDEC2_Params *params, VIDDEC2_DynamicParams *dynParams)
+{
+    Vdec2_Handle    hVd;
+    ColorSpace_Type cs;
+
+    if (!hEngine || !codecName || !params || !dynParams) {
+        return NULL;
+    }
+
+    fakedmai_delay("Vdec2_create");
+
+    hVd = calloc(1, sizeof(*hVd));
+    hVd->visa.hVd = hVd;
+    hVd->params = *params;
+    hVd->dynParams = *dynParams;
+    cs = chroma_to_colorspace(params->forceChromaFormat);
+    hVd->outBufSize = BufferGfx_calcFrameSize(params->maxWidth,
+                          params->maxHeight, cs);
+    hVd->inBufSize = params->maxWidth * params->maxHeight / 2;
+    pthread_mutex_init(&hVd->mutex, NULL);
+
+    FAKEDMAI_DEBUG("created video decoder %s %ldx%ld\n", codecName,
+        (long)params->maxWidth, (long)params->maxHeight);
+    return hVd;
+}
+
+Int Vdec2_delete(Vdec2_Handle hVd)
+{
+    if (!hVd) {
+        return Dmai_EOK;
+    }
+
+    pthread_mutex_destroy(&hVd->mutex);
+    free(hVd);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Vdec2_process
+ *    The decoded frame is displayable right away, and the codec keeps it as
+ *    its reference until the next frame releases it.  Once flushed, the
+ *    reference is released and the call returns Dmai_EEOF.
+ ******************************************************************************/
+Int Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
+        Buffer_Handle hDstBuf)
+{
+    BufferGfx_Dimensions dim;
+
+    pthread_mutex_lock(&hVd->mutex);
+    if (hVd->flushing) {
+        if (hVd->hRefBuf) {
+            buf_list_push(&hVd->freeBufs, hVd->hRefBuf);
+            hVd->hRefBuf = NULL;
+        }
+        hVd->flushing = FALSE;
+        pthread_mutex_unlock(&hVd->mutex);
+        return Dmai_EEOF;
+    }
+    pthread_mutex_unlock(&hVd->mutex);
+
+    if (Buffer_getNumBytesUsed(hInBuf) <= 0) {
+        return Dmai_EBITERROR;
+    }
+
+    fakedmai_delay("Vdec2_process");
+
+    dim.x = 0;
+    dim.y = 0;
+    dim.width = hVd->params.maxWidth;
+    dim.height = hVd->params.maxHeight;
+    dim.lineLength = BufferGfx_calcLineLength(dim.width,
+                         BufferGfx_getColorSpace(hDstBuf));
+    BufferGfx_setDimensions(hDstBuf, &dim);
+    BufferGfx_setFrameType(hDstBuf, IVIDEO_I_FRAME);
+    Buffer_setNumBytesUsed(hDstBuf, Buffer_getSize(hDstBuf));
+
+    pthread_mutex_lock(&hVd->mutex);
+    if (hVd->hRefBuf) {
+        buf_list_push(&hVd->freeBufs, hVd->hRefBuf);
+    }
+    hVd->hRefBuf = hDstBuf;
+    buf_list_push(&hVd->displayBufs, hDstBuf);
+    pthread_mutex_unlock(&hVd->mutex);
+
+    /* The whole access unit is consumed, numBytesUsed stays as it is */
+    return Dmai_EOK;
+}
+
+Int Vdec2_flush(Vdec2_Handle hVd)
+{
+    pthread_mutex_lock(&hVd->mutex);
+    hVd->flushing = TRUE;
+    pthread_mutex_unlock(&hVd->mutex);
+
+    return Dmai_EOK;
+}
+
+Void Vdec2_setBufTab(Vdec2_Handle hVd, BufTab_Handle hBufTab)
+{
+    hVd->hOutBufTab = hBufTab;
+}
+
+BufTab_Handle Vdec2_getBufTab(Vdec2_Handle hVd)
+{
+    return hVd->hOutBufTab;
+}
+
+Buffer_Handle Vdec2_getDisplayBuf(Vdec2_Handle hVd)
+{
+    Buffer_Handle hBuf;
+
+    pthread_mutex_lock(&hVd->mutex);
+    hBuf = buf_list_pop(&hVd->displayBufs);
+    pthread_mutex_unlock(&hVd->mutex);
+
+    return hBuf;
+}
+
+Buffer_Handle Vdec2_getFreeBuf(Vdec2_Handle hVd)
+{
+    Buffer_Handle hBuf;
+
+    pthread_mutex_lock(&hVd->mutex);
+    hBuf = buf_list_pop(&hVd->freeBufs);
+    pthread_mutex_unlock(&hVd->mutex);
+
+    return hBuf;
+}
+
+Int32 Vdec2_getInBufSize(Vdec2_Handle hVd)
+{
+    return hVd->inBufSize;
+}
+
+Int32 Vdec2_getOutBufSize(Vdec2_Handle hVd)
+{
+    return hVd->outBufSize;
+}
+
+Int32 Vdec2_getMinOutBufs(Vdec2_Handle hVd)
+{
+    return 3;
+}
+
+VIDDEC2_Handle Vdec2_getVisaHandle(Vdec2_Handle hVd)
+{
+    return &hVd->visa;
+}
+
+Int32 VIDDEC2_control(VIDDEC2_Handle handle, VIDDEC2_Cmd id,
+          VIDDEC2_DynamicParams *params, VIDDEC2_Status *status)
+{
+    Vdec2_Handle hVd = handle->hVd;
+
+    fakedmai_delay("VIDDEC2_control");
+
+    switch (id) {
+        case XDM_SETPARAMS:
+            hVd->dynParams = *params;
+            break;
+        case XDM_FLUSH:
+            Vdec2_flush(hVd);
+            break;
+        case XDM_GETSTATUS:
+        case XDM_GETBUFINFO:
+            status->extendedError = 0;
+            status->maxNumDisplayBufs = Vdec2_getMinOutBufs(hVd);
+            status->outputWidth = hVd->params.maxWidth;
+            status->outputHeight = hVd->params.maxHeight;
+            status->frameRate = hVd->params.maxFrameRate;
+            status->bitRate = hVd->params.maxBitRate;
+            status->contentType = IVIDEO_PROGRESSIVE;
+            status->outputChromaFormat = hVd->params.forceChromaFormat;
+            status->bufInfo.minNumInBufs = 1;
+            status->bufInfo.minNumOutBufs = 1;
+            status->bufInfo.minInBufSize[0] = hVd->inBufSize;
+            status->bufInfo.minOutBufSize[0] = hVd->outBufSize;
+            break;
+        default:
+            break;
+    }
+
+    return VIDDEC2_EOK;
+}
+
+/******************************************************************************
+ * Venc1
+ ******************************************************************************/
+typedef struct VIDENC1_Obj {
+    struct Venc1_Object    *hVe;
+} VIDENC1_Obj;
+
+typedef struct Venc1_Object {
+    VIDENC1_Obj             visa;
+    VIDENC1_Params          params;
+    VIDENC1_DynamicParams   dynParams;
+    Int32                   inBufSize;
+    Int32                   outBufSize;
+    unsigned long           frame;
+    pthread_mutex_t         mutex;
+} Venc1_Object;
+
+const VIDENC1_Params Venc1_Params_DEFAULT = {
+    sizeof(IVIDENC1_Params),
+    XDM_DEFAULT,
+    IVIDEO_LOW_DELAY,
+    576,
+    720,
+    30000,
+    6000000,
+    XDM_BYTE,
+    0,
+    XDM_YUV_422ILE,
+    IVIDEO_PROGRESSIVE,
+    XDM_CHROMA_NA
+};
+
+const VIDENC1_DynamicParams Venc1_DynamicParams_DEFAULT = {
+    sizeof(IVIDENC1_DynamicParams),
+    576,
+    720,
+    30000,
+    30000,
+    6000000,
+    30,
+    XDM_ENCODE_AU,
+    0,
+    IVIDEO_NA_FRAME,
+    0,
+    XDAS_FALSE
+};
+
+Venc1_Handle Venc1_create(Engine_Handle hEngine, Char *codecName,
+                 VIDENC1_Params *params, VIDENC1_DynamicParams *dynParams)
+{
+    Venc1_Handle hVe;
+
+    if (!hEngine || !codecName || !params || !dynParams) {
+        return NULL;
+    }
+
+    fakedmai_delay("Venc1_create");
+
+    hVe = calloc(1, sizeof(*hVe));
+    hVe->visa.hVe = hVe;
+    hVe->params = *params;
+    hVe->dynParams = *dynParams;
+    hVe->inBufSize = BufferGfx_calcFrameSize(params->maxWidth,
+                         params->maxHeight,
+                         chroma_to_colorspace(params->inputChromaFormat));
+    hVe->outBufSize = params->maxWidth * params->maxHeight / 2;
+    pthread_mutex_init(&hVe->mutex, NULL);
+
+    FAKEDMAI_DEBUG("created video encoder %s %ldx%ld\n", codecName,
+        (long)params->maxWidth, (long)params->maxHeight);
+    return hVe;
+}
+
+Int Venc1_delete(Venc1_Handle hVe)
+{
+    if (!hVe) {
+        return Dmai_EOK;
+    }
+
+    pthread_mutex_destroy(&hVe->mutex);
+    free(hVe);
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Venc1_process
+ *    Writes an access unit of the size the rate control would aim for, an
+ *    H.264 start code followed by filler.  Key frames are four times as
+ *    large as the others.
+ ******************************************************************************/
+Int Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf,
+        Buffer_Handle hOutBuf)
+{
+    VIDENC1_DynamicParams dyn;
+    Int8                 *out = Buffer_getUserPtr(hOutBuf);
+    Int32                 bytes;
+    Bool                  key;
+
+    pthread_mutex_lock(&hVe->mutex);
+    dyn = hVe->dynParams;
+    key = hVe->frame == 0 ||
+          (dyn.intraFrameInterval > 0 &&
+           hVe->frame % dyn.intraFrameInterval == 0) ||
+          dyn.forceFrame == IVIDEO_I_FRAME ||
+          dyn.forceFrame == IVIDEO_IDR_FRAME;
+    hVe->frame++;
+    pthread_mutex_unlock(&hVe->mutex);
+
+    fakedmai_delay("Venc1_process");
+
+    bytes = dyn.targetFrameRate > 0 ?
+        (Int32)((long long)dyn.targetBitRate * 1000 / dyn.targetFrameRate /
+                8) : 4096;
+    if (key) {
+        bytes *= 4;
+    }
+    if (bytes < 5) {
+        bytes = 5;
+    }
+    if (bytes > Buffer_getSize(hOutBuf)) {
+        bytes = Buffer_getSize(hOutBuf);
+    }
+
+    out[0] = 0;
+    out[1] = 0;
+    out[2] = 0;
+    out[3] = 1;
+    out[4] = key ? 0x65 : 0x41;
+    memset(out + 5, 0xff, bytes - 5);
+    Buffer_setNumBytesUsed(hOutBuf, bytes);
+
+    return Dmai_EOK;
+}
+
+Int Venc1_flush(Venc1_Handle hVe)
+{
+    return Dmai_EOK;
+}
+
+Int32 Venc1_getInBufSize(Venc1_Handle hVe)
+{
+    return hVe->inBufSize;
+}
+
+Int32 Venc1_getOutBufSize(Venc1_Handle hVe)
+{
+    return hVe->outBufSize;
+}
+
+VIDENC1_Handle Venc1_getVisaHandle(Venc1_Handle hVe)
+{
+    return &hVe->visa;
+}
+
+Int32 VIDENC1_control(VIDENC1_Handle handle, VIDENC1_Cmd id,
+          VIDENC1_DynamicParams *params, VIDENC1_Status *status)
+{
+    Venc1_Handle hVe = handle->hVe;
+
+    fakedmai_delay("VIDENC1_control");
+
+    switch (id) {
+        case XDM_SETPARAMS:
+            pthread_mutex_lock(&hVe->mutex);
+            hVe->dynParams = *params;
+            pthread_mutex_unlock(&hVe->mutex);
+            break;
+        case XDM_GETSTATUS:
+        case XDM_GETBUFINFO:
+            status->extendedError = 0;
+            status->bufInfo.minNumInBufs = 1;
+            status->bufInfo.minNumOutBufs = 1;
+            status->bufInfo.minInBufSize[0] = hVe->inBufSize;
+            status->bufInfo.minOutBufSize[0] = hVe->outBufSize;
+            break;
+        default:
+            break;
+    }
+
+    return VIDENC1_EOK;
+}
+
+/******************************************************************************
+ * Audio and image codecs
+ *    Each process call consumes its whole input and produces a fixed
+ *    amount of output.
+ ******************************************************************************/
+typedef struct fake_codec {
+    const char     *call;
+    Int32           inBufSize;
+    Int32           outBufSize;
+    Int32           outBytes;
+} fake_codec;
+
+static fake_codec *fake_codec_create(const char *call, Int32 inBufSize,
+                       Int32 outBufSize, Int32 outBytes)
+{
+    fake_codec *codec = calloc(1, sizeof(*codec));
+
+    codec->call = call;
+    codec->inBufSize = inBufSize;
+    codec->outBufSize = outBufSize;
+    codec->outBytes = outBytes < outBufSize ? outBytes : outBufSize;
+    return codec;
+}
+
+static Int fake_codec_process(fake_codec *codec, Buffer_Handle hInBuf,
+               Buffer_Handle hOutBuf)
+{
+    Int32 bytes = codec->outBytes;
+
+    if (Buffer_getNumBytesUsed(hInBuf) <= 0) {
+        return Dmai_EBITERROR;
+    }
+
+    fakedmai_delay(codec->call);
+
+    if (bytes > Buffer_getSize(hOutBuf)) {
+        bytes = Buffer_getSize(hOutBuf);
+    }
+    memset(Buffer_getUserPtr(hOutBuf), 0, bytes);
+    Buffer_setNumBytesUsed(hOutBuf, bytes);
+
+    return Dmai_EOK;
+}
+
+typedef struct Adec1_Object { fake_codec *codec; } Adec1_Object;
+typedef struct Aenc1_Object { fake_codec *codec; } Aenc1_Object;
+typedef struct Idec1_Object { fake_codec *codec; } Idec1_Object;
+typedef struct Ienc1_Object { fake_codec *codec; } Ienc1_Object;
+
+const AUDDEC1_Params Adec1_Params_DEFAULT = {
+    sizeof(IAUDDEC1_Params), 16, 0, XDM_LE_16
+};
+
+const AUDDEC1_DynamicParams Adec1_DynamicParams_DEFAULT = {
+    sizeof(IAUDDEC1_DynamicParams), XDAS_FALSE
+};
+
+const AUDENC1_Params Aenc1_Params_DEFAULT = {
+    sizeof(IAUDENC1_Params), 44100, 128000, 1, XDM_LE_16, 0, 0, 16,
+    192000, 0, XDAS_FALSE, XDAS_FALSE, XDAS_FALSE
+};
+
+const AUDENC1_DynamicParams Aenc1_DynamicParams_DEFAULT = {
+    sizeof(IAUDENC1_DynamicParams), 128000, 44100, 1, XDAS_FALSE, 0, 16
+};
+
+const IMGDEC1_Params Idec1_Params_DEFAULT = {
+    sizeof(IIMGDEC1_Params), 576, 720, 1, XDM_BYTE, XDM_YUV_422ILE
+};
+
+const IMGDEC1_DynamicParams Idec1_DynamicParams_DEFAULT = {
+    sizeof(IIMGDEC1_DynamicParams), 0, XDM_DECODE_AU, 0
+};
+
+const IMGENC1_Params Ienc1_Params_DEFAULT = {
+    sizeof(IIMGENC1_Params), 576, 720, 1, XDM_BYTE, XDM_YUV_422ILE
+};
+
+const IMGENC1_DynamicParams Ienc1_DynamicParams_DEFAULT = {
+    sizeof(IIMGENC1_DynamicParams), 0, XDM_YUV_422ILE, 576, 720, 0,
+    XDM_ENCODE_AU, 75
+};
+
+Adec1_Handle Adec1_create(Engine_Handle hEngine, Char *codecName,
+                 AUDDEC1_Params *params, AUDDEC1_DynamicParams *dynParams)
+{
+    Adec1_Handle hAd;
+
+    if (!hEngine || !codecName || !params || !dynParams) {
+        return NULL;
+    }
+
+    /* One AAC frame is 1024 stereo samples */
+    hAd = calloc(1, sizeof(*hAd));
+    hAd->codec = fake_codec_create("Adec1_process", 16 * 1024, 8 * 1024,
+                     1024 * 2 * params->outputPCMWidth / 8);
+    return hAd;
+}
+
+Int Adec1_process(Adec1_Handle hAd, Buffer_Handle hInBuf,
+        Buffer_Handle hOutBuf)
+{
+    return fake_codec_process(hAd->codec, hInBuf, hOutBuf);
+}
+
+Int Adec1_delete(Adec1_Handle hAd)
+{
+    if (hAd) {
+        free(hAd->codec);
+        free(hAd);
+    }
+    return Dmai_EOK;
+}
+
+Int32 Adec1_getInBufSize(Adec1_Handle hAd)
+{
+    return hAd->codec->inBufSize;
+}
+
+Int32 Adec1_getOutBufSize(Adec1_Handle hAd)
+{
+    return hAd->codec->outBufSize;
+}
+
+Int Adec1_getSampleRate(Adec1_Handle hAd)
+{
+    return 44100;
+}
+
+Aenc1_Handle Aenc1_create(Engine_Handle hEngine, Char *codecName,
+                 AUDENC1_Params *params, AUDENC1_DynamicParams *dynParams)
+{
+    Aenc1_Handle hAe;
+
+    if (!hEngine || !codecName || !params || !dynParams ||
+        params->sampleRate <= 0) {
+        return NULL;
+    }
+
+    hAe = calloc(1, sizeof(*hAe));
+    hAe->codec = fake_codec_create("Aenc1_process", 8 * 1024, 16 * 1024,
+                     (Int32)((long long)params->bitRate * 1024 /
+                         params->sampleRate / 8));
+    return hAe;
+}
+
+Int Aenc1_process(Aenc1_Handle hAe, Buffer_Handle hInBuf,
+        Buffer_Handle hOutBuf)
+{
+    return fake_codec_process(hAe->codec, hInBuf, hOutBuf);
+}
+
+Int Aenc1_delete(Aenc1_Handle hAe)
+{
+    if (hAe) {
+        free(hAe->codec);
+        free(hAe);
+    }
+    return Dmai_EOK;
+}
+
+Int32 Aenc1_getInBufSize(Aenc1_Handle hAe)
+{
+    return hAe->codec->inBufSize;
+}
+
+Int32 Aenc1_getOutBufSize(Aenc1_Handle hAe)
+{
+    return hAe->codec->outBufSize;
+}
+
+Idec1_Handle Idec1_create(Engine_Handle hEngine, Char *codecName,
+                 IMGDEC1_Params *params, IMGDEC1_DynamicParams *dynParams)
+{
+    Idec1_Handle hId;
+    Int32        size;
+
+    if (!hEngine || !codecName || !params || !dynParams) {
+        return NULL;
+    }
+
+    size = BufferGfx_calcFrameSize(params->maxWidth, params->maxHeight,
+               chroma_to_colorspace(params->forceChromaFormat));
+    hId = calloc(1, sizeof(*hId));
+    hId->codec = fake_codec_create("Idec1_process", size / 2, size, size);
+    return hId;
+}
+
+Int Idec1_process(Idec1_Handle hId, Buffer_Handle hInBuf,
+        Buffer_Handle hOutBuf)
+{
+    return fake_codec_process(hId->codec, hInBuf, hOutBuf);
+}
+
+Int Idec1_delete(Idec1_Handle hId)
+{
+    if (hId) {
+        free(hId->codec);
+        free(hId);
+    }
+    return Dmai_EOK;
+}
+
+Int32 Idec1_getInBufSize(Idec1_Handle hId)
+{
+    return hId->codec->inBufSize;
+}
+
+Int32 Idec1_getOutBufSize(Idec1_Handle hId)
+{
+    return hId->codec->outBufSize;
+}
+
+Ienc1_Handle Ienc1_create(Engine_Handle hEngine, Char *codecName,
+                 IMGENC1_Params *params, IMGENC1_DynamicParams *dynParams)
+{
+    Ienc1_Handle hIe;
+    Int32        size;
+
+    if (!hEngine || !codecName || !params || !dynParams) {
+        return NULL;
+    }
+
+    size = BufferGfx_calcFrameSize(params->maxWidth, params->maxHeight,
+               chroma_to_colorspace(params->forceChromaFormat));
+    hIe = calloc(1, sizeof(*hIe));
+    hIe->codec = fake_codec_create("Ienc1_process", size, size / 2,
+                     size / 10);
+    return hIe;
+}
+
+Int Ienc1_process(Ienc1_Handle hIe, Buffer_Handle hInBuf,
+        Buffer_Handle hOutBuf)
+{
+    return fake_codec_process(hIe->codec, hInBuf, hOutBuf);
+}
+
+Int Ienc1_delete(Ienc1_Handle hIe)
+{
+    if (hIe) {
+        free(hIe->codec);
+        free(hIe);
+    }
+    return Dmai_EOK;
+}
+
+Int32 Ienc1_getInBufSize(Ienc1_Handle hIe)
+{
+    return hIe->codec->inBufSize;
+}
+
+Int32 Ienc1_getOutBufSize(Ienc1_Handle hIe)
+{
+    return hIe->codec->outBufSize;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
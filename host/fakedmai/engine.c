@@ -0,0 +1,205 @@
+/*
+ * engine.c
+ *
+ * Codec Engine runtime and engines of the host stand-in.  Every engine
+ * name opens successfully and reports the algorithms of FAKEDMAI_ALGS.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/ce/CERuntime.h>
+#include <ti/sdo/ce/Engine.h>
+
+#include "fakedmai.h"
+
+#define DEFAULT_ALGS \
+    "h264dec:ti.sdo.ce.video2.IVIDDEC2," \
+    "mpeg4dec:ti.sdo.ce.video2.IVIDDEC2," \
+    "mpeg2dec:ti.sdo.ce.video2.IVIDDEC2," \
+    "h264enc:ti.sdo.ce.video1.IVIDENC1," \
+    "mpeg4enc:ti.sdo.ce.video1.IVIDENC1," \
+    "aachedec:ti.sdo.ce.audio1.IAUDDEC1," \
+    "aacheenc:ti.sdo.ce.audio1.IAUDENC1," \
+    "jpegdec:ti.sdo.ce.image1.IIMGDEC1," \
+    "jpegenc:ti.sdo.ce.image1.IIMGENC1"
+
+#define MAX_ALGS    32
+
+typedef struct engine_alg {
+    String  name;
+    String  typeTab[2];
+} engine_alg;
+
+typedef struct Engine_Obj {
+    String          name;
+    Engine_Error    lastError;
+} Engine_Obj;
+
+typedef struct Server_Obj {
+    Engine_Handle   hEngine;
+} Server_Obj;
+
+static engine_alg      algs[MAX_ALGS];
+static Int             numAlgs;
+static pthread_once_t  algsOnce = PTHREAD_ONCE_INIT;
+
+Engine_Attrs Engine_ATTRS = { NULL };
+
+/******************************************************************************
+ * engine_algs_init
+ ******************************************************************************/
+static void engine_algs_init(void)
+{
+    const char *env = getenv("FAKEDMAI_ALGS");
+    char       *copy = strdup(env ? env : DEFAULT_ALGS);
+    char       *tok, *save = NULL;
+
+    for (tok = strtok_r(copy, ",", &save); tok && numAlgs < MAX_ALGS;
+         tok = strtok_r(NULL, ",", &save)) {
+        char *colon = strchr(tok, ':');
+
+        if (!colon) {
+            fprintf(stderr, "fakedmai: ignoring algorithm '%s'\n", tok);
+            continue;
+        }
+        *colon = '\0';
+        algs[numAlgs].name = strdup(tok);
+        algs[numAlgs].typeTab[0] = strdup(colon + 1);
+        algs[numAlgs].typeTab[1] = NULL;
+        numAlgs++;
+    }
+    free(copy);
+}
+
+/******************************************************************************
+ * CERuntime_init / CERuntime_exit
+ ******************************************************************************/
+Void CERuntime_init(Void)
+{
+    pthread_once(&algsOnce, engine_algs_init);
+}
+
+Void CERuntime_exit(Void)
+{
+}
+
+/******************************************************************************
+ * Engine_open
+ ******************************************************************************/
+Engine_Handle Engine_open(String name, Engine_Attrs *attrs, Engine_Error *ec)
+{
+    Engine_Handle hEngine;
+
+    fakedmai_delay("Engine_open");
+
+    if (!name) {
+        if (ec) {
+            *ec = Engine_EEXIST;
+        }
+        return NULL;
+    }
+
+    hEngine = calloc(1, sizeof(*hEngine));
+    hEngine->name = strdup(name);
+    if (ec) {
+        *ec = Engine_EOK;
+    }
+
+    FAKEDMAI_DEBUG("opened engine %s\n", name);
+    return hEngine;
+}
+
+/******************************************************************************
+ * Engine_close
+ ******************************************************************************/
+Void Engine_close(Engine_Handle hEngine)
+{
+    if (!hEngine) {
+        return;
+    }
+
+    free(hEngine->name);
+    free(hEngine);
+}
+
+/******************************************************************************
+ * Engine_getNumAlgs
+ ******************************************************************************/
+Engine_Error Engine_getNumAlgs(String name, Int *num)
+{
+    pthread_once(&algsOnce, engine_algs_init);
+    fakedmai_delay("Engine_getNumAlgs");
+
+    *num = numAlgs;
+    return Engine_EOK;
+}
+
+/******************************************************************************
+ * Engine_getAlgInfo
+ ******************************************************************************/
+Engine_Error Engine_getAlgInfo(String name, Engine_AlgInfo *algInfo,
+                 Int index)
+{
+    pthread_once(&algsOnce, engine_algs_init);
+    fakedmai_delay("Engine_getAlgInfo");
+
+    if (index < 0 || index >= numAlgs) {
+        return Engine_ENOTFOUND;
+    }
+
+    algInfo->name = algs[index].name;
+    algInfo->typeTab = algs[index].typeTab;
+    algInfo->isLocal = FALSE;
+    return Engine_EOK;
+}
+
+/******************************************************************************
+ * Engine_getServer
+ ******************************************************************************/
+Server_Handle Engine_getServer(Engine_Handle hEngine)
+{
+    static Server_Obj server;
+
+    server.hEngine = hEngine;
+    return &server;
+}
+
+/******************************************************************************
+ * Engine_getCpuLoad
+ *    There is no DSP, report it idle.
+ ******************************************************************************/
+Int Engine_getCpuLoad(Engine_Handle hEngine)
+{
+    return 0;
+}
+
+/******************************************************************************
+ * Engine_getLastError
+ ******************************************************************************/
+Engine_Error Engine_getLastError(Engine_Handle hEngine)
+{
+    return hEngine ? hEngine->lastError : Engine_EINVAL;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
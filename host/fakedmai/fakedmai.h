@@ -0,0 +1,85 @@
+/*
+ * fakedmai.h
+ *
+ * Private definitions shared by the host stand-in of DMAI and Codec Engine.
+ *
+ * Environment variables:
+ *   FAKEDMAI_CMEM_SIZE  bytes of the contiguous arena (default 64 MB)
+ *   FAKEDMAI_LATENCY    per call latencies in us, "Vdec2_process=8000,..."
+ *   FAKEDMAI_SPIN       busy-wait the latencies instead of sleeping
+ *   FAKEDMAI_DEVICE     device reported by Cpu_getDevice (dm6467, dm365,
+ *                       omap3530, omapl138, default dm6467)
+ *   FAKEDMAI_ALGS       algorithms of every engine, "name:type,..."
+ *                       (default: the usual video/audio/image codecs)
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef __FAKEDMAI_H__
+#define __FAKEDMAI_H__
+
+#include <stdio.h>
+#include <xdc/std.h>
+
+/* Contiguous arena statistics, see Memory_contigAlloc */
+typedef struct fakedmai_mem_stats {
+    unsigned long   allocs;
+    unsigned long   frees;
+    unsigned long   failures;
+    unsigned long   bytes;
+    unsigned long   peak;
+    unsigned long   size;
+    unsigned long   registered;
+} fakedmai_mem_stats;
+
+/* Latency of an API call, as configured through FAKEDMAI_LATENCY */
+extern unsigned long fakedmai_latency(const char *call);
+
+/* Wait the configured latency of an API call */
+extern void fakedmai_delay(const char *call);
+
+/* Monotonic time in us */
+extern unsigned long long fakedmai_now(void);
+
+/* Contiguous arena statistics */
+extern void fakedmai_mem_get_stats(fakedmai_mem_stats *stats);
+extern void fakedmai_mem_reset_peak(void);
+
+/* Number of bytes moved by Framecopy and Resize */
+extern unsigned long long fakedmai_copy_bytes(void);
+extern void fakedmai_add_copy_bytes(unsigned long bytes);
+
+/* Frames scanned out by a display and the vsyncs that repeated a frame */
+struct Display_Object;
+extern void fakedmai_display_stats(struct Display_Object *hDisplay,
+                unsigned long *shown, unsigned long *repeated);
+
+/* Trace the calls to stderr when FAKEDMAI_DEBUG is set */
+extern int fakedmai_debug;
+
+#define FAKEDMAI_DEBUG(...) do {                                       \
+    if (fakedmai_debug) {                                              \
+        fprintf(stderr, "fakedmai: " __VA_ARGS__);                     \
+    }                                                                  \
+} while (0)
+
+#endif /* __FAKEDMAI_H__ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
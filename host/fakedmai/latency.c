@@ -0,0 +1,138 @@
+/*
+ * latency.c
+ *
+ * Latency model of the host stand-in: every DMAI/CE call that would wait
+ * for a coprocessor or a driver on the target waits the time configured
+ * in FAKEDMAI_LATENCY instead.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "fakedmai.h"
+
+#define MAX_LATENCIES   64
+
+typedef struct latency_entry {
+    char            call[48];
+    unsigned long   us;
+} latency_entry;
+
+static latency_entry   latencies[MAX_LATENCIES];
+static int             numLatencies;
+static int             spin;
+static pthread_once_t  latencyOnce = PTHREAD_ONCE_INIT;
+
+int fakedmai_debug;
+
+/******************************************************************************
+ * latency_init
+ *    Parse FAKEDMAI_LATENCY, a comma separated list of call=us pairs.
+ ******************************************************************************/
+static void latency_init(void)
+{
+    const char *env = getenv("FAKEDMAI_LATENCY");
+    char       *copy, *tok, *save = NULL;
+
+    spin = getenv("FAKEDMAI_SPIN") != NULL;
+    fakedmai_debug = getenv("FAKEDMAI_DEBUG") != NULL;
+
+    if (!env) {
+        return;
+    }
+
+    copy = strdup(env);
+    for (tok = strtok_r(copy, ",", &save); tok && numLatencies < MAX_LATENCIES;
+         tok = strtok_r(NULL, ",", &save)) {
+        char *eq = strchr(tok, '=');
+
+        if (!eq || eq == tok || (size_t)(eq - tok) >=
+            sizeof(latencies[0].call)) {
+            fprintf(stderr, "fakedmai: ignoring latency '%s'\n", tok);
+            continue;
+        }
+        memcpy(latencies[numLatencies].call, tok, eq - tok);
+        latencies[numLatencies].call[eq - tok] = '\0';
+        latencies[numLatencies].us = strtoul(eq + 1, NULL, 10);
+        numLatencies++;
+    }
+    free(copy);
+}
+
+/******************************************************************************
+ * fakedmai_now
+ ******************************************************************************/
+unsigned long long fakedmai_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (unsigned long long)ts.tv_sec * 1000000ULL + ts.tv_nsec / 1000;
+}
+
+/******************************************************************************
+ * fakedmai_latency
+ ******************************************************************************/
+unsigned long fakedmai_latency(const char *call)
+{
+    int i;
+
+    pthread_once(&latencyOnce, latency_init);
+
+    for (i = 0; i < numLatencies; i++) {
+        if (!strcmp(latencies[i].call, call)) {
+            return latencies[i].us;
+        }
+    }
+    return 0;
+}
+
+/******************************************************************************
+ * fakedmai_delay
+ *    Sleeping lets the other threads of the pipeline run like they would
+ *    while the DSP or the driver works; spinning charges the time to the
+ *    caller instead, like an ARM side codec would.
+ ******************************************************************************/
+void fakedmai_delay(const char *call)
+{
+    unsigned long      us = fakedmai_latency(call);
+    unsigned long long end;
+    struct timespec    ts;
+
+    if (!us) {
+        return;
+    }
+
+    if (spin) {
+        end = fakedmai_now() + us;
+        while (fakedmai_now() < end);
+        return;
+    }
+
+    ts.tv_sec = us / 1000000;
+    ts.tv_nsec = (us % 1000000) * 1000;
+    while (nanosleep(&ts, &ts) != 0);
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,336 @@
+/*
+ * memory.c
+ *
+ * Contiguous memory of the host stand-in.  CMEM hands out physically
+ * contiguous blocks from a fixed pool on the target; here they come
+ * first-fit from one arena of FAKEDMAI_CMEM_SIZE bytes mapped at a fake
+ * physical base, so pool exhaustion and fragmentation show up on the host
+ * too.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <ti/sdo/ce/osal/Memory.h>
+
+#include "fakedmai.h"
+
+#define ARENA_DEFAULT_SIZE  (64 * 1024 * 1024)
+#define ARENA_PHYS_BASE     0x80000000UL
+#define ARENA_ALIGN         4096
+
+typedef struct mem_block {
+    unsigned long       offset;
+    unsigned long       size;
+    struct mem_block   *next;
+} mem_block;
+
+typedef struct mem_range {
+    unsigned long       virt;
+    unsigned long       size;
+    unsigned long       phys;
+    struct mem_range   *next;
+} mem_range;
+
+static pthread_mutex_t     memMutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t      memOnce = PTHREAD_ONCE_INIT;
+static char               *arena;
+static unsigned long       arenaSize;
+static mem_block          *blocks;
+static mem_range          *ranges;
+static fakedmai_mem_stats  stats;
+
+Memory_AllocParams Memory_DEFAULTPARAMS = {
+    Memory_CONTIGPOOL,
+    Memory_NONCACHED,
+    Memory_DEFAULTALIGNMENT,
+    0
+};
+
+/******************************************************************************
+ * mem_init
+ ******************************************************************************/
+static void mem_init(void)
+{
+    const char *env = getenv("FAKEDMAI_CMEM_SIZE");
+
+    arenaSize = env ? strtoul(env, NULL, 0) : ARENA_DEFAULT_SIZE;
+    arenaSize = (arenaSize + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1UL);
+    if (posix_memalign((void **)&arena, ARENA_ALIGN, arenaSize) != 0) {
+        fprintf(stderr, "fakedmai: failed to map %lu bytes of CMEM\n",
+            arenaSize);
+        arena = NULL;
+        arenaSize = 0;
+    }
+    stats.size = arenaSize;
+}
+
+/******************************************************************************
+ * mem_in_arena
+ ******************************************************************************/
+static int mem_in_arena(unsigned long virt, unsigned long size)
+{
+    return arena && virt >= (unsigned long)arena &&
+           virt + size <= (unsigned long)arena + arenaSize;
+}
+
+/******************************************************************************
+ * Memory_contigAlloc
+ ******************************************************************************/
+Ptr Memory_contigAlloc(UInt size, UInt align)
+{
+    mem_block     **link, *blk;
+    unsigned long   offset = 0;
+
+    pthread_once(&memOnce, mem_init);
+
+    if (align == 0 || align == Memory_DEFAULTALIGNMENT || align < 8) {
+        align = 8;
+    }
+
+    pthread_mutex_lock(&memMutex);
+
+    /* The block list is kept sorted on the offset, take the first hole */
+    for (link = &blocks; ; link = &(*link)->next) {
+        unsigned long end = *link ? (*link)->offset : arenaSize;
+
+        offset = (offset + align - 1) & ~((unsigned long)align - 1);
+        if (offset + size <= end) {
+            break;
+        }
+        if (!*link) {
+            stats.failures++;
+            pthread_mutex_unlock(&memMutex);
+            FAKEDMAI_DEBUG("contigAlloc of %u bytes failed\n", size);
+            return NULL;
+        }
+        offset = (*link)->offset + (*link)->size;
+    }
+
+    blk = malloc(sizeof(*blk));
+    blk->offset = offset;
+    blk->size = size;
+    blk->next = *link;
+    *link = blk;
+
+    stats.allocs++;
+    stats.bytes += size;
+    if (stats.bytes > stats.peak) {
+        stats.peak = stats.bytes;
+    }
+    pthread_mutex_unlock(&memMutex);
+
+    return arena + offset;
+}
+
+/******************************************************************************
+ * Memory_contigFree
+ ******************************************************************************/
+Bool Memory_contigFree(Ptr addr, UInt size)
+{
+    mem_block     **link, *blk;
+    unsigned long   offset;
+
+    if (!addr || !mem_in_arena((unsigned long)addr, 0)) {
+        return FALSE;
+    }
+    offset = (char *)addr - arena;
+
+    pthread_mutex_lock(&memMutex);
+    for (link = &blocks; *link; link = &(*link)->next) {
+        if ((*link)->offset == offset) {
+            blk = *link;
+            if (blk->size != size) {
+                fprintf(stderr, "fakedmai: contigFree of %p with size %u, "
+                    "allocated with %lu\n", addr, size, blk->size);
+            }
+            *link = blk->next;
+            stats.frees++;
+            stats.bytes -= blk->size;
+            pthread_mutex_unlock(&memMutex);
+            free(blk);
+            return TRUE;
+        }
+    }
+    pthread_mutex_unlock(&memMutex);
+
+    fprintf(stderr, "fakedmai: contigFree of unknown block %p\n", addr);
+    return FALSE;
+}
+
+/******************************************************************************
+ * Memory_alloc
+ ******************************************************************************/
+Ptr Memory_alloc(UInt size, Memory_AllocParams *params)
+{
+    if (!params) {
+        params = &Memory_DEFAULTPARAMS;
+    }
+
+    if (params->type == Memory_MALLOC) {
+        return malloc(size);
+    }
+    return Memory_contigAlloc(size, params->align);
+}
+
+/******************************************************************************
+ * Memory_free
+ ******************************************************************************/
+Bool Memory_free(Ptr addr, UInt size, Memory_AllocParams *params)
+{
+    if (!params) {
+        params = &Memory_DEFAULTPARAMS;
+    }
+
+    if (params->type == Memory_MALLOC) {
+        free(addr);
+        return TRUE;
+    }
+    return Memory_contigFree(addr, size);
+}
+
+/******************************************************************************
+ * Memory_getBufferPhysicalAddress
+ *    Memory from the arena and registered ranges are contiguous, anything
+ *    else is plain user memory and has no physical address.
+ ******************************************************************************/
+UInt32 Memory_getBufferPhysicalAddress(Ptr virtualAddress, Int sizeInBytes,
+           Bool *isContiguous)
+{
+    unsigned long  virt = (unsigned long)virtualAddress;
+    unsigned long  phys = 0;
+    mem_range     *r;
+
+    pthread_once(&memOnce, mem_init);
+
+    if (mem_in_arena(virt, sizeInBytes)) {
+        phys = ARENA_PHYS_BASE + (virt - (unsigned long)arena);
+    }
+    else {
+        pthread_mutex_lock(&memMutex);
+        for (r = ranges; r; r = r->next) {
+            if (virt >= r->virt && virt + sizeInBytes <= r->virt + r->size) {
+                phys = r->phys + (virt - r->virt);
+                break;
+            }
+        }
+        pthread_mutex_unlock(&memMutex);
+    }
+
+    if (isContiguous) {
+        *isContiguous = phys != 0;
+    }
+    return phys;
+}
+
+/******************************************************************************
+ * Memory_registerContigBuf
+ ******************************************************************************/
+Bool Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+         UInt32 physicalAddress)
+{
+    mem_range *r = malloc(sizeof(*r));
+
+    r->virt = virtualAddress;
+    r->size = sizeInBytes;
+    r->phys = physicalAddress;
+
+    fakedmai_delay("Memory_registerContigBuf");
+
+    pthread_mutex_lock(&memMutex);
+    r->next = ranges;
+    ranges = r;
+    stats.registered++;
+    pthread_mutex_unlock(&memMutex);
+
+    return TRUE;
+}
+
+/******************************************************************************
+ * Memory_unregisterContigBuf
+ ******************************************************************************/
+Bool Memory_unregisterContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes)
+{
+    mem_range **link, *r;
+
+    fakedmai_delay("Memory_unregisterContigBuf");
+
+    pthread_mutex_lock(&memMutex);
+    for (link = &ranges; *link; link = &(*link)->next) {
+        if ((*link)->virt == virtualAddress &&
+            (*link)->size == sizeInBytes) {
+            r = *link;
+            *link = r->next;
+            stats.registered--;
+            pthread_mutex_unlock(&memMutex);
+            free(r);
+            return TRUE;
+        }
+    }
+    pthread_mutex_unlock(&memMutex);
+
+    return FALSE;
+}
+
+/******************************************************************************
+ * Memory_cacheInv / Memory_cacheWb / Memory_cacheWbInv
+ *    The host caches are coherent, only the cost is modelled.
+ ******************************************************************************/
+Void Memory_cacheInv(Ptr addr, Int sizeInBytes)
+{
+    fakedmai_delay("Memory_cacheInv");
+}
+
+Void Memory_cacheWb(Ptr addr, Int sizeInBytes)
+{
+    fakedmai_delay("Memory_cacheWb");
+}
+
+Void Memory_cacheWbInv(Ptr addr, Int sizeInBytes)
+{
+    fakedmai_delay("Memory_cacheWbInv");
+}
+
+/******************************************************************************
+ * fakedmai_mem_get_stats
+ ******************************************************************************/
+void fakedmai_mem_get_stats(fakedmai_mem_stats *s)
+{
+    pthread_once(&memOnce, mem_init);
+
+    pthread_mutex_lock(&memMutex);
+    *s = stats;
+    pthread_mutex_unlock(&memMutex);
+}
+
+/******************************************************************************
+ * fakedmai_mem_reset_peak
+ ******************************************************************************/
+void fakedmai_mem_reset_peak(void)
+{
+    pthread_mutex_lock(&memMutex);
+    stats.peak = stats.bytes;
+    pthread_mutex_unlock(&memMutex);
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,564 @@
+/*
+ * video.c
+ *
+ * Display, frame copy and resizer of the host stand-in.  The copies and
+ * the scaling really move the pixels, so their cost on the host CPU is
+ * part of what the benchmark measures.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+#include <ti/sdo/dmai/BufTab.h>
+#include <ti/sdo/dmai/Display.h>
+#include <ti/sdo/dmai/Framecopy.h>
+#include <ti/sdo/dmai/Resize.h>
+#include <ti/sdo/dmai/priv/_Buffer.h>
+
+#include "fakedmai.h"
+
+static volatile unsigned long long copyBytes;
+
+/******************************************************************************
+ * fakedmai_copy_bytes / fakedmai_add_copy_bytes
+ ******************************************************************************/
+unsigned long long fakedmai_copy_bytes(void)
+{
+    return __sync_fetch_and_add(&copyBytes, 0);
+}
+
+void fakedmai_add_copy_bytes(unsigned long bytes)
+{
+    __sync_fetch_and_add(&copyBytes, bytes);
+}
+
+/******************************************************************************
+ * plane_layout
+ *    Returns the number of planes of a frame, with the byte offset of the
+ *    chroma plane and its vertical subsampling.
+ ******************************************************************************/
+static Int plane_layout(Buffer_Handle hBuf, Int32 *chromaOffset,
+               Int *vSub)
+{
+    switch (BufferGfx_getColorSpace(hBuf)) {
+        case ColorSpace_YUV420PSEMI:
+            *chromaOffset = Buffer_getSize(hBuf) * 2 / 3;
+            *vSub = 2;
+            return 2;
+        case ColorSpace_YUV422PSEMI:
+            *chromaOffset = Buffer_getSize(hBuf) / 2;
+            *vSub = 1;
+            return 2;
+        default:
+            *chromaOffset = 0;
+            *vSub = 1;
+            return 1;
+    }
+}
+
+/******************************************************************************
+ * Display
+ ******************************************************************************/
+typedef struct Display_Object {
+    Display_Attrs       attrs;
+    BufTab_Handle       hBufTab;
+    Bool                ownBufTab;
+    pthread_t           thread;
+    pthread_mutex_t     mutex;
+    pthread_cond_t      cond;
+    Bool                quit;
+    Buffer_Handle      *queued;
+    Int                 numQueued;
+    Buffer_Handle      *done;
+    Int                 numDone;
+    Buffer_Handle       showing;
+    unsigned long       shown;
+    unsigned long       repeated;
+} Display_Object;
+
+const Display_Attrs Display_Attrs_DM6467_VID_DEFAULT = {
+    3, Display_Std_V4L2, VideoStd_1080I_30, Display_Output_COMPONENT,
+    "/dev/video2", 0, ColorSpace_YUV422PSEMI, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_DM365_VID_DEFAULT = {
+    3, Display_Std_V4L2, VideoStd_D1_NTSC, Display_Output_COMPOSITE,
+    "/dev/video2", 0, ColorSpace_UYVY, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_O3530_VID_DEFAULT = {
+    3, Display_Std_V4L2, VideoStd_VGA, Display_Output_LCD,
+    "/dev/video1", 0, ColorSpace_UYVY, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_OMAPL138_VID_DEFAULT = {
+    3, Display_Std_V4L2, VideoStd_D1_NTSC, Display_Output_COMPOSITE,
+    "/dev/video2", 0, ColorSpace_UYVY, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_DM6446_DM355_VID_DEFAULT = {
+    3, Display_Std_V4L2, VideoStd_D1_NTSC, Display_Output_COMPOSITE,
+    "/dev/video2", 0, ColorSpace_UYVY, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_DM6446_DM355_OSD_DEFAULT = {
+    1, Display_Std_FBDEV, VideoStd_D1_NTSC, Display_Output_COMPOSITE,
+    "/dev/fb0", 0, ColorSpace_RGB565, -1, -1, 0, 0
+};
+
+const Display_Attrs Display_Attrs_O3530_OSD_DEFAULT = {
+    1, Display_Std_FBDEV, VideoStd_VGA, Display_Output_LCD,
+    "/dev/fb0", 0, ColorSpace_RGB565, -1, -1, 0, 0
+};
+
+/******************************************************************************
+ * display_vsync
+ *    Scans out the next queued buffer at every vsync and hands the previous
+ *    one back to Display_get.  With nothing queued the frame is repeated.
+ ******************************************************************************/
+static void *display_vsync(void *arg)
+{
+    Display_Handle  hDisplay = arg;
+    long            period = 1000000000L /
+                        VideoStd_getRefreshRate(hDisplay->attrs.videoStd);
+    struct timespec next;
+
+    clock_gettime(CLOCK_MONOTONIC, &next);
+
+    pthread_mutex_lock(&hDisplay->mutex);
+    while (!hDisplay->quit) {
+        next.tv_nsec += period;
+        while (next.tv_nsec >= 1000000000L) {
+            next.tv_nsec -= 1000000000L;
+            next.tv_sec++;
+        }
+        pthread_mutex_unlock(&hDisplay->mutex);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &next,
+                   NULL) == EINTR);
+        pthread_mutex_lock(&hDisplay->mutex);
+
+        if (hDisplay->numQueued == 0) {
+            hDisplay->repeated++;
+            continue;
+        }
+
+        if (hDisplay->showing) {
+            hDisplay->done[hDisplay->numDone++] = hDisplay->showing;
+            pthread_cond_broadcast(&hDisplay->cond);
+        }
+        hDisplay->showing = hDisplay->queued[0];
+        memmove(hDisplay->queued, hDisplay->queued + 1,
+            --hDisplay->numQueued * sizeof(Buffer_Handle));
+        hDisplay->shown++;
+    }
+    pthread_mutex_unlock(&hDisplay->mutex);
+
+    return NULL;
+}
+
+/******************************************************************************
+ * Display_create
+ ******************************************************************************/
+Display_Handle Display_create(BufTab_Handle hBufTab, Display_Attrs *attrs)
+{
+    Display_Handle  hDisplay = calloc(1, sizeof(*hDisplay));
+    BufferGfx_Attrs gfxAttrs = BufferGfx_Attrs_DEFAULT;
+    Int32           width, height;
+    Int             i;
+
+    hDisplay->attrs = *attrs;
+
+    if (!hBufTab) {
+        if (VideoStd_getResolution(attrs->videoStd, &width, &height) < 0) {
+            width = 720;
+            height = 480;
+        }
+        if (attrs->width > 0 && attrs->height > 0) {
+            width = attrs->width;
+            height = attrs->height;
+        }
+
+        gfxAttrs.colorSpace = attrs->colorSpace;
+        gfxAttrs.dim.width = width;
+        gfxAttrs.dim.height = height;
+        gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(width,
+                                      attrs->colorSpace);
+        hBufTab = BufTab_create(attrs->numBufs,
+                      BufferGfx_calcFrameSize(width, height,
+                          attrs->colorSpace),
+                      BufferGfx_getBufferAttrs(&gfxAttrs));
+        if (!hBufTab) {
+            free(hDisplay);
+            return NULL;
+        }
+        hDisplay->ownBufTab = TRUE;
+    }
+    hDisplay->hBufTab = hBufTab;
+
+    /* Like the V4L2 driver, all the buffers start out queued */
+    hDisplay->queued = calloc(BufTab_getNumBufs(hBufTab),
+                           sizeof(Buffer_Handle));
+    hDisplay->done = calloc(BufTab_getNumBufs(hBufTab),
+                         sizeof(Buffer_Handle));
+    for (i = 0; i < BufTab_getNumBufs(hBufTab); i++) {
+        hDisplay->queued[hDisplay->numQueued++] = BufTab_getBuf(hBufTab, i);
+    }
+
+    pthread_mutex_init(&hDisplay->mutex, NULL);
+    pthread_cond_init(&hDisplay->cond, NULL);
+    if (pthread_create(&hDisplay->thread, NULL, display_vsync,
+            hDisplay) != 0) {
+        Display_delete(hDisplay);
+        return NULL;
+    }
+
+    return hDisplay;
+}
+
+/******************************************************************************
+ * Display_delete
+ ******************************************************************************/
+Int Display_delete(Display_Handle hDisplay)
+{
+    if (!hDisplay) {
+        return Dmai_EOK;
+    }
+
+    if (hDisplay->thread) {
+        pthread_mutex_lock(&hDisplay->mutex);
+        hDisplay->quit = TRUE;
+        pthread_cond_broadcast(&hDisplay->cond);
+        pthread_mutex_unlock(&hDisplay->mutex);
+        pthread_join(hDisplay->thread, NULL);
+    }
+
+    if (hDisplay->ownBufTab) {
+        BufTab_delete(hDisplay->hBufTab);
+    }
+    pthread_cond_destroy(&hDisplay->cond);
+    pthread_mutex_destroy(&hDisplay->mutex);
+    free(hDisplay->queued);
+    free(hDisplay->done);
+    free(hDisplay);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Display_get
+ *    Blocks until a buffer has been scanned out and replaced.
+ ******************************************************************************/
+Int Display_get(Display_Handle hDisplay, Buffer_Handle *hBufPtr)
+{
+    pthread_mutex_lock(&hDisplay->mutex);
+    while (hDisplay->numDone == 0 && !hDisplay->quit) {
+        pthread_cond_wait(&hDisplay->cond, &hDisplay->mutex);
+    }
+
+    if (hDisplay->numDone == 0) {
+        pthread_mutex_unlock(&hDisplay->mutex);
+        *hBufPtr = NULL;
+        return Dmai_EIO;
+    }
+
+    *hBufPtr = hDisplay->done[0];
+    memmove(hDisplay->done, hDisplay->done + 1,
+        --hDisplay->numDone * sizeof(Buffer_Handle));
+    pthread_mutex_unlock(&hDisplay->mutex);
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Display_put
+ ******************************************************************************/
+Int Display_put(Display_Handle hDisplay, Buffer_Handle hBuf)
+{
+    Int ret = Dmai_EOK;
+
+    fakedmai_delay("Display_put");
+
+    pthread_mutex_lock(&hDisplay->mutex);
+    if (Buffer_getBufTab(hBuf) != hDisplay->hBufTab ||
+        hDisplay->numQueued >= BufTab_getNumBufs(hDisplay->hBufTab)) {
+        ret = Dmai_EINVAL;
+    }
+    else {
+        hDisplay->queued[hDisplay->numQueued++] = hBuf;
+    }
+    pthread_mutex_unlock(&hDisplay->mutex);
+
+    return ret;
+}
+
+/******************************************************************************
+ * Display_getBufTab / Display_getHandle
+ ******************************************************************************/
+BufTab_Handle Display_getBufTab(Display_Handle hDisplay)
+{
+    return hDisplay->hBufTab;
+}
+
+Int Display_getHandle(Display_Handle hDisplay)
+{
+    return -1;
+}
+
+/******************************************************************************
+ * fakedmai_display_stats
+ ******************************************************************************/
+void fakedmai_display_stats(Display_Handle hDisplay, unsigned long *shown,
+         unsigned long *repeated)
+{
+    pthread_mutex_lock(&hDisplay->mutex);
+    *shown = hDisplay->shown;
+    *repeated = hDisplay->repeated;
+    pthread_mutex_unlock(&hDisplay->mutex);
+}
+
+/******************************************************************************
+ * Framecopy
+ ******************************************************************************/
+typedef struct Framecopy_Object {
+    Framecopy_Attrs attrs;
+    Bool            configured;
+} Framecopy_Object;
+
+const Framecopy_Attrs Framecopy_Attrs_DEFAULT = { FALSE, FALSE };
+
+Framecopy_Handle Framecopy_create(Framecopy_Attrs *attrs)
+{
+    Framecopy_Handle hFc = calloc(1, sizeof(*hFc));
+
+    hFc->attrs = attrs ? *attrs : Framecopy_Attrs_DEFAULT;
+    return hFc;
+}
+
+Int Framecopy_delete(Framecopy_Handle hFc)
+{
+    free(hFc);
+    return Dmai_EOK;
+}
+
+Int Framecopy_config(Framecopy_Handle hFc, Buffer_Handle hSrcBuf,
+        Buffer_Handle hDstBuf)
+{
+    if (Buffer_getType(hSrcBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hDstBuf) != Buffer_Type_GRAPHICS ||
+        BufferGfx_getColorSpace(hSrcBuf) != BufferGfx_getColorSpace(hDstBuf)) {
+        return Dmai_EINVAL;
+    }
+
+    hFc->configured = TRUE;
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Framecopy_execute
+ *    Copies the overlapping part of the source and destination windows,
+ *    line by line.
+ ******************************************************************************/
+Int Framecopy_execute(Framecopy_Handle hFc, Buffer_Handle hSrcBuf,
+        Buffer_Handle hDstBuf)
+{
+    BufferGfx_Dimensions sDim, dDim;
+    ColorSpace_Type      cs = BufferGfx_getColorSpace(hSrcBuf);
+    Int32                sChroma, dChroma, bytes, lines, y;
+    Int                  planes, vSub, p;
+    unsigned long        total = 0;
+
+    if (!hFc->configured) {
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &sDim);
+    BufferGfx_getDimensions(hDstBuf, &dDim);
+    planes = plane_layout(hSrcBuf, &sChroma, &vSub);
+    plane_layout(hDstBuf, &dChroma, &vSub);
+
+    bytes = BufferGfx_calcLineLength(sDim.width < dDim.width ?
+                sDim.width : dDim.width, cs);
+    lines = sDim.height < dDim.height ? sDim.height : dDim.height;
+
+    for (p = 0; p < planes; p++) {
+        Int    sub = p ? vSub : 1;
+        Int8  *src = Buffer_getUserPtr(hSrcBuf) + (p ? sChroma : 0) +
+                     (sDim.y / sub) * sDim.lineLength +
+                     BufferGfx_calcLineLength(sDim.x, cs);
+        Int8  *dst = Buffer_getUserPtr(hDstBuf) + (p ? dChroma : 0) +
+                     (dDim.y / sub) * dDim.lineLength +
+                     BufferGfx_calcLineLength(dDim.x, cs);
+
+        for (y = 0; y < lines / sub; y++) {
+            memcpy(dst, src, bytes);
+            src += sDim.lineLength;
+            dst += dDim.lineLength;
+        }
+        total += (unsigned long)bytes * (lines / sub);
+    }
+
+    fakedmai_add_copy_bytes(total);
+    fakedmai_delay("Framecopy_execute");
+    Buffer_setNumBytesUsed(hDstBuf, Buffer_getSize(hDstBuf));
+
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * Resize
+ ******************************************************************************/
+typedef struct Resize_Object {
+    Resize_Attrs    attrs;
+    Bool            configured;
+} Resize_Object;
+
+const Resize_Attrs Resize_Attrs_DEFAULT = {
+    Resize_WindowType_BLACKMAN,
+    Resize_WindowType_BLACKMAN,
+    Resize_FilterType_LOWPASS,
+    Resize_FilterType_LOWPASS,
+    0
+};
+
+Resize_Handle Resize_create(Resize_Attrs *attrs)
+{
+    Resize_Handle hResize = calloc(1, sizeof(*hResize));
+
+    hResize->attrs = attrs ? *attrs : Resize_Attrs_DEFAULT;
+    return hResize;
+}
+
+Int Resize_delete(Resize_Handle hResize)
+{
+    free(hResize);
+    return Dmai_EOK;
+}
+
+Int Resize_config(Resize_Handle hResize, Buffer_Handle hSrcBuf,
+        Buffer_Handle hDstBuf)
+{
+    ColorSpace_Type cs = BufferGfx_getColorSpace(hSrcBuf);
+
+    if (Buffer_getType(hSrcBuf) != Buffer_Type_GRAPHICS ||
+        Buffer_getType(hDstBuf) != Buffer_Type_GRAPHICS ||
+        cs != BufferGfx_getColorSpace(hDstBuf) ||
+        cs == ColorSpace_YUV420P || cs == ColorSpace_YUV422P ||
+        cs == ColorSpace_YUV444P || cs == ColorSpace_2BIT) {
+        return Dmai_EINVAL;
+    }
+
+    hResize->configured = TRUE;
+    return Dmai_EOK;
+}
+
+/******************************************************************************
+ * scale_plane
+ *    Nearest neighbour scaling of a plane of units of unitBytes bytes.
+ ******************************************************************************/
+static unsigned long scale_plane(const Int8 *src, Int32 sPitch, Int32 sw,
+                         Int32 sh, Int8 *dst, Int32 dPitch, Int32 dw,
+                         Int32 dh, Int unitBytes)
+{
+    Int32 x, y;
+
+    if (sw <= 0 || sh <= 0 || dw <= 0 || dh <= 0) {
+        return 0;
+    }
+
+    for (y = 0; y < dh; y++) {
+        const Int8 *s = src + (Int32)((long long)y * sh / dh) * sPitch;
+        Int8       *d = dst + y * dPitch;
+
+        if (sw == dw) {
+            memcpy(d, s, dw * unitBytes);
+            continue;
+        }
+        for (x = 0; x < dw; x++) {
+            memcpy(d + x * unitBytes,
+                s + (Int32)((long long)x * sw / dw) * unitBytes, unitBytes);
+        }
+    }
+
+    return (unsigned long)dw * dh * unitBytes;
+}
+
+/******************************************************************************
+ * Resize_execute
+ ******************************************************************************/
+Int Resize_execute(Resize_Handle hResize, Buffer_Handle hSrcBuf,
+        Buffer_Handle hDstBuf)
+{
+    BufferGfx_Dimensions sDim, dDim;
+    ColorSpace_Type      cs = BufferGfx_getColorSpace(hSrcBuf);
+    Int32                sChroma, dChroma;
+    Int                  vSub, unit;
+    Int8                *src, *dst;
+    unsigned long        total;
+
+    if (!hResize->configured) {
+        return Dmai_EINVAL;
+    }
+
+    BufferGfx_getDimensions(hSrcBuf, &sDim);
+    BufferGfx_getDimensions(hDstBuf, &dDim);
+    src = Buffer_getUserPtr(hSrcBuf) + sDim.y * sDim.lineLength;
+    dst = Buffer_getUserPtr(hDstBuf) + dDim.y * dDim.lineLength;
+
+    if (plane_layout(hSrcBuf, &sChroma, &vSub) == 2) {
+        plane_layout(hDstBuf, &dChroma, &vSub);
+        total = scale_plane(src + sDim.x, sDim.lineLength, sDim.width,
+                    sDim.height, dst + dDim.x, dDim.lineLength, dDim.width,
+                    dDim.height, 1);
+        src = Buffer_getUserPtr(hSrcBuf) + sChroma +
+              sDim.y / vSub * sDim.lineLength + (sDim.x & ~1);
+        dst = Buffer_getUserPtr(hDstBuf) + dChroma +
+              dDim.y / vSub * dDim.lineLength + (dDim.x & ~1);
+        total += scale_plane(src, sDim.lineLength, sDim.width / 2,
+                     sDim.height / vSub, dst, dDim.lineLength,
+                     dDim.width / 2, dDim.height / vSub, 2);
+    }
+    else if (cs == ColorSpace_UYVY) {
+        /* A macro pixel holds two pixels */
+        total = scale_plane(src + sDim.x / 2 * 4, sDim.lineLength,
+                    sDim.width / 2, sDim.height, dst + dDim.x / 2 * 4,
+                    dDim.lineLength, dDim.width / 2, dDim.height, 4);
+    }
+    else {
+        unit = ColorSpace_getBpp(cs) / 8;
+        total = scale_plane(src + sDim.x * unit, sDim.lineLength, sDim.width,
+                    sDim.height, dst + dDim.x * unit, dDim.lineLength,
+                    dDim.width, dDim.height, unit);
+    }
+
+    fakedmai_add_copy_bytes(total);
+    fakedmai_delay("Resize_execute");
+    Buffer_setNumBytesUsed(hDstBuf, Buffer_getSize(hDstBuf));
+
+    return Dmai_EOK;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
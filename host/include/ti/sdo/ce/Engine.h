@@ -0,0 +1,81 @@
+/*
+ * Engine.h
+ *
+ * Host stand-in for the Codec Engine engine API.  Every engine name opens
+ * and reports the algorithms listed in FAKEDMAI_ALGS, see
+ * host/fakedmai/engine.c.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_Engine_
+#define ti_sdo_ce_Engine_
+
+#include <xdc/std.h>
+
+typedef struct Engine_Obj *Engine_Handle;
+typedef struct Server_Obj *Server_Handle;
+
+typedef enum {
+    Engine_EOK = 0,
+    Engine_EEXIST = 1,
+    Engine_ENOMEM = 2,
+    Engine_EDSPLOAD = 3,
+    Engine_ENOCOMM = 4,
+    Engine_ENOSERVER = 5,
+    Engine_ECOMALLOC = 6,
+    Engine_ERUNTIME = 7,
+    Engine_ECODECCREATE = 8,
+    Engine_ECODECSTART = 9,
+    Engine_EINVAL = 10,
+    Engine_EBADSERVER = 11,
+    Engine_ENOTAVAIL = 12,
+    Engine_EWRONGSTATE = 13,
+    Engine_EINUSE = 14,
+    Engine_ENOTFOUND = 15,
+    Engine_ETIMEOUT = 16
+} Engine_Error;
+
+typedef struct Engine_Attrs {
+    String procId;
+} Engine_Attrs;
+
+typedef struct Engine_AlgInfo {
+    Int     algInfoSize;
+    String  name;
+    String  *typeTab;
+    Bool    isLocal;
+} Engine_AlgInfo;
+
+extern Engine_Attrs Engine_ATTRS;
+
+extern Engine_Handle Engine_open(String name, Engine_Attrs *attrs,
+                         Engine_Error *ec);
+extern Void          Engine_close(Engine_Handle engine);
+extern Engine_Error  Engine_getNumAlgs(String name, Int *numAlgs);
+extern Engine_Error  Engine_getAlgInfo(String name, Engine_AlgInfo *algInfo,
+                         Int index);
+extern Server_Handle Engine_getServer(Engine_Handle engine);
+extern Int           Engine_getCpuLoad(Engine_Handle engine);
+extern Engine_Error  Engine_getLastError(Engine_Handle engine);
+
+#endif /* ti_sdo_ce_Engine_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
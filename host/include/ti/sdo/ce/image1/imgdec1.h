@@ -0,0 +1,44 @@
+/*
+ * imgdec1.h
+ *
+ * Host stand-in for the Codec Engine IMGDEC1 VISA interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_image1_IMGDEC1_
+#define ti_sdo_ce_image1_IMGDEC1_
+
+#include <ti/sdo/ce/Engine.h>
+#include <ti/xdais/dm/iimgdec1.h>
+
+#define IMGDEC1_EOK            XDM_EOK
+#define IMGDEC1_EFAIL          XDM_EFAIL
+#define IMGDEC1_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct IMGDEC1_Obj       *IMGDEC1_Handle;
+typedef XDM_CmdId                IMGDEC1_Cmd;
+typedef IIMGDEC1_Params          IMGDEC1_Params;
+typedef IIMGDEC1_DynamicParams   IMGDEC1_DynamicParams;
+typedef IIMGDEC1_OutArgs         IMGDEC1_OutArgs;
+
+#endif /* ti_sdo_ce_image1_IMGDEC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,44 @@
+/*
+ * imgenc1.h
+ *
+ * Host stand-in for the Codec Engine IMGENC1 VISA interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_image1_IMGENC1_
+#define ti_sdo_ce_image1_IMGENC1_
+
+#include <ti/sdo/ce/Engine.h>
+#include <ti/xdais/dm/iimgenc1.h>
+
+#define IMGENC1_EOK            XDM_EOK
+#define IMGENC1_EFAIL          XDM_EFAIL
+#define IMGENC1_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct IMGENC1_Obj       *IMGENC1_Handle;
+typedef XDM_CmdId                IMGENC1_Cmd;
+typedef IIMGENC1_Params          IMGENC1_Params;
+typedef IIMGENC1_DynamicParams   IMGENC1_DynamicParams;
+typedef IIMGENC1_OutArgs         IMGENC1_OutArgs;
+
+#endif /* ti_sdo_ce_image1_IMGENC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Memory.h
+ *
+ * Host stand-in for the Codec Engine contiguous memory API.  Allocations
+ * come from a CMEM-like arena with fake physical addresses, see
+ * host/fakedmai/memory.c.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_osal_Memory_
+#define ti_sdo_ce_osal_Memory_
+
+#include <xdc/std.h>
+
+typedef enum {
+    Memory_SEG = 0,
+    Memory_MALLOC = 1,
+    Memory_CONTIGPOOL = 2,
+    Memory_CONTIGHEAP = 3
+} Memory_type;
+
+typedef struct Memory_AllocParams {
+    Memory_type type;
+    UInt        flags;
+    UInt        align;
+    UInt        seg;
+} Memory_AllocParams;
+
+#define Memory_CACHED           0x0000
+#define Memory_NONCACHED        0x0001
+#define Memory_DEFAULTALIGNMENT ((UInt)(-1))
+
+extern Memory_AllocParams Memory_DEFAULTPARAMS;
+
+extern Ptr    Memory_alloc(UInt size, Memory_AllocParams *params);
+extern Bool   Memory_free(Ptr addr, UInt size, Memory_AllocParams *params);
+extern Ptr    Memory_contigAlloc(UInt size, UInt align);
+extern Bool   Memory_contigFree(Ptr addr, UInt size);
+extern UInt32 Memory_getBufferPhysicalAddress(Ptr virtualAddress, Int sizeInBytes,
+                  Bool *isContiguous);
+extern Bool   Memory_registerContigBuf(UInt32 virtualAddress, UInt32 sizeInBytes,
+                  UInt32 physicalAddress);
+extern Bool   Memory_unregisterContigBuf(UInt32 virtualAddress,
+                  UInt32 sizeInBytes);
+extern Void   Memory_cacheInv(Ptr addr, Int sizeInBytes);
+extern Void   Memory_cacheWb(Ptr addr, Int sizeInBytes);
+extern Void   Memory_cacheWbInv(Ptr addr, Int sizeInBytes);
+
+#endif /* ti_sdo_ce_osal_Memory_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,49 @@
+/*
+ * videnc1.h
+ *
+ * Host stand-in for the Codec Engine VIDENC1 VISA interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_video1_VIDENC1_
+#define ti_sdo_ce_video1_VIDENC1_
+
+#include <ti/sdo/ce/Engine.h>
+#include <ti/xdais/dm/ividenc1.h>
+
+#define VIDENC1_EOK            XDM_EOK
+#define VIDENC1_EFAIL          XDM_EFAIL
+#define VIDENC1_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct VIDENC1_Obj       *VIDENC1_Handle;
+typedef XDM_CmdId                VIDENC1_Cmd;
+typedef IVIDENC1_Params          VIDENC1_Params;
+typedef IVIDENC1_DynamicParams   VIDENC1_DynamicParams;
+typedef IVIDENC1_OutArgs         VIDENC1_OutArgs;
+typedef IVIDENC1_InArgs          VIDENC1_InArgs;
+typedef IVIDENC1_Status          VIDENC1_Status;
+
+extern Int32 VIDENC1_control(VIDENC1_Handle handle, VIDENC1_Cmd id,
+                 VIDENC1_DynamicParams *params, VIDENC1_Status *status);
+
+#endif /* ti_sdo_ce_video1_VIDENC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
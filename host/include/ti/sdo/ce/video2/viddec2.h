@@ -0,0 +1,49 @@
+/*
+ * viddec2.h
+ *
+ * Host stand-in for the Codec Engine VIDDEC2 VISA interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_ce_video2_VIDDEC2_
+#define ti_sdo_ce_video2_VIDDEC2_
+
+#include <ti/sdo/ce/Engine.h>
+#include <ti/xdais/dm/ividdec2.h>
+
+#define VIDDEC2_EOK            XDM_EOK
+#define VIDDEC2_EFAIL          XDM_EFAIL
+#define VIDDEC2_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct VIDDEC2_Obj       *VIDDEC2_Handle;
+typedef XDM_CmdId                VIDDEC2_Cmd;
+typedef IVIDDEC2_Params          VIDDEC2_Params;
+typedef IVIDDEC2_DynamicParams   VIDDEC2_DynamicParams;
+typedef IVIDDEC2_OutArgs         VIDDEC2_OutArgs;
+typedef IVIDDEC2_InArgs          VIDDEC2_InArgs;
+typedef IVIDDEC2_Status          VIDDEC2_Status;
+
+extern Int32 VIDDEC2_control(VIDDEC2_Handle handle, VIDDEC2_Cmd id,
+                 VIDDEC2_DynamicParams *params, VIDDEC2_Status *status);
+
+#endif /* ti_sdo_ce_video2_VIDDEC2_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,48 @@
+/*
+ * BufTab.h
+ *
+ * Host stand-in for the DMAI buffer table module.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_BufTab_h_
+#define ti_sdo_dmai_BufTab_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Buffer.h>
+
+extern BufTab_Handle BufTab_create(Int numBufs, Int32 size,
+                         Buffer_Attrs *attrs);
+extern Int           BufTab_delete(BufTab_Handle hBufTab);
+extern Int           BufTab_chunk(BufTab_Handle hBufTab, Int numBufs,
+                         Int32 size);
+extern Int           BufTab_expand(BufTab_Handle hBufTab, Int numBufs);
+extern Int           BufTab_collapse(BufTab_Handle hBufTab);
+extern Int           BufTab_getNumBufs(BufTab_Handle hBufTab);
+extern Buffer_Handle BufTab_getBuf(BufTab_Handle hBufTab, Int bufIdx);
+extern Buffer_Handle BufTab_getFreeBuf(BufTab_Handle hBufTab);
+extern Void          BufTab_freeBuf(Buffer_Handle hBuf);
+extern Void          BufTab_freeAll(BufTab_Handle hBufTab);
+extern Void          BufTab_print(BufTab_Handle hBufTab);
+
+#endif /* ti_sdo_dmai_BufTab_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,78 @@
+/*
+ * BufferGfx.h
+ *
+ * Host stand-in for the DMAI graphics buffer module.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_BufferGfx_h_
+#define ti_sdo_dmai_BufferGfx_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/ColorSpace.h>
+#include <ti/sdo/dmai/VideoStd.h>
+
+/* Frame types carried by the graphics buffers */
+#define BufferGfx_FrameType_NOTSET  -1
+
+typedef struct BufferGfx_Dimensions {
+    Int32   x;
+    Int32   y;
+    Int32   width;
+    Int32   height;
+    Int32   lineLength;
+} BufferGfx_Dimensions;
+
+typedef struct BufferGfx_Attrs {
+    Buffer_Attrs            bAttrs;
+    ColorSpace_Type         colorSpace;
+    BufferGfx_Dimensions    dim;
+} BufferGfx_Attrs;
+
+extern const BufferGfx_Attrs BufferGfx_Attrs_DEFAULT;
+
+#define BufferGfx_getBufferAttrs(gfxAttrs) (&(gfxAttrs)->bAttrs)
+
+extern Int             BufferGfx_getDimensions(Buffer_Handle hBuf,
+                           BufferGfx_Dimensions *dimPtr);
+extern Int             BufferGfx_setDimensions(Buffer_Handle hBuf,
+                           BufferGfx_Dimensions *dimPtr);
+extern Int             BufferGfx_resetDimensions(Buffer_Handle hBuf);
+extern ColorSpace_Type BufferGfx_getColorSpace(Buffer_Handle hBuf);
+extern Int             BufferGfx_setColorSpace(Buffer_Handle hBuf,
+                           ColorSpace_Type colorSpace);
+extern UInt32          BufferGfx_getFrameType(Buffer_Handle hBuf);
+extern Void            BufferGfx_setFrameType(Buffer_Handle hBuf,
+                           UInt32 frameType);
+extern Int32           BufferGfx_calcLineLength(Int32 width,
+                           ColorSpace_Type colorSpace);
+extern Int             BufferGfx_calcDimensions(VideoStd_Type videoStd,
+                           ColorSpace_Type colorSpace,
+                           BufferGfx_Dimensions *dimPtr);
+extern Int32           BufferGfx_calcSize(VideoStd_Type videoStd,
+                           ColorSpace_Type colorSpace);
+extern Int32           BufferGfx_calcFrameSize(Int32 width, Int32 height,
+                           ColorSpace_Type colorSpace);
+
+#endif /* ti_sdo_dmai_BufferGfx_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
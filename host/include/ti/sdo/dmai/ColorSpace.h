@@ -0,0 +1,51 @@
+/*
+ * ColorSpace.h
+ *
+ * Host stand-in for the DMAI color space definitions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_ColorSpace_h_
+#define ti_sdo_dmai_ColorSpace_h_
+
+#include <xdc/std.h>
+
+typedef enum {
+    ColorSpace_NOTSET = -1,
+    ColorSpace_YUV420PSEMI = 0,
+    ColorSpace_YUV422PSEMI,
+    ColorSpace_UYVY,
+    ColorSpace_RGB888,
+    ColorSpace_RGB565,
+    ColorSpace_2BIT,
+    ColorSpace_YUV420P,
+    ColorSpace_YUV422P,
+    ColorSpace_YUV444P,
+    ColorSpace_GRAY,
+    ColorSpace_COUNT
+} ColorSpace_Type;
+
+/* Bits per pixel of the first plane, or of the packed format */
+extern Int ColorSpace_getBpp(ColorSpace_Type colorSpace);
+
+#endif /* ti_sdo_dmai_ColorSpace_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
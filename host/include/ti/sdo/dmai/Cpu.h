@@ -0,0 +1,61 @@
+/*
+ * Cpu.h
+ *
+ * Host stand-in for the DMAI CPU module.  FAKEDMAI_DEVICE selects the
+ * device reported by Cpu_getDevice, the load comes from getrusage.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Cpu_h_
+#define ti_sdo_dmai_Cpu_h_
+
+#include <xdc/std.h>
+
+typedef struct Cpu_Object *Cpu_Handle;
+
+typedef enum {
+    Cpu_Device_DM6467 = 0,
+    Cpu_Device_DM6446,
+    Cpu_Device_DM355,
+    Cpu_Device_DM357,
+    Cpu_Device_DM6437,
+    Cpu_Device_DM365,
+    Cpu_Device_OMAP3530,
+    Cpu_Device_OMAPL137,
+    Cpu_Device_OMAPL138,
+    Cpu_Device_DM3730,
+    Cpu_Device_COUNT
+} Cpu_Device;
+
+typedef struct Cpu_Attrs {
+    Int dummy;
+} Cpu_Attrs;
+
+extern const Cpu_Attrs Cpu_Attrs_DEFAULT;
+
+extern Cpu_Handle Cpu_create(Cpu_Attrs *attrs);
+extern Int        Cpu_delete(Cpu_Handle hCpu);
+extern Int        Cpu_getLoad(Cpu_Handle hCpu, Int *cpuLoad);
+extern Int        Cpu_getDevice(Cpu_Handle hCpu, Cpu_Device *device);
+
+#endif /* ti_sdo_dmai_Cpu_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
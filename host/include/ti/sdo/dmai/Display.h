@@ -0,0 +1,88 @@
+/*
+ * Display.h
+ *
+ * Host stand-in for the DMAI display module.  A thread flips the buffers
+ * at the refresh rate of the video standard, Display_get blocks until one
+ * has been scanned out like the V4L2 driver does.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Display_h_
+#define ti_sdo_dmai_Display_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/BufTab.h>
+#include <ti/sdo/dmai/ColorSpace.h>
+#include <ti/sdo/dmai/VideoStd.h>
+
+typedef struct Display_Object *Display_Handle;
+
+typedef enum {
+    Display_Std_V4L2 = 0,
+    Display_Std_FBDEV,
+    Display_Std_COUNT
+} Display_Std;
+
+typedef enum {
+    Display_Output_SVIDEO = 0,
+    Display_Output_COMPOSITE,
+    Display_Output_COMPONENT,
+    Display_Output_LCD,
+    Display_Output_DVI,
+    Display_Output_SYSTEM,
+    Display_Output_COUNT
+} Display_Output;
+
+typedef struct Display_Attrs {
+    Int             numBufs;
+    Display_Std     displayStd;
+    VideoStd_Type   videoStd;
+    Display_Output  videoOutput;
+    Char           *displayDevice;
+    Int             rotation;
+    ColorSpace_Type colorSpace;
+    Int             width;
+    Int             height;
+    Int             delayStreamon;
+    Int             forceResolution;
+} Display_Attrs;
+
+extern const Display_Attrs Display_Attrs_DM6467_VID_DEFAULT;
+extern const Display_Attrs Display_Attrs_DM365_VID_DEFAULT;
+extern const Display_Attrs Display_Attrs_O3530_VID_DEFAULT;
+extern const Display_Attrs Display_Attrs_OMAPL138_VID_DEFAULT;
+extern const Display_Attrs Display_Attrs_DM6446_DM355_VID_DEFAULT;
+extern const Display_Attrs Display_Attrs_DM6446_DM355_OSD_DEFAULT;
+extern const Display_Attrs Display_Attrs_O3530_OSD_DEFAULT;
+
+extern Display_Handle Display_create(BufTab_Handle hBufTab,
+                          Display_Attrs *attrs);
+extern Int            Display_delete(Display_Handle hDisplay);
+extern Int            Display_get(Display_Handle hDisplay,
+                          Buffer_Handle *hBufPtr);
+extern Int            Display_put(Display_Handle hDisplay,
+                          Buffer_Handle hBuf);
+extern BufTab_Handle  Display_getBufTab(Display_Handle hDisplay);
+extern Int            Display_getHandle(Display_Handle hDisplay);
+
+#endif /* ti_sdo_dmai_Display_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
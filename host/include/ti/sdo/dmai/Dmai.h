@@ -0,0 +1,54 @@
+/*
+ * Dmai.h
+ *
+ * Host stand-in for the DMAI common definitions and error codes.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Dmai_h_
+#define ti_sdo_dmai_Dmai_h_
+
+#include <xdc/std.h>
+
+#define Dmai_EOK            0
+#define Dmai_ENOMEM         -1
+#define Dmai_EIO            -2
+#define Dmai_ENOTIMPL       -3
+#define Dmai_EFAIL          -4
+#define Dmai_EINVAL         -5
+#define Dmai_EEOF           -6
+#define Dmai_EBITERROR      -7
+#define Dmai_EFIRSTFIELD    -8
+#define Dmai_ETIMEOUT       -9
+#define Dmai_EBUSY          -10
+
+/* Not all the file systems have O_DIRECT, no need to copy this one */
+#define Dmai_BASE           0
+
+#define Dmai_roundUp(x, m)  (((x) + ((m) - 1)) & ~((m) - 1))
+#define Dmai_clear(x)       memset(&(x), 0, sizeof(x))
+
+extern Void Dmai_init(Void);
+extern Void Dmai_setLogLevel(Int level);
+
+#endif /* ti_sdo_dmai_Dmai_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
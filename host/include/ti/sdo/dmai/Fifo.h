@@ -0,0 +1,49 @@
+/*
+ * Fifo.h
+ *
+ * Host stand-in for the DMAI Fifo module.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Fifo_h_
+#define ti_sdo_dmai_Fifo_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+
+typedef struct Fifo_Object *Fifo_Handle;
+
+typedef struct Fifo_Attrs {
+    Int dummy;
+} Fifo_Attrs;
+
+extern const Fifo_Attrs Fifo_Attrs_DEFAULT;
+
+extern Fifo_Handle Fifo_create(Fifo_Attrs *attrs);
+extern Int         Fifo_delete(Fifo_Handle hFifo);
+extern Int         Fifo_get(Fifo_Handle hFifo, Ptr ptrPtr);
+extern Int         Fifo_put(Fifo_Handle hFifo, Ptr ptr);
+extern Int         Fifo_flush(Fifo_Handle hFifo);
+extern Int         Fifo_getNumEntries(Fifo_Handle hFifo);
+
+#endif /* ti_sdo_dmai_Fifo_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
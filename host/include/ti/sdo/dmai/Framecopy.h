@@ -0,0 +1,51 @@
+/*
+ * Framecopy.h
+ *
+ * Host stand-in for the DMAI frame copy module.  The copies are done
+ * with memcpy, plane by plane.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Framecopy_h_
+#define ti_sdo_dmai_Framecopy_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Buffer.h>
+
+typedef struct Framecopy_Object *Framecopy_Handle;
+
+typedef struct Framecopy_Attrs {
+    Bool accel;
+    Bool sdma;
+} Framecopy_Attrs;
+
+extern const Framecopy_Attrs Framecopy_Attrs_DEFAULT;
+
+extern Framecopy_Handle Framecopy_create(Framecopy_Attrs *attrs);
+extern Int              Framecopy_config(Framecopy_Handle hFc,
+                            Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
+extern Int              Framecopy_execute(Framecopy_Handle hFc,
+                            Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
+extern Int              Framecopy_delete(Framecopy_Handle hFc);
+
+#endif /* ti_sdo_dmai_Framecopy_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,69 @@
+/*
+ * Resize.h
+ *
+ * Host stand-in for the DMAI resizer module.  Scaling is nearest
+ * neighbour, done on the CPU.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_Resize_h_
+#define ti_sdo_dmai_Resize_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Buffer.h>
+
+typedef struct Resize_Object *Resize_Handle;
+
+typedef enum {
+    Resize_WindowType_HANN = 0,
+    Resize_WindowType_BLACKMAN,
+    Resize_WindowType_TRIANGULAR,
+    Resize_WindowType_RECTANGULAR,
+    Resize_WindowType_BYPASS
+} Resize_WindowType;
+
+typedef enum {
+    Resize_FilterType_BILINEAR = 0,
+    Resize_FilterType_BICUBIC,
+    Resize_FilterType_LOWPASS,
+    Resize_FilterType_BYPASS
+} Resize_FilterType;
+
+typedef struct Resize_Attrs {
+    Resize_WindowType   hWindowType;
+    Resize_WindowType   vWindowType;
+    Resize_FilterType   hFilterType;
+    Resize_FilterType   vFilterType;
+    Int                 rszRate;
+} Resize_Attrs;
+
+extern const Resize_Attrs Resize_Attrs_DEFAULT;
+
+extern Resize_Handle Resize_create(Resize_Attrs *attrs);
+extern Int           Resize_config(Resize_Handle hResize,
+                         Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
+extern Int           Resize_execute(Resize_Handle hResize,
+                         Buffer_Handle hSrcBuf, Buffer_Handle hDstBuf);
+extern Int           Resize_delete(Resize_Handle hResize);
+
+#endif /* ti_sdo_dmai_Resize_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,65 @@
+/*
+ * VideoStd.h
+ *
+ * Host stand-in for the DMAI video standards.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_VideoStd_h_
+#define ti_sdo_dmai_VideoStd_h_
+
+#include <xdc/std.h>
+
+typedef enum {
+    VideoStd_AUTO = 0,
+    VideoStd_CIF,
+    VideoStd_SIF_NTSC,
+    VideoStd_SIF_PAL,
+    VideoStd_VGA,
+    VideoStd_D1_NTSC,
+    VideoStd_D1_PAL,
+    VideoStd_480P,
+    VideoStd_576P,
+    VideoStd_720P_60,
+    VideoStd_720P_50,
+    VideoStd_720P_30,
+    VideoStd_1080I_30,
+    VideoStd_1080I_25,
+    VideoStd_1080P_30,
+    VideoStd_1080P_25,
+    VideoStd_1080P_24,
+    VideoStd_1080P_60,
+    VideoStd_1080P_50,
+    VideoStd_QVGA,
+    VideoStd_COUNT
+} VideoStd_Type;
+
+#define VideoStd_D1_WIDTH           720
+#define VideoStd_D1_NTSC_HEIGHT     480
+#define VideoStd_D1_PAL_HEIGHT      576
+
+extern Int   VideoStd_getResolution(VideoStd_Type videoStd, Int32 *width,
+                 Int32 *height);
+extern Int   VideoStd_getRefreshRate(VideoStd_Type videoStd);
+
+#endif /* ti_sdo_dmai_VideoStd_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
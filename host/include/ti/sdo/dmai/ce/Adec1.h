@@ -0,0 +1,52 @@
+/*
+ * Adec1.h
+ *
+ * Host stand-in for the DMAI XDM 1.0 audio decoder wrapper.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_ce_Adec1_h_
+#define ti_sdo_dmai_ce_Adec1_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/audio1/auddec1.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+
+typedef struct Adec1_Object *Adec1_Handle;
+
+extern const AUDDEC1_Params         Adec1_Params_DEFAULT;
+extern const AUDDEC1_DynamicParams  Adec1_DynamicParams_DEFAULT;
+
+extern Adec1_Handle   Adec1_create(Engine_Handle hEngine, Char *codecName,
+                          AUDDEC1_Params *params,
+                          AUDDEC1_DynamicParams *dynParams);
+extern Int            Adec1_process(Adec1_Handle hCodec, Buffer_Handle hInBuf,
+                          Buffer_Handle hOutBuf);
+extern Int            Adec1_delete(Adec1_Handle hCodec);
+extern Int32          Adec1_getInBufSize(Adec1_Handle hCodec);
+extern Int32          Adec1_getOutBufSize(Adec1_Handle hCodec);
+extern Int            Adec1_getSampleRate(Adec1_Handle hCodec);
+
+#endif /* ti_sdo_dmai_ce_Adec1_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
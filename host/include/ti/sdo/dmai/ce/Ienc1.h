@@ -0,0 +1,51 @@
+/*
+ * Ienc1.h
+ *
+ * Host stand-in for the DMAI XDM 1.0 image encoder wrapper.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_ce_Ienc1_h_
+#define ti_sdo_dmai_ce_Ienc1_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/image1/imgenc1.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+
+typedef struct Ienc1_Object *Ienc1_Handle;
+
+extern const IMGENC1_Params         Ienc1_Params_DEFAULT;
+extern const IMGENC1_DynamicParams  Ienc1_DynamicParams_DEFAULT;
+
+extern Ienc1_Handle   Ienc1_create(Engine_Handle hEngine, Char *codecName,
+                          IMGENC1_Params *params,
+                          IMGENC1_DynamicParams *dynParams);
+extern Int            Ienc1_process(Ienc1_Handle hCodec, Buffer_Handle hInBuf,
+                          Buffer_Handle hOutBuf);
+extern Int            Ienc1_delete(Ienc1_Handle hCodec);
+extern Int32          Ienc1_getInBufSize(Ienc1_Handle hCodec);
+extern Int32          Ienc1_getOutBufSize(Ienc1_Handle hCodec);
+
+#endif /* ti_sdo_dmai_ce_Ienc1_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,59 @@
+/*
+ * Vdec2.h
+ *
+ * Host stand-in for the DMAI XDM 1.2 video decoder wrapper.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_ce_Vdec2_h_
+#define ti_sdo_dmai_ce_Vdec2_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/video2/viddec2.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufTab.h>
+
+typedef struct Vdec2_Object *Vdec2_Handle;
+
+extern const VIDDEC2_Params         Vdec2_Params_DEFAULT;
+extern const VIDDEC2_DynamicParams  Vdec2_DynamicParams_DEFAULT;
+
+extern Vdec2_Handle   Vdec2_create(Engine_Handle hEngine, Char *codecName,
+                          VIDDEC2_Params *params,
+                          VIDDEC2_DynamicParams *dynParams);
+extern Int            Vdec2_process(Vdec2_Handle hVd, Buffer_Handle hInBuf,
+                          Buffer_Handle hDstBuf);
+extern Int            Vdec2_flush(Vdec2_Handle hVd);
+extern Int            Vdec2_delete(Vdec2_Handle hVd);
+extern Void           Vdec2_setBufTab(Vdec2_Handle hVd, BufTab_Handle hBufTab);
+extern BufTab_Handle  Vdec2_getBufTab(Vdec2_Handle hVd);
+extern Buffer_Handle  Vdec2_getDisplayBuf(Vdec2_Handle hVd);
+extern Buffer_Handle  Vdec2_getFreeBuf(Vdec2_Handle hVd);
+extern Int32          Vdec2_getInBufSize(Vdec2_Handle hVd);
+extern Int32          Vdec2_getOutBufSize(Vdec2_Handle hVd);
+extern Int32          Vdec2_getMinOutBufs(Vdec2_Handle hVd);
+extern VIDDEC2_Handle Vdec2_getVisaHandle(Vdec2_Handle hVd);
+
+#endif /* ti_sdo_dmai_ce_Vdec2_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
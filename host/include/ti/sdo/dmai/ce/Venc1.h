@@ -0,0 +1,54 @@
+/*
+ * Venc1.h
+ *
+ * Host stand-in for the DMAI XDM 1.0 video encoder wrapper.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_ce_Venc1_h_
+#define ti_sdo_dmai_ce_Venc1_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/ce/Engine.h>
+#include <ti/sdo/ce/video1/videnc1.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufTab.h>
+
+typedef struct Venc1_Object *Venc1_Handle;
+
+extern const VIDENC1_Params         Venc1_Params_DEFAULT;
+extern const VIDENC1_DynamicParams  Venc1_DynamicParams_DEFAULT;
+
+extern Venc1_Handle   Venc1_create(Engine_Handle hEngine, Char *codecName,
+                          VIDENC1_Params *params,
+                          VIDENC1_DynamicParams *dynParams);
+extern Int            Venc1_process(Venc1_Handle hVe, Buffer_Handle hInBuf,
+                          Buffer_Handle hOutBuf);
+extern Int            Venc1_flush(Venc1_Handle hVe);
+extern Int            Venc1_delete(Venc1_Handle hVe);
+extern Int32          Venc1_getInBufSize(Venc1_Handle hVe);
+extern Int32          Venc1_getOutBufSize(Venc1_Handle hVe);
+extern VIDENC1_Handle Venc1_getVisaHandle(Venc1_Handle hVe);
+
+#endif /* ti_sdo_dmai_ce_Venc1_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
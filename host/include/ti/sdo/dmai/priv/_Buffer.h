@@ -0,0 +1,63 @@
+/*
+ * _Buffer.h
+ *
+ * Host stand-in for the private DMAI buffer objects.  The plugin reads
+ * the buffer type and the frame type straight from these.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_sdo_dmai_priv__Buffer_h_
+#define ti_sdo_dmai_priv__Buffer_h_
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Buffer.h>
+#include <ti/sdo/dmai/BufferGfx.h>
+
+typedef struct _Buffer_Object {
+    Buffer_Type         type;
+    Int8               *userPtr;
+    Int32               physPtr;
+    Int32               numBytes;
+    Int32               numBytesUsed;
+    Int                 id;
+    Bool                reference;
+    UInt16              useMask;
+    UInt16              defaultUseMask;
+    Memory_AllocParams  memParams;
+    BufTab_Handle       hBufTab;
+} _Buffer_Object;
+
+typedef struct _BufferGfx_Object {
+    _Buffer_Object          bufObject;
+    BufferGfx_Dimensions    dim;
+    BufferGfx_Dimensions    origDim;
+    ColorSpace_Type         colorSpace;
+    UInt32                  frameType;
+} _BufferGfx_Object;
+
+extern Int _Buffer_init(Buffer_Handle hBuf, Int32 size, Buffer_Attrs *attrs);
+extern Int _Buffer_setBufTab(Buffer_Handle hBuf, BufTab_Handle hBufTab);
+extern Int _Buffer_setId(Buffer_Handle hBuf, Int id);
+extern Int _Buffer_getOriginalSize(Buffer_Handle hBuf);
+
+#endif /* ti_sdo_dmai_priv__Buffer_h_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,56 @@
+/*
+ * iauddec1.h
+ *
+ * Host stand-in for the XDM 1.0 audio decoder interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IAUDDEC1_
+#define ti_xdais_dm_IAUDDEC1_
+
+#include <ti/xdais/dm/xdm.h>
+
+typedef struct IAUDDEC1_Params {
+    XDAS_Int32  size;
+    XDAS_Int32  outputPCMWidth;
+    XDAS_Int32  pcmFormat;
+    XDAS_Int32  dataEndianness;
+} IAUDDEC1_Params;
+
+typedef struct IAUDDEC1_DynamicParams {
+    XDAS_Int32  size;
+    XDAS_Int32  downSampleSbrFlag;
+} IAUDDEC1_DynamicParams;
+
+typedef struct IAUDDEC1_OutArgs {
+    XDAS_Int32  size;
+    XDAS_Int32  extendedError;
+    XDAS_Int32  bytesConsumed;
+    XDAS_Int32  numSamples;
+    XDAS_Int32  channelMode;
+    XDAS_Int32  lfeFlag;
+    XDAS_Int32  dualMonoMode;
+    XDAS_Int32  sampleRate;
+} IAUDDEC1_OutArgs;
+
+#endif /* ti_xdais_dm_IAUDDEC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
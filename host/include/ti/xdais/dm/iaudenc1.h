@@ -0,0 +1,67 @@
+/*
+ * iaudenc1.h
+ *
+ * Host stand-in for the XDM 1.0 audio encoder interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IAUDENC1_
+#define ti_xdais_dm_IAUDENC1_
+
+#include <ti/xdais/dm/xdm.h>
+
+typedef struct IAUDENC1_Params {
+    XDAS_Int32  size;
+    XDAS_Int32  sampleRate;
+    XDAS_Int32  bitRate;
+    XDAS_Int32  channelMode;
+    XDAS_Int32  dataEndianness;
+    XDAS_Int32  encMode;
+    XDAS_Int32  inputFormat;
+    XDAS_Int32  inputBitsPerSample;
+    XDAS_Int32  maxBitRate;
+    XDAS_Int32  dualMonoMode;
+    XDAS_Int32  crcFlag;
+    XDAS_Int32  ancFlag;
+    XDAS_Int32  lfeFlag;
+} IAUDENC1_Params;
+
+typedef struct IAUDENC1_DynamicParams {
+    XDAS_Int32  size;
+    XDAS_Int32  bitRate;
+    XDAS_Int32  sampleRate;
+    XDAS_Int32  channelMode;
+    XDAS_Int32  lfeFlag;
+    XDAS_Int32  dualMonoMode;
+    XDAS_Int32  inputBitsPerSample;
+} IAUDENC1_DynamicParams;
+
+typedef struct IAUDENC1_OutArgs {
+    XDAS_Int32  size;
+    XDAS_Int32  extendedError;
+    XDAS_Int32  bytesGenerated;
+    XDAS_Int32  numZeroesPadded;
+    XDAS_Int32  numInSamples;
+} IAUDENC1_OutArgs;
+
+#endif /* ti_xdais_dm_IAUDENC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
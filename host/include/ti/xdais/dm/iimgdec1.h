@@ -0,0 +1,57 @@
+/*
+ * iimgdec1.h
+ *
+ * Host stand-in for the XDM 1.0 image decoder interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IIMGDEC1_
+#define ti_xdais_dm_IIMGDEC1_
+
+#include <ti/xdais/dm/xdm.h>
+
+typedef struct IIMGDEC1_Params {
+    XDAS_Int32  size;
+    XDAS_Int32  maxHeight;
+    XDAS_Int32  maxWidth;
+    XDAS_Int32  maxScans;
+    XDAS_Int32  dataEndianness;
+    XDAS_Int32  forceChromaFormat;
+} IIMGDEC1_Params;
+
+typedef struct IIMGDEC1_DynamicParams {
+    XDAS_Int32  size;
+    XDAS_Int32  numAU;
+    XDAS_Int32  decodeHeader;
+    XDAS_Int32  displayWidth;
+} IIMGDEC1_DynamicParams;
+
+typedef struct IIMGDEC1_OutArgs {
+    XDAS_Int32  size;
+    XDAS_Int32  extendedError;
+    XDAS_Int32  bytesConsumed;
+    XDAS_Int32  currentAU;
+    XDAS_Int32  currentScan;
+} IIMGDEC1_OutArgs;
+
+#endif /* ti_xdais_dm_IIMGDEC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
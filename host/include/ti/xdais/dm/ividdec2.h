@@ -0,0 +1,89 @@
+/*
+ * ividdec2.h
+ *
+ * Host stand-in for the XDM 1.2 video decoder interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IVIDDEC2_
+#define ti_xdais_dm_IVIDDEC2_
+
+#include <ti/xdais/dm/ivideo.h>
+
+#define IVIDDEC2_EOK            XDM_EOK
+#define IVIDDEC2_EFAIL          XDM_EFAIL
+#define IVIDDEC2_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct IVIDDEC2_Params {
+    XDAS_Int32  size;
+    XDAS_Int32  maxHeight;
+    XDAS_Int32  maxWidth;
+    XDAS_Int32  maxFrameRate;
+    XDAS_Int32  maxBitRate;
+    XDAS_Int32  dataEndianness;
+    XDAS_Int32  forceChromaFormat;
+} IVIDDEC2_Params;
+
+typedef struct IVIDDEC2_DynamicParams {
+    XDAS_Int32  size;
+    XDAS_Int32  decodeHeader;
+    XDAS_Int32  displayWidth;
+    XDAS_Int32  frameSkipMode;
+    XDAS_Int32  frameOrder;
+    XDAS_Int32  newFrameFlag;
+    XDAS_Int32  mbDataFlag;
+} IVIDDEC2_DynamicParams;
+
+typedef struct IVIDDEC2_InArgs {
+    XDAS_Int32  size;
+    XDAS_Int32  numBytes;
+    XDAS_Int32  inputID;
+} IVIDDEC2_InArgs;
+
+typedef struct IVIDDEC2_OutArgs {
+    XDAS_Int32      size;
+    XDAS_Int32      bytesConsumed;
+    XDAS_Int32      outputID[XDM_MAX_IO_BUFFERS];
+    IVIDEO1_BufDesc decodedBufs;
+    IVIDEO1_BufDesc displayBufs[XDM_MAX_IO_BUFFERS];
+    XDAS_Int32      outputMbDataID;
+    XDM1_SingleBufDesc mbDataBuf;
+    XDAS_Int32      freeBufID[XDM_MAX_IO_BUFFERS];
+    XDAS_Int32      outBufsInUseFlag;
+} IVIDDEC2_OutArgs;
+
+typedef struct IVIDDEC2_Status {
+    XDAS_Int32      size;
+    XDAS_Int32      extendedError;
+    XDM1_SingleBufDesc data;
+    XDAS_Int32      maxNumDisplayBufs;
+    XDAS_Int32      outputHeight;
+    XDAS_Int32      outputWidth;
+    XDAS_Int32      frameRate;
+    XDAS_Int32      bitRate;
+    XDAS_Int32      contentType;
+    XDAS_Int32      outputChromaFormat;
+    XDM_AlgBufInfo  bufInfo;
+} IVIDDEC2_Status;
+
+#endif /* ti_xdais_dm_IVIDDEC2_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,90 @@
+/*
+ * ividenc1.h
+ *
+ * Host stand-in for the XDM 1.0 video encoder interface.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IVIDENC1_
+#define ti_xdais_dm_IVIDENC1_
+
+#include <ti/xdais/dm/ivideo.h>
+
+#define IVIDENC1_EOK            XDM_EOK
+#define IVIDENC1_EFAIL          XDM_EFAIL
+#define IVIDENC1_EUNSUPPORTED   XDM_EUNSUPPORTED
+
+typedef struct IVIDENC1_Params {
+    XDAS_Int32  size;
+    XDAS_Int32  encodingPreset;
+    XDAS_Int32  rateControlPreset;
+    XDAS_Int32  maxHeight;
+    XDAS_Int32  maxWidth;
+    XDAS_Int32  maxFrameRate;
+    XDAS_Int32  maxBitRate;
+    XDAS_Int32  dataEndianness;
+    XDAS_Int32  maxInterFrameInterval;
+    XDAS_Int32  inputChromaFormat;
+    XDAS_Int32  inputContentType;
+    XDAS_Int32  reconChromaFormat;
+} IVIDENC1_Params;
+
+typedef struct IVIDENC1_DynamicParams {
+    XDAS_Int32  size;
+    XDAS_Int32  inputHeight;
+    XDAS_Int32  inputWidth;
+    XDAS_Int32  refFrameRate;
+    XDAS_Int32  targetFrameRate;
+    XDAS_Int32  targetBitRate;
+    XDAS_Int32  intraFrameInterval;
+    XDAS_Int32  generateHeader;
+    XDAS_Int32  captureWidth;
+    XDAS_Int32  forceFrame;
+    XDAS_Int32  interFrameInterval;
+    XDAS_Int32  mbDataFlag;
+} IVIDENC1_DynamicParams;
+
+typedef struct IVIDENC1_InArgs {
+    XDAS_Int32  size;
+    XDAS_Int32  inputID;
+    XDAS_Int32  topFieldFirstFlag;
+} IVIDENC1_InArgs;
+
+typedef struct IVIDENC1_OutArgs {
+    XDAS_Int32      size;
+    XDAS_Int32      extendedError;
+    XDAS_Int32      bytesGenerated;
+    XDAS_Int32      encodedFrameType;
+    XDAS_Int32      inputFrameSkip;
+    XDAS_Int32      outputID;
+    XDM1_SingleBufDesc encodedBuf;
+} IVIDENC1_OutArgs;
+
+typedef struct IVIDENC1_Status {
+    XDAS_Int32      size;
+    XDAS_Int32      extendedError;
+    XDM1_SingleBufDesc data;
+    XDM_AlgBufInfo  bufInfo;
+} IVIDENC1_Status;
+
+#endif /* ti_xdais_dm_IVIDENC1_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,116 @@
+/*
+ * ivideo.h
+ *
+ * Host stand-in for the XDM video definitions.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_IVIDEO_
+#define ti_xdais_dm_IVIDEO_
+
+#include <ti/xdais/dm/xdm.h>
+
+typedef enum {
+    IVIDEO_NA_FRAME = -1,
+    IVIDEO_I_FRAME = 0,
+    IVIDEO_P_FRAME = 1,
+    IVIDEO_B_FRAME = 2,
+    IVIDEO_IDR_FRAME = 3,
+    IVIDEO_II_FRAME = 4,
+    IVIDEO_IP_FRAME = 5,
+    IVIDEO_IB_FRAME = 6,
+    IVIDEO_PI_FRAME = 7,
+    IVIDEO_PP_FRAME = 8,
+    IVIDEO_PB_FRAME = 9,
+    IVIDEO_BI_FRAME = 10,
+    IVIDEO_BP_FRAME = 11,
+    IVIDEO_BB_FRAME = 12,
+    IVIDEO_MBAFF_I_FRAME = 13,
+    IVIDEO_MBAFF_P_FRAME = 14,
+    IVIDEO_MBAFF_B_FRAME = 15,
+    IVIDEO_MBAFF_IDR_FRAME = 16,
+    IVIDEO_FRAMETYPE_DEFAULT = IVIDEO_I_FRAME
+} IVIDEO_FrameType;
+
+typedef enum {
+    IVIDEO_CONTENTTYPE_NA = -1,
+    IVIDEO_PROGRESSIVE = 0,
+    IVIDEO_INTERLACED = 1,
+    IVIDEO_CONTENTTYPE_DEFAULT = IVIDEO_PROGRESSIVE
+} IVIDEO_ContentType;
+
+typedef enum {
+    IVIDEO_CBR = 1,
+    IVIDEO_LOW_DELAY = 1,
+    IVIDEO_VBR = 2,
+    IVIDEO_STORAGE = 2,
+    IVIDEO_TWOPASS = 3,
+    IVIDEO_NONE = 4,
+    IVIDEO_USER_DEFINED = 5,
+    IVIDEO_RATECONTROLPRESET_DEFAULT = IVIDEO_LOW_DELAY
+} IVIDEO_RateControlPreset;
+
+typedef enum {
+    IVIDEO_NA_SKIP = -1,
+    IVIDEO_NO_SKIP = 0,
+    IVIDEO_SKIP_P = 1,
+    IVIDEO_SKIP_B = 2,
+    IVIDEO_SKIP_I = 3,
+    IVIDEO_SKIP_IP = 4,
+    IVIDEO_SKIP_IB = 5,
+    IVIDEO_SKIP_PB = 6,
+    IVIDEO_SKIP_IPB = 7,
+    IVIDEO_SKIP_IDR = 8,
+    IVIDEO_SKIP_DEFAULT = IVIDEO_NO_SKIP
+} IVIDEO_SkipMode;
+
+typedef enum {
+    IVIDEO_DISPLAY_ORDER = 0,
+    IVIDEO_DECODE_ORDER = 1
+} IVIDDEC_FrameOrder;
+
+typedef struct IVIDEO1_BufDesc {
+    XDAS_Int32          numBufs;
+    XDAS_Int32          frameWidth;
+    XDAS_Int32          frameHeight;
+    XDAS_Int32          framePitch;
+    XDM1_SingleBufDesc  bufDesc[3];
+    XDAS_Int32          extendedError;
+    XDAS_Int32          frameType;
+    XDAS_Int32          topFieldFirstFlag;
+    XDAS_Int32          repeatFirstFieldFlag;
+    XDAS_Int32          frameStatus;
+    XDAS_Int32          repeatFrame;
+    XDAS_Int32          contentType;
+    XDAS_Int32          chromaFormat;
+} IVIDEO1_BufDesc;
+
+typedef struct IVIDEO1_BufDescIn {
+    XDAS_Int32          numBufs;
+    XDAS_Int32          frameWidth;
+    XDAS_Int32          frameHeight;
+    XDAS_Int32          framePitch;
+    XDM1_SingleBufDesc  bufDesc[3];
+} IVIDEO1_BufDescIn;
+
+#endif /* ti_xdais_dm_IVIDEO_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
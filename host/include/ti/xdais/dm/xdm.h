@@ -0,0 +1,133 @@
+/*
+ * xdm.h
+ *
+ * Host stand-in for the XDM definitions shared by all the codec classes:
+ * return codes, buffer descriptors, control commands and chroma formats.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_dm_XDM_
+#define ti_xdais_dm_XDM_
+
+#include <ti/xdais/xdas.h>
+
+#define XDM_EOK                 0
+#define XDM_EFAIL               -1
+#define XDM_EUNSUPPORTED        -3
+
+#define XDM_MAX_IO_BUFFERS      16
+#define XDM_MAX_CONTEXT_BUFFERS 32
+
+/* Bits of the extendedError field */
+#define XDM_PARAMSCHANGE        8
+#define XDM_APPLIEDCONCEALMENT  9
+#define XDM_INSUFFICIENTDATA    10
+#define XDM_CORRUPTEDDATA       11
+#define XDM_CORRUPTEDHEADER     12
+#define XDM_UNSUPPORTEDINPUT    13
+#define XDM_UNSUPPORTEDPARAM    14
+#define XDM_FATALERROR          15
+
+#define XDM_ISFATALERROR(x)     (((x) >> XDM_FATALERROR) & 0x1)
+
+typedef enum {
+    XDM_GETSTATUS = 0,
+    XDM_SETPARAMS = 1,
+    XDM_RESET = 2,
+    XDM_SETDEFAULT = 3,
+    XDM_FLUSH = 4,
+    XDM_GETBUFINFO = 5,
+    XDM_GETVERSION = 6,
+    XDM_GETCONTEXTINFO = 7
+} XDM_CmdId;
+
+typedef enum {
+    XDM_BYTE = 1,
+    XDM_LE_16 = 2,
+    XDM_LE_32 = 3,
+    XDM_LE_64 = 4,
+    XDM_BE_16 = 5,
+    XDM_BE_32 = 6,
+    XDM_BE_64 = 7
+} XDM_DataFormat;
+
+typedef enum {
+    XDM_CHROMA_NA = -1,
+    XDM_YUV_420P = 1,
+    XDM_YUV_422P = 2,
+    XDM_YUV_422IBE = 3,
+    XDM_YUV_422ILE = 4,
+    XDM_YUV_444P = 5,
+    XDM_YUV_411P = 6,
+    XDM_GRAY = 7,
+    XDM_RGB = 8,
+    XDM_YUV_420SP = 9,
+    XDM_ARGB8888 = 10,
+    XDM_RGB555 = 11,
+    XDM_RGB565 = 12,
+    XDM_YUV_444ILE = 13,
+    XDM_CHROMAFORMAT_DEFAULT = XDM_YUV_422ILE
+} XDM_ChromaFormat;
+
+typedef enum {
+    XDM_DEFAULT = 0,
+    XDM_HIGH_QUALITY = 1,
+    XDM_HIGH_SPEED = 2,
+    XDM_USER_DEFINED = 3
+} XDM_EncodingPreset;
+
+typedef enum {
+    XDM_DECODE_AU = 0,
+    XDM_PARSE_HEADER = 1
+} XDM_DecMode;
+
+typedef enum {
+    XDM_ENCODE_AU = 0,
+    XDM_GENERATE_HEADER = 1
+} XDM_EncMode;
+
+typedef struct XDM1_SingleBufDesc {
+    XDAS_Int8       *buf;
+    XDAS_Int32      bufSize;
+    XDAS_Int32      accessMask;
+} XDM1_SingleBufDesc;
+
+typedef struct XDM1_BufDesc {
+    XDAS_Int32          numBufs;
+    XDM1_SingleBufDesc  descs[XDM_MAX_IO_BUFFERS];
+} XDM1_BufDesc;
+
+typedef struct XDM_BufDesc {
+    XDAS_Int8       **bufs;
+    XDAS_Int32      numBufs;
+    XDAS_Int32      *bufSizes;
+} XDM_BufDesc;
+
+typedef struct XDM_AlgBufInfo {
+    XDAS_Int32      minNumInBufs;
+    XDAS_Int32      minNumOutBufs;
+    XDAS_Int32      minInBufSize[XDM_MAX_IO_BUFFERS];
+    XDAS_Int32      minOutBufSize[XDM_MAX_IO_BUFFERS];
+} XDM_AlgBufInfo;
+
+#endif /* ti_xdais_dm_XDM_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
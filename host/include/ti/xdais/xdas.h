@@ -0,0 +1,45 @@
+/*
+ * xdas.h
+ *
+ * Host stand-in for the XDAIS base types.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef ti_xdais_XDAS_
+#define ti_xdais_XDAS_
+
+#include <xdc/std.h>
+
+typedef Void            XDAS_Void;
+typedef UInt8           XDAS_Bool;
+typedef Int8            XDAS_Int8;
+typedef UInt8           XDAS_UInt8;
+typedef Int16           XDAS_Int16;
+typedef UInt16          XDAS_UInt16;
+typedef Int32           XDAS_Int32;
+typedef UInt32          XDAS_UInt32;
+
+#define XDAS_TRUE       1
+#define XDAS_FALSE      0
+
+#endif /* ti_xdais_XDAS_ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
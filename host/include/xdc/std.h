@@ -0,0 +1,70 @@
+/*
+ * std.h
+ *
+ * Host stand-in for the XDC standard types used by DMAI and Codec Engine.
+ * Int32/UInt32 are longs, as on the ARM targets, so they also hold a
+ * pointer on LP64 hosts.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef xdc_std__include
+#define xdc_std__include
+
+#include <stddef.h>
+
+typedef char            Char;
+typedef unsigned char   UChar;
+typedef short           Short;
+typedef unsigned short  UShort;
+typedef int             Int;
+typedef unsigned int    UInt;
+typedef unsigned int    Uns;
+typedef long            Long;
+typedef unsigned long   ULong;
+typedef long            LgInt;
+typedef unsigned long   LgUns;
+typedef float           Float;
+typedef double          Double;
+typedef void            Void;
+typedef void           *Ptr;
+typedef char           *String;
+typedef long            Arg;
+typedef unsigned short  Bool;
+
+typedef signed char     Int8;
+typedef unsigned char   UInt8;
+typedef short           Int16;
+typedef unsigned short  UInt16;
+typedef long            Int32;
+typedef unsigned long   UInt32;
+typedef long long       Int64;
+typedef unsigned long long UInt64;
+
+#ifndef TRUE
+#define TRUE            1
+#endif
+#ifndef FALSE
+#define FALSE           0
+#endif
+
+#endif /* xdc_std__include */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,148 @@
+/*
+ * parserbench.c
+ *
+ * Measures the throughput of the elementary stream parsers of the plugin
+ * over a corpus of files, fed through the decoder's circular buffer in
+ * writes of a fixed size like a demuxer or a file source would.
+ *
+ *     parserbench [-n runs] [-w write] [-c chunk] [-C caps] parser file...
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <getopt.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "parserdrive.h"
+
+/******************************************************************************
+ * usage
+ ******************************************************************************/
+static void usage(const gchar *prog)
+{
+    const parserdrive_parser *parser;
+
+    fprintf(stderr,
+        "usage: %s [options] parser file...\n"
+        "  -n runs    passes over every file (10)\n"
+        "  -w bytes   size of the writes into the circular buffer (4096)\n"
+        "  -c bytes   codec input buffer size (per parser default)\n"
+        "  -C caps    caps of the stream (per parser default)\n"
+        "parsers:", prog);
+    for (parser = parserdrive_parsers; parser->name; parser++) {
+        fprintf(stderr, " %s", parser->name);
+    }
+    fprintf(stderr, "\n");
+}
+
+/******************************************************************************
+ * main
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    const parserdrive_parser *parser;
+    parserdrive_stats stats, total = { 0, };
+    const gchar *capsString = NULL;
+    GstCaps *caps;
+    GTimer *timer;
+    gsize write = 4096, size;
+    gdouble elapsed, allElapsed = 0;
+    gint runs = 10, chunkSize = 0, c, i, r;
+    gchar *data;
+    GError *error = NULL;
+
+    gst_init(&argc, &argv);
+
+    while ((c = getopt(argc, argv, "n:w:c:C:")) != -1) {
+        switch (c) {
+            case 'n': runs = atoi(optarg); break;
+            case 'w': write = strtoul(optarg, NULL, 0); break;
+            case 'c': chunkSize = atoi(optarg); break;
+            case 'C': capsString = optarg; break;
+            default:
+                usage(argv[0]);
+                return 1;
+        }
+    }
+
+    if (argc - optind < 2 || runs <= 0 || write == 0 ||
+        !(parser = parserdrive_find(argv[optind]))) {
+        usage(argv[0]);
+        return 1;
+    }
+
+    caps = gst_caps_from_string(capsString ? capsString : parser->caps);
+    if (!caps) {
+        fprintf(stderr, "invalid caps\n");
+        return 1;
+    }
+    if (chunkSize <= 0) {
+        chunkSize = parser->chunkSize;
+    }
+
+    printf("%-32s %10s %8s %8s %10s %8s\n", "file", "bytes", "frames",
+        "key", "MB/s", "moves");
+
+    timer = g_timer_new();
+    for (i = optind + 1; i < argc; i++) {
+        if (!g_file_get_contents(argv[i], &data, &size, &error)) {
+            fprintf(stderr, "%s\n", error->message);
+            g_clear_error(&error);
+            continue;
+        }
+
+        memset(&stats, 0, sizeof(stats));
+        g_timer_start(timer);
+        for (r = 0; r < runs; r++) {
+            if (!parserdrive_run(parser, caps, chunkSize, (guint8 *)data,
+                    size, &write, 1, -1, &stats)) {
+                fprintf(stderr, "%s: failed to start the parser\n", argv[i]);
+                break;
+            }
+        }
+        elapsed = g_timer_elapsed(timer, NULL);
+        g_free(data);
+
+        printf("%-32s %10" G_GUINT64_FORMAT " %8u %8u %10.1f %8u\n",
+            argv[i], stats.bytes / runs, stats.frames / runs,
+            stats.keyFrames / runs, elapsed > 0 ? stats.bytes / elapsed / 1e6 :
+            0.0, stats.moves / runs);
+        if (stats.overflows) {
+            printf("%-32s %u writes overflowed the circular buffer\n",
+                "", stats.overflows / runs);
+        }
+
+        total.bytes += stats.bytes;
+        total.frames += stats.frames;
+        allElapsed += elapsed;
+    }
+    g_timer_destroy(timer);
+    gst_caps_unref(caps);
+
+    printf("%-32s %10" G_GUINT64_FORMAT " %8u %8s %10.1f\n", "total",
+        total.bytes / runs, total.frames / runs, "",
+        allElapsed > 0 ? total.bytes / allElapsed / 1e6 : 0.0);
+
+    return 0;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
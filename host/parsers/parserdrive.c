@@ -0,0 +1,226 @@
+/*
+ * parserdrive.c
+ *
+ * Drives the elementary stream parsers of the plugin the way TIDmaidec
+ * does, see parserdrive.h.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <string.h>
+
+#include "parserdrive.h"
+#include "gsttisupport_aac.h"
+#include "gsttisupport_generic.h"
+#include "gsttisupport_h264.h"
+#include "gsttisupport_jpeg.h"
+#include "gsttisupport_mp3.h"
+#include "gsttisupport_mpeg2.h"
+#include "gsttisupport_mpeg4.h"
+
+/* Empty frames in a row before deciding the parser is stuck */
+#define MAX_EMPTY_FRAMES    16
+
+const parserdrive_parser parserdrive_parsers[] = {
+    { "h264",    &gstti_h264_parser,
+      "video/x-h264,stream-format=(string)byte-stream", "h264dec",
+      1024 * 1024 },
+    { "mpeg4",   &gstti_mpeg4_parser,
+      "video/mpeg,mpegversion=(int)4", "mpeg4dec", 1024 * 1024 },
+    { "mpeg2",   &gstti_mpeg2_parser,
+      "video/mpeg,mpegversion=(int)2", "mpeg2dec", 1024 * 1024 },
+    { "jpeg",    &gstti_jpeg_parser,
+      "image/jpeg", "jpegdec", 1024 * 1024 },
+    { "aac",     &gstti_aac_parser,
+      "audio/mpeg,mpegversion=(int)4", "aachedec", 8 * 1024 },
+    { "mp3",     &gstti_mp3_parser,
+      "audio/mpeg,mpegversion=(int)1,layer=(int)3", "mp3dec", 8 * 1024 },
+    { "generic", &gstti_generic_parser,
+      "video/x-wmv,parsed=(boolean)true", "vc1dec", 1024 * 1024 },
+    { NULL, }
+};
+
+/******************************************************************************
+ * parserdrive_find
+ ******************************************************************************/
+const parserdrive_parser *parserdrive_find(const gchar *name)
+{
+    const parserdrive_parser *parser;
+
+    for (parser = parserdrive_parsers; parser->name; parser++) {
+        if (!strcmp(parser->name, name)) {
+            return parser;
+        }
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * parserdrive_params
+ *    What TIDmaidec takes from the caps before starting the parser.
+ ******************************************************************************/
+static void parserdrive_params(const parserdrive_parser *parser,
+    GstCaps *caps, struct gstti_parser_params *params)
+{
+    GstStructure *capStruct;
+
+    memset(params, 0, sizeof(*params));
+    params->caps = caps;
+    params->codecName = parser->codecName;
+
+    if (caps && gst_caps_get_size(caps) > 0) {
+        capStruct = gst_caps_get_structure(caps, 0);
+        gst_structure_get_int(capStruct, "rate", &params->rate);
+        gst_structure_get_int(capStruct, "channels", &params->channels);
+    }
+}
+
+/******************************************************************************
+ * parserdrive_frames
+ *    Takes the frames the parser finds in the circular buffer, like the
+ *    decoder does before every codec call, and consumes them whole.
+ ******************************************************************************/
+static void parserdrive_frames(const parserdrive_parser *parser,
+    void *private, const guint8 *circ, gint chunkSize, gint *tail,
+    gint *marker, gint *head, parserdrive_stats *stats)
+{
+    struct gstti_parser_range range;
+    gint framepos, empty = 0;
+
+    while (*head > *tail) {
+        range.data = circ;
+        range.tail = *tail;
+        range.marker = *marker;
+        range.head = *head;
+        range.chunkSize = chunkSize;
+        range.duration = GST_CLOCK_TIME_NONE;
+        range.frameType = GSTTI_FRAME_UNKNOWN;
+
+        framepos = parser->ops->parse(private, &range);
+
+        if (range.marker < 0 || range.marker > *head) {
+            g_error("%s: marker %d outside of [0, %d]", parser->name,
+                range.marker, *head);
+        }
+        *marker = range.marker;
+
+        if (framepos < 0) {
+            return;
+        }
+
+        if (framepos < *tail || framepos > *head) {
+            g_error("%s: frame end %d outside of [%d, %d]", parser->name,
+                framepos, *tail, *head);
+        }
+
+        if (framepos == *tail) {
+            if (++empty > MAX_EMPTY_FRAMES) {
+                g_error("%s: parser keeps returning empty frames at %d",
+                    parser->name, framepos);
+            }
+            continue;
+        }
+        empty = 0;
+
+        stats->frames++;
+        stats->frameBytes += framepos - *tail;
+        if (range.frameType == GSTTI_FRAME_I) {
+            stats->keyFrames++;
+        }
+
+        *tail = framepos;
+        if (*tail >= *head) {
+            *tail = *head = *marker = 0;
+        }
+    }
+}
+
+/******************************************************************************
+ * parserdrive_run
+ ******************************************************************************/
+gboolean parserdrive_run(const parserdrive_parser *parser, GstCaps *caps,
+    gint chunkSize, const guint8 *data, gsize size, const gsize *writes,
+    gint numWrites, gssize flushAt, parserdrive_stats *stats)
+{
+    struct gstti_parser_params params;
+    void *private;
+    guint8 *circ;
+    gint numInputBufs, end, head = 0, tail = 0, marker = 0, w = 0;
+    gsize pos = 0, len;
+
+    parserdrive_params(parser, caps, &params);
+    private = parser->ops->init(&params);
+    if (!private) {
+        return FALSE;
+    }
+
+    numInputBufs = params.numInputBufs ? params.numInputBufs :
+        parser->ops->numInputBufs;
+    end = MAX(numInputBufs, 1) * chunkSize;
+    circ = g_malloc(end);
+
+    while (pos < size) {
+        len = MIN(writes[w++ % numWrites], size - pos);
+        len = MIN(len, (gsize)end);
+
+        /* validate_circBuf_space */
+        if (end - head < (gint)len) {
+            if (end - head + tail < (gint)len) {
+                stats->overflows++;
+                head = tail = marker = 0;
+            } else {
+                stats->moves++;
+                memmove(circ, circ + tail, head - tail);
+                head -= tail;
+                marker -= tail;
+                tail = 0;
+            }
+        }
+
+        memcpy(circ + head, data + pos, len);
+        head += len;
+        stats->bytes += len;
+
+        if (flushAt >= 0 && pos <= (gsize)flushAt &&
+            pos + len > (gsize)flushAt) {
+            /* Flush events reset the parser and empty the buffer */
+            parser->ops->flush_start(private);
+            head = tail = marker = 0;
+            parser->ops->flush_stop(private);
+        }
+        pos += len;
+
+        parserdrive_frames(parser, private, circ, chunkSize, &tail, &marker,
+            &head, stats);
+    }
+
+    /* At the end of the stream the decoder drains the rest to the codec */
+    if (head > tail) {
+        stats->frames++;
+        stats->frameBytes += head - tail;
+    }
+
+    parser->ops->clean(private);
+    g_free(circ);
+
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
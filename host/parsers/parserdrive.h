@@ -0,0 +1,76 @@
+/*
+ * parserdrive.h
+ *
+ * Drives the elementary stream parsers of the plugin the way TIDmaidec
+ * does: the stream goes through an input circular buffer and the parser
+ * is asked for the next frame after every write.  Shared by the parser
+ * benchmark and the fuzz targets.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef __PARSERDRIVE_H__
+#define __PARSERDRIVE_H__
+
+#include <gst/gst.h>
+
+#include "gsttiparsers.h"
+
+typedef struct parserdrive_parser {
+    const gchar                 *name;
+    struct gstti_parser_ops     *ops;
+    /* Caps of a stream without codec_data */
+    const gchar                 *caps;
+    /* Codec the frames go to, as the generic parser checks it */
+    const gchar                 *codecName;
+    /* Size of the codec input buffer */
+    gint                        chunkSize;
+} parserdrive_parser;
+
+typedef struct parserdrive_stats {
+    guint64     bytes;
+    guint64     frameBytes;
+    guint       frames;
+    guint       keyFrames;
+    /* Writes that didn't fit in the circular buffer, which was reset */
+    guint       overflows;
+    /* Times the data had to be moved to the start of the buffer */
+    guint       moves;
+} parserdrive_stats;
+
+extern const parserdrive_parser parserdrive_parsers[];
+
+/* Looks up a parser by name, NULL if there is no such parser */
+const parserdrive_parser *parserdrive_find(const gchar *name);
+
+/*
+ * Feeds data to the parser in writes of the given sizes (cycling through
+ * them), flushing the parser at flushAt bytes if it's not negative.
+ * Aborts if the parser returns a position outside the data it was given
+ * or keeps returning empty frames.  Returns FALSE if the parser could
+ * not be started.
+ */
+gboolean parserdrive_run(const parserdrive_parser *parser, GstCaps *caps,
+    gint chunkSize, const guint8 *data, gsize size, const gsize *writes,
+    gint numWrites, gssize flushAt, parserdrive_stats *stats);
+
+#endif /* __PARSERDRIVE_H__ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
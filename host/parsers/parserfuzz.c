@@ -0,0 +1,158 @@
+/*
+ * parserfuzz.c
+ *
+ * Fuzz target for the elementary stream parsers of the plugin.
+ *
+ * The first byte of the input picks the parser, the second one how the
+ * data is cut into writes, whether a flush happens halfway and whether
+ * the next bytes are codec_data for the caps; the rest is the stream.
+ *
+ * Built with -DPARSERFUZZ_LIBFUZZER this is a libFuzzer target.  Otherwise
+ * it has a main reading the input from the files given, or from stdin,
+ * which suits AFL and reproducing crashes.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "parserdrive.h"
+
+#define FUZZ_FLUSH          0x01
+#define FUZZ_CODEC_DATA     0x02
+
+/* Small codec buffers, so the data moves around in the circular buffer */
+#define FUZZ_CHUNK_SIZE     4096
+
+int LLVMFuzzerTestOneInput(const guint8 *data, size_t size);
+
+/******************************************************************************
+ * fuzz_caps
+ ******************************************************************************/
+static GstCaps *fuzz_caps(const parserdrive_parser *parser,
+    const guint8 *codecData, gsize codecDataSize)
+{
+    GstCaps *caps = gst_caps_from_string(parser->caps);
+    GstBuffer *buf;
+
+    if (codecData) {
+        buf = gst_buffer_new_and_alloc(codecDataSize);
+        memcpy(GST_BUFFER_DATA(buf), codecData, codecDataSize);
+        if (!strcmp(parser->name, "h264")) {
+            gst_caps_set_simple(caps, "stream-format", G_TYPE_STRING, "avc",
+                NULL);
+        }
+        gst_caps_set_simple(caps, "codec_data", GST_TYPE_BUFFER, buf, NULL);
+        gst_buffer_unref(buf);
+    }
+
+    return caps;
+}
+
+/******************************************************************************
+ * LLVMFuzzerTestOneInput
+ ******************************************************************************/
+int LLVMFuzzerTestOneInput(const guint8 *data, size_t size)
+{
+    static gboolean initialized = FALSE;
+    static gint numParsers = 0;
+    const parserdrive_parser *parser;
+    parserdrive_stats stats = { 0, };
+    const guint8 *codecData = NULL;
+    gsize codecDataSize = 0, writes[4];
+    GstCaps *caps;
+    guint8 flags;
+    gint i;
+
+    if (!initialized) {
+        gst_init(NULL, NULL);
+        while (parserdrive_parsers[numParsers].name) {
+            numParsers++;
+        }
+        initialized = TRUE;
+    }
+
+    if (size < 2) {
+        return 0;
+    }
+
+    parser = &parserdrive_parsers[data[0] % numParsers];
+    flags = data[1];
+    data += 2;
+    size -= 2;
+
+    if ((flags & FUZZ_CODEC_DATA) && size > 0) {
+        codecDataSize = MIN(data[0], size - 1);
+        codecData = data + 1;
+        data += codecDataSize + 1;
+        size -= codecDataSize + 1;
+    }
+
+    /* Write sizes from 1 byte to several codec buffers */
+    for (i = 0; i < 4; i++) {
+        writes[i] = 1 + ((flags >> 2) * (i + 1) * 2654435761U >> 7) %
+            (3 * FUZZ_CHUNK_SIZE);
+    }
+
+    caps = fuzz_caps(parser, codecData, codecDataSize);
+    parserdrive_run(parser, caps, FUZZ_CHUNK_SIZE, data, size, writes, 4,
+        (flags & FUZZ_FLUSH) ? (gssize)size / 2 : -1, &stats);
+    gst_caps_unref(caps);
+
+    return 0;
+}
+
+#ifndef PARSERFUZZ_LIBFUZZER
+/******************************************************************************
+ * main
+ ******************************************************************************/
+int main(int argc, char *argv[])
+{
+    GByteArray *input;
+    guint8 buf[4096];
+    gchar *data;
+    gsize size, n;
+    gint i;
+
+    if (argc < 2) {
+        input = g_byte_array_new();
+        while ((n = fread(buf, 1, sizeof(buf), stdin)) > 0) {
+            g_byte_array_append(input, buf, n);
+        }
+        LLVMFuzzerTestOneInput(input->data, input->len);
+        g_byte_array_free(input, TRUE);
+        return 0;
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (!g_file_get_contents(argv[i], &data, &size, NULL)) {
+            fprintf(stderr, "failed to read %s\n", argv[i]);
+            return 1;
+        }
+        LLVMFuzzerTestOneInput((guint8 *)data, size);
+        g_free(data);
+    }
+
+    return 0;
+}
+#endif
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
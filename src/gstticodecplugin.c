@@ -29,7 +29,9 @@
 #endif
 
 #include <sys/resource.h>
+#include <sys/stat.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <gst/gst.h>
 
@@ -49,11 +51,11 @@
 #include "gsttisupport_aac.h"
 #include "gsttisupport_mp3.h"
 #include "gsttisupport_wma.h"
-#include "gsttisupport_g711.h"
 #include "gsttisupport_jpeg.h"
 #include "gsttidmairesizer.h"
 #include "gsttidmaiperf.h"
 #include "gsttidmaiaccel.h"
+#include "gsttidmaig711.h"
 #include "gsttipriority.h"
 #include "ti_encoders.h"
 #include "ti_decoders.h"
@@ -109,35 +111,237 @@ struct codec_custom_data_entry codec_custom_data[] = {
     { .codec_name = NULL },
 };
 
+/*
+ * Algorithm list of an engine, as reported by Codec Engine
+ */
+struct codec_registry_alg {
+    gchar *name;
+    gchar *type;
+};
+
+/*
+ * Cache of the algorithms provided by each engine, so the plugin doesn't
+ * walk the engine every time it's loaded.  The algorithm tables of the
+ * engines are linked into the plugin by the XDC configuration, and the
+ * remote ones come with the codec server image, so entries are keyed by
+ * the engine name, the identity of the plugin binary and the one of the
+ * server image, and probed again when either changes.  A relative server
+ * name is loaded from the current directory, so it's keyed on the path it
+ * resolves to as well.
+ * GST_TI_REGISTRY_CACHE overrides the cache file, an empty value disables
+ * the cache.
+ */
+static gchar *
+codec_registry_cache_file (void)
+{
+    const gchar *env = g_getenv ("GST_TI_REGISTRY_CACHE");
+
+    if (env)
+        return *env ? g_strdup (env) : NULL;
+
+    return g_build_filename (g_get_user_cache_dir (), "gst-ti-dmai",
+        "registry.cache", NULL);
+}
+
+static gchar *
+codec_registry_key (GstPlugin *TICodecPlugin, const gchar *engine)
+{
+    const gchar *filename = gst_plugin_get_filename (TICodecPlugin);
+    Engine_Desc desc;
+    struct stat st, serverSt;
+    gchar *serverPath, *key;
+
+    if (!filename || stat (filename, &st) != 0)
+        return NULL;
+
+    /* Local engines have no server image */
+    if (Engine_getDesc ((Char *) engine, &desc) != Engine_EOK ||
+        !desc.remoteName) {
+        return g_strdup_printf ("%s:%lu:%lu:%lu", filename,
+            (gulong) st.st_ino, (gulong) st.st_size, (gulong) st.st_mtime);
+    }
+
+    serverPath = realpath (desc.remoteName, NULL);
+    if (!serverPath)
+        return NULL;
+
+    if (stat (serverPath, &serverSt) != 0) {
+        free (serverPath);
+        return NULL;
+    }
+
+    key = g_strdup_printf ("%s:%lu:%lu:%lu:%s:%s:%lu:%lu", filename,
+        (gulong) st.st_ino, (gulong) st.st_size, (gulong) st.st_mtime,
+        desc.remoteName, serverPath, (gulong) serverSt.st_size,
+        (gulong) serverSt.st_mtime);
+    free (serverPath);
+
+    return key;
+}
+
+static GArray *
+codec_registry_load (GKeyFile *cache, const gchar *engine, const gchar *key)
+{
+    GArray *algs;
+    gchar *cachedKey;
+    gchar **names, **types;
+    gsize numNames, numTypes, i;
+
+    cachedKey = g_key_file_get_string (cache, engine, "key", NULL);
+    if (!cachedKey || strcmp (cachedKey, key)) {
+        g_free (cachedKey);
+        return NULL;
+    }
+    g_free (cachedKey);
+
+    names = g_key_file_get_string_list (cache, engine, "names", &numNames,
+        NULL);
+    types = g_key_file_get_string_list (cache, engine, "types", &numTypes,
+        NULL);
+    if (!names || !types || numNames != numTypes) {
+        g_strfreev (names);
+        g_strfreev (types);
+        return NULL;
+    }
+
+    algs = g_array_new (FALSE, FALSE, sizeof (struct codec_registry_alg));
+    for (i = 0; i < numNames; i++) {
+        struct codec_registry_alg alg;
+
+        /* Freed by the probe, or owned by the registered elements */
+        alg.name = names[i];
+        alg.type = types[i];
+        g_array_append_val (algs, alg);
+    }
+    g_free (names);
+    g_free (types);
+
+    return algs;
+}
+
+static GArray *
+codec_registry_probe (const gchar *engine)
+{
+    GArray *algs = g_array_new (FALSE, FALSE,
+        sizeof (struct codec_registry_alg));
+    Engine_AlgInfo algoname;
+    gint numalgo = 0, i;
+
+    /* Get the algorithms from Codec Engine */
+    algoname.algInfoSize = sizeof(Engine_AlgInfo); 
+    Engine_getNumAlgs ((Char *) engine, &numalgo);
+
+    for (i = 0; i < numalgo; i++) {
+        struct codec_registry_alg alg;
+
+        /* Get the algo info */
+        Engine_getAlgInfo ((Char *) engine, &algoname, i);
+        alg.name = g_strdup (algoname.name);
+        alg.type = g_strdup (*algoname.typeTab);
+        g_array_append_val (algs, alg);
+    }
+
+    return algs;
+}
+
+static void
+codec_registry_store (const gchar *filename, GKeyFile *cache,
+    const gchar *engine, const gchar *key, GArray *algs)
+{
+    const gchar **names = g_new0 (const gchar *, algs->len + 1);
+    const gchar **types = g_new0 (const gchar *, algs->len + 1);
+    gchar *dir, *data;
+    gsize length;
+    guint i;
+
+    for (i = 0; i < algs->len; i++) {
+        names[i] = g_array_index (algs, struct codec_registry_alg, i).name;
+        types[i] = g_array_index (algs, struct codec_registry_alg, i).type;
+    }
+
+    g_key_file_set_string (cache, engine, "key", key);
+    g_key_file_set_string_list (cache, engine, "names", names, algs->len);
+    g_key_file_set_string_list (cache, engine, "types", types, algs->len);
+    g_free (names);
+    g_free (types);
+
+    dir = g_path_get_dirname (filename);
+    g_mkdir_with_parents (dir, 0755);
+    g_free (dir);
+
+    data = g_key_file_to_data (cache, &length, NULL);
+    if (!g_file_set_contents (filename, data, length, NULL)) {
+        GST_WARNING ("Failed to write the codec registry cache %s", filename);
+    }
+    g_free (data);
+}
+
+/*
+ * Returns the algorithms of the engine, from the cache if it's valid or
+ * from Codec Engine otherwise
+ */
+static GArray *
+codec_registry_get (GstPlugin *TICodecPlugin, const gchar *engine)
+{
+    gchar *filename = codec_registry_cache_file ();
+    gchar *key = codec_registry_key (TICodecPlugin, engine);
+    GKeyFile *cache = g_key_file_new ();
+    GArray *algs = NULL;
+
+    if (filename && key) {
+        g_key_file_load_from_file (cache, filename, G_KEY_FILE_NONE, NULL);
+        algs = codec_registry_load (cache, engine, key);
+    }
+
+    if (algs) {
+        GST_INFO ("Using the cached algorithms of engine %s", engine);
+    } else {
+        GST_INFO ("Probing the algorithms of engine %s", engine);
+        algs = codec_registry_probe (engine);
+        if (filename && key)
+            codec_registry_store (filename, cache, engine, key, algs);
+    }
+
+    g_key_file_free (cache);
+    g_free (key);
+    g_free (filename);
+
+    return algs;
+}
+
 static gboolean
 probe_codec_server_decoders (GstPlugin *TICodecPlugin)
 {
     GstTIDmaidecData *decoder = NULL;
+    GArray *algs;
     gint numalgo;
     gint xdm_ver;
-    Engine_AlgInfo algoname;
+    struct codec_registry_alg algoname;
     enum dmai_codec_type mediaType;
 
     /* Get the algorithms from Codec Engine */
-    algoname.algInfoSize = sizeof(Engine_AlgInfo); 
-    Engine_getNumAlgs (DECODEENGINE, &numalgo);
+    algs = codec_registry_get (TICodecPlugin, DECODEENGINE);
+    numalgo = algs->len;
 
     while (numalgo != 0) {
         numalgo--;
 
         /* Get the algo info */
-        Engine_getAlgInfo (DECODEENGINE, &algoname, numalgo);
+        algoname = g_array_index (algs, struct codec_registry_alg, numalgo);
 
-        if (g_strstr_len (*algoname.typeTab, 100, "DEC2")) {
+        if (g_strstr_len (algoname.type, 100, "DEC2")) {
             xdm_ver = 2;
-        } else if (g_strstr_len (*algoname.typeTab, 100, "DEC1")) {
+        } else if (g_strstr_len (algoname.type, 100, "DEC1")) {
             xdm_ver = 1;
-        } else if (g_strstr_len (*algoname.typeTab, 100, "DEC")) {
+        } else if (g_strstr_len (algoname.type, 100, "DEC")) {
             xdm_ver = 0;
         } else {
             /* Nothing we handle, maybe an encoder */
+            g_free (algoname.name);
+            g_free (algoname.type);
             continue;
         }
+        g_free (algoname.type);
         decoder = g_malloc0 (sizeof (GstTIDmaidecData));
         decoder->codecName = algoname.name;
         decoder->engineName = DECODEENGINE;
@@ -159,6 +363,7 @@ probe_codec_server_decoders (GstPlugin *TICodecPlugin)
             decoder->streamtype = "mpeg2";
             decoder->sinkCaps = &gstti_mpeg2_caps;
             decoder->parser = &gstti_mpeg2_parser;
+            decoder->stream_ops = &gstti_mpeg2_stream_dec_ops;
         } else if (!strcmp (decoder->codecName, "aachedec") ||
                 !strcmp (decoder->codecName, "aaclcdec")) {
             mediaType = AUDIO;
@@ -170,7 +375,7 @@ probe_codec_server_decoders (GstPlugin *TICodecPlugin)
             mediaType = AUDIO;
             decoder->streamtype = "mp3";
             decoder->sinkCaps = &gstti_mp3_sink_caps;
-            decoder->parser = &gstti_generic_parser;
+            decoder->parser = &gstti_mp3_parser;
         } else if (!strcmp (decoder->codecName, "wmadec")) {
             mediaType = AUDIO;
             decoder->streamtype = "wma";
@@ -206,20 +411,14 @@ probe_codec_server_decoders (GstPlugin *TICodecPlugin)
             /* Now register the element */
             if (!register_dmai_decoder(TICodecPlugin,vdecoder)){
                 g_warning("Failed to register one decoder, aborting");
+                g_array_free (algs, TRUE);
                 return FALSE;
             }
-
-#if 0
-        } else if (!strcmp (decoder->codecName, "g711dec")) {
-            decoder->streamtype = "g711";
-            mediaType = AUDIO;
-            decoder->sinkCaps = &gstti_g711_caps;
-            decoder->parser = &gstti_generic_parser;
-#endif
         } else {
            GST_WARNING ("Element not provided for codec: %s",
                decoder->codecName);
            g_free(decoder);
+           g_free(algoname.name);
            continue;
         }
 
@@ -271,9 +470,11 @@ probe_codec_server_decoders (GstPlugin *TICodecPlugin)
         /* Now register the element */
         if (!register_dmai_decoder(TICodecPlugin,decoder)){
             g_warning("Failed to register one decoder, aborting");
+            g_array_free (algs, TRUE);
             return FALSE;
         }
     }
+    g_array_free (algs, TRUE);
     return TRUE;
 }
 
@@ -281,29 +482,33 @@ static gboolean
 probe_codec_server_encoders (GstPlugin *TICodecPlugin)
 {
     GstTIDmaiencData *encoder;
+    GArray *algs;
     gint numalgo;
     gint xdm_ver;
-    Engine_AlgInfo algoname;
+    struct codec_registry_alg algoname;
     enum dmai_codec_type mediaType;
 
     /* Get the algorithms from Codec Engine */
-    algoname.algInfoSize = sizeof(Engine_AlgInfo); 
-    Engine_getNumAlgs (ENCODEENGINE, &numalgo);
+    algs = codec_registry_get (TICodecPlugin, ENCODEENGINE);
+    numalgo = algs->len;
 
     while (numalgo != 0) {
         numalgo--;
 
         /* Get the algo info */
-        Engine_getAlgInfo (ENCODEENGINE, &algoname, numalgo);
+        algoname = g_array_index (algs, struct codec_registry_alg, numalgo);
 
-        if (g_strstr_len (*algoname.typeTab, 100, "ENC1")) {
+        if (g_strstr_len (algoname.type, 100, "ENC1")) {
             xdm_ver = 1;
-        } else if (g_strstr_len (*algoname.typeTab, 100, "ENC")) {
+        } else if (g_strstr_len (algoname.type, 100, "ENC")) {
             xdm_ver = 0;
         } else {
             /* Nothing we handle, maybe an decoder */
+            g_free (algoname.name);
+            g_free (algoname.type);
             continue;
         }
+        g_free (algoname.type);
         encoder = g_malloc0 (sizeof (GstTIDmaiencData));
         encoder->codecName = algoname.name;
         encoder->engineName = ENCODEENGINE;
@@ -336,13 +541,6 @@ probe_codec_server_encoders (GstPlugin *TICodecPlugin)
             mediaType = AUDIO;
             encoder->streamtype = "wma";
             encoder->srcCaps = &gstti_wma_caps;
-#if 0
-        } else if (!strcmp (encoder->codecName, "g711enc")) {
-            mediaType = AUDIO;
-            encoder->streamtype = "g711";
-            encoder->srcCaps = &gstti_g711_caps;
-            continue;
-#endif
         } else if (!strcmp (encoder->codecName, "jpegenc")) {
             GstTIDmaiencData *vencoder;
 
@@ -371,12 +569,14 @@ probe_codec_server_encoders (GstPlugin *TICodecPlugin)
             /* Now register the element */
             if (!register_dmai_encoder(TICodecPlugin,vencoder)){
                 g_warning("Failed to register one encoder, aborting");
+                g_array_free (algs, TRUE);
                 return FALSE;
             }
         } else {
             GST_WARNING ("Element not provided for codec: %s",
                 encoder->codecName);
             g_free(encoder);
+            g_free(algoname.name);
             continue;
         }
 
@@ -433,9 +633,11 @@ probe_codec_server_encoders (GstPlugin *TICodecPlugin)
         /* Now register the element */
         if (!register_dmai_encoder(TICodecPlugin,encoder)){
             g_warning("Failed to register one encoder, aborting");
+            g_array_free (algs, TRUE);
             return FALSE;
         }
     }
+    g_array_free (algs, TRUE);
     return TRUE;
 }
 
@@ -460,6 +662,15 @@ TICodecPlugin_init (GstPlugin * TICodecPlugin)
         return FALSE;
     }
 
+    /* Native g711, the codec server speech codecs aren't supported */
+    if (!gst_element_register(TICodecPlugin, "dmaidec_g711",
+        GST_RANK_PRIMARY,GST_TYPE_TIDMAIG711DEC))
+        return FALSE;
+
+    if (!gst_element_register(TICodecPlugin, "dmaienc_g711",
+        GST_RANK_PRIMARY,GST_TYPE_TIDMAIG711ENC))
+        return FALSE;
+
     if (!gst_element_register(TICodecPlugin, "dmaiaccel",
         GST_RANK_PRIMARY,GST_TYPE_TIDMAIACCEL))
         return FALSE;
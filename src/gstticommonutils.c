@@ -20,6 +20,7 @@
  */
 
 #include <gst/gst.h>
+#include <pthread.h>
 #include <stdlib.h>
 #include <string.h>
 
@@ -30,6 +31,7 @@
 #include <ti/sdo/dmai/priv/_Buffer.h>
 
 #include "gsttidmaibuffertransport.h"
+#include "gstticommonutils.h"
 
 /* This variable is used to flush the fifo.  It is pushed to the
  * fifo when we want to flush it.  When the encode/decode thread
@@ -165,6 +167,167 @@ gboolean gst_ti_blackFill(Buffer_Handle hBuf)
     return TRUE;
 }
 
+/*******************************************************************************
+ * gst_ti_memcpy
+ * Copies a frame out of non contiguous memory, where the EDMA can't be used.
+ * On the Cortex-A8 parts it moves 64 bytes per iteration with NEON,
+ * prefetching ahead of the source.
+ *******************************************************************************/
+void gst_ti_memcpy(void *dst, const void *src, gsize size)
+{
+#if ((PLATFORM == omap35x) || (PLATFORM == dm37x)) && defined(__ARM_NEON__)
+    gsize blocks = size / 64;
+
+    if (blocks && !(((guint32) dst | (guint32) src) & 0x7)) {
+        gsize done = blocks * 64;
+
+        __asm__ __volatile__ (
+            "1:                                     \n"
+            "pld        [%[src], #192]              \n"
+            "vld1.64    {d0-d3}, [%[src]]!          \n"
+            "vld1.64    {d4-d7}, [%[src]]!          \n"
+            "subs       %[blocks], %[blocks], #1    \n"
+            "vst1.64    {d0-d3}, [%[dst]]!          \n"
+            "vst1.64    {d4-d7}, [%[dst]]!          \n"
+            "bne        1b                          \n"
+            : [dst] "+r" (dst), [src] "+r" (src), [blocks] "+r" (blocks)
+            :
+            : "cc", "memory", "d0", "d1", "d2", "d3", "d4", "d5", "d6", "d7");
+
+        size -= done;
+    }
+#endif
+    memcpy(dst, src, size);
+}
+
+/* Engines opened by the elements of the process, shared by name */
+struct gst_ti_engine {
+    gchar           *name;
+    Engine_Handle   hEngine;
+    gint            refcount;
+    pthread_mutex_t lock;
+};
+
+static GSList *engines = NULL;
+static pthread_mutex_t engines_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+static struct gst_ti_engine *gst_ti_engine_find(Engine_Handle hEngine)
+{
+    GSList *e;
+
+    for (e = engines; e; e = g_slist_next(e)) {
+        if (((struct gst_ti_engine *)e->data)->hEngine == hEngine)
+            return (struct gst_ti_engine *)e->data;
+    }
+    return NULL;
+}
+
+/******************************************************************************
+ * gst_ti_engine_open
+ *    Get a handle of the named engine.  The first caller opens it, the
+ *    rest of the elements in the process share the same handle, saving
+ *    the setup of the link with the codec server on every open.
+ *****************************************************************************/
+Engine_Handle gst_ti_engine_open(const gchar *name)
+{
+    struct gst_ti_engine *engine = NULL;
+    Engine_Handle hEngine;
+    GSList *e;
+
+    pthread_mutex_lock(&engines_mutex);
+    for (e = engines; e; e = g_slist_next(e)) {
+        if (!strcmp(((struct gst_ti_engine *)e->data)->name, name)) {
+            engine = (struct gst_ti_engine *)e->data;
+            break;
+        }
+    }
+
+    if (!engine) {
+        hEngine = Engine_open((Char *) name, NULL, NULL);
+        if (hEngine == NULL) {
+            pthread_mutex_unlock(&engines_mutex);
+            return NULL;
+        }
+
+        engine = g_malloc0(sizeof(struct gst_ti_engine));
+        engine->name = g_strdup(name);
+        engine->hEngine = hEngine;
+        pthread_mutex_init(&engine->lock, NULL);
+        engines = g_slist_prepend(engines, engine);
+    }
+    engine->refcount++;
+    hEngine = engine->hEngine;
+    pthread_mutex_unlock(&engines_mutex);
+
+    return hEngine;
+}
+
+/******************************************************************************
+ * gst_ti_engine_close
+ *    Release a handle from gst_ti_engine_open, the engine is closed when
+ *    the last user releases it.
+ *****************************************************************************/
+void gst_ti_engine_close(Engine_Handle hEngine)
+{
+    struct gst_ti_engine *engine;
+
+    pthread_mutex_lock(&engines_mutex);
+    engine = gst_ti_engine_find(hEngine);
+    if (!engine) {
+        pthread_mutex_unlock(&engines_mutex);
+        g_warning("Closing an engine handle that is not open");
+        return;
+    }
+
+    if (--engine->refcount == 0) {
+        engines = g_slist_remove(engines, engine);
+        Engine_close(engine->hEngine);
+        pthread_mutex_destroy(&engine->lock);
+        g_free(engine->name);
+        g_free(engine);
+    }
+    pthread_mutex_unlock(&engines_mutex);
+}
+
+/******************************************************************************
+ * gst_ti_engine_lock
+ *    Engine handles are not thread safe, and with remote codecs every VISA
+ *    call (create, delete, process, control) goes through the message
+ *    queues of the engine handle.  Since the handle is shared by all the
+ *    elements using the same engine, every one of those calls must hold
+ *    this lock.  The price is that codecs on the same engine no longer run
+ *    their process calls in parallel: each element waits for the others'
+ *    calls to finish, which on a remote server was mostly the case anyway,
+ *    since the DSP runs one algorithm at a time.
+ *****************************************************************************/
+void gst_ti_engine_lock(Engine_Handle hEngine)
+{
+    struct gst_ti_engine *engine;
+
+    pthread_mutex_lock(&engines_mutex);
+    engine = gst_ti_engine_find(hEngine);
+    pthread_mutex_unlock(&engines_mutex);
+
+    /* The caller holds a reference, so the engine can't go away */
+    if (engine)
+        pthread_mutex_lock(&engine->lock);
+}
+
+/******************************************************************************
+ * gst_ti_engine_unlock
+ *****************************************************************************/
+void gst_ti_engine_unlock(Engine_Handle hEngine)
+{
+    struct gst_ti_engine *engine;
+
+    pthread_mutex_lock(&engines_mutex);
+    engine = gst_ti_engine_find(hEngine);
+    pthread_mutex_unlock(&engines_mutex);
+
+    if (engine)
+        pthread_mutex_unlock(&engine->lock);
+}
+
 /******************************************************************************
  * Custom ViM Settings for editing this file
  ******************************************************************************/
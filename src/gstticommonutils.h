@@ -30,6 +30,8 @@
 #include <ti/sdo/dmai/Buffer.h>
 #include <ti/sdo/dmai/BufferGfx.h>
 
+#include <ti/sdo/ce/Engine.h>
+
 #define undefined 0
 #define dm355   1
 #define dm6446  2
@@ -84,6 +86,15 @@ gint gst_ti_calculate_bufSize (gint width, gint height,
 /* Function to black fill a buffer*/
 gboolean gst_ti_blackFill(Buffer_Handle hBuf);
 
+/* Function to copy a frame from non contiguous memory */
+void gst_ti_memcpy(void *dst, const void *src, gsize size);
+
+/* Functions to share the engine handles among the elements */
+Engine_Handle gst_ti_engine_open(const gchar *name);
+void gst_ti_engine_close(Engine_Handle hEngine);
+void gst_ti_engine_lock(Engine_Handle hEngine);
+void gst_ti_engine_unlock(Engine_Handle hEngine);
+
 #ifdef GLIB_2_31_AND_UP  
     #define GMUTEX_LOCK(mutex) g_mutex_lock(&mutex)
 #else
@@ -37,11 +37,33 @@
 
 #include "gsttidmaiaccel.h"
 #include "gsttidmaibuffertransport.h"
+#include "gstticommonutils.h"
 
 /* Declare variable used to categorize GST_LOG output */
 GST_DEBUG_CATEGORY_STATIC (gst_tidmaiaccel_debug);
 #define GST_CAT_DEFAULT gst_tidmaiaccel_debug
 
+/* Element property identifiers */
+enum
+{
+  PROP_0,
+  PROP_NUM_BUFS,
+  PROP_MAX_BUFS
+};
+
+/* Registration of a contiguous buffer, held while output buffers pointing
+ * to it are alive. The table outlives the elements, since the output
+ * buffers may be released after stop.
+ */
+struct dmaiaccel_contig_buf {
+    UInt32  phys;
+    Int32   size;
+    gint    refs;
+};
+
+static GHashTable *contig_bufs = NULL;
+G_LOCK_DEFINE_STATIC(contig_bufs);
+
 static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE(
     "sink",
     GST_PAD_SINK,
@@ -70,6 +92,10 @@ static gboolean gst_tidmaiaccel_set_caps (GstBaseTransform *trans,
 static GstFlowReturn gst_tidmaiaccel_prepare_output_buffer (GstBaseTransform
     *trans, GstBuffer *inBuf, gint size, GstCaps *caps, GstBuffer **outBuf);
 static gboolean gst_tidmaiaccel_stop (GstBaseTransform *trans);
+static void gst_tidmaiaccel_set_property (GObject *object, guint prop_id,
+    const GValue *value, GParamSpec *pspec);
+static void gst_tidmaiaccel_get_property (GObject *object, guint prop_id,
+    GValue *value, GParamSpec *pspec);
 
 /******************************************************************************
  * gst_tidmaiaccel_init
@@ -81,6 +107,11 @@ static void gst_tidmaiaccel_init (GstTIDmaiaccel *dmaiaccel)
     dmaiaccel->width = 0;
     dmaiaccel->height = 0;
     dmaiaccel->bufTabAllocated = FALSE;
+    dmaiaccel->numBufs = 2;
+    dmaiaccel->maxBufs = 8;
+    dmaiaccel->poolStats = NULL;
+    pthread_mutex_init(&dmaiaccel->bufTabMutex, NULL);
+    pthread_cond_init(&dmaiaccel->bufTabCond, NULL);
 }
 
 
@@ -153,11 +184,30 @@ static void gst_tidmaiaccel_base_init(gpointer gclass)
  ******************************************************************************/
 static void gst_tidmaiaccel_class_init(GstTIDmaiaccelClass *klass)
 {
+    GObjectClass            *gobject_class;
     GstBaseTransformClass   *trans_class;
 
+    gobject_class    = (GObjectClass *) klass;
     trans_class      = (GstBaseTransformClass *) klass;
 
     GST_LOG("Begin\n");
+    gobject_class->set_property = gst_tidmaiaccel_set_property;
+    gobject_class->get_property = gst_tidmaiaccel_get_property;
+
+    g_object_class_install_property(gobject_class, PROP_NUM_BUFS,
+        g_param_spec_int("numBufs",
+            "Number of buffers",
+            "Number of contiguous buffers allocated to copy non contiguous "
+            "input buffers",
+            1, G_MAXINT32, 2, G_PARAM_READWRITE));
+
+    g_object_class_install_property(gobject_class, PROP_MAX_BUFS,
+        g_param_spec_int("maxBufs",
+            "Maximum number of buffers",
+            "Maximum number of contiguous buffers, the pool grows up to this "
+            "size before waiting for downstream to release a buffer",
+            1, G_MAXINT32, 8, G_PARAM_READWRITE));
+
     trans_class->transform = GST_DEBUG_FUNCPTR(gst_tidmaiaccel_transform);
     trans_class->set_caps  = GST_DEBUG_FUNCPTR(gst_tidmaiaccel_set_caps);
     trans_class->stop = GST_DEBUG_FUNCPTR(gst_tidmaiaccel_stop);
@@ -169,6 +219,110 @@ static void gst_tidmaiaccel_class_init(GstTIDmaiaccelClass *klass)
     GST_LOG("Finish\n");
 }
 
+/******************************************************************************
+ * gst_tidmaiaccel_set_property
+ *****************************************************************************/
+static void gst_tidmaiaccel_set_property (GObject *object, guint prop_id,
+    const GValue *value, GParamSpec *pspec)
+{
+    GstTIDmaiaccel *dmaiaccel = GST_TIDMAIACCEL(object);
+
+    switch (prop_id) {
+    case PROP_NUM_BUFS:
+        dmaiaccel->numBufs = g_value_get_int(value);
+        break;
+    case PROP_MAX_BUFS:
+        dmaiaccel->maxBufs = g_value_get_int(value);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+/******************************************************************************
+ * gst_tidmaiaccel_get_property
+ *****************************************************************************/
+static void gst_tidmaiaccel_get_property (GObject *object, guint prop_id,
+    GValue *value, GParamSpec *pspec)
+{
+    GstTIDmaiaccel *dmaiaccel = GST_TIDMAIACCEL(object);
+
+    switch (prop_id) {
+    case PROP_NUM_BUFS:
+        g_value_set_int(value, dmaiaccel->numBufs);
+        break;
+    case PROP_MAX_BUFS:
+        g_value_set_int(value, dmaiaccel->maxBufs);
+        break;
+    default:
+        G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+        break;
+    }
+}
+
+/******************************************************************************
+ * gst_tidmaiaccel_register_contig_buf
+ *    Registers a contiguous buffer, or takes one more reference on its
+ *    registration if it is already in use by another output buffer
+ *****************************************************************************/
+static void gst_tidmaiaccel_register_contig_buf (GstBuffer *inBuf,
+    UInt32 phys)
+{
+    struct dmaiaccel_contig_buf *contig;
+    gpointer key = GST_BUFFER_DATA(inBuf);
+
+    G_LOCK(contig_bufs);
+    if (!contig_bufs) {
+        contig_bufs = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+            NULL, g_free);
+    }
+
+    contig = g_hash_table_lookup(contig_bufs, key);
+    if (contig && contig->phys == phys &&
+        contig->size == GST_BUFFER_SIZE(inBuf)) {
+        contig->refs++;
+        G_UNLOCK(contig_bufs);
+        return;
+    }
+
+    if (contig) {
+        /* The memory on this address was replaced */
+        Memory_unregisterContigBuf(GPOINTER_TO_UINT(key), contig->size);
+    }
+
+    GST_DEBUG("Registering contiguous buffer %p, physical address 0x%x",
+        key, (guint) phys);
+    Memory_registerContigBuf((UInt32)key, GST_BUFFER_SIZE(inBuf), phys);
+
+    contig = g_malloc(sizeof(struct dmaiaccel_contig_buf));
+    contig->phys = phys;
+    contig->size = GST_BUFFER_SIZE(inBuf);
+    contig->refs = 1;
+    g_hash_table_insert(contig_bufs, key, contig);
+    G_UNLOCK(contig_bufs);
+}
+
+/******************************************************************************
+ * gst_tidmaiaccel_unregister_contig_buf
+ *    Drops a reference on a registration, and unregisters the buffer once
+ *    no output buffer points to it. Upstream may free the memory after that,
+ *    and a new allocation on the same address must not look contiguous.
+ *****************************************************************************/
+static void gst_tidmaiaccel_unregister_contig_buf (gpointer key)
+{
+    struct dmaiaccel_contig_buf *contig;
+
+    G_LOCK(contig_bufs);
+    contig = contig_bufs ? g_hash_table_lookup(contig_bufs, key) : NULL;
+    if (contig && --contig->refs == 0) {
+        GST_DEBUG("Unregistering contiguous buffer %p", key);
+        Memory_unregisterContigBuf(GPOINTER_TO_UINT(key), contig->size);
+        g_hash_table_remove(contig_bufs, key);
+    }
+    G_UNLOCK(contig_bufs);
+}
+
 /******************************************************************************
  * gst_tidmaiaccel_stop
  *****************************************************************************/
@@ -185,6 +339,11 @@ static gboolean gst_tidmaiaccel_stop (GstBaseTransform *trans)
 
     dmaiaccel->bufTabAllocated = FALSE;
 
+    if (dmaiaccel->poolStats){
+        gst_tidmaitelemetry_pool_release(dmaiaccel->poolStats);
+        dmaiaccel->poolStats = NULL;
+    }
+
     GST_LOG("Finish\n");
 
     return TRUE;
@@ -250,8 +409,7 @@ void dmaiaccel_release_cb(gpointer data,
 
     GST_DEBUG("Release callback for dmaiaccel allocated buffer");
 
-    Memory_unregisterContigBuf((UInt32)Buffer_getUserPtr(hBuf),
-        Buffer_getSize(hBuf));
+    gst_tidmaiaccel_unregister_contig_buf(Buffer_getUserPtr(hBuf));
 
     /* Now we can release our input buffer */
     gst_buffer_unref(inBuf);
@@ -279,8 +437,7 @@ static GstFlowReturn gst_tidmaiaccel_prepare_output_buffer (GstBaseTransform
     if (isContiguous && dmaiaccel->width){
         GST_DEBUG("Is contiguous video buffer");
 
-        Memory_registerContigBuf((UInt32)GST_BUFFER_DATA(inBuf),
-            GST_BUFFER_SIZE(inBuf),phys);
+        gst_tidmaiaccel_register_contig_buf(inBuf, phys);
         /* This is a contiguous buffer, create a dmai buffer transport */
         BufferGfx_Attrs gfxAttrs    = BufferGfx_Attrs_DEFAULT;
 
@@ -296,6 +453,8 @@ static GstFlowReturn gst_tidmaiaccel_prepare_output_buffer (GstBaseTransform
         Buffer_setUserPtr(hOutBuf, (Int8*)GST_BUFFER_DATA(inBuf));
         Buffer_setNumBytesUsed(hOutBuf, GST_BUFFER_SIZE(inBuf));
         *outBuf = gst_tidmaibuffertransport_new(hOutBuf, NULL, NULL, FALSE);
+        gst_tidmaibuffertransport_set_owner(
+            (GstTIDmaiBufferTransport *)*outBuf, GST_ELEMENT(dmaiaccel));
         gst_buffer_set_data(*outBuf, (guint8*) Buffer_getUserPtr(hOutBuf),
             Buffer_getSize(hOutBuf));
         gst_buffer_copy_metadata(*outBuf,inBuf,GST_BUFFER_COPY_ALL);
@@ -311,6 +470,9 @@ static GstFlowReturn gst_tidmaiaccel_prepare_output_buffer (GstBaseTransform
 
         return GST_FLOW_OK;
     } else {
+        GstClockTime waitStart;
+        gchar *name;
+
         GST_DEBUG("Copying into contiguous video buffer");
         /* This is a contiguous buffer, create a dmai buffer transport */
         if (!dmaiaccel->bufTabAllocated){
@@ -323,40 +485,63 @@ static GstFlowReturn gst_tidmaiaccel_prepare_output_buffer (GstBaseTransform
             gfxAttrs.dim.lineLength     = dmaiaccel->lineLength;
 
             dmaiaccel->hOutBufTab =
-                        BufTab_create(2, GST_BUFFER_SIZE(inBuf),
+                        BufTab_create(dmaiaccel->numBufs,
+                            GST_BUFFER_SIZE(inBuf),
                             BufferGfx_getBufferAttrs(&gfxAttrs));
-            pthread_mutex_init(&dmaiaccel->bufTabMutex, NULL);
-            pthread_cond_init(&dmaiaccel->bufTabCond, NULL);
             if (dmaiaccel->hOutBufTab == NULL) {
                 GST_ELEMENT_ERROR(dmaiaccel,RESOURCE,NO_SPACE_LEFT,(NULL),
                     ("failed to create output buffer tab"));
                 return GST_FLOW_ERROR;
             }
             dmaiaccel->bufTabAllocated = TRUE;
+
+            name = g_strdup_printf("%s:copy", GST_ELEMENT_NAME(dmaiaccel));
+            dmaiaccel->poolStats = gst_tidmaitelemetry_pool_new(name, "bufs",
+                dmaiaccel->numBufs);
+            g_free(name);
+        }
+
+        if (GST_BUFFER_SIZE(inBuf) >
+            Buffer_getSize(BufTab_getBuf(dmaiaccel->hOutBufTab, 0))) {
+            GST_ELEMENT_ERROR(dmaiaccel,STREAM,FAILED,(NULL),
+                ("input buffer is bigger than the contiguous buffers"));
+            return GST_FLOW_ERROR;
         }
 
         pthread_mutex_lock(&dmaiaccel->bufTabMutex);
-        hOutBuf = BufTab_getFreeBuf(dmaiaccel->hOutBufTab);
-        if (hOutBuf == NULL) {
+        while ((hOutBuf = BufTab_getFreeBuf(dmaiaccel->hOutBufTab)) == NULL) {
+            if (BufTab_getNumBufs(dmaiaccel->hOutBufTab) < dmaiaccel->maxBufs) {
+                /* Downstream is holding all our buffers, grow the pool */
+                GST_INFO("Expanding bufTab to %d buffers",
+                    (int)BufTab_getNumBufs(dmaiaccel->hOutBufTab) + 1);
+                if (BufTab_expand(dmaiaccel->hOutBufTab, 1) < 0) {
+                    GST_ELEMENT_ERROR(dmaiaccel,RESOURCE,NO_SPACE_LEFT,(NULL),
+                        ("failed to expand the contiguous buffer tab"));
+                    pthread_mutex_unlock(&dmaiaccel->bufTabMutex);
+                    return GST_FLOW_ERROR;
+                }
+                continue;
+            }
+
             GST_INFO("Failed to get free buffer, waiting on bufTab\n");
+            waitStart = gst_util_get_timestamp();
             pthread_cond_wait(&dmaiaccel->bufTabCond, &dmaiaccel->bufTabMutex);
-
-            hOutBuf = BufTab_getFreeBuf(dmaiaccel->hOutBufTab);
-
-            if (hOutBuf == NULL) {
-                GST_ELEMENT_ERROR(dmaiaccel,RESOURCE,NO_SPACE_LEFT,(NULL),
-                    ("failed to get a free contiguous buffer from BufTab"));
-                pthread_mutex_unlock(&dmaiaccel->bufTabMutex);
-                return GST_FLOW_ERROR;
-            }
+            gst_tidmaitelemetry_blocked(dmaiaccel->poolStats,
+                gst_util_get_timestamp() - waitStart);
         }
+        gst_tidmaitelemetry_update_buftab(dmaiaccel->poolStats,
+            dmaiaccel->hOutBufTab);
         pthread_mutex_unlock(&dmaiaccel->bufTabMutex);
 
-        memcpy(Buffer_getUserPtr(hOutBuf),GST_BUFFER_DATA(inBuf),
+        gst_ti_memcpy(Buffer_getUserPtr(hOutBuf),GST_BUFFER_DATA(inBuf),
             GST_BUFFER_SIZE(inBuf));
         Buffer_setNumBytesUsed(hOutBuf, GST_BUFFER_SIZE(inBuf));
         *outBuf = gst_tidmaibuffertransport_new(hOutBuf, &dmaiaccel->bufTabMutex,
             &dmaiaccel->bufTabCond, FALSE);
+        gst_tidmaibuffertransport_set_pool_stats(
+            (GstTIDmaiBufferTransport *)*outBuf, dmaiaccel->poolStats);
+        gst_tidmaibuffertransport_set_owner(
+            (GstTIDmaiBufferTransport *)*outBuf, GST_ELEMENT(dmaiaccel));
         gst_buffer_set_data(*outBuf, (guint8*) Buffer_getUserPtr(hOutBuf),
             Buffer_getSize(hOutBuf));
         gst_buffer_copy_metadata(*outBuf,inBuf,GST_BUFFER_COPY_ALL);
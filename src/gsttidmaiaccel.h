@@ -27,6 +27,8 @@
 #include <gst/base/gstbasetransform.h>
 #include <ti/sdo/dmai/BufTab.h>
 
+#include "gsttidmaitelemetry.h"
+
 G_BEGIN_DECLS
 
 /* Standard macros for manipulating TIDmaiaccel objects */
@@ -57,10 +59,15 @@ struct _GstTIDmaiaccel
   ColorSpace_Type     colorSpace;
   gint                lineLength;
 
+  /* Pool used to copy non contiguous buffers. It starts with numBufs and
+   * grows up to maxBufs before waiting for downstream to release one */
   BufTab_Handle       hOutBufTab;
   pthread_mutex_t     bufTabMutex;
   pthread_cond_t      bufTabCond;
   gboolean            bufTabAllocated;
+  gint                numBufs;
+  gint                maxBufs;
+  GstTIDmaiPoolStats  *poolStats;
 };
 
 /* _GstTIDmaiaccelClass object */
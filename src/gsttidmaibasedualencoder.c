@@ -545,14 +545,11 @@ gst_tidmai_base_dualencoder_init_engine(GstTIDmaiBaseDualEncoder *base_dualencod
   /* Initialize the codec engine run time */
   CERuntime_init ();
   
-  /* Init the engine handler */
-  Engine_Error *engine_error = NULL;
-  base_dualencoder->engine_handle =
-      Engine_open ("codecServer", NULL, engine_error);
-
-  if (engine_error != Engine_EOK) {
-    GST_WARNING_OBJECT (base_dualencoder, "Problems in Engine_open with code: %d",
-        (int)engine_error);
+  /* Init the engine handler, shared with the other elements */
+  base_dualencoder->engine_handle = gst_ti_engine_open ("codecServer");
+
+  if (base_dualencoder->engine_handle == NULL) {
+    GST_WARNING_OBJECT (base_dualencoder, "Problems in Engine_open");
     return FALSE;
   }
   
@@ -566,7 +563,8 @@ gboolean
 gst_tidmai_base_dualencoder_finalize_engine(GstTIDmaiBaseDualEncoder *base_dualencoder) {
   
   /* Close the engine handler */
-  Engine_close ((Engine_Handle) base_dualencoder->engine_handle);
+  gst_ti_engine_close ((Engine_Handle) base_dualencoder->engine_handle);
+  base_dualencoder->engine_handle = NULL;
   
   /* Exit the codec engine run time */
   CERuntime_exit ();
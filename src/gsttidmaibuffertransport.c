@@ -17,6 +17,14 @@
  * DMAI it can access the DMAI buffer directly via the
  * GST_TIDMAIBUFFERTRANSPORT_DMAIBUF() macro.
  *
+ * Setting GST_TIDMAI_TRACE=<age in ms> in the environment enables a tracer
+ * of the live transport buffers, to find who holds the buffers when a
+ * pipeline stalls.  The oldest outstanding buffers, with their creation
+ * site, owner element and age, are dumped to stderr when one of them gets
+ * older than the given age (0 disables this check) or when the process
+ * gets a SIGUSR2.  Both are handled by a watchdog thread, so they work
+ * when nothing moves on the pipeline anymore.
+ *
  * Original Author:
  *     Don Darling, Texas Instruments, Inc.
  *
@@ -33,12 +41,54 @@
  *
  */
 
+#include <pthread.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <string.h>
+
 #include <ti/sdo/dmai/Dmai.h>
 #include <ti/sdo/dmai/Buffer.h>
 #include <ti/sdo/dmai/BufTab.h>
 
 #include "gsttidmaibuffertransport.h"
 
+/* Buffer lifetime tracer.  Live buffers are kept on a fixed table of slots
+ * claimed with atomic operations, so tracing takes no locks and no
+ * allocations per buffer and can stay enabled in production.
+ * A slot is claimed (TRACE_SLOT_BUSY), filled, and only then published
+ * (TRACE_SLOT_LIVE); the generation tells the watchdog whether a slot was
+ * reused while it was copying it.
+ */
+#define TRACE_SLOTS     1024
+#define TRACE_DUMP_MAX  16
+/* How often the watchdog looks for requests, in us */
+#define TRACE_POLL      100000
+
+enum {
+    TRACE_SLOT_FREE,
+    TRACE_SLOT_BUSY,
+    TRACE_SLOT_LIVE,
+};
+
+struct trace_slot {
+    volatile gint   state;
+    volatile gint   generation;
+    gpointer        buf;
+    const gchar     *site;
+    gchar           owner[32];
+    GstClockTime    created;
+    /* Reference count when the last event (creation, owner) was recorded */
+    volatile gint   refcount;
+};
+
+static struct trace_slot trace_slots[TRACE_SLOTS];
+static gboolean trace_enabled = FALSE;
+static GstClockTime trace_max_age = 0;
+static volatile gint trace_next = 0;
+static volatile gint trace_live = 0;
+static volatile gint trace_untracked = 0;
+static volatile gint trace_dump_requested = 0;
+
 /* Declare variable used to categorize GST_LOG output */
 GST_DEBUG_CATEGORY_STATIC (gst_tidmaibuffertransport_debug);
 #define GST_CAT_DEFAULT gst_tidmaibuffertransport_debug
@@ -52,6 +102,7 @@ static void gst_tidmaibuffertransport_init(GTypeInstance *instance,
 static void gst_tidmaibuffertransport_class_init(gpointer g_class,
                 gpointer class_data);
 static void gst_tidmaibuffertransport_finalize(GstTIDmaiBufferTransport *nbuf);
+static void gst_tidmaibuffertransport_trace_init(void);
 
 
 /******************************************************************************
@@ -107,6 +158,8 @@ static void gst_tidmaibuffertransport_class_init(gpointer g_class,
     mo_class->finalize =
         (GstMiniObjectFinalizeFunction) gst_tidmaibuffertransport_finalize;
 
+    gst_tidmaibuffertransport_trace_init();
+
     GST_LOG("end class_init\n");
 }
 
@@ -125,6 +178,234 @@ static void gst_tidmaibuffertransport_init(GTypeInstance *instance,
     buf->mutex = NULL;
     buf->cond = NULL;
     buf->is_dummy = FALSE;
+    buf->poolStats = NULL;
+    buf->traceSlot = -1;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_signal
+ *    Only flags the request, the dump is done by the watchdog thread
+ ******************************************************************************/
+static void gst_tidmaibuffertransport_trace_signal(int signum)
+{
+    g_atomic_int_set(&trace_dump_requested, 1);
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_add
+ ******************************************************************************/
+static void gst_tidmaibuffertransport_trace_add(GstTIDmaiBufferTransport *buf,
+                const gchar *site)
+{
+    guint start = (guint)g_atomic_int_exchange_and_add(&trace_next, 1);
+    guint i;
+
+    for (i = 0; i < TRACE_SLOTS; i++) {
+        guint index = (start + i) % TRACE_SLOTS;
+        struct trace_slot *slot = &trace_slots[index];
+
+        if (g_atomic_int_compare_and_exchange(&slot->state, TRACE_SLOT_FREE,
+            TRACE_SLOT_BUSY)) {
+            g_atomic_int_inc(&slot->generation);
+            slot->buf = buf;
+            slot->site = site;
+            slot->owner[0] = '\0';
+            slot->created = gst_util_get_timestamp();
+            slot->refcount = GST_MINI_OBJECT_REFCOUNT_VALUE(buf);
+            buf->traceSlot = index;
+            g_atomic_int_inc(&trace_live);
+            /* Publish the slot once it is filled */
+            g_atomic_int_set(&slot->state, TRACE_SLOT_LIVE);
+            return;
+        }
+    }
+
+    g_atomic_int_inc(&trace_untracked);
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_remove
+ ******************************************************************************/
+static void gst_tidmaibuffertransport_trace_remove
+    (GstTIDmaiBufferTransport *buf)
+{
+    struct trace_slot *slot = &trace_slots[buf->traceSlot];
+
+    g_atomic_int_set(&slot->state, TRACE_SLOT_BUSY);
+    g_atomic_int_inc(&slot->generation);
+    slot->buf = NULL;
+    g_atomic_int_add(&trace_live, -1);
+    g_atomic_int_set(&slot->state, TRACE_SLOT_FREE);
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_copy
+ *    Take a consistent copy of a live slot, FALSE if it is not live or was
+ *    reused while copying it.  The buffer itself is never dereferenced.
+ ******************************************************************************/
+static gboolean gst_tidmaibuffertransport_trace_copy(gint index,
+                struct trace_slot *copy)
+{
+    struct trace_slot *slot = &trace_slots[index];
+    gint generation = g_atomic_int_get(&slot->generation);
+
+    if (g_atomic_int_get(&slot->state) != TRACE_SLOT_LIVE)
+        return FALSE;
+
+    *copy = *slot;
+    copy->owner[sizeof(copy->owner) - 1] = '\0';
+
+    return g_atomic_int_get(&slot->state) == TRACE_SLOT_LIVE &&
+        g_atomic_int_get(&slot->generation) == generation;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_check
+ *    TRUE if a live buffer is older than the max age
+ ******************************************************************************/
+static gboolean gst_tidmaibuffertransport_trace_check(GstClockTime now)
+{
+    struct trace_slot copy;
+    gint i;
+
+    for (i = 0; i < TRACE_SLOTS; i++) {
+        if (gst_tidmaibuffertransport_trace_copy(i, &copy) &&
+            copy.created < now && now - copy.created > trace_max_age)
+            return TRUE;
+    }
+
+    return FALSE;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_watchdog
+ *    Dump the live buffers when requested by the signal, or when the oldest
+ *    one gets older than the max age.  Runs on its own thread, since a
+ *    stalled pipeline doesn't create buffers anymore.
+ ******************************************************************************/
+static void *gst_tidmaibuffertransport_trace_watchdog(void *arg)
+{
+    GstClockTime nextCheck = 0;
+
+    while (TRUE) {
+        GstClockTime now;
+
+        g_usleep(TRACE_POLL);
+
+        if (g_atomic_int_get(&trace_dump_requested)) {
+            g_atomic_int_set(&trace_dump_requested, 0);
+            gst_tidmaibuffertransport_trace_dump();
+        }
+
+        if (!trace_max_age)
+            continue;
+
+        /* The table is scanned at most once per second */
+        now = gst_util_get_timestamp();
+        if (now < nextCheck)
+            continue;
+        nextCheck = now + GST_SECOND;
+
+        if (gst_tidmaibuffertransport_trace_check(now)) {
+            gst_tidmaibuffertransport_trace_dump();
+            /* Don't dump again until the max age has passed */
+            nextCheck = now + MAX(trace_max_age, GST_SECOND);
+        }
+    }
+
+    return NULL;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_init
+ *    Enable the tracer if requested on the environment
+ ******************************************************************************/
+static void gst_tidmaibuffertransport_trace_init(void)
+{
+    const gchar *env = g_getenv("GST_TIDMAI_TRACE");
+    struct sigaction action;
+    pthread_attr_t attr;
+    pthread_t watchdog;
+
+    if (!env)
+        return;
+
+    trace_max_age = (GstClockTime)strtoul(env, NULL, 10) * GST_MSECOND;
+
+    pthread_attr_init(&attr);
+    pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+    if (pthread_create(&watchdog, &attr,
+        gst_tidmaibuffertransport_trace_watchdog, NULL)) {
+        pthread_attr_destroy(&attr);
+        GST_WARNING("Failed to start the tracer watchdog, not tracing");
+        return;
+    }
+    pthread_attr_destroy(&attr);
+    trace_enabled = TRUE;
+
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = gst_tidmaibuffertransport_trace_signal;
+    action.sa_flags = SA_RESTART;
+    sigaction(SIGUSR2, &action, NULL);
+
+    GST_INFO("Tracing transport buffers, max age %" GST_TIME_FORMAT,
+        GST_TIME_ARGS(trace_max_age));
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_compare
+ ******************************************************************************/
+static gint gst_tidmaibuffertransport_trace_compare(gconstpointer a,
+                gconstpointer b)
+{
+    const struct trace_slot *sa = a, *sb = b;
+
+    return sa->created < sb->created ? -1 : sa->created > sb->created;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_trace_dump
+ *    Print the oldest outstanding transport buffers.  The slots are copied
+ *    first, a buffer may be released while we print it.
+ ******************************************************************************/
+void gst_tidmaibuffertransport_trace_dump(void)
+{
+    struct trace_slot *live;
+    GstClockTime now = gst_util_get_timestamp();
+    gint i, count = 0;
+
+    if (!trace_enabled)
+        return;
+
+    live = g_new(struct trace_slot, TRACE_SLOTS);
+    for (i = 0; i < TRACE_SLOTS; i++) {
+        if (gst_tidmaibuffertransport_trace_copy(i, &live[count]))
+            count++;
+    }
+    qsort(live, count, sizeof(struct trace_slot),
+        gst_tidmaibuffertransport_trace_compare);
+
+    g_printerr("TIDmaiBufferTransport: %d live buffers (%d untracked), "
+        "oldest first:\n", g_atomic_int_get(&trace_live),
+        g_atomic_int_get(&trace_untracked));
+    for (i = 0; i < count && i < TRACE_DUMP_MAX; i++) {
+        g_printerr("  %p: age %" GST_TIME_FORMAT ", owner %s, "
+            "refcount %d, created at %s\n", live[i].buf,
+            GST_TIME_ARGS(now > live[i].created ? now - live[i].created : 0),
+            live[i].owner[0] ? live[i].owner : "unknown", live[i].refcount,
+            live[i].site);
+    }
+
+    g_free(live);
 }
 
 
@@ -164,6 +445,10 @@ static void gst_tidmaibuffertransport_finalize(GstTIDmaiBufferTransport *cbuf)
                 GST_DEBUG("Not broadcasting buffer free at finalize, since use mask is not clean yet");
             }
         }
+        if (cbuf->poolStats) {
+            gst_tidmaitelemetry_update_buftab(cbuf->poolStats,
+                Buffer_getBufTab(cbuf->dmaiBuffer));
+        }
         /* Release mutex, if available */
         if (cbuf->mutex)
            pthread_mutex_unlock(cbuf->mutex);
@@ -172,6 +457,12 @@ static void gst_tidmaibuffertransport_finalize(GstTIDmaiBufferTransport *cbuf)
         Buffer_delete(cbuf->dmaiBuffer);
     }
     
+    if (cbuf->poolStats)
+        gst_tidmaitelemetry_pool_unref(cbuf->poolStats);
+
+    if (cbuf->traceSlot >= 0)
+        gst_tidmaibuffertransport_trace_remove(cbuf);
+
     gst_caps_replace (&GST_BUFFER_CAPS (GST_BUFFER(cbuf)), NULL);
 
     GST_MINI_OBJECT_CLASS (parent_class)->finalize                                                             
@@ -185,8 +476,9 @@ static void gst_tidmaibuffertransport_finalize(GstTIDmaiBufferTransport *cbuf)
  * gst_tidmaibuffertransport_new
  *    Create a new DMAI buffer transport object.
  ******************************************************************************/
-GstBuffer *gst_tidmaibuffertransport_new(Buffer_Handle hBuf,
-    pthread_mutex_t *mutex, pthread_cond_t *cond, gboolean is_dummy)
+GstBuffer *gst_tidmaibuffertransport_new_full(Buffer_Handle hBuf,
+    pthread_mutex_t *mutex, pthread_cond_t *cond, gboolean is_dummy,
+    const gchar *site)
 {
     GstTIDmaiBufferTransport *buf;
 
@@ -209,6 +501,9 @@ GstBuffer *gst_tidmaibuffertransport_new(Buffer_Handle hBuf,
     buf->mutex = mutex;
     buf->cond = cond;
     buf->is_dummy = is_dummy;
+
+    if (trace_enabled)
+        gst_tidmaibuffertransport_trace_add(buf, site);
     GST_LOG("end new\n");
 
     return GST_BUFFER(buf);
@@ -228,6 +523,36 @@ void gst_tidmaibuffertransport_set_release_callback
 }
 
 
+/******************************************************************************
+ * gst_tidmaibuffertransport_set_pool_stats
+ *    Set the statistics to update when the buffer is released to its tab
+ ******************************************************************************/
+void gst_tidmaibuffertransport_set_pool_stats
+    (GstTIDmaiBufferTransport *buf, GstTIDmaiPoolStats *poolStats){
+    if (poolStats)
+        gst_tidmaitelemetry_pool_ref(poolStats);
+    if (buf->poolStats)
+        gst_tidmaitelemetry_pool_unref(buf->poolStats);
+    buf->poolStats = poolStats;
+}
+
+
+/******************************************************************************
+ * gst_tidmaibuffertransport_set_owner
+ *    Name the element owning the buffer on the tracer dumps
+ ******************************************************************************/
+void gst_tidmaibuffertransport_set_owner
+    (GstTIDmaiBufferTransport *buf, GstElement *owner){
+    if (buf->traceSlot < 0)
+        return;
+
+    g_strlcpy(trace_slots[buf->traceSlot].owner, GST_ELEMENT_NAME(owner),
+        sizeof(trace_slots[buf->traceSlot].owner));
+    g_atomic_int_set(&trace_slots[buf->traceSlot].refcount,
+        GST_MINI_OBJECT_REFCOUNT_VALUE(buf));
+}
+
+
 /******************************************************************************
  * Custom ViM Settings for editing this file
  ******************************************************************************/
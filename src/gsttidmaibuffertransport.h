@@ -31,6 +31,8 @@
 
 #include <pthread.h>
 
+#include "gsttidmaitelemetry.h"
+
 G_BEGIN_DECLS
 
 typedef struct _GstTIDmaiBufferTransport GstTIDmaiBufferTransport;
@@ -59,15 +61,24 @@ struct _GstTIDmaiBufferTransport {
   pthread_mutex_t   *mutex;
   pthread_cond_t   *cond;
   gboolean is_dummy;
+  GstTIDmaiPoolStats *poolStats;
+  gint traceSlot;
 };
 
 /* External function declarations */
 GType      gst_tidmaibuffertransport_get_type(void);
-GstBuffer* gst_tidmaibuffertransport_new(Buffer_Handle hBuf, pthread_mutex_t *, pthread_cond_t *, gboolean is_dummy);
+GstBuffer* gst_tidmaibuffertransport_new_full(Buffer_Handle hBuf, pthread_mutex_t *, pthread_cond_t *, gboolean is_dummy, const gchar *site);
+#define gst_tidmaibuffertransport_new(hBuf, mutex, cond, is_dummy) \
+    gst_tidmaibuffertransport_new_full(hBuf, mutex, cond, is_dummy, G_STRLOC)
 void       gst_tidmaibuffertransport_set_release_callback
     (GstTIDmaiBufferTransport *,
      void (*)(gpointer,GstTIDmaiBufferTransport *),
      gpointer);
+void       gst_tidmaibuffertransport_set_pool_stats
+    (GstTIDmaiBufferTransport *, GstTIDmaiPoolStats *);
+void       gst_tidmaibuffertransport_set_owner
+    (GstTIDmaiBufferTransport *, GstElement *);
+void       gst_tidmaibuffertransport_trace_dump(void);
 
 G_END_DECLS
 
@@ -60,6 +60,7 @@ enum
     PROP_NUM_OUTPUT_BUFS, /* numOutputBufs  (int)     */
     PROP_QOS,             /* qos (boolean) */
     PROP_GENERATE_TIMESTAMPS,/* generateTimestamps (boolean) */
+    PROP_AGGREGATE_TIME,  /* aggregateTime (int) */
 };
 
 /* Declare a global pointer to our element base class */
@@ -100,7 +101,7 @@ static gboolean
 static gboolean
  gst_tidmaidec_exit_decoder(GstTIDmaidec *dmaidec);
 static gboolean
- gst_tidmaidec_configure_codec (GstTIDmaidec *dmaidec);
+ gst_tidmaidec_configure_codec (GstTIDmaidec *dmaidec, GstBuffer *buf);
 static gboolean
  gst_tidmaidec_deconfigure_codec (GstTIDmaidec *dmaidec);
 static GstFlowReturn
@@ -109,6 +110,10 @@ static GstClockTime
  gst_tidmaidec_frame_duration(GstTIDmaidec *dmaidec);
 static GstBuffer *
  gstti_dmaidec_circ_buffer_drain(GstTIDmaidec *dmaidec);
+static void
+ gst_tidmaidec_aggregate_push(GstTIDmaidec *dmaidec);
+static void
+ gst_tidmaidec_aggregate_discard(GstTIDmaidec *dmaidec);
 static void gstti_dmaidec_circ_buffer_flush
  (GstTIDmaidec *dmaidec, gint bytes);
 
@@ -309,6 +314,13 @@ static void gst_tidmaidec_class_init(GstTIDmaidecClass *klass)
             "Some buggy streams may have wrong timestamps or durations, generate them instead using as base time the first valid timestamp that we receive",
             FALSE, G_PARAM_READWRITE));
 
+    g_object_class_install_property(gobject_class, PROP_AGGREGATE_TIME,
+        g_param_spec_int("aggregateTime",
+            "Audio aggregation time",
+            "Gather decoded audio up to this many milliseconds before pushing "
+            "it downstream, 0 pushes every decoded frame (audio only)",
+            0, 1000, 0, G_PARAM_READWRITE));
+
     /* Install custom properties for this codec type */
     if (decoder->dops->install_properties){
         decoder->dops->install_properties(gobject_class);
@@ -427,10 +439,18 @@ static void gst_tidmaidec_init(GstTIDmaidec *dmaidec, GstTIDmaidecClass *gclass)
     dmaidec->skip_frames        = 0;
     dmaidec->skip_done          = 0;
     dmaidec->qos                = FALSE;
+    dmaidec->aggregateTime      = 0;
+    dmaidec->aggBuffer          = NULL;
+    dmaidec->aggFill            = 0;
 
     dmaidec->numOutputBufs      = 0UL;
     dmaidec->numInputBufs       = 0UL;
     dmaidec->metaBufTab         = NULL;
+    dmaidec->autoOutputBufs     = FALSE;
+    dmaidec->dpbFrames          = 0;
+    dmaidec->reorderFrames      = -1;
+    dmaidec->maxFrameSize       = 0;
+    dmaidec->displayDelay       = -1;
 
     GST_LOG_OBJECT(dmaidec,"Leave");
 }
@@ -472,6 +492,11 @@ static void gst_tidmaidec_set_property(GObject *object, guint prop_id,
         GST_LOG_OBJECT(dmaidec,"seeting \"generate_timestamps\" to %s\n",
             dmaidec->generate_timestamps?"TRUE":"FALSE");
         break;
+    case PROP_AGGREGATE_TIME:
+        dmaidec->aggregateTime = g_value_get_int(value);
+        GST_LOG_OBJECT(dmaidec,"setting \"aggregateTime\" to %d\n",
+            dmaidec->aggregateTime);
+        break;
     default:
         /* If this codec provide custom properties...
          * We allow custom codecs to overwrite the generic properties
@@ -519,6 +544,9 @@ static void gst_tidmaidec_get_property(GObject *object, guint prop_id,
     case PROP_GENERATE_TIMESTAMPS:
         g_value_set_boolean(value,dmaidec->generate_timestamps);
         break;
+    case PROP_AGGREGATE_TIME:
+        g_value_set_int(value,dmaidec->aggregateTime);
+        break;
     default:
         /* If this codec provide custom properties...
          * We allow custom codecs to overwrite the generic properties
@@ -630,7 +658,7 @@ static gboolean gst_tidmaidec_init_decoder(GstTIDmaidec *dmaidec)
 
     /* Open the codec engine */
     GST_DEBUG_OBJECT(dmaidec,"opening codec engine \"%s\"\n", dmaidec->engineName);
-    dmaidec->hEngine = Engine_open((Char *) dmaidec->engineName, NULL, NULL);
+    dmaidec->hEngine = gst_ti_engine_open(dmaidec->engineName);
 
     if (dmaidec->hEngine == NULL) {
         GST_ELEMENT_ERROR(dmaidec,STREAM,CODEC_NOT_FOUND,(NULL),
@@ -646,8 +674,10 @@ static gboolean gst_tidmaidec_init_decoder(GstTIDmaidec *dmaidec)
 #endif
     dmaidec->allocated_buffer = NULL;
     dmaidec->downstreamBuffers = FALSE;
+    dmaidec->outPoolStats = NULL;
 
     /* Define the number of display buffers to allocate */
+    dmaidec->autoOutputBufs = (dmaidec->numOutputBufs == 0);
     if (dmaidec->numOutputBufs == 0) {
         switch (decoder->dops->codec_type){
         case IMAGE:
@@ -723,7 +753,7 @@ static gboolean gst_tidmaidec_exit_decoder(GstTIDmaidec *dmaidec)
 
     if (dmaidec->hEngine) {
         GST_DEBUG_OBJECT(dmaidec,"closing codec engine\n");
-        Engine_close(dmaidec->hEngine);
+        gst_ti_engine_close(dmaidec->hEngine);
         dmaidec->hEngine = NULL;
     }
 
@@ -734,14 +764,16 @@ static gboolean gst_tidmaidec_exit_decoder(GstTIDmaidec *dmaidec)
 
 /******************************************************************************
  * gst_tidmaidec_configure_codec
- *     Initialize codec engine
+ *     Initialize codec engine. buf is the first buffer of the stream.
  *****************************************************************************/
-static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
+static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec,
+    GstBuffer *buf)
 {
     BufferGfx_Attrs        gfxAttrs  = BufferGfx_Attrs_DEFAULT;
     Buffer_Attrs           Attrs     = Buffer_Attrs_DEFAULT;
     GstTIDmaidecData       *decoder;
     GstTIDmaidecClass *gclass;
+    struct gstti_parser_params parserParams;
     int i;
 
     gclass = (GstTIDmaidecClass *) (G_OBJECT_GET_CLASS (dmaidec));
@@ -792,6 +824,24 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
         gst_caps_unref(caps);
     }
 
+    /* Let the stream tell what it needs, so the codec and its buffers are
+     * sized for this stream instead of for the largest one supported
+     */
+    dmaidec->dpbFrames = 0;
+    dmaidec->reorderFrames = -1;
+    dmaidec->maxFrameSize = 0;
+    if (decoder->stream_ops && decoder->stream_ops->probe){
+        decoder->stream_ops->probe(dmaidec, buf);
+    }
+
+    /* The decoded picture buffer, the frame being decoded, and two frames
+     * on display (the same triple buffering as the default)
+     */
+    if (dmaidec->dpbFrames && dmaidec->autoOutputBufs &&
+        decoder->dops->codec_type == VIDEO) {
+        dmaidec->numOutputBufs = dmaidec->dpbFrames + 3;
+    }
+
     /* Set the caps on the parameters of the decoder */
     decoder->dops->set_codec_caps(dmaidec);
     if (gclass->codec_data && gclass->codec_data->set_codec_caps) {
@@ -799,11 +849,14 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
     }
 
     /* Create codec */
+    gst_ti_engine_lock(dmaidec->hEngine);
     if (!decoder->dops->codec_create(dmaidec)){
+        gst_ti_engine_unlock(dmaidec->hEngine);
         GST_ELEMENT_ERROR(dmaidec,STREAM,CODEC_NOT_FOUND,(NULL),
             ("Failed to create codec"));
         return FALSE;
     }
+    gst_ti_engine_unlock(dmaidec->hEngine);
 
     /* Get the buffer sizes */
     dmaidec->outBufSize = decoder->dops->get_out_buffer_size(dmaidec);
@@ -829,6 +882,13 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
         dmaidec->outBufSize = gst_ti_calculate_bufSize (
             dmaidec->width,dmaidec->height,dmaidec->colorSpace);
         dmaidec->inBufSize = dmaidec->outBufSize;
+        /* The circular buffer has to fit a whole frame waiting for the
+         * parser next to an incoming one, pushed with a 1.5x margin
+         */
+        if (dmaidec->maxFrameSize &&
+            dmaidec->maxFrameSize * 5 / 2 < dmaidec->inBufSize) {
+            dmaidec->inBufSize = dmaidec->maxFrameSize * 5 / 2;
+        }
 #if PLATFORM == dm365
         /* For DM365 NV12 decoding, the output buffers aren't 1.5 x times the width*height,
          * but instead around 1.8. The formula to calculate the output buffer was taken from 
@@ -892,12 +952,15 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
             /* We need to recreate the codec, since some codecs around
                doesn't support dinamically set the displayWidth
              */
+            gst_ti_engine_lock(dmaidec->hEngine);
             decoder->dops->codec_destroy(dmaidec);
             if (!decoder->dops->codec_create(dmaidec)){
+                gst_ti_engine_unlock(dmaidec->hEngine);
                 GST_ELEMENT_ERROR(dmaidec,STREAM,CODEC_NOT_FOUND,(NULL),
                     ("Failed to create codec"));
                 return FALSE;
             }
+            gst_ti_engine_unlock(dmaidec->hEngine);
         }
         break;
     }
@@ -925,6 +988,16 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
         return FALSE;
     }
 
+    /* Track the occupancy of the output buffers, unless they belong to
+     * downstream */
+    if (!dmaidec->downstreamBuffers) {
+        gchar *name = g_strdup_printf("%s:out", GST_ELEMENT_NAME(dmaidec));
+
+        dmaidec->outPoolStats = gst_tidmaitelemetry_pool_new(name, "bufs",
+            BufTab_getNumBufs(dmaidec->hOutBufTab));
+        g_free(name);
+    }
+
     if (decoder->dops->set_outBufTab){
         /* Set the Output Buffer Tab on the codec */
         decoder->dops->set_outBufTab(dmaidec,dmaidec->hOutBufTab);
@@ -932,13 +1005,21 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
 
     /* Start the parser before allocating the input circular buffer */
     g_assert(decoder && decoder->parser);
-    if (!decoder->parser->init(dmaidec)){
+    parserParams.caps = GST_PAD_CAPS(dmaidec->sinkpad);
+    parserParams.codecName = dmaidec->codecName;
+    parserParams.rate = dmaidec->rate;
+    parserParams.channels = dmaidec->channels;
+    parserParams.numInputBufs = dmaidec->numInputBufs;
+    dmaidec->parser_private = decoder->parser->init(&parserParams);
+    if (!dmaidec->parser_private){
         GST_ELEMENT_ERROR(dmaidec,STREAM,FAILED,(NULL),
             ("Failed to initialize a parser for the stream"));
+        return FALSE;
     }
     dmaidec->parser_started = TRUE;
 
     /* Query the parser for the required number of buffers */
+    dmaidec->numInputBufs = parserParams.numInputBufs;
     if (dmaidec->numInputBufs == 0) {
         dmaidec->numInputBufs = decoder->parser->numInputBufs;
     }
@@ -960,6 +1041,9 @@ static gboolean gst_tidmaidec_configure_codec (GstTIDmaidec  *dmaidec)
     dmaidec->head = 0;
     dmaidec->tail = 0;
     dmaidec->marker = 0;
+    dmaidec->parserTimestamp = GST_CLOCK_TIME_NONE;
+    dmaidec->frameType = GSTTI_FRAME_UNKNOWN;
+    dmaidec->waitKeyFrame = FALSE;
 #ifdef GLIB_2_31_AND_UP
     g_mutex_init(&dmaidec->circMutex);
 #else
@@ -1009,9 +1093,11 @@ static gboolean gst_tidmaidec_deconfigure_codec (GstTIDmaidec  *dmaidec)
        g_type_get_qdata(G_OBJECT_CLASS_TYPE(gclass),GST_TIDMAIDEC_PARAMS_QDATA);
 
     dmaidec->src_pad_caps_fixed = FALSE;
+    gst_tidmaidec_aggregate_discard(dmaidec);
 
     if (dmaidec->parser_started){
-        decoder->parser->clean(dmaidec);
+        decoder->parser->clean(dmaidec->parser_private);
+        dmaidec->parser_private = NULL;
         dmaidec->parser_started = FALSE;
     }
 
@@ -1038,6 +1124,10 @@ static gboolean gst_tidmaidec_deconfigure_codec (GstTIDmaidec  *dmaidec)
         BufTab_delete(dmaidec->hOutBufTab);
         dmaidec->hOutBufTab = NULL;
     }
+    if (dmaidec->outPoolStats) {
+        gst_tidmaitelemetry_pool_release(dmaidec->outPoolStats);
+        dmaidec->outPoolStats = NULL;
+    }
     dmaidec->allocatedWidth = 0;
     dmaidec->allocatedHeight = 0;
 
@@ -1063,7 +1153,9 @@ static gboolean gst_tidmaidec_deconfigure_codec (GstTIDmaidec  *dmaidec)
 
     if (dmaidec->hCodec) {
         GST_LOG_OBJECT(dmaidec,"closing decoder\n");
+        gst_ti_engine_lock(dmaidec->hEngine);
         decoder->dops->codec_destroy(dmaidec);
+        gst_ti_engine_unlock(dmaidec->hEngine);
         dmaidec->hCodec = NULL;
     }
 
@@ -1290,6 +1382,7 @@ static gboolean gst_tidmaidec_sink_event(GstPad *pad, GstEvent *event)
            our current timestamp when we start a new segment
          */
         dmaidec->sample_duration = 0;
+        gst_tidmaidec_aggregate_push(dmaidec);
 
         ret = gst_pad_event_default(pad, event);
         goto done;
@@ -1317,6 +1410,7 @@ static gboolean gst_tidmaidec_sink_event(GstPad *pad, GstEvent *event)
             if (empty)
                 break;
         }
+        gst_tidmaidec_aggregate_push(dmaidec);
 
         ret = gst_pad_event_default(pad, event);
         goto done;
@@ -1441,6 +1535,7 @@ static void gstti_dmaidec_circ_buffer_flush(GstTIDmaidec *dmaidec, gint bytes){
     if (dmaidec->flushing){
         GST_DEBUG_OBJECT(dmaidec,"Flushing the circular buffer completely");
         dmaidec->head = dmaidec->tail = dmaidec->marker = 0;
+        dmaidec->parserTimestamp = GST_CLOCK_TIME_NONE;
         GMUTEX_LOCK(dmaidec->circMetaMutex);
         if (dmaidec->circMeta){
             g_list_foreach (dmaidec->circMeta, meta_free, NULL);
@@ -1458,7 +1553,7 @@ static void gstti_dmaidec_circ_buffer_flush(GstTIDmaidec *dmaidec, gint bytes){
          * so we cover our backs here.
          */
         if (dmaidec->tail >= dmaidec->head){
-            dmaidec->tail = dmaidec->head = 0;
+            dmaidec->tail = dmaidec->head = dmaidec->marker = 0;
         }
         GMUTEX_LOCK(dmaidec->circMetaMutex);
         element = g_list_first(dmaidec->circMeta);
@@ -1598,6 +1693,11 @@ static gboolean gstti_dmaidec_circ_buffer_push(GstTIDmaidec *dmaidec, GstBuffer
             ret = FALSE;
             goto out;
         }
+        if (bytes == 0){
+            /* The whole buffer was dropped (i.e. waiting for a key frame) */
+            gst_buffer_unref(meta);
+            goto out;
+        }
     } else {
         /* Copy the new data into the circular buffer */
         memcpy(&data[dmaidec->head],GST_BUFFER_DATA(buf),GST_BUFFER_SIZE(buf));
@@ -1632,6 +1732,7 @@ static GstBuffer *__gstti_dmaidec_circ_buffer_peek
     GstBuffer *buf = NULL;
     GstTIDmaidecClass *gclass;
     GstTIDmaidecData *decoder;
+    GstClockTime duration = GST_CLOCK_TIME_NONE;
 
     /* To be called with the circMutex locked */
 
@@ -1649,9 +1750,22 @@ static GstBuffer *__gstti_dmaidec_circ_buffer_peek
         return NULL;
     }
 
+    dmaidec->frameType = GSTTI_FRAME_UNKNOWN;
     if (!framepos) {
+        struct gstti_parser_range range;
+
         /* Find the start of the next frame */
-        framepos = decoder->parser->parse(dmaidec);
+        range.data = (const guint8 *)Buffer_getUserPtr(dmaidec->circBuf);
+        range.tail = dmaidec->tail;
+        range.marker = dmaidec->marker;
+        range.head = dmaidec->head;
+        range.chunkSize = dmaidec->inBufSize;
+        range.duration = GST_CLOCK_TIME_NONE;
+        range.frameType = GSTTI_FRAME_UNKNOWN;
+        framepos = decoder->parser->parse(dmaidec->parser_private, &range);
+        dmaidec->marker = range.marker;
+        duration = range.duration;
+        dmaidec->frameType = range.frameType;
         if (dmaidec->flushing) {
             framepos = -1;
             /* Flush the circular buffer */
@@ -1665,6 +1779,7 @@ static GstBuffer *__gstti_dmaidec_circ_buffer_peek
         Buffer_Handle hBuf;
         GList *element;
         gint size = framepos - dmaidec->tail;
+        gboolean aligned = FALSE;
 
         Attrs.useMask = gst_tidmaibuffertransport_GST_FREE;
         Attrs.reference = TRUE;
@@ -1688,11 +1803,35 @@ static GstBuffer *__gstti_dmaidec_circ_buffer_peek
                     GST_BUFFER_OFFSET(data),
                     g_list_position(dmaidec->circMeta,element));
                 gst_buffer_copy_metadata(buf,data,GST_BUFFER_COPY_ALL);
+                aligned = (GST_BUFFER_OFFSET(data) == dmaidec->tail);
                 break;
             }
             element = g_list_next(element);
         }
         GMUTEX_UNLOCK(dmaidec->circMetaMutex);
+
+        /* The parser knows better than the container which frames are
+         * key frames (elementary streams carry no flags at all)
+         */
+        if (dmaidec->frameType == GSTTI_FRAME_I){
+            GST_BUFFER_FLAG_UNSET(buf, GST_BUFFER_FLAG_DELTA_UNIT);
+        } else if (dmaidec->frameType != GSTTI_FRAME_UNKNOWN){
+            GST_BUFFER_FLAG_SET(buf, GST_BUFFER_FLAG_DELTA_UNIT);
+        }
+
+        /* Frames that don't start an incoming buffer are timed after the
+         * previous one, when the parser knows their duration
+         */
+        if (GST_CLOCK_TIME_IS_VALID(duration)){
+            if (!aligned &&
+                GST_CLOCK_TIME_IS_VALID(dmaidec->parserTimestamp)){
+                GST_BUFFER_TIMESTAMP(buf) = dmaidec->parserTimestamp;
+            }
+            GST_BUFFER_DURATION(buf) = duration;
+            dmaidec->parserTimestamp =
+                GST_CLOCK_TIME_IS_VALID(GST_BUFFER_TIMESTAMP(buf)) ?
+                GST_BUFFER_TIMESTAMP(buf) + duration : GST_CLOCK_TIME_NONE;
+        }
     }
 
     GST_LOG_OBJECT(dmaidec,"Leave");
@@ -1769,6 +1908,93 @@ static gboolean gst_tidmaidec_clip_buffer(GstTIDmaidec  *dmaidec,gint64 timestam
     return FALSE;
 }
 
+/******************************************************************************
+ * gst_tidmaidec_aggregate_take
+ *    Return the decoded audio gathered so far, if any
+ ******************************************************************************/
+static GstBuffer *gst_tidmaidec_aggregate_take(GstTIDmaidec *dmaidec){
+    GstBuffer *outBuf = dmaidec->aggBuffer;
+
+    if (!outBuf)
+        return NULL;
+
+    dmaidec->aggBuffer = NULL;
+    if (!dmaidec->aggFill){
+        gst_buffer_unref(outBuf);
+        return NULL;
+    }
+    GST_BUFFER_SIZE(outBuf) = dmaidec->aggFill;
+    dmaidec->aggFill = 0;
+
+    return outBuf;
+}
+
+/******************************************************************************
+ * gst_tidmaidec_aggregate_audio
+ *    Copy the decoded samples into the aggregation buffer.  Returns a buffer
+ *    ready to be pushed once aggregateTime worth of audio is gathered.
+ ******************************************************************************/
+static GstBuffer *gst_tidmaidec_aggregate_audio(GstTIDmaidec *dmaidec,
+    Buffer_Handle hBuf, GstBuffer *meta){
+    GstBuffer *ready = NULL;
+    gint bytes = Buffer_getNumBytesUsed(hBuf);
+    gint target = gst_util_uint64_scale_int(dmaidec->rate *
+        dmaidec->channels * (dmaidec->depth >> 3), dmaidec->aggregateTime,
+        1000);
+
+    /* No room left for these samples, push what we have */
+    if (dmaidec->aggBuffer &&
+        dmaidec->aggFill + bytes > GST_BUFFER_SIZE(dmaidec->aggBuffer)){
+        ready = gst_tidmaidec_aggregate_take(dmaidec);
+    }
+
+    if (!dmaidec->aggBuffer){
+        dmaidec->aggBuffer = gst_buffer_new_and_alloc(MAX(target, bytes));
+        dmaidec->aggFill = 0;
+        gst_buffer_copy_metadata(dmaidec->aggBuffer, meta,
+            GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS);
+        GST_BUFFER_DURATION(dmaidec->aggBuffer) = 0;
+    }
+
+    memcpy(GST_BUFFER_DATA(dmaidec->aggBuffer) + dmaidec->aggFill,
+        Buffer_getUserPtr(hBuf), bytes);
+    dmaidec->aggFill += bytes;
+    if (GST_CLOCK_TIME_IS_VALID(GST_BUFFER_DURATION(meta)))
+        GST_BUFFER_DURATION(dmaidec->aggBuffer) += GST_BUFFER_DURATION(meta);
+
+    if (!ready && dmaidec->aggFill >= target)
+        ready = gst_tidmaidec_aggregate_take(dmaidec);
+
+    return ready;
+}
+
+/******************************************************************************
+ * gst_tidmaidec_aggregate_push
+ *    Push the pending aggregated audio (on EOS or a new segment)
+ ******************************************************************************/
+static void gst_tidmaidec_aggregate_push(GstTIDmaidec *dmaidec){
+    GstBuffer *outBuf = gst_tidmaidec_aggregate_take(dmaidec);
+
+    if (!outBuf)
+        return;
+
+    gst_buffer_set_caps(outBuf, GST_PAD_CAPS(dmaidec->srcpad));
+    if (gst_pad_push(dmaidec->srcpad, outBuf) != GST_FLOW_OK) {
+        GST_DEBUG_OBJECT(dmaidec,"push of the aggregated audio failed");
+    }
+}
+
+/******************************************************************************
+ * gst_tidmaidec_aggregate_discard
+ ******************************************************************************/
+static void gst_tidmaidec_aggregate_discard(GstTIDmaidec *dmaidec){
+    if (dmaidec->aggBuffer){
+        gst_buffer_unref(dmaidec->aggBuffer);
+        dmaidec->aggBuffer = NULL;
+    }
+    dmaidec->aggFill = 0;
+}
+
 /******************************************************************************
  * decode
  *  This function decodes a frame and adds the decoded data to the output list
@@ -1796,7 +2022,9 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
          * frames out of the codec and push them to the sink.
          */
         if (decoder->dops->codec_type == VIDEO){
+            gst_ti_engine_lock(dmaidec->hEngine);
             decoder->dops->codec_flush(dmaidec);
+            gst_ti_engine_unlock(dmaidec->hEngine);
         }
         codecFlushed = TRUE;
 
@@ -1858,19 +2086,26 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
         hDstBuf = BufTab_getFreeBuf(dmaidec->hOutBufTab);
 
         if (hDstBuf == NULL) {
+            GstClockTime waitStart = gst_util_get_timestamp();
+
             GST_INFO_OBJECT(dmaidec,"Failed to get free buffer, waiting on bufTab\n");
             pthread_cond_wait(&dmaidec->bufTabCond, &dmaidec->bufTabMutex);
             GST_INFO_OBJECT(dmaidec,"Awaked from waiting on bufTab\n");
+            gst_tidmaitelemetry_blocked(dmaidec->outPoolStats,
+                gst_util_get_timestamp() - waitStart);
 
             hDstBuf = BufTab_getFreeBuf(dmaidec->hOutBufTab);
 
             if (hDstBuf == NULL) {
+                gst_tidmaitelemetry_failed(dmaidec->outPoolStats);
                 GST_ELEMENT_ERROR(dmaidec,RESOURCE,NO_SPACE_LEFT,(NULL),
                     ("failed to get a free contiguous buffer from BufTab"));
                 pthread_mutex_unlock(&dmaidec->bufTabMutex);
                 goto failure;
             }
         }
+        gst_tidmaitelemetry_update_buftab(dmaidec->outPoolStats,
+            dmaidec->hOutBufTab);
         pthread_mutex_unlock(&dmaidec->bufTabMutex);
     } else {
         if (!dmaidec->allocated_buffer) {
@@ -1918,9 +2153,12 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
         return GST_FLOW_OK;
     }
 
+    /* The engine handle may be shared with other elements */
+    gst_ti_engine_lock(dmaidec->hEngine);
     if (!decoder->dops->codec_process(dmaidec,encData,hDstBuf,codecFlushed)){
         skip_frame = TRUE;
     }
+    gst_ti_engine_unlock(dmaidec->hEngine);
 
     if (decoder->parser->trustme){
         /* In parser we trust */
@@ -2045,6 +2283,22 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
             dmaidec->current_timestamp += dmaidec->sample_duration;
         }
 
+        if (decoder->dops->codec_type == AUDIO && dmaidec->aggregateTime) {
+            /* Gather the decoded samples, the DMAI buffer goes back to
+             * the codec right away
+             */
+            outBuf = NULL;
+            if (!(codecFlushed && dmaidec->metaBufTab[id].is_dummy)) {
+                outBuf = gst_tidmaidec_aggregate_audio(dmaidec, hDstBuf,
+                    &dmaidec->metaBufTab[id].buffer);
+            }
+            Buffer_freeUseMask(hDstBuf, gst_tidmaibuffertransport_GST_FREE |
+                decoder->dops->outputUseMask);
+            if (!outBuf)
+                goto no_buffer_pushed;
+            goto push_buffer;
+        }
+
         /* Create a DMAI transport buffer object to carry a DMAI buffer to
          * the source pad.  The transport buffer knows how to release the
          * buffer for re-use in this element when the source pad calls
@@ -2052,6 +2306,12 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
          */
         outBuf = gst_tidmaibuffertransport_new(hDstBuf,
             &dmaidec->bufTabMutex, &dmaidec->bufTabCond, FALSE);
+        gst_tidmaibuffertransport_set_owner(
+            (GstTIDmaiBufferTransport *)outBuf, GST_ELEMENT(dmaidec));
+        if (dmaidec->outPoolStats) {
+            gst_tidmaibuffertransport_set_pool_stats(
+                (GstTIDmaiBufferTransport *)outBuf, dmaidec->outPoolStats);
+        }
         gst_buffer_copy_metadata(outBuf,&dmaidec->metaBufTab[id].buffer,
             GST_BUFFER_COPY_FLAGS | GST_BUFFER_COPY_TIMESTAMPS);
         if (decoder->dops->codec_type == VIDEO ||
@@ -2068,6 +2328,7 @@ static GstFlowReturn decode(GstTIDmaidec *dmaidec,GstBuffer * encData){
             gst_buffer_set_data(outBuf, GST_BUFFER_DATA(outBuf),
                 Buffer_getNumBytesUsed(hDstBuf));
         }
+push_buffer:
         gst_buffer_set_caps(outBuf, GST_PAD_CAPS(dmaidec->srcpad));
 
         if (TRUE) { /* Forward playback*/
@@ -2193,7 +2454,7 @@ static GstFlowReturn gst_tidmaidec_chain(GstPad * pad, GstBuffer * buf)
 
     if (dmaidec->require_configure){
         dmaidec->require_configure = FALSE;
-        if (!gst_tidmaidec_configure_codec(dmaidec)) {
+        if (!gst_tidmaidec_configure_codec(dmaidec, buf)) {
             GST_ERROR("failing to configure codec");
             return GST_FLOW_UNEXPECTED;
         }
@@ -2211,6 +2472,25 @@ static GstFlowReturn gst_tidmaidec_chain(GstPad * pad, GstBuffer * buf)
     }
 
     while ((pushBuffer = gstti_dmaidec_circ_buffer_peek(dmaidec))){
+        /* After a flush decoding restarts on an I frame, and when we are
+         * late B frames go first, since no other frame refers to them
+         */
+        if ((dmaidec->waitKeyFrame &&
+             dmaidec->frameType != GSTTI_FRAME_UNKNOWN &&
+             dmaidec->frameType != GSTTI_FRAME_I) ||
+            (dmaidec->qos && dmaidec->qos_value > 1 &&
+             dmaidec->frameType == GSTTI_FRAME_B)){
+            GST_DEBUG_OBJECT(dmaidec,"Dropping a frame of type %d",
+                dmaidec->frameType);
+            gstti_dmaidec_circ_buffer_flush(dmaidec,GST_BUFFER_SIZE(pushBuffer));
+            gst_buffer_unref(pushBuffer);
+            if (dmaidec->generate_timestamps) {
+                dmaidec->current_timestamp += dmaidec->frameDuration;
+            }
+            continue;
+        }
+        dmaidec->waitKeyFrame = FALSE;
+
         /* Decide if we need to skip frames due QoS
          */
         if (dmaidec->skip_frames){
@@ -2329,6 +2609,9 @@ static void gst_tidmaidec_stop_flushing(GstTIDmaidec *dmaidec)
     if (dmaidec->parser_started)
         decoder->parser->flush_stop(dmaidec->parser_private);
 
+    /* Samples gathered before the seek are not going to be pushed */
+    gst_tidmaidec_aggregate_discard(dmaidec);
+    dmaidec->waitKeyFrame = TRUE;
     dmaidec->flushing = FALSE;
 }
 
@@ -29,6 +29,7 @@
 
 #include <gst/gst.h>
 #include "gstticommonutils.h"
+#include "gsttidmaitelemetry.h"
 
 #include <xdc/std.h>
 #include <ti/sdo/ce/Engine.h>
@@ -84,6 +85,7 @@ struct _GstTIDmaidec
     pthread_mutex_t     bufTabMutex;
     pthread_cond_t      bufTabCond;
     gint16              outputUseMask;
+    GstTIDmaiPoolStats  *outPoolStats;
 
     /* Video Information */
     gint                framerateNum;
@@ -112,6 +114,12 @@ struct _GstTIDmaidec
     gint                qos_value;
     gint                skip_frames, skip_done; /* QOS skip to next I Frame */
 
+    /* Audio aggregation: decoded samples are gathered up to aggregateTime
+       milliseconds before being pushed */
+    gint                aggregateTime;
+    GstBuffer           *aggBuffer;
+    gint                aggFill;
+
     /* Buffer management */
     Buffer_Handle       circBuf;
 #ifdef GLIB_2_31_AND_UP
@@ -128,8 +136,22 @@ struct _GstTIDmaidec
     gint                tail;
     gint                marker;
     gint                end;
+    /* Timestamp following the last frame timed by the parser */
+    GstClockTime        parserTimestamp;
+    /* Coding type of the last frame handed out by the parser, and whether
+       frames are dropped until the next I frame (after a flush) */
+    gint                frameType;
+    gboolean            waitKeyFrame;
     UInt32              numInputBufs;
     UInt32              numOutputBufs;
+    gboolean            autoOutputBufs;
+    /* What the stream requires, as found by the stream probe ahead of
+       creating the codec (0, or -1 for reorderFrames, when unknown) */
+    gint                dpbFrames;
+    gint                reorderFrames;
+    gint                maxFrameSize;
+    /* Frames the codec holds back before output, -1 to follow the stream */
+    gint                displayDelay;
     BufTab_Handle       hOutBufTab;
     gint                outBufSize;
     gint                inBufSize;
@@ -200,6 +222,11 @@ struct gstti_stream_decoder_ops {
      * may be used to interleave data (like on h264) 
      */
     int             (* custom_memcpy)(GstTIDmaidec *, void *, int, GstBuffer *);
+    /*
+     * (optional) Looks at the stream headers (caps or the first buffer)
+     * before the codec is created, to fill in the stream requirements
+     */
+    void            (* probe)(GstTIDmaidec *, GstBuffer *);
     /* Functions to provide custom properties */
     void (*setup)(GstTIDmaidec *dmaidec);
     void (*install_properties)(GObjectClass *);
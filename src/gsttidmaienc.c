@@ -57,6 +57,9 @@
 GST_DEBUG_CATEGORY (gst_tidmaienc_debug);
 #define GST_CAT_DEFAULT gst_tidmaienc_debug
 
+/* Size of the audio staging ring, in codec input frames */
+#define AUDIO_RING_FRAMES 4
+
 /* Element property identifiers */
 enum
 {
@@ -86,6 +89,8 @@ static gboolean
  gst_tidmaienc_set_sink_caps(GstPad *pad, GstCaps *caps);
 static gboolean
  gst_tidmaienc_sink_event(GstPad *pad, GstEvent *event);
+static gboolean
+ gst_tidmaienc_src_event(GstPad *pad, GstEvent *event);
 static GstFlowReturn
  gst_tidmaienc_chain(GstPad *pad, GstBuffer *buf);
 static GstStateChangeReturn
@@ -254,6 +259,10 @@ static void gst_tidmaienc_finalize(GObject * object)
     if (dmaienc->stream_private){
         g_free(dmaienc->stream_private);
     }
+    if (dmaienc->keyUnit){
+        gst_structure_free(dmaienc->keyUnit);
+        dmaienc->keyUnit = NULL;
+    }
 
     G_OBJECT_CLASS(g_type_class_peek_parent(G_OBJECT_GET_CLASS (object)))
         ->finalize (object);
@@ -376,6 +385,8 @@ static void gst_tidmaienc_init(GstTIDmaienc *dmaienc, GstTIDmaiencClass *gclass)
      */
     dmaienc->srcpad =
         gst_pad_new_from_template(gclass->srcTemplateCaps, "src");
+    gst_pad_set_event_function(
+        dmaienc->srcpad, GST_DEBUG_FUNCPTR(gst_tidmaienc_src_event));
 
     /* Add pads to TIDmaienc element */
     gst_element_add_pad(GST_ELEMENT(dmaienc), dmaienc->sinkpad);
@@ -396,8 +407,15 @@ static void gst_tidmaienc_init(GstTIDmaienc *dmaienc, GstTIDmaiencClass *gclass)
     dmaienc->freeMutex          = NULL;
 #endif
     dmaienc->outBuf             = NULL;
+    dmaienc->outPoolStats       = NULL;
     dmaienc->inBuf              = NULL;
     dmaienc->inBufSize          = 0;
+    dmaienc->audioRing          = NULL;
+    dmaienc->audioFrame         = NULL;
+    dmaienc->ringSize           = 0;
+    dmaienc->ringHead           = 0;
+    dmaienc->ringTail           = 0;
+    dmaienc->flushing           = FALSE;
     dmaienc->singleOutBufSize   = 0;
     dmaienc->outBufSize         = 0;
 
@@ -419,6 +437,10 @@ static void gst_tidmaienc_init(GstTIDmaienc *dmaienc, GstTIDmaiencClass *gclass)
 
     dmaienc->asampleSize        = GST_CLOCK_TIME_NONE;
     dmaienc->asampleTime        = GST_CLOCK_TIME_NONE;
+
+    dmaienc->forceKeyFrame      = FALSE;
+    dmaienc->dynParamsChanged   = FALSE;
+    dmaienc->keyUnit            = NULL;
 }
 
 
@@ -610,7 +632,7 @@ static gboolean gst_tidmaienc_init_encoder(GstTIDmaienc *dmaienc)
 
     /* Open the codec engine */
     GST_DEBUG("opening codec engine \"%s\"\n", dmaienc->engineName);
-    dmaienc->hEngine = Engine_open((Char *) dmaienc->engineName, NULL, NULL);
+    dmaienc->hEngine = gst_ti_engine_open(dmaienc->engineName);
 
     if (dmaienc->hEngine == NULL) {
         GST_ELEMENT_ERROR(dmaienc,STREAM,CODEC_NOT_FOUND,(NULL),
@@ -656,9 +678,16 @@ static gboolean gst_tidmaienc_exit_encoder(GstTIDmaienc *dmaienc)
         dmaienc->adapter = NULL;
     }
 
+    GST_OBJECT_LOCK(dmaienc);
+    if (dmaienc->keyUnit){
+        gst_structure_free(dmaienc->keyUnit);
+        dmaienc->keyUnit = NULL;
+    }
+    GST_OBJECT_UNLOCK(dmaienc);
+
     if (dmaienc->hEngine) {
         GST_DEBUG("closing codec engine\n");
-        Engine_close(dmaienc->hEngine);
+        gst_ti_engine_close(dmaienc->hEngine);
         dmaienc->hEngine = NULL;
     }
 
@@ -676,6 +705,7 @@ static gboolean gst_tidmaienc_configure_codec (GstTIDmaienc  *dmaienc)
     GstTIDmaiencClass      *gclass;
     GstTIDmaiencData       *encoder;
     struct cmemSlice *slice;
+    gchar *name;
 
     gclass = (GstTIDmaiencClass *) (G_OBJECT_GET_CLASS (dmaienc));
     encoder = (GstTIDmaiencData *)
@@ -684,9 +714,12 @@ static gboolean gst_tidmaienc_configure_codec (GstTIDmaienc  *dmaienc)
     GST_DEBUG("Init\n");
 
     /* We create the codec here since only at this point we got the custom args */
+    gst_ti_engine_lock(dmaienc->hEngine);
     if (!encoder->eops->codec_create(dmaienc)) {
+        gst_ti_engine_unlock(dmaienc->hEngine);
         return FALSE;
     }
+    gst_ti_engine_unlock(dmaienc->hEngine);
 
     dmaienc->firstBuffer = TRUE;
 
@@ -728,6 +761,35 @@ static gboolean gst_tidmaienc_configure_codec (GstTIDmaienc  *dmaienc)
     }
     GST_DEBUG("Output buffer handler: %p\n",dmaienc->outBuf);
 
+    name = g_strdup_printf("%s:out", GST_ELEMENT_NAME(dmaienc));
+    dmaienc->outPoolStats = gst_tidmaitelemetry_pool_new(name, "bytes",
+        dmaienc->outBufSize);
+    g_free(name);
+
+    if (encoder->eops->codec_type == AUDIO) {
+        Buffer_Attrs ringAttrs = Buffer_Attrs_DEFAULT;
+        Buffer_Attrs refAttrs = Buffer_Attrs_DEFAULT;
+
+        /* Staging ring for the raw samples, plus a reference buffer
+           pointing to the frame being encoded
+         */
+        dmaienc->ringSize = dmaienc->inBufSize * AUDIO_RING_FRAMES;
+        dmaienc->ringHead = dmaienc->ringTail = 0;
+        dmaienc->audioRing = Buffer_create(dmaienc->ringSize, &ringAttrs);
+
+        refAttrs.reference = TRUE;
+        dmaienc->audioFrame = Buffer_create(dmaienc->inBufSize, &refAttrs);
+
+        if (dmaienc->audioRing == NULL || dmaienc->audioFrame == NULL) {
+            GST_ELEMENT_ERROR(dmaienc,RESOURCE,NO_SPACE_LEFT,(NULL),
+                ("failed to create input buffers"));
+            return FALSE;
+        }
+        Buffer_setSize(dmaienc->audioFrame,dmaienc->inBufSize);
+        GST_DEBUG("Audio staging ring: %p, %d bytes\n",dmaienc->audioRing,
+            dmaienc->ringSize);
+    }
+
     return TRUE;
 }
 
@@ -773,6 +835,11 @@ static gboolean gst_tidmaienc_deconfigure_codec (GstTIDmaienc  *dmaienc)
         dmaienc->outBuf = NULL;
     }
 
+    if (dmaienc->outPoolStats) {
+        gst_tidmaitelemetry_pool_release(dmaienc->outPoolStats);
+        dmaienc->outPoolStats = NULL;
+    }
+
     GMUTEX_UNLOCK(dmaienc->freeMutex);
 #ifdef GLIB_2_31_AND_UP
     g_mutex_clear(&dmaienc->freeMutex);
@@ -789,9 +856,24 @@ static gboolean gst_tidmaienc_deconfigure_codec (GstTIDmaienc  *dmaienc)
         dmaienc->inBuf = NULL;
     }
 
+    if (dmaienc->audioFrame){
+        Buffer_delete(dmaienc->audioFrame);
+        dmaienc->audioFrame = NULL;
+    }
+
+    if (dmaienc->audioRing){
+        GST_DEBUG("freeing audio staging ring, %p\n",dmaienc->audioRing);
+        Buffer_delete(dmaienc->audioRing);
+        dmaienc->audioRing = NULL;
+    }
+    dmaienc->ringHead = dmaienc->ringTail = 0;
+    dmaienc->flushing = FALSE;
+
     if (dmaienc->hCodec) {
         GST_LOG("closing video encoder\n");
+        gst_ti_engine_lock(dmaienc->hEngine);
         encoder->eops->codec_destroy(dmaienc);
+        gst_ti_engine_unlock(dmaienc->hEngine);
         dmaienc->hCodec = NULL;
     }
     return TRUE;
@@ -989,6 +1071,65 @@ static gboolean gst_tidmaienc_set_sink_caps(GstPad *pad, GstCaps *caps)
 }
 
 
+/******************************************************************************
+ * gst_tidmaienc_request_key_unit
+ *     Handle a GstForceKeyUnit event: the codec is asked to produce a key
+ *     frame on the next process call, and a downstream GstForceKeyUnit
+ *     event is pushed in front of it.  The event is consumed.
+ ******************************************************************************/
+static gboolean gst_tidmaienc_request_key_unit(GstTIDmaienc *dmaienc,
+    GstEvent *event)
+{
+    const GstStructure *s = gst_event_get_structure(event);
+
+    if (!s || !gst_structure_has_name(s, "GstForceKeyUnit")) {
+        return FALSE;
+    }
+
+    GST_INFO_OBJECT(dmaienc, "key unit requested");
+
+    GST_OBJECT_LOCK(dmaienc);
+    if (dmaienc->keyUnit) {
+        gst_structure_free(dmaienc->keyUnit);
+    }
+    dmaienc->keyUnit = gst_structure_copy(s);
+    GST_OBJECT_UNLOCK(dmaienc);
+
+    g_atomic_int_set(&dmaienc->forceKeyFrame, TRUE);
+    gst_event_unref(event);
+
+    return TRUE;
+}
+
+/******************************************************************************
+ * gst_tidmaienc_push_key_unit
+ *     Push the downstream GstForceKeyUnit event of a pending request in
+ *     front of the key frame that satisfies it.
+ ******************************************************************************/
+static void gst_tidmaienc_push_key_unit(GstTIDmaienc *dmaienc,
+    GstBuffer *outBuf)
+{
+    GstStructure *s;
+
+    GST_OBJECT_LOCK(dmaienc);
+    s = dmaienc->keyUnit;
+    dmaienc->keyUnit = NULL;
+    GST_OBJECT_UNLOCK(dmaienc);
+
+    if (!s) {
+        return;
+    }
+
+    /* Requests coming from downstream only carry the running time */
+    if (!gst_structure_has_field(s, "timestamp")) {
+        gst_structure_set(s, "timestamp", G_TYPE_UINT64,
+            GST_BUFFER_TIMESTAMP(outBuf), (char *)NULL);
+    }
+
+    gst_pad_push_event(dmaienc->srcpad,
+        gst_event_new_custom(GST_EVENT_CUSTOM_DOWNSTREAM, s));
+}
+
 /******************************************************************************
  * gst_tidmaienc_sink_event
  *     Perform event processing.
@@ -1016,13 +1157,34 @@ static gboolean gst_tidmaienc_sink_event(GstPad *pad, GstEvent *event)
         ret = gst_pad_push_event(dmaienc->srcpad, event);
         break;
     case GST_EVENT_FLUSH_START:
-        /* Flush the adapter */
+        /* Not serialized: only unblock the chain function, the state is
+           reset on FLUSH_STOP once it has returned */
+        g_atomic_int_set(&dmaienc->flushing, TRUE);
+        ret = gst_pad_push_event(dmaienc->srcpad, event);
+        break;
+    case GST_EVENT_FLUSH_STOP:
+        /* Flush the adapter and the audio staging ring */
         gst_adapter_clear(dmaienc->adapter);
+        if (encoder->eops->codec_type == AUDIO) {
+            dmaienc->ringHead = dmaienc->ringTail = 0;
+            dmaienc->basets = GST_CLOCK_TIME_NONE;
+        }
         /* Flush the encoder */
         if (encoder->eops->codec_flush) {
+            gst_ti_engine_lock(dmaienc->hEngine);
             encoder->eops->codec_flush(dmaienc);
+            gst_ti_engine_unlock(dmaienc->hEngine);
         }
+        g_atomic_int_set(&dmaienc->flushing, FALSE);
 
+        ret = gst_pad_push_event(dmaienc->srcpad, event);
+        break;
+    case GST_EVENT_CUSTOM_DOWNSTREAM:
+        if (encoder->eops->force_key_frame &&
+            gst_tidmaienc_request_key_unit(dmaienc, event)) {
+            ret = TRUE;
+            break;
+        }
         ret = gst_pad_push_event(dmaienc->srcpad, event);
         break;
     default:
@@ -1033,6 +1195,62 @@ static gboolean gst_tidmaienc_sink_event(GstPad *pad, GstEvent *event)
     return ret;
 }
 
+/******************************************************************************
+ * gst_tidmaienc_src_event
+ *     Handle the events coming from downstream.
+ ******************************************************************************/
+static gboolean gst_tidmaienc_src_event(GstPad *pad, GstEvent *event)
+{
+    GstTIDmaienc *dmaienc;
+    gboolean      ret = FALSE;
+    GstTIDmaiencClass *gclass;
+    GstTIDmaiencData *encoder;
+
+    dmaienc =(GstTIDmaienc *) gst_pad_get_parent(pad);
+    gclass = (GstTIDmaiencClass *) (G_OBJECT_GET_CLASS (dmaienc));
+    encoder = (GstTIDmaiencData *)
+      g_type_get_qdata(G_OBJECT_CLASS_TYPE(gclass),GST_TIDMAIENC_PARAMS_QDATA);
+
+    GST_DEBUG("pad \"%s\" received:  %s\n", GST_PAD_NAME(pad),
+        GST_EVENT_TYPE_NAME(event));
+
+    switch (GST_EVENT_TYPE(event)) {
+    case GST_EVENT_CUSTOM_UPSTREAM:
+        if (encoder->eops->force_key_frame &&
+            gst_tidmaienc_request_key_unit(dmaienc, event)) {
+            ret = TRUE;
+            break;
+        }
+        ret = gst_pad_push_event(dmaienc->sinkpad, event);
+        break;
+    default:
+        ret = gst_pad_push_event(dmaienc->sinkpad, event);
+    }
+
+    gst_object_unref(dmaienc);
+    return ret;
+}
+
+/******************************************************************************
+ * encode_buffer_update_stats
+ *     Publish the occupancy of the output buffer, with the free mutex held
+ *****************************************************************************/
+static void encode_buffer_update_stats(GstTIDmaienc *dmaienc){
+    GList *e;
+    gint freeSize = 0, largestFree = 0;
+
+    for (e = dmaienc->freeSlices; e; e = g_list_next(e)){
+        struct cmemSlice *slice = (struct cmemSlice *)e->data;
+
+        freeSize += slice->size;
+        if (slice->size > largestFree)
+            largestFree = slice->size;
+    }
+
+    gst_tidmaitelemetry_set_used(dmaienc->outPoolStats, dmaienc->outBufSize,
+        dmaienc->outBufSize - freeSize, largestFree);
+}
+
 void release_cb(gpointer data, GstTIDmaiBufferTransport *buf){
     GstTIDmaienc *dmaienc = (GstTIDmaienc *)data;
 
@@ -1082,6 +1300,7 @@ void release_cb(gpointer data, GstTIDmaiBufferTransport *buf){
                         g_list_delete_link(dmaienc->freeSlices,e);
                 }
             }
+            encode_buffer_update_stats(dmaienc);
             GMUTEX_UNLOCK(dmaienc->freeMutex);
             return;
         }
@@ -1103,6 +1322,7 @@ void release_cb(gpointer data, GstTIDmaiBufferTransport *buf){
                         g_list_delete_link(dmaienc->freeSlices,g_list_next(e));
                 }
             }
+            encode_buffer_update_stats(dmaienc);
             GMUTEX_UNLOCK(dmaienc->freeMutex);
             return;
         }
@@ -1116,6 +1336,7 @@ void release_cb(gpointer data, GstTIDmaiBufferTransport *buf){
             nslice->size = buffer_size;
             dmaienc->freeSlices = g_list_insert_before(dmaienc->freeSlices,e,
                 nslice);
+            encode_buffer_update_stats(dmaienc);
             GMUTEX_UNLOCK(dmaienc->freeMutex);
             return;
         }
@@ -1133,6 +1354,7 @@ void release_cb(gpointer data, GstTIDmaiBufferTransport *buf){
     nslice->size = buffer_size;
     dmaienc->freeSlices = g_list_insert_before(dmaienc->freeSlices,NULL,
         nslice);
+    encode_buffer_update_stats(dmaienc);
     GMUTEX_UNLOCK(dmaienc->freeMutex);
 }
 
@@ -1158,6 +1380,7 @@ GList *sliceAvailable(GstTIDmaienc *dmaienc, gint *size){
              */
             slice->start += *size;
             slice->size -= *size;
+            encode_buffer_update_stats(dmaienc);
             GMUTEX_UNLOCK(dmaienc->freeMutex);
             return e;
         }
@@ -1169,6 +1392,11 @@ GList *sliceAvailable(GstTIDmaienc *dmaienc, gint *size){
 
         e = g_list_next(e);
     }
+    gst_tidmaitelemetry_failed(dmaienc->outPoolStats);
+    if (!maxSliceAvailable){
+        GMUTEX_UNLOCK(dmaienc->freeMutex);
+        return NULL;
+    }
     GST_WARNING(
       "Free memory not found, using our best available free block of size %d...",
       *size);
@@ -1177,6 +1405,7 @@ GList *sliceAvailable(GstTIDmaienc *dmaienc, gint *size){
     *size = maxSliceAvailable->size;
     maxSliceAvailable->size = 0;
 
+    encode_buffer_update_stats(dmaienc);
     GMUTEX_UNLOCK(dmaienc->freeMutex);
     return a;
 }
@@ -1269,6 +1498,14 @@ Buffer_Handle get_raw_buffer(GstTIDmaienc *dmaienc, GstBuffer *buf){
                 attrs = &gfxAttrs.bAttrs;
                 break;
             default:
+                if (dmaienc->audioFrame){
+                    /* The samples are already staged in contiguous memory */
+                    Buffer_setUserPtr(dmaienc->audioFrame,
+                        (Int8 *)GST_BUFFER_DATA(buf));
+                    Buffer_setNumBytesUsed(dmaienc->audioFrame,
+                        dmaienc->inBufSize);
+                    return dmaienc->audioFrame;
+                }
                 attrs= &Attrs;
         }
         /* Allocate a Buffer tab and copy the data there */
@@ -1315,16 +1552,22 @@ static int encode(GstTIDmaienc *dmaienc,GstBuffer * rawData){
     /* Obtain a free output buffer for the raw data */
     hSrcBuf = get_raw_buffer(dmaienc,rawData);
     hDstBuf = encode_buffer_get_free(dmaienc,&element);
-    bufferSize = Buffer_getNumBytesUsed(hDstBuf);
 
     if (!hSrcBuf || !hDstBuf){
         goto failure;
     }
+    bufferSize = Buffer_getNumBytesUsed(hDstBuf);
     slice = (struct cmemSlice *)element->data;
 
+    /* The engine handle may be shared with other elements, and the
+     * process call may also apply dynamic params (a control call)
+     */
+    gst_ti_engine_lock(dmaienc->hEngine);
     if (!encoder->eops->codec_process(dmaienc,hSrcBuf,hDstBuf)){
+        gst_ti_engine_unlock(dmaienc->hEngine);
         goto failure;
     }
+    gst_ti_engine_unlock(dmaienc->hEngine);
 
     /* Create a DMAI transport buffer object to carry a DMAI buffer to
      * the source pad.  The transport buffer knows how to release the
@@ -1332,6 +1575,8 @@ static int encode(GstTIDmaienc *dmaienc,GstBuffer * rawData){
      * gst_buffer_unref().
          */
     outBuf = gst_tidmaibuffertransport_new(hDstBuf,NULL, NULL, FALSE);
+    gst_tidmaibuffertransport_set_owner((GstTIDmaiBufferTransport *)outBuf,
+        GST_ELEMENT(dmaienc));
     GST_BUFFER_SIZE(outBuf) = Buffer_getNumBytesUsed(hDstBuf);
     GST_DEBUG("Encoded buffer: %d size=%d\n", Buffer_getUserPtr(hDstBuf), GST_BUFFER_SIZE(outBuf));
 
@@ -1349,6 +1594,7 @@ static int encode(GstTIDmaienc *dmaienc,GstBuffer * rawData){
         g_free(slice);
         dmaienc->freeSlices = g_list_delete_link (dmaienc->freeSlices,element);
     }
+    encode_buffer_update_stats(dmaienc);
     GMUTEX_UNLOCK(dmaienc->freeMutex);
 
     gst_tidmaibuffertransport_set_release_callback(
@@ -1397,6 +1643,7 @@ static int encode(GstTIDmaienc *dmaienc,GstBuffer * rawData){
          */
         if (dmaienc->lastFrameType == dmaienc->keyFrameType){
             GST_BUFFER_FLAG_UNSET(outBuf, GST_BUFFER_FLAG_DELTA_UNIT);
+            gst_tidmaienc_push_key_unit(dmaienc, outBuf);
         } else {
             GST_BUFFER_FLAG_SET(outBuf, GST_BUFFER_FLAG_DELTA_UNIT);
         }
@@ -1425,6 +1672,8 @@ static int encode(GstTIDmaienc *dmaienc,GstBuffer * rawData){
            GST_TIDMAIBUFFERTRANSPORT_DMAIBUF(rawData) == hSrcBuf) 
           ||
           (hSrcBuf == dmaienc->inBuf)
+          ||
+          (hSrcBuf == dmaienc->audioFrame)
          )){
         Buffer_delete(hSrcBuf);
         hSrcBuf = NULL;
@@ -1453,27 +1702,93 @@ failure:
     return ret;
 }
 
-static GstBuffer *adapter_get_buffer(GstTIDmaienc *dmaienc, 
-    GstTIDmaiencData *encoder){
-    GstBuffer *buf = NULL;
-    const guint8 *buffer = NULL;
+/******************************************************************************
+ * gst_tidmaienc_audio_chain
+ *    Copy the raw samples into the staging ring, and encode every complete
+ *    codec frame straight from there.  Timestamps are interpolated from
+ *    the samples consumed by the codec.
+ ******************************************************************************/
+static GstFlowReturn gst_tidmaienc_audio_chain(GstTIDmaienc *dmaienc,
+    GstBuffer *buf){
+    guint8 *ring, *data;
+    gint avail, size, bytesConsumed;
+    GstBuffer *frame;
+
+    if (!dmaienc->audioRing){
+        GST_ELEMENT_ERROR(dmaienc,CORE,NEGOTIATION,(NULL),
+            ("Received audio before the encoder was configured"));
+        gst_buffer_unref(buf);
+        return GST_FLOW_NOT_NEGOTIATED;
+    }
 
-    if (encoder->eops->codec_type == AUDIO){
-        buffer = gst_adapter_peek(dmaienc->adapter,dmaienc->inBufSize);
-        buf = gst_buffer_new();
-        GST_BUFFER_DATA(buf) = (guint8 *)buffer;
-        GST_BUFFER_SIZE(buf) = dmaienc->inBufSize;
-        GST_BUFFER_TIMESTAMP(buf) = dmaienc->basets;
-        GST_BUFFER_DURATION(buf) = (dmaienc->inBufSize / dmaienc->asampleSize)
-            * dmaienc->asampleTime;
-    } else {
-        /* For Video processing we want to use gst_adapter_take_buffer
-         * because it keeps the timestamps
-         */
-        buf = gst_adapter_take_buffer(dmaienc->adapter,dmaienc->inBufSize);
+    ring = (guint8 *)Buffer_getUserPtr(dmaienc->audioRing);
+    data = GST_BUFFER_DATA(buf);
+    avail = GST_BUFFER_SIZE(buf);
+
+    if (!GST_CLOCK_TIME_IS_VALID(dmaienc->basets)){
+        dmaienc->basets = GST_BUFFER_TIMESTAMP(buf);
     }
 
-    return buf;
+    while (avail > 0){
+        /* Move the leftover (less than a codec frame) to the start */
+        if (dmaienc->ringSize - dmaienc->ringHead < avail &&
+            dmaienc->ringTail > 0){
+            memmove(ring, ring + dmaienc->ringTail,
+                dmaienc->ringHead - dmaienc->ringTail);
+            dmaienc->ringHead -= dmaienc->ringTail;
+            dmaienc->ringTail = 0;
+        }
+
+        size = MIN(avail, dmaienc->ringSize - dmaienc->ringHead);
+        memcpy(ring + dmaienc->ringHead, data, size);
+        dmaienc->ringHead += size;
+        data += size;
+        avail -= size;
+
+        while (dmaienc->ringHead - dmaienc->ringTail >= dmaienc->inBufSize){
+            if (g_atomic_int_get(&dmaienc->flushing)){
+                GST_DEBUG("Flushing, dropping the staged samples");
+                gst_buffer_unref(buf);
+                return GST_FLOW_WRONG_STATE;
+            }
+
+            frame = gst_buffer_new();
+            GST_BUFFER_DATA(frame) = ring + dmaienc->ringTail;
+            GST_BUFFER_SIZE(frame) = dmaienc->inBufSize;
+            GST_BUFFER_TIMESTAMP(frame) = dmaienc->basets;
+            GST_BUFFER_DURATION(frame) =
+                (dmaienc->inBufSize / dmaienc->asampleSize)
+                * dmaienc->asampleTime;
+
+            bytesConsumed = encode(dmaienc, frame);
+            if (bytesConsumed < 0) {
+                GST_ELEMENT_ERROR(dmaienc,STREAM,FAILED,(NULL),
+                    ("Failed to encode buffer"));
+                gst_buffer_unref(buf);
+                return GST_FLOW_UNEXPECTED;
+            }
+            if (bytesConsumed == 0) {
+                GST_WARNING_OBJECT(dmaienc,
+                    "Codec consumed no samples, dropping the frame");
+                bytesConsumed = dmaienc->inBufSize;
+            }
+
+            dmaienc->ringTail += bytesConsumed;
+            dmaienc->basets += (bytesConsumed / dmaienc->asampleSize)
+                * dmaienc->asampleTime;
+        }
+
+        if (dmaienc->ringTail == dmaienc->ringHead){
+            dmaienc->ringHead = dmaienc->ringTail = 0;
+        }
+    }
+
+    if (dmaienc->ringHead == 0){
+        dmaienc->basets = GST_CLOCK_TIME_NONE;
+    }
+    gst_buffer_unref(buf);
+
+    return GST_FLOW_OK;
 }
 
 /******************************************************************************
@@ -1494,6 +1809,16 @@ static GstFlowReturn gst_tidmaienc_chain(GstPad * pad, GstBuffer * buf)
     encoder = (GstTIDmaiencData *)
        g_type_get_qdata(G_OBJECT_CLASS_TYPE(gclass),GST_TIDMAIENC_PARAMS_QDATA);
 
+    if (g_atomic_int_get(&dmaienc->flushing)){
+        GST_DEBUG("Dropping buffer while flushing");
+        gst_buffer_unref(buf);
+        return GST_FLOW_WRONG_STATE;
+    }
+
+    if (encoder->eops->codec_type == AUDIO){
+        return gst_tidmaienc_audio_chain(dmaienc, buf);
+    }
+
     if (!GST_IS_TIDMAIBUFFERTRANSPORT(buf) ||
         Buffer_getType(GST_TIDMAIBUFFERTRANSPORT_DMAIBUF(buf))
           != Buffer_Type_GRAPHICS){
@@ -1505,8 +1830,9 @@ static GstFlowReturn gst_tidmaienc_chain(GstPad * pad, GstBuffer * buf)
         /* Push the buffer into the adapter*/
         gst_adapter_push(dmaienc->adapter,buf);
 
+        /* gst_adapter_take_buffer keeps the timestamps */
         if (gst_adapter_available(dmaienc->adapter) >= dmaienc->inBufSize){
-            buf = adapter_get_buffer(dmaienc,encoder);
+            buf = gst_adapter_take_buffer(dmaienc->adapter,dmaienc->inBufSize);
         } else {
             buf = NULL;
         }
@@ -1524,21 +1850,6 @@ static GstFlowReturn gst_tidmaienc_chain(GstPad * pad, GstBuffer * buf)
             gst_buffer_unref(buf);
             return GST_FLOW_UNEXPECTED;
         }
-
-        if (encoder->eops->codec_type == AUDIO) {
-            /* Need to flush the adapter */
-            gst_adapter_flush(dmaienc->adapter,bytesConsumed);
-            if (gst_adapter_available(dmaienc->adapter) == 0) {
-                dmaienc->basets = GST_CLOCK_TIME_NONE;
-            } else {
-                dmaienc->basets += (bytesConsumed / dmaienc->asampleSize)
-                    * dmaienc->asampleTime;
-            }
-
-            if (gst_adapter_available(dmaienc->adapter) >= dmaienc->inBufSize){
-                buf = adapter_get_buffer(dmaienc,encoder);
-            }
-        }
     }
 
     return GST_FLOW_OK;
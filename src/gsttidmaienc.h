@@ -35,6 +35,7 @@
 #include <gst/base/gstadapter.h>
 #include <pthread.h>
 #include "gstticommonutils.h"
+#include "gsttidmaitelemetry.h"
 
 #include <xdc/std.h>
 #include <ti/sdo/ce/Engine.h>
@@ -96,6 +97,16 @@ struct _GstTIDmaienc
 #else
     GMutex              *freeMutex;
 #endif
+    GstTIDmaiPoolStats  *outPoolStats;
+    /* Audio staging ring: raw samples are copied once into contiguous
+       memory and handed to the codec from there */
+    Buffer_Handle       audioRing;
+    Buffer_Handle       audioFrame;
+    gint                ringSize;
+    gint                ringHead;
+    gint                ringTail;
+    /* Set between FLUSH_START and FLUSH_STOP, the chain function bails out */
+    gint                flushing;
     /* Audio Data */
     gint                channels;
     gint                depth;
@@ -117,6 +128,11 @@ struct _GstTIDmaienc
     Int32               lastFrameType;
     Int32               keyFrameType;
     gboolean            fixTimestamp;
+    /* Key frame requests and dynamic parameter changes, applied by the
+       codec on the next process call */
+    gint                forceKeyFrame;
+    gint                dynParamsChanged;
+    GstStructure        *keyUnit;
     /* Stream specific structure to inform the parser
        about the format generated by the codec. For example
        for h264 it states if the codec generates bytestream
@@ -140,6 +156,8 @@ struct _GstTIDmaiencClass
 struct gstti_encoder_ops {
     const gchar             *xdmversion;
     enum dmai_codec_type    codec_type;
+    /* The codec honours forceKeyFrame, so GstForceKeyUnit can be handled */
+    gboolean                force_key_frame;
     /* Functions to provide custom properties */
     void                    (*install_properties)(GObjectClass *);
     void                    (*set_property)
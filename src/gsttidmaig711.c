@@ -0,0 +1,352 @@
+/*
+ * gsttidmaig711.c
+ *
+ * This file defines the native g711 decoder and encoder.  G.711 is a table
+ * lookup per sample, so running it on the ARM is cheaper than a Codec
+ * Engine call.  The elements are registered as "dmaidec_g711" and
+ * "dmaienc_g711" (the g711 server codecs are speech algorithms, which the
+ * plugin doesn't drive).
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifdef HAVE_CONFIG_H
+#  include <config.h>
+#endif
+
+#include <stdio.h>
+#include <string.h>
+#include <gst/gst.h>
+
+#include "gsttidmaig711.h"
+#include "gsttisupport_g711.h"
+
+/* Declare variable used to categorize GST_LOG output */
+GST_DEBUG_CATEGORY_STATIC (gst_tidmaig711_debug);
+#define GST_CAT_DEFAULT gst_tidmaig711_debug
+
+#define G711_RAW_CAPS \
+    "audio/x-raw-int, " \
+    "   width = (int) 16, " \
+    "   depth = (int) 16, " \
+    "   signed = (boolean) TRUE, " \
+    "   endianness = (int) BYTE_ORDER, " \
+    "   channels = (int) [ 1, 2 ], " \
+    "   rate = (int) [ 8000, MAX ]"
+
+#define G711_CODED_CAPS \
+    "audio/x-alaw, " \
+    "   rate = (int) [ 8000, MAX ], " \
+    "   channels = (int) [ 1, 2 ]; " \
+    "audio/x-mulaw, " \
+    "   rate = (int) [ 8000, MAX ], " \
+    "   channels = (int) [ 1, 2 ]"
+
+static GstStaticPadTemplate dec_sink_factory = GST_STATIC_PAD_TEMPLATE(
+    "sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS(G711_CODED_CAPS));
+static GstStaticPadTemplate dec_src_factory = GST_STATIC_PAD_TEMPLATE(
+    "src", GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS(G711_RAW_CAPS));
+static GstStaticPadTemplate enc_sink_factory = GST_STATIC_PAD_TEMPLATE(
+    "sink", GST_PAD_SINK, GST_PAD_ALWAYS, GST_STATIC_CAPS(G711_RAW_CAPS));
+static GstStaticPadTemplate enc_src_factory = GST_STATIC_PAD_TEMPLATE(
+    "src", GST_PAD_SRC, GST_PAD_ALWAYS, GST_STATIC_CAPS(G711_CODED_CAPS));
+
+/* Static Function Declarations */
+static void
+ gst_tidmaig711dec_base_init(gpointer g_class);
+static void
+ gst_tidmaig711enc_base_init(gpointer g_class);
+static void
+ gst_tidmaig711_class_init(GstTIDmaiG711Class *g_class, gpointer decoder);
+static GstCaps *gst_tidmaig711_transform_caps(GstBaseTransform *trans,
+    GstPadDirection direction, GstCaps *caps);
+static gboolean gst_tidmaig711_get_unit_size(GstBaseTransform *trans,
+    GstCaps *caps, guint *size);
+static gboolean gst_tidmaig711_set_caps(GstBaseTransform *trans,
+    GstCaps *in, GstCaps *out);
+static GstFlowReturn gst_tidmaig711_transform(GstBaseTransform *trans,
+    GstBuffer *inBuf, GstBuffer *outBuf);
+
+/******************************************************************************
+ * gst_tidmaig711_init
+ *****************************************************************************/
+static void gst_tidmaig711_init (GstTIDmaiG711 *g711)
+{
+    g711->alaw = FALSE;
+    g711->channels = 0;
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_register_type
+ *    Defines function pointers for initialization routines for the decoder
+ *    or encoder type.
+ ******************************************************************************/
+static GType gst_tidmaig711_register_type(const gchar *name,
+    GBaseInitFunc base_init, gboolean decoder)
+{
+    GTypeInfo object_info = {
+        sizeof(GstTIDmaiG711Class),
+        base_init,
+        NULL,
+        (GClassInitFunc)gst_tidmaig711_class_init,
+        NULL,
+        GINT_TO_POINTER(decoder),
+        sizeof(GstTIDmaiG711),
+        0,
+        (GInstanceInitFunc) gst_tidmaig711_init
+    };
+
+    /* Initialize GST_LOG for this object */
+    GST_DEBUG_CATEGORY_INIT(gst_tidmaig711_debug, "TIDmaig711", 0,
+        "TI DMAI native g711");
+
+    return g_type_register_static(GST_TYPE_BASE_TRANSFORM, name,
+        &object_info, (GTypeFlags)0);
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711dec_get_type
+ ******************************************************************************/
+GType gst_tidmaig711dec_get_type(void)
+{
+    static GType object_type = 0;
+
+    if (G_UNLIKELY(object_type == 0)) {
+        object_type = gst_tidmaig711_register_type("GstTIDmaiG711Dec",
+            gst_tidmaig711dec_base_init, TRUE);
+
+        GST_LOG("initialized get_type\n");
+    }
+
+    return object_type;
+};
+
+
+/******************************************************************************
+ * gst_tidmaig711enc_get_type
+ ******************************************************************************/
+GType gst_tidmaig711enc_get_type(void)
+{
+    static GType object_type = 0;
+
+    if (G_UNLIKELY(object_type == 0)) {
+        object_type = gst_tidmaig711_register_type("GstTIDmaiG711Enc",
+            gst_tidmaig711enc_base_init, FALSE);
+
+        GST_LOG("initialized get_type\n");
+    }
+
+    return object_type;
+};
+
+
+/******************************************************************************
+ * gst_tidmaig711dec_base_init
+ ******************************************************************************/
+static void gst_tidmaig711dec_base_init(gpointer gclass)
+{
+    static GstElementDetails element_details = {
+        "DMAI g711 Audio Decoder",
+        "Codec/Decoder/Audio",
+        "Native A-law and u-law decoder",
+        "Texas Instruments, Inc."
+    };
+
+    GstElementClass *element_class = GST_ELEMENT_CLASS(gclass);
+
+    gst_element_class_add_pad_template(element_class,
+        gst_static_pad_template_get (&dec_src_factory));
+    gst_element_class_add_pad_template(element_class,
+        gst_static_pad_template_get (&dec_sink_factory));
+    gst_element_class_set_details(element_class, &element_details);
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711enc_base_init
+ ******************************************************************************/
+static void gst_tidmaig711enc_base_init(gpointer gclass)
+{
+    static GstElementDetails element_details = {
+        "DMAI g711 Audio Encoder",
+        "Codec/Encoder/Audio",
+        "Native A-law and u-law encoder",
+        "Texas Instruments, Inc."
+    };
+
+    GstElementClass *element_class = GST_ELEMENT_CLASS(gclass);
+
+    gst_element_class_add_pad_template(element_class,
+        gst_static_pad_template_get (&enc_src_factory));
+    gst_element_class_add_pad_template(element_class,
+        gst_static_pad_template_get (&enc_sink_factory));
+    gst_element_class_set_details(element_class, &element_details);
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_class_init
+ ******************************************************************************/
+static void gst_tidmaig711_class_init(GstTIDmaiG711Class *klass,
+    gpointer decoder)
+{
+    GstBaseTransformClass   *trans_class;
+
+    trans_class      = (GstBaseTransformClass *) klass;
+
+    klass->decoder = GPOINTER_TO_INT(decoder);
+
+    trans_class->transform_caps =
+        GST_DEBUG_FUNCPTR(gst_tidmaig711_transform_caps);
+    trans_class->get_unit_size =
+        GST_DEBUG_FUNCPTR(gst_tidmaig711_get_unit_size);
+    trans_class->set_caps  = GST_DEBUG_FUNCPTR(gst_tidmaig711_set_caps);
+    trans_class->transform = GST_DEBUG_FUNCPTR(gst_tidmaig711_transform);
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_transform_caps
+ *    Raw samples are on the src pad of the decoder and on the sink pad of
+ *    the encoder.  Rate and channels are kept across the element.
+ ******************************************************************************/
+static GstCaps *gst_tidmaig711_transform_caps(GstBaseTransform *trans,
+    GstPadDirection direction, GstCaps *caps)
+{
+    GstTIDmaiG711Class *klass = GST_TIDMAIG711_GET_CLASS(trans);
+    gboolean toRaw = ((direction == GST_PAD_SINK) == klass->decoder);
+    static const gchar *coded[] = { "audio/x-alaw", "audio/x-mulaw" };
+    GstCaps *ret = gst_caps_new_empty();
+    guint i, j;
+
+    for (i = 0; i < gst_caps_get_size(caps); i++) {
+        GstStructure *s = gst_caps_get_structure(caps, i);
+        const GValue *rate = gst_structure_get_value(s, "rate");
+        const GValue *channels = gst_structure_get_value(s, "channels");
+
+        for (j = 0; j < (toRaw ? 1 : G_N_ELEMENTS(coded)); j++) {
+            GstStructure *t;
+
+            if (toRaw) {
+                t = gst_structure_new("audio/x-raw-int",
+                    "width", G_TYPE_INT, 16,
+                    "depth", G_TYPE_INT, 16,
+                    "signed", G_TYPE_BOOLEAN, TRUE,
+                    "endianness", G_TYPE_INT, G_BYTE_ORDER,
+                    (char *)NULL);
+            } else {
+                t = gst_structure_new(coded[j], (char *)NULL);
+            }
+            if (rate)
+                gst_structure_set_value(t, "rate", rate);
+            if (channels)
+                gst_structure_set_value(t, "channels", channels);
+
+            gst_caps_append_structure(ret, t);
+        }
+    }
+
+    GST_LOG_OBJECT(trans, "transformed %" GST_PTR_FORMAT " into %"
+        GST_PTR_FORMAT, caps, ret);
+    return ret;
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_get_unit_size
+ *    One sample frame: a byte per channel coded, two bytes per channel raw
+ ******************************************************************************/
+static gboolean gst_tidmaig711_get_unit_size(GstBaseTransform *trans,
+    GstCaps *caps, guint *size)
+{
+    GstStructure *s = gst_caps_get_structure(caps, 0);
+    gint channels;
+
+    if (!gst_structure_get_int(s, "channels", &channels))
+        return FALSE;
+
+    *size = channels;
+    if (gst_structure_has_name(s, "audio/x-raw-int"))
+        *size *= 2;
+
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_set_caps
+ ******************************************************************************/
+static gboolean gst_tidmaig711_set_caps(GstBaseTransform *trans,
+    GstCaps *in, GstCaps *out)
+{
+    GstTIDmaiG711 *g711 = GST_TIDMAIG711(trans);
+    GstTIDmaiG711Class *klass = GST_TIDMAIG711_GET_CLASS(trans);
+    GstStructure *s;
+
+    s = gst_caps_get_structure(klass->decoder ? in : out, 0);
+    if (!gst_structure_get_int(s, "channels", &g711->channels)) {
+        GST_ELEMENT_ERROR(g711, STREAM, FORMAT, (NULL),
+            ("No channels on the caps"));
+        return FALSE;
+    }
+    g711->alaw = gst_structure_has_name(s, "audio/x-alaw");
+
+    GST_DEBUG_OBJECT(g711, "%s, %d channels", g711->alaw ? "A-law" : "u-law",
+        g711->channels);
+    return TRUE;
+}
+
+
+/******************************************************************************
+ * gst_tidmaig711_transform
+ ******************************************************************************/
+static GstFlowReturn gst_tidmaig711_transform(GstBaseTransform *trans,
+    GstBuffer *inBuf, GstBuffer *outBuf)
+{
+    GstTIDmaiG711 *g711 = GST_TIDMAIG711(trans);
+    GstTIDmaiG711Class *klass = GST_TIDMAIG711_GET_CLASS(trans);
+    gint samples;
+
+    if (klass->decoder) {
+        samples = GST_BUFFER_SIZE(inBuf);
+        if (g711->alaw) {
+            gstti_g711_alaw_decode((gint16 *)GST_BUFFER_DATA(outBuf),
+                GST_BUFFER_DATA(inBuf), samples);
+        } else {
+            gstti_g711_ulaw_decode((gint16 *)GST_BUFFER_DATA(outBuf),
+                GST_BUFFER_DATA(inBuf), samples);
+        }
+    } else {
+        samples = GST_BUFFER_SIZE(inBuf) / 2;
+        if (g711->alaw) {
+            gstti_g711_alaw_encode(GST_BUFFER_DATA(outBuf),
+                (const gint16 *)GST_BUFFER_DATA(inBuf), samples);
+        } else {
+            gstti_g711_ulaw_encode(GST_BUFFER_DATA(outBuf),
+                (const gint16 *)GST_BUFFER_DATA(inBuf), samples);
+        }
+    }
+
+    return GST_FLOW_OK;
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,76 @@
+/*
+ * gsttidmaig711.h
+ *
+ * This file declares the native g711 decoder and encoder, registered as
+ * "dmaidec_g711" and "dmaienc_g711".
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef __GST_TIDMAIG711_H__
+#define __GST_TIDMAIG711_H__
+
+#include <gst/gst.h>
+#include <gst/base/gstbasetransform.h>
+
+G_BEGIN_DECLS
+
+/* Standard macros for manipulating TIDmaiG711 objects */
+#define GST_TYPE_TIDMAIG711DEC \
+  (gst_tidmaig711dec_get_type())
+#define GST_TYPE_TIDMAIG711ENC \
+  (gst_tidmaig711enc_get_type())
+#define GST_TIDMAIG711(obj) \
+  ((GstTIDmaiG711 *)(obj))
+#define GST_TIDMAIG711_GET_CLASS(obj) \
+  ((GstTIDmaiG711Class *)(G_OBJECT_GET_CLASS(obj)))
+
+typedef struct _GstTIDmaiG711      GstTIDmaiG711;
+typedef struct _GstTIDmaiG711Class GstTIDmaiG711Class;
+
+/* _GstTIDmaiG711 object */
+struct _GstTIDmaiG711
+{
+  /* gStreamer infrastructure */
+  GstBaseTransform    element;
+
+  /* TRUE for A-law, FALSE for u-law */
+  gboolean            alaw;
+  gint                channels;
+};
+
+/* _GstTIDmaiG711Class object */
+struct _GstTIDmaiG711Class
+{
+  GstBaseTransformClass parent_class;
+
+  /* TRUE on the decoder, FALSE on the encoder */
+  gboolean              decoder;
+};
+
+/* External function declarations */
+GType gst_tidmaig711dec_get_type(void);
+GType gst_tidmaig711enc_get_type(void);
+
+G_END_DECLS
+
+#endif /* __GST_TIDMAIG711_H__ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
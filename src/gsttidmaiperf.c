@@ -60,6 +60,53 @@
  * segment, the following keys are used: mem_seg, base, size, 
  * maxblocklen, and used.
  * </refsect2>
+ *
+ * <refsect2>
+ * <title>Latency measurement</title>
+ * |[
+ * gst-launch v4l2src ! dmaiperf role=start probe-id=enc ! TIVidenc1 codecName=h264enc engineName=codecServer ! dmaiperf role=end probe-id=enc ! rtph264pay ! udpsink
+ * ]| The end probe adds the transit time of the buffers between both
+ * elements to its performance data, matching the buffers by timestamp:
+ * |[
+ * latency: 1234 samples; min: 20.125 ms; avg: 24.510 ms; p95: 30.002 ms; p99: 33.871 ms; max: 35.120 ms;
+ * ]|
+ * </refsect2>
+ *
+ * <refsect2>
+ * <title>Frame pacing and export</title>
+ * Every period also reports the minimum, maximum and 99th percentile of
+ * the interval between buffer arrivals, and the number of gaps found on
+ * the buffer timestamps:
+ * |[
+ * interval: min: 32.950 ms; max: 34.102 ms; p99: 34.010 ms; ts-gaps: 0;
+ * ]|
+ * Setting location writes one record per period to a file, with the
+ * log2 histograms of the arrival intervals and buffer durations (bucket
+ * n holds values below 256 << n microseconds).  The file is JSON lines
+ * if its name ends with .json, and CSV otherwise.
+ * </refsect2>
+ *
+ * <refsect2>
+ * <title>Per-thread CPU load</title>
+ * With print-threads set, the load of every thread of the process that
+ * ran during the period is added, as percent of one CPU.  Streaming
+ * threads are named after the pad running them:
+ * |[
+ * thread: vidsrc:src(812): 12.4; thread: queue0:src(815): 41.0;
+ * ]|
+ * </refsect2>
+ *
+ * <refsect2>
+ * <title>Buffer pool occupancy</title>
+ * With print-pools set, the occupancy of the contiguous buffer pools of
+ * the decoders, encoders and dmaiaccel is added.  The high-water mark,
+ * the smallest largest free block seen and the time spent blocked waiting
+ * for a free buffer tell how far numOutputBufs or outBufMultiple can be
+ * reduced, or if they need to grow:
+ * |[
+ * pool: TIViddec2-0:out; used: 3/4 bufs; high-water: 4; largest-free: 1 (min 0); blocked: 12.501 ms (3); failures: 0;
+ * ]|
+ * </refsect2>
  */
 
 #ifdef HAVE_CONFIG_H
@@ -67,18 +114,60 @@
 #endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <unistd.h>
 #include <gst/gst.h>
 #include <gst/video/video.h>
 #include <ti/sdo/dmai/Dmai.h>
 #include "gsttidmaiperf.h"
+#include "gsttidmaitelemetry.h"
+#include "gstticommonutils.h"
 
 /* Declare variable used to categorize GST_LOG output */
 GST_DEBUG_CATEGORY_STATIC (gst_dmaiperf_debug);
 #define GST_CAT_DEFAULT gst_dmaiperf_debug
 
-/* The message is variable length depending on configuration */
-#define GST_TIME_FORMAT_MAX_SIZE 4096
+/* Maximum number of buffers the start probe keeps track of */
+#define DMAIPERF_PROBE_MAX_PENDING 512
+
+/* The histograms use log2 buckets: bucket 0 counts the values under 256 us,
+ * bucket N the values in [128 << N, 256 << N) us, the last one everything
+ * above */
+#define DMAIPERF_HIST_SHIFT 8
+
+/* Time values as ms with us precision, for the info message */
+#define DMAIPERF_MS_FORMAT "%u.%03u ms"
+#define DMAIPERF_MS_ARGS(t) (guint) ((t) / GST_MSECOND), \
+    (guint) (((t) % GST_MSECOND) / GST_USECOND)
+
+/* Statistics of a series of time samples */
+struct dmaiperf_stats
+{
+  guint samples;
+  GstClockTime min;
+  GstClockTime avg;
+  GstClockTime p95;
+  GstClockTime p99;
+  GstClockTime max;
+};
+
+/* Marks the end of the export queue */
+static gchar export_eos[] = "";
+
+/* Shared state between the start and end probes with the same probe-id */
+struct _GstDmaiperfProbe
+{
+  gchar *probeId;
+  gint refcount;
+  pthread_mutex_t mutex;
+  /* Buffer timestamp -> time the buffer went through the start probe */
+  GHashTable *pending;
+  GQueue *order;
+};
+
+static GHashTable *probes = NULL;
+static pthread_mutex_t probes_mutex = PTHREAD_MUTEX_INITIALIZER;
 
 
 /* Element property identifier */
@@ -86,7 +175,12 @@ enum
 {
   PROP_0,
   PROP_ENGINE_NAME,
-  PROP_PRINT_ARM_LOAD
+  PROP_PRINT_ARM_LOAD,
+  PROP_PRINT_THREADS,
+  PROP_PRINT_POOLS,
+  PROP_ROLE,
+  PROP_PROBE_ID,
+  PROP_LOCATION
 };
 
 static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE ("sink",
@@ -114,6 +208,7 @@ static gboolean gst_dmaiperf_start (GstBaseTransform * trans);
 static gboolean gst_dmaiperf_stop (GstBaseTransform * trans);
 static void gst_dmaiperf_set_property (GObject * object, guint prop_id,
     const GValue * value, GParamSpec * pspec);
+static void gst_dmaiperf_finalize (GObject * object);
 
 /******************************************************************************
  * gst_dmaiperf_init
@@ -131,7 +226,34 @@ gst_dmaiperf_init (GstDmaiperf * dmaiperf, GstDmaiperfClass * gclass)
   dmaiperf->engineName = NULL;
   dmaiperf->hCpu = NULL;
   dmaiperf->printArmLoad = FALSE;
+  dmaiperf->printThreads = FALSE;
+  dmaiperf->printPools = FALSE;
+  dmaiperf->threadTicks = NULL;
+  dmaiperf->threadLoads = NULL;
   dmaiperf->error = NULL;
+  dmaiperf->role = DMAIPERF_ROLE_NONE;
+  dmaiperf->probeId = NULL;
+  dmaiperf->probe = NULL;
+  dmaiperf->latencies = NULL;
+  dmaiperf->intervals = NULL;
+  dmaiperf->location = NULL;
+  dmaiperf->exportFile = NULL;
+  dmaiperf->exportQueue = NULL;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_finalize
+ *    Frees the string properties.
+ *****************************************************************************/
+static void
+gst_dmaiperf_finalize (GObject * object)
+{
+  GstDmaiperf *dmaiperf = (GstDmaiperf *) object;
+
+  g_free (dmaiperf->probeId);
+  g_free (dmaiperf->location);
+
+  G_OBJECT_CLASS (parent_class)->finalize (object);
 }
 
 /******************************************************************************
@@ -207,6 +329,7 @@ gst_dmaiperf_class_init (GstDmaiperfClass * klass)
   gobject_class = (GObjectClass *) klass;
 
   gobject_class->set_property = gst_dmaiperf_set_property;
+  gobject_class->finalize = gst_dmaiperf_finalize;
   gobject_class = (GObjectClass *) klass;
   trans_class = (GstBaseTransformClass *) klass;
 
@@ -226,6 +349,32 @@ gst_dmaiperf_class_init (GstDmaiperfClass * klass)
       g_param_spec_boolean ("print-arm-load", "print-arm-load",
           "Print the CPU load info", FALSE, G_PARAM_WRITABLE));
 
+  g_object_class_install_property (gobject_class, PROP_PRINT_THREADS,
+      g_param_spec_boolean ("print-threads", "print-threads",
+          "Print the CPU load of each thread of the process",
+          FALSE, G_PARAM_WRITABLE));
+
+  g_object_class_install_property (gobject_class, PROP_PRINT_POOLS,
+      g_param_spec_boolean ("print-pools", "print-pools",
+          "Print the occupancy of the contiguous buffer pools",
+          FALSE, G_PARAM_WRITABLE));
+
+  g_object_class_install_property (gobject_class, PROP_ROLE,
+      g_param_spec_string ("role", "role",
+          "Role on latency measurement: \"start\" or \"end\" probe",
+          NULL, G_PARAM_WRITABLE));
+
+  g_object_class_install_property (gobject_class, PROP_PROBE_ID,
+      g_param_spec_string ("probe-id", "probe-id",
+          "Identifier shared by the start and end probes of a latency "
+          "measurement", NULL, G_PARAM_WRITABLE));
+
+  g_object_class_install_property (gobject_class, PROP_LOCATION,
+      g_param_spec_string ("location", "location",
+          "File to export the performance data of every period to, as JSON "
+          "if the name ends with .json and as CSV otherwise",
+          NULL, G_PARAM_WRITABLE));
+
   GST_LOG ("initialized class init\n");
 }
 
@@ -250,6 +399,40 @@ gst_dmaiperf_set_property (GObject * object, guint prop_id,
       dmaiperf->printArmLoad = g_value_get_boolean(value);
       break;
 
+    case PROP_PRINT_THREADS:
+      dmaiperf->printThreads = g_value_get_boolean (value);
+      break;
+
+    case PROP_PRINT_POOLS:
+      dmaiperf->printPools = g_value_get_boolean (value);
+      break;
+
+    case PROP_ROLE:
+    {
+      const gchar *role = g_value_get_string (value);
+
+      if (!role || !strcmp (role, "none")) {
+        dmaiperf->role = DMAIPERF_ROLE_NONE;
+      } else if (!strcmp (role, "start")) {
+        dmaiperf->role = DMAIPERF_ROLE_START;
+      } else if (!strcmp (role, "end")) {
+        dmaiperf->role = DMAIPERF_ROLE_END;
+      } else {
+        GST_WARNING ("Unknown role \"%s\", expected start or end", role);
+      }
+      break;
+    }
+
+    case PROP_PROBE_ID:
+      g_free (dmaiperf->probeId);
+      dmaiperf->probeId = g_strdup (g_value_get_string (value));
+      break;
+
+    case PROP_LOCATION:
+      g_free (dmaiperf->location);
+      dmaiperf->location = g_strdup (g_value_get_string (value));
+      break;
+
     default:
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
       break;
@@ -258,6 +441,494 @@ gst_dmaiperf_set_property (GObject * object, guint prop_id,
   GST_LOG ("end set_property\n");
 }
 
+/******************************************************************************
+ * gst_dmaiperf_probe_get
+ *    Gets the probe shared by all the elements with the same probe-id
+ ******************************************************************************/
+static GstDmaiperfProbe *
+gst_dmaiperf_probe_get (const gchar * probeId)
+{
+  GstDmaiperfProbe *probe;
+
+  pthread_mutex_lock (&probes_mutex);
+  if (!probes)
+    probes = g_hash_table_new (g_str_hash, g_str_equal);
+
+  probe = g_hash_table_lookup (probes, probeId);
+  if (!probe) {
+    probe = g_malloc0 (sizeof (GstDmaiperfProbe));
+    probe->probeId = g_strdup (probeId);
+    pthread_mutex_init (&probe->mutex, NULL);
+    probe->pending = g_hash_table_new_full (g_int64_hash, g_int64_equal,
+        g_free, g_free);
+    probe->order = g_queue_new ();
+    g_hash_table_insert (probes, probe->probeId, probe);
+  }
+  probe->refcount++;
+  pthread_mutex_unlock (&probes_mutex);
+
+  return probe;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_probe_put
+ ******************************************************************************/
+static void
+gst_dmaiperf_probe_put (GstDmaiperfProbe * probe)
+{
+  pthread_mutex_lock (&probes_mutex);
+  if (--probe->refcount == 0) {
+    g_hash_table_remove (probes, probe->probeId);
+    g_hash_table_destroy (probe->pending);
+    g_queue_free (probe->order);
+    pthread_mutex_destroy (&probe->mutex);
+    g_free (probe->probeId);
+    g_free (probe);
+  }
+  pthread_mutex_unlock (&probes_mutex);
+}
+
+/******************************************************************************
+ * gst_dmaiperf_probe_mark
+ *    Records when the buffer with the given timestamp went by the start probe
+ ******************************************************************************/
+static void
+gst_dmaiperf_probe_mark (GstDmaiperfProbe * probe, GstClockTime timestamp,
+    GstClockTime time)
+{
+  gint64 *key;
+  GstClockTime *value;
+
+  pthread_mutex_lock (&probe->mutex);
+  /* Forget the oldest buffers if the end probe is not getting them */
+  while (g_queue_get_length (probe->order) >= DMAIPERF_PROBE_MAX_PENDING) {
+    key = g_queue_pop_head (probe->order);
+    g_hash_table_remove (probe->pending, key);
+  }
+
+  key = g_malloc (sizeof (gint64));
+  *key = timestamp;
+  value = g_malloc (sizeof (GstClockTime));
+  *value = time;
+  if (g_hash_table_lookup (probe->pending, key)) {
+    /* Same timestamp again, keep the first one */
+    g_free (key);
+    g_free (value);
+  } else {
+    g_hash_table_insert (probe->pending, key, value);
+    g_queue_push_tail (probe->order, key);
+  }
+  pthread_mutex_unlock (&probe->mutex);
+}
+
+/******************************************************************************
+ * gst_dmaiperf_probe_match
+ *    Returns the latency of the buffer with the given timestamp since it went
+ *    by the start probe, or GST_CLOCK_TIME_NONE if it is unknown
+ ******************************************************************************/
+static GstClockTime
+gst_dmaiperf_probe_match (GstDmaiperfProbe * probe, GstClockTime timestamp,
+    GstClockTime time)
+{
+  gint64 key = timestamp;
+  GstClockTime latency = GST_CLOCK_TIME_NONE;
+  GstClockTime *start;
+  gpointer orig_key;
+
+  pthread_mutex_lock (&probe->mutex);
+  if (g_hash_table_lookup_extended (probe->pending, &key, &orig_key,
+          (gpointer *) & start)) {
+    latency = time - *start;
+    g_queue_remove (probe->order, orig_key);
+    g_hash_table_remove (probe->pending, &key);
+  }
+  pthread_mutex_unlock (&probe->mutex);
+
+  return latency;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_compare_time
+ ******************************************************************************/
+static gint
+gst_dmaiperf_compare_time (gconstpointer a, gconstpointer b)
+{
+  GstClockTime ta = *(const GstClockTime *) a;
+  GstClockTime tb = *(const GstClockTime *) b;
+
+  return (ta > tb) - (ta < tb);
+}
+
+/******************************************************************************
+ * gst_dmaiperf_get_stats
+ *    Computes the statistics of the samples of the last period and clears
+ *    them for the next one
+ ******************************************************************************/
+static void
+gst_dmaiperf_get_stats (GArray * array, struct dmaiperf_stats *stats)
+{
+  GstClockTime *samples = (GstClockTime *) array->data;
+  GstClockTime sum = 0;
+  guint i, n = array->len;
+
+  memset (stats, 0, sizeof (struct dmaiperf_stats));
+  stats->samples = n;
+  if (n == 0)
+    return;
+
+  g_array_sort (array, gst_dmaiperf_compare_time);
+  for (i = 0; i < n; i++)
+    sum += samples[i];
+
+  stats->min = samples[0];
+  stats->avg = sum / n;
+  stats->p95 = samples[(n - 1) * 95 / 100];
+  stats->p99 = samples[(n - 1) * 99 / 100];
+  stats->max = samples[n - 1];
+
+  g_array_set_size (array, 0);
+}
+
+/******************************************************************************
+ * gst_dmaiperf_hist_add
+ *    Adds a sample to a log2 histogram, see DMAIPERF_HIST_BUCKETS
+ ******************************************************************************/
+static void
+gst_dmaiperf_hist_add (guint32 * hist, GstClockTime value)
+{
+  guint64 us = GST_TIME_AS_USECONDS (value) >> DMAIPERF_HIST_SHIFT;
+  gint bucket = 0;
+
+  while (us && bucket < DMAIPERF_HIST_BUCKETS - 1) {
+    us >>= 1;
+    bucket++;
+  }
+  hist[bucket]++;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_track_pacing
+ *    Accounts the arrival interval and duration of the buffer, and detects
+ *    gaps on the timestamps
+ ******************************************************************************/
+static void
+gst_dmaiperf_track_pacing (GstDmaiperf * dmaiperf, GstBuffer * buf,
+    GstClockTime time)
+{
+  if (GST_CLOCK_TIME_IS_VALID (dmaiperf->lastArrival)) {
+    GstClockTime interval = time - dmaiperf->lastArrival;
+
+    g_array_append_val (dmaiperf->intervals, interval);
+    gst_dmaiperf_hist_add (dmaiperf->intervalHist, interval);
+  }
+  dmaiperf->lastArrival = time;
+
+  if (GST_BUFFER_DURATION_IS_VALID (buf))
+    gst_dmaiperf_hist_add (dmaiperf->durationHist, GST_BUFFER_DURATION (buf));
+
+  if (!GST_BUFFER_TIMESTAMP_IS_VALID (buf))
+    return;
+
+  /* A buffer starting later than the end of the previous one means that
+   * something was dropped upstream */
+  if (GST_CLOCK_TIME_IS_VALID (dmaiperf->nextTimestamp) &&
+      GST_BUFFER_TIMESTAMP (buf) >
+      dmaiperf->nextTimestamp + dmaiperf->lastDuration / 2) {
+    GST_DEBUG ("Timestamp gap of %" GST_TIME_FORMAT,
+        GST_TIME_ARGS (GST_BUFFER_TIMESTAMP (buf) - dmaiperf->nextTimestamp));
+    dmaiperf->tsGaps++;
+  }
+
+  if (GST_BUFFER_DURATION_IS_VALID (buf)) {
+    dmaiperf->lastDuration = GST_BUFFER_DURATION (buf);
+    dmaiperf->nextTimestamp = GST_BUFFER_TIMESTAMP (buf) +
+        GST_BUFFER_DURATION (buf);
+  } else {
+    dmaiperf->nextTimestamp = GST_CLOCK_TIME_NONE;
+  }
+}
+
+/******************************************************************************
+ * gst_dmaiperf_read_thread_stat
+ *    Reads the name and the user plus system ticks of a thread from
+ *    /proc/self/task/<tid>/stat
+ ******************************************************************************/
+static gboolean
+gst_dmaiperf_read_thread_stat (const gchar * tid, gchar * name, gsize size,
+    guint64 * ticks)
+{
+  gchar *path, *contents, *start, *end;
+  unsigned long utime, stime;
+  gboolean ret = FALSE;
+
+  path = g_strdup_printf ("/proc/self/task/%s/stat", tid);
+  if (!g_file_get_contents (path, &contents, NULL, NULL)) {
+    g_free (path);
+    return FALSE;
+  }
+  g_free (path);
+
+  /* The name is enclosed in parenthesis and may contain any character,
+   * so the fields are counted from the last parenthesis on */
+  start = strchr (contents, '(');
+  end = strrchr (contents, ')');
+  if (start && end && end > start &&
+      sscanf (end + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %lu %lu",
+          &utime, &stime) == 2) {
+    g_strlcpy (name, start + 1, MIN (size, (gsize) (end - start)));
+    /* Keep the name safe to quote on the JSON export */
+    g_strdelimit (name, "\"\\", '_');
+    *ticks = (guint64) utime + stime;
+    ret = TRUE;
+  }
+
+  g_free (contents);
+  return ret;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_sample_threads
+ *    Computes the CPU load of every thread of the process since the last
+ *    sample.  GStreamer names its streaming threads after the pad running
+ *    the task, so they can be told apart on the report.
+ ******************************************************************************/
+static void
+gst_dmaiperf_sample_threads (GstDmaiperf * dmaiperf, GstClockTime time)
+{
+  GHashTable *ticks;
+  GDir *dir;
+  const gchar *entry;
+  guint64 elapsed = 0;
+  glong hz = sysconf (_SC_CLK_TCK);
+
+  g_array_set_size (dmaiperf->threadLoads, 0);
+
+  dir = g_dir_open ("/proc/self/task", 0, NULL);
+  if (!dir || hz <= 0) {
+    if (dir)
+      g_dir_close (dir);
+    return;
+  }
+
+  if (GST_CLOCK_TIME_IS_VALID (dmaiperf->threadStamp))
+    elapsed = GST_TIME_AS_MSECONDS (GST_CLOCK_DIFF (dmaiperf->threadStamp,
+            time));
+
+  ticks = g_hash_table_new_full (g_direct_hash, g_direct_equal, NULL, g_free);
+
+  while ((entry = g_dir_read_name (dir))) {
+    struct dmaiperf_thread_load thread;
+    guint64 *now, *last;
+
+    now = g_new (guint64, 1);
+    if (!gst_dmaiperf_read_thread_stat (entry, thread.name,
+            sizeof (thread.name), now)) {
+      g_free (now);
+      continue;
+    }
+
+    thread.tid = atoi (entry);
+    g_hash_table_insert (ticks, GINT_TO_POINTER (thread.tid), now);
+
+    last = g_hash_table_lookup (dmaiperf->threadTicks,
+        GINT_TO_POINTER (thread.tid));
+    if (!last || !elapsed || *now <= *last)
+      continue;
+
+    thread.load = (*now - *last) * 1000 * 1000 / (hz * elapsed);
+    g_array_append_val (dmaiperf->threadLoads, thread);
+  }
+  g_dir_close (dir);
+
+  /* Threads that exited are dropped with the old table */
+  g_hash_table_destroy (dmaiperf->threadTicks);
+  dmaiperf->threadTicks = ticks;
+  dmaiperf->threadStamp = time;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_export_thread
+ *    Writes the records queued by the streaming thread
+ ******************************************************************************/
+static void *
+gst_dmaiperf_export_thread (void *arg)
+{
+  GstDmaiperf *dmaiperf = (GstDmaiperf *) arg;
+  gchar *line;
+
+  while ((line = g_async_queue_pop (dmaiperf->exportQueue)) != export_eos) {
+    fputs (line, dmaiperf->exportFile);
+    fflush (dmaiperf->exportFile);
+    g_free (line);
+  }
+
+  return NULL;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_append_hist
+ ******************************************************************************/
+static void
+gst_dmaiperf_append_hist (GstDmaiperf * dmaiperf, GString * line,
+    const gchar * name, guint32 * hist)
+{
+  gint i;
+
+  if (dmaiperf->json)
+    g_string_append_printf (line, ", \"%s\": [", name);
+
+  for (i = 0; i < DMAIPERF_HIST_BUCKETS; i++) {
+    g_string_append_printf (line, dmaiperf->json && i == 0 ? "%u" : ",%u",
+        hist[i]);
+  }
+
+  if (dmaiperf->json)
+    g_string_append (line, "]");
+}
+
+/******************************************************************************
+ * gst_dmaiperf_export
+ *    Queues the record of the last period to the export thread
+ ******************************************************************************/
+static void
+gst_dmaiperf_export (GstDmaiperf * dmaiperf, GstClockTime time,
+    guint fps_int, guint fps_frac, guint64 bps, gint cpu,
+    struct dmaiperf_stats *interval, struct dmaiperf_stats *latency)
+{
+  GString *line = g_string_sized_new (512);
+
+  if (dmaiperf->json) {
+    g_string_append_printf (line, "{\"timestamp\": %" G_GUINT64_FORMAT ", "
+        "\"fps\": %u.%02u, \"bps\": %" G_GUINT64_FORMAT ", \"cpu\": %d, "
+        "\"interval\": {\"min_us\": %" G_GUINT64_FORMAT ", "
+        "\"max_us\": %" G_GUINT64_FORMAT ", \"p99_us\": %" G_GUINT64_FORMAT
+        "}, \"ts_gaps\": %u", time, fps_int, fps_frac, bps, cpu,
+        GST_TIME_AS_USECONDS (interval->min),
+        GST_TIME_AS_USECONDS (interval->max),
+        GST_TIME_AS_USECONDS (interval->p99), dmaiperf->tsGaps);
+    if (dmaiperf->threadLoads) {
+      guint i;
+
+      g_string_append (line, ", \"threads\": [");
+      for (i = 0; i < dmaiperf->threadLoads->len; i++) {
+        struct dmaiperf_thread_load *thread =
+            &g_array_index (dmaiperf->threadLoads,
+            struct dmaiperf_thread_load, i);
+
+        g_string_append_printf (line, "%s{\"tid\": %d, \"name\": \"%s\", "
+            "\"load\": %u.%u}", i ? ", " : "", thread->tid, thread->name,
+            thread->load / 10, thread->load % 10);
+      }
+      g_string_append (line, "]");
+    }
+    if (dmaiperf->printPools) {
+      g_string_append (line, ", \"pools\": ");
+      gst_tidmaitelemetry_report (line, TRUE);
+    }
+    if (latency) {
+      g_string_append_printf (line, ", \"latency\": {\"samples\": %u, "
+          "\"min_us\": %" G_GUINT64_FORMAT ", \"avg_us\": %" G_GUINT64_FORMAT
+          ", \"p95_us\": %" G_GUINT64_FORMAT ", \"p99_us\": %"
+          G_GUINT64_FORMAT ", \"max_us\": %" G_GUINT64_FORMAT "}",
+          latency->samples, GST_TIME_AS_USECONDS (latency->min),
+          GST_TIME_AS_USECONDS (latency->avg),
+          GST_TIME_AS_USECONDS (latency->p95),
+          GST_TIME_AS_USECONDS (latency->p99),
+          GST_TIME_AS_USECONDS (latency->max));
+    }
+  } else {
+    struct dmaiperf_stats none = { 0, };
+
+    if (!latency)
+      latency = &none;
+    g_string_append_printf (line, "%" G_GUINT64_FORMAT ",%u.%02u,%"
+        G_GUINT64_FORMAT ",%d,%" G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT
+        ",%" G_GUINT64_FORMAT ",%u,%u,%" G_GUINT64_FORMAT ",%"
+        G_GUINT64_FORMAT ",%" G_GUINT64_FORMAT, time, fps_int, fps_frac,
+        bps, cpu, GST_TIME_AS_USECONDS (interval->min),
+        GST_TIME_AS_USECONDS (interval->max),
+        GST_TIME_AS_USECONDS (interval->p99), dmaiperf->tsGaps,
+        latency->samples, GST_TIME_AS_USECONDS (latency->avg),
+        GST_TIME_AS_USECONDS (latency->p99),
+        GST_TIME_AS_USECONDS (latency->max));
+  }
+
+  gst_dmaiperf_append_hist (dmaiperf, line, "interval_hist",
+      dmaiperf->intervalHist);
+  gst_dmaiperf_append_hist (dmaiperf, line, "duration_hist",
+      dmaiperf->durationHist);
+  g_string_append (line, dmaiperf->json ? "}\n" : "\n");
+
+  g_async_queue_push (dmaiperf->exportQueue, g_string_free (line, FALSE));
+}
+
+/******************************************************************************
+ * gst_dmaiperf_start_export
+ ******************************************************************************/
+static gboolean
+gst_dmaiperf_start_export (GstDmaiperf * dmaiperf)
+{
+  gint i;
+
+  dmaiperf->exportFile = fopen (dmaiperf->location, "w");
+  if (!dmaiperf->exportFile) {
+    GST_ELEMENT_ERROR (dmaiperf, RESOURCE, OPEN_WRITE, (NULL),
+        ("failed to open \"%s\" for writing", dmaiperf->location));
+    return FALSE;
+  }
+  dmaiperf->json = g_str_has_suffix (dmaiperf->location, ".json");
+  dmaiperf->exportQueue = g_async_queue_new ();
+
+  if (!dmaiperf->json) {
+    GString *header = g_string_new ("timestamp_ns,fps,bps,cpu,"
+        "interval_min_us,interval_max_us,interval_p99_us,ts_gaps,"
+        "latency_samples,latency_avg_us,latency_p99_us,latency_max_us");
+
+    for (i = 0; i < DMAIPERF_HIST_BUCKETS; i++)
+      g_string_append_printf (header, ",interval_hist_%d", i);
+    for (i = 0; i < DMAIPERF_HIST_BUCKETS; i++)
+      g_string_append_printf (header, ",duration_hist_%d", i);
+    g_string_append (header, "\n");
+    g_async_queue_push (dmaiperf->exportQueue, g_string_free (header, FALSE));
+  }
+
+  if (pthread_create (&dmaiperf->exportThread, NULL,
+          gst_dmaiperf_export_thread, dmaiperf)) {
+    GST_ELEMENT_ERROR (dmaiperf, RESOURCE, FAILED, (NULL),
+        ("failed to create the export thread"));
+    g_async_queue_unref (dmaiperf->exportQueue);
+    dmaiperf->exportQueue = NULL;
+    fclose (dmaiperf->exportFile);
+    dmaiperf->exportFile = NULL;
+    return FALSE;
+  }
+
+  return TRUE;
+}
+
+/******************************************************************************
+ * gst_dmaiperf_stop_export
+ ******************************************************************************/
+static void
+gst_dmaiperf_stop_export (GstDmaiperf * dmaiperf)
+{
+  gchar *line;
+
+  if (!dmaiperf->exportQueue)
+    return;
+
+  g_async_queue_push (dmaiperf->exportQueue, export_eos);
+  pthread_join (dmaiperf->exportThread, NULL);
+
+  while ((line = g_async_queue_try_pop (dmaiperf->exportQueue)))
+    g_free (line);
+  g_async_queue_unref (dmaiperf->exportQueue);
+  dmaiperf->exportQueue = NULL;
+
+  fclose (dmaiperf->exportFile);
+  dmaiperf->exportFile = NULL;
+}
+
 /******************************************************************************
  * gst_dmaiperf_start
  *    Start measuring pipeline performance
@@ -272,7 +943,7 @@ gst_dmaiperf_start (GstBaseTransform * trans)
     GST_ELEMENT_WARNING (dmaiperf, RESOURCE, SETTINGS, (NULL),
         ("Engine name not specified, not printing DSP information"));
   } else {
-      dmaiperf->hEngine = Engine_open ((Char *) dmaiperf->engineName, NULL, NULL);
+      dmaiperf->hEngine = gst_ti_engine_open (dmaiperf->engineName);
 
       if (dmaiperf->hEngine == NULL) {
         GST_ELEMENT_ERROR (dmaiperf, STREAM, CODEC_NOT_FOUND, (NULL),
@@ -299,6 +970,37 @@ gst_dmaiperf_start (GstBaseTransform * trans)
 
   dmaiperf->error = g_error_new(GST_CORE_ERROR,GST_CORE_ERROR_TAG,"Performance Information");
 
+  if (dmaiperf->role != DMAIPERF_ROLE_NONE) {
+    if (!dmaiperf->probeId) {
+      GST_ELEMENT_WARNING (dmaiperf, RESOURCE, SETTINGS, (NULL),
+          ("Probe id not specified, not measuring latency"));
+    } else {
+      dmaiperf->probe = gst_dmaiperf_probe_get (dmaiperf->probeId);
+      if (dmaiperf->role == DMAIPERF_ROLE_END)
+        dmaiperf->latencies = g_array_new (FALSE, FALSE,
+            sizeof (GstClockTime));
+    }
+  }
+
+  dmaiperf->lastArrival = GST_CLOCK_TIME_NONE;
+  dmaiperf->nextTimestamp = GST_CLOCK_TIME_NONE;
+  dmaiperf->lastDuration = 0;
+  dmaiperf->tsGaps = 0;
+  memset (dmaiperf->intervalHist, 0, sizeof (dmaiperf->intervalHist));
+  memset (dmaiperf->durationHist, 0, sizeof (dmaiperf->durationHist));
+  dmaiperf->intervals = g_array_new (FALSE, FALSE, sizeof (GstClockTime));
+
+  if (dmaiperf->printThreads) {
+    dmaiperf->threadTicks = g_hash_table_new_full (g_direct_hash,
+        g_direct_equal, NULL, g_free);
+    dmaiperf->threadLoads = g_array_new (FALSE, FALSE,
+        sizeof (struct dmaiperf_thread_load));
+    dmaiperf->threadStamp = GST_CLOCK_TIME_NONE;
+  }
+
+  if (dmaiperf->location && !gst_dmaiperf_start_export (dmaiperf))
+    return FALSE;
+
   return TRUE;
 }
 
@@ -320,7 +1022,7 @@ gst_dmaiperf_stop (GstBaseTransform * trans)
 
   if (dmaiperf->hEngine) {
     GST_DEBUG ("closing the engine\n");
-    Engine_close (dmaiperf->hEngine);
+    gst_ti_engine_close (dmaiperf->hEngine);
     dmaiperf->hEngine = NULL;
   }
 
@@ -333,6 +1035,33 @@ gst_dmaiperf_stop (GstBaseTransform * trans)
     dmaiperf->hCpu = NULL;
   }
 
+  if (dmaiperf->probe) {
+    gst_dmaiperf_probe_put (dmaiperf->probe);
+    dmaiperf->probe = NULL;
+  }
+
+  if (dmaiperf->latencies) {
+    g_array_free (dmaiperf->latencies, TRUE);
+    dmaiperf->latencies = NULL;
+  }
+
+  if (dmaiperf->intervals) {
+    g_array_free (dmaiperf->intervals, TRUE);
+    dmaiperf->intervals = NULL;
+  }
+
+  if (dmaiperf->threadTicks) {
+    g_hash_table_destroy (dmaiperf->threadTicks);
+    dmaiperf->threadTicks = NULL;
+  }
+
+  if (dmaiperf->threadLoads) {
+    g_array_free (dmaiperf->threadLoads, TRUE);
+    dmaiperf->threadLoads = NULL;
+  }
+
+  gst_dmaiperf_stop_export (dmaiperf);
+
   return TRUE;
 }
 
@@ -349,63 +1078,129 @@ gst_dmaiperf_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
   GST_LOG ("Transform function\n");
 
   GstClockTime time = gst_util_get_timestamp ();
+
+  gst_dmaiperf_track_pacing (dmaiperf, buf, time);
+
   if (!GST_CLOCK_TIME_IS_VALID (dmaiperf->lastLoadstamp) ||
         (GST_CLOCK_TIME_IS_VALID (time) &&
             GST_CLOCK_DIFF (dmaiperf->lastLoadstamp, time) > GST_SECOND)) {
-      gchar info[GST_TIME_FORMAT_MAX_SIZE];
-      gint idx;
+      GString *info = g_string_sized_new (512);
+      guint64 bps;
+      Int load = -1;
+      struct dmaiperf_stats interval, latency;
       /*Real data per second: Time spent / unit (1000msec)*/
       
       GstClockTime factor_n = GST_TIME_AS_MSECONDS(GST_CLOCK_DIFF (dmaiperf->lastLoadstamp, time));
       GstClockTime factor_d = GST_TIME_AS_MSECONDS(GST_SECOND);
       fps_int = dmaiperf->fps * factor_d / factor_n;
       fps_frac = 100 * dmaiperf->fps * factor_d / factor_n - 100 *fps_int;
+      bps = dmaiperf->bps * factor_d / factor_n;
       
-      idx = g_snprintf (info, GST_TIME_FORMAT_MAX_SIZE, "Timestamp: %" GST_TIME_FORMAT"; "
+      g_string_append_printf (info, "Timestamp: %" GST_TIME_FORMAT"; "
           "bps: %llu; "
           "fps: %d.%2.2d; ",
-          GST_TIME_ARGS (time), (dmaiperf->bps * factor_d / factor_n), fps_int, fps_frac);
+          GST_TIME_ARGS (time), bps, fps_int, fps_frac);
 
       dmaiperf->fps = 0;
       dmaiperf->bps = 0;
 
+      gst_dmaiperf_get_stats (dmaiperf->intervals, &interval);
+      g_string_append_printf (info,
+          "interval: min: " DMAIPERF_MS_FORMAT "; max: " DMAIPERF_MS_FORMAT
+          "; p99: " DMAIPERF_MS_FORMAT "; ts-gaps: %u; ",
+          DMAIPERF_MS_ARGS (interval.min), DMAIPERF_MS_ARGS (interval.max),
+          DMAIPERF_MS_ARGS (interval.p99), dmaiperf->tsGaps);
+
       if (dmaiperf->hCpu){
-          Int load;
           Cpu_getLoad(dmaiperf->hCpu, &load);
-          idx += g_snprintf (&info[idx], GST_TIME_FORMAT_MAX_SIZE - idx,
-              "CPU: %d; ",load);
+          g_string_append_printf (info, "CPU: %d; ",load);
+      }
+
+      if (dmaiperf->threadLoads) {
+          guint i;
+
+          gst_dmaiperf_sample_threads (dmaiperf, time);
+          for (i = 0; i < dmaiperf->threadLoads->len; i++) {
+            struct dmaiperf_thread_load *thread =
+                &g_array_index (dmaiperf->threadLoads,
+                struct dmaiperf_thread_load, i);
+
+            g_string_append_printf (info, "thread: %s(%d): %u.%u; ",
+                thread->name, thread->tid, thread->load / 10,
+                thread->load % 10);
+          }
+      }
+
+      if (dmaiperf->printPools) {
+          GString *pools = g_string_new (NULL);
+
+          gst_tidmaitelemetry_report (pools, FALSE);
+          g_string_append (info, pools->str);
+          g_string_free (pools, TRUE);
       }
 
       if (dmaiperf->hDsp) {
           gint32 nsegs, i;
-          guint32 load = Server_getCpuLoad (dmaiperf->hDsp);
-          idx += g_snprintf (&info[idx], GST_TIME_FORMAT_MAX_SIZE-idx,
-              "DSP: %d; ", load);
+          guint32 load;
+
+          /* The engine may be shared with the codecs of the pipeline */
+          gst_ti_engine_lock (dmaiperf->hEngine);
+          load = Server_getCpuLoad (dmaiperf->hDsp);
+          g_string_append_printf (info, "DSP: %d; ", load);
 
           Server_getNumMemSegs (dmaiperf->hDsp, &nsegs);
           for (i = 0; i < nsegs; i++) {
             Server_MemStat ms;
             Server_getMemStat (dmaiperf->hDsp, i, &ms);
-            idx += g_snprintf (&info[idx], GST_TIME_FORMAT_MAX_SIZE - idx,
+            g_string_append_printf (info,
                 "mem_seg: %s; base: 0x%x; size: 0x%x; maxblocklen: 0x%x; used: 0x%x; ",
                 ms.name, (unsigned int) ms.base, (unsigned int) ms.size,
                 (unsigned int) ms.maxBlockLen, (unsigned int) ms.used);
           }
+          gst_ti_engine_unlock (dmaiperf->hEngine);
       }
 
-      if (idx ==  GST_TIME_FORMAT_MAX_SIZE){
-	/* more info than buffer can hold, make sure it has reasonable termination. */
-	info[GST_TIME_FORMAT_MAX_SIZE - 2] = '*';
-	info[GST_TIME_FORMAT_MAX_SIZE - 1] = '\0';
+      if (dmaiperf->latencies) {
+          gst_dmaiperf_get_stats (dmaiperf->latencies, &latency);
+          g_string_append_printf (info, "latency: %u samples; min: "
+              DMAIPERF_MS_FORMAT "; avg: " DMAIPERF_MS_FORMAT "; p95: "
+              DMAIPERF_MS_FORMAT "; p99: " DMAIPERF_MS_FORMAT "; max: "
+              DMAIPERF_MS_FORMAT "; ",
+              latency.samples, DMAIPERF_MS_ARGS (latency.min),
+              DMAIPERF_MS_ARGS (latency.avg), DMAIPERF_MS_ARGS (latency.p95),
+              DMAIPERF_MS_ARGS (latency.p99), DMAIPERF_MS_ARGS (latency.max));
       }
 
       gst_element_post_message(
         (GstElement *)dmaiperf,
         gst_message_new_info((GstObject *)dmaiperf, dmaiperf->error, 
-          (const gchar *)info));
+          (const gchar *)info->str));
+      g_string_free (info, TRUE);
+
+      if (dmaiperf->exportQueue) {
+          gst_dmaiperf_export (dmaiperf, time, fps_int, fps_frac, bps, load,
+              &interval, dmaiperf->latencies ? &latency : NULL);
+      }
+
+      dmaiperf->tsGaps = 0;
+      memset (dmaiperf->intervalHist, 0, sizeof (dmaiperf->intervalHist));
+      memset (dmaiperf->durationHist, 0, sizeof (dmaiperf->durationHist));
       dmaiperf->lastLoadstamp = time;
   }
 
+  if (dmaiperf->probe && GST_BUFFER_TIMESTAMP_IS_VALID (buf)) {
+    if (dmaiperf->role == DMAIPERF_ROLE_START) {
+      gst_dmaiperf_probe_mark (dmaiperf->probe, GST_BUFFER_TIMESTAMP (buf),
+          time);
+    } else {
+      GstClockTime latency = gst_dmaiperf_probe_match (dmaiperf->probe,
+          GST_BUFFER_TIMESTAMP (buf), time);
+
+      if (GST_CLOCK_TIME_IS_VALID (latency))
+        g_array_append_val (dmaiperf->latencies, latency);
+    }
+  }
+
   dmaiperf->fps++;
   dmaiperf->bps+= GST_BUFFER_SIZE(buf);
 
@@ -24,6 +24,7 @@
 #define __GST_DMAIPERF_H__
 
 #include <pthread.h>
+#include <stdio.h>
 
 #include <gst/gst.h>
 #include <gst/base/gstbasetransform.h>
@@ -47,6 +48,27 @@ G_BEGIN_DECLS
    (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_DMAIPERF))
 typedef struct _GstDmaiperf GstDmaiperf;
 typedef struct _GstDmaiperfClass GstDmaiperfClass;
+typedef struct _GstDmaiperfProbe GstDmaiperfProbe;
+
+/* Number of buckets of the frame pacing histograms */
+#define DMAIPERF_HIST_BUCKETS 16
+
+/* CPU load of a thread of the process over the last period */
+struct dmaiperf_thread_load
+{
+  gint tid;
+  gchar name[16];
+  /* In tenths of percent of one CPU */
+  guint load;
+};
+
+/* Role of the element when measuring latency between two of them */
+enum dmaiperf_role
+{
+  DMAIPERF_ROLE_NONE,
+  DMAIPERF_ROLE_START,
+  DMAIPERF_ROLE_END
+};
 
  /* _GstDmaiperf object */
 struct _GstDmaiperf
@@ -67,6 +89,37 @@ struct _GstDmaiperf
   guint32 fps;
   guint32 bps;
   gboolean printArmLoad;
+  gboolean printThreads;
+  gboolean printPools;
+
+  /* Per-thread CPU accounting: thread id -> ticks at threadStamp */
+  GHashTable *threadTicks;
+  GstClockTime threadStamp;
+  GArray *threadLoads;
+
+  /* Latency measurement: the start probe records when each buffer goes by,
+   * the end probe with the same probe-id matches it by timestamp */
+  enum dmaiperf_role role;
+  gchar *probeId;
+  GstDmaiperfProbe *probe;
+  GArray *latencies;
+
+  /* Frame pacing: arrival intervals and durations of the last period */
+  GstClockTime lastArrival;
+  GstClockTime nextTimestamp;
+  GstClockTime lastDuration;
+  GArray *intervals;
+  guint32 intervalHist[DMAIPERF_HIST_BUCKETS];
+  guint32 durationHist[DMAIPERF_HIST_BUCKETS];
+  guint32 tsGaps;
+
+  /* Export of the performance data to a CSV or JSON file, written by
+   * exportThread so the streaming thread never waits on the file */
+  gchar *location;
+  gboolean json;
+  FILE *exportFile;
+  GAsyncQueue *exportQueue;
+  pthread_t exportThread;
 };
 
  /* _GstDmaiperfClass object */
@@ -0,0 +1,239 @@
+/*
+ * gsttidmaitelemetry.c
+ *
+ * Keeps track of how close the DMAI elements get to exhaust their
+ * contiguous buffer pools: high-water mark of the buffers in use, time
+ * spent blocked waiting for a free buffer and the largest free block left.
+ * The statistics of all the pools are published by dmaiperf.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#include <pthread.h>
+
+#include <ti/sdo/dmai/Buffer.h>
+
+#include "gsttidmaitelemetry.h"
+
+/* Registered pools, and lock for the statistics of all of them */
+static GList *pools = NULL;
+static pthread_mutex_t pools_mutex = PTHREAD_MUTEX_INITIALIZER;
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_pool_new
+ *    Create and register the statistics of a pool.  The pool starts with
+ *    a reference owned by the caller.
+ ******************************************************************************/
+GstTIDmaiPoolStats *gst_tidmaitelemetry_pool_new(const gchar *name,
+    const gchar *unit, gsize capacity)
+{
+    GstTIDmaiPoolStats *pool = g_malloc0(sizeof(GstTIDmaiPoolStats));
+
+    pool->name = g_strdup(name);
+    pool->unit = unit;
+    pool->refcount = 1;
+    pool->registered = TRUE;
+    pool->capacity = capacity;
+    pool->largestFree = capacity;
+    pool->minLargestFree = capacity;
+
+    pthread_mutex_lock(&pools_mutex);
+    pools = g_list_append(pools, pool);
+    pthread_mutex_unlock(&pools_mutex);
+
+    return pool;
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_pool_ref
+ *    Buffers carried downstream keep a reference, so their release can be
+ *    accounted after the element is gone.
+ ******************************************************************************/
+void gst_tidmaitelemetry_pool_ref(GstTIDmaiPoolStats *pool)
+{
+    pthread_mutex_lock(&pools_mutex);
+    pool->refcount++;
+    pthread_mutex_unlock(&pools_mutex);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_pool_unref
+ ******************************************************************************/
+void gst_tidmaitelemetry_pool_unref(GstTIDmaiPoolStats *pool)
+{
+    gboolean last;
+
+    pthread_mutex_lock(&pools_mutex);
+    last = (--pool->refcount == 0);
+    if (last && pool->registered)
+        pools = g_list_remove(pools, pool);
+    pthread_mutex_unlock(&pools_mutex);
+
+    if (last) {
+        g_free(pool->name);
+        g_free(pool);
+    }
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_pool_release
+ *    Unregister the pool when its owner frees it, and drop the owner
+ *    reference
+ ******************************************************************************/
+void gst_tidmaitelemetry_pool_release(GstTIDmaiPoolStats *pool)
+{
+    pthread_mutex_lock(&pools_mutex);
+    if (pool->registered) {
+        pools = g_list_remove(pools, pool);
+        pool->registered = FALSE;
+    }
+    pthread_mutex_unlock(&pools_mutex);
+
+    gst_tidmaitelemetry_pool_unref(pool);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_set_used
+ *    Record the current occupancy of the pool
+ ******************************************************************************/
+void gst_tidmaitelemetry_set_used(GstTIDmaiPoolStats *pool, gsize capacity,
+    gsize used, gsize largestFree)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pools_mutex);
+    pool->capacity = capacity;
+    pool->used = used;
+    pool->largestFree = largestFree;
+    if (used > pool->highWater)
+        pool->highWater = used;
+    if (largestFree < pool->minLargestFree)
+        pool->minLargestFree = largestFree;
+    pthread_mutex_unlock(&pools_mutex);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_update_buftab
+ *    Record the occupancy of a buffer tab, counting the buffers still in
+ *    use by the codec or downstream.  Call with the lock of the tab held.
+ ******************************************************************************/
+void gst_tidmaitelemetry_update_buftab(GstTIDmaiPoolStats *pool,
+    BufTab_Handle hBufTab)
+{
+    Int numBufs, i, used = 0;
+
+    if (!pool || !hBufTab)
+        return;
+
+    numBufs = BufTab_getNumBufs(hBufTab);
+    for (i = 0; i < numBufs; i++) {
+        if (Buffer_getUseMask(BufTab_getBuf(hBufTab, i)) != 0)
+            used++;
+    }
+
+    gst_tidmaitelemetry_set_used(pool, numBufs, used, numBufs - used);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_blocked
+ *    Account time spent waiting for a free buffer
+ ******************************************************************************/
+void gst_tidmaitelemetry_blocked(GstTIDmaiPoolStats *pool, GstClockTime time)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pools_mutex);
+    pool->blockedTime += time;
+    pool->blockedCount++;
+    pthread_mutex_unlock(&pools_mutex);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_failed
+ *    Account a request the pool was not able to satisfy
+ ******************************************************************************/
+void gst_tidmaitelemetry_failed(GstTIDmaiPoolStats *pool)
+{
+    if (!pool)
+        return;
+
+    pthread_mutex_lock(&pools_mutex);
+    pool->failures++;
+    pthread_mutex_unlock(&pools_mutex);
+}
+
+
+/******************************************************************************
+ * gst_tidmaitelemetry_report
+ *    Append the statistics of all the registered pools, as "key: value;"
+ *    pairs or as a JSON array
+ ******************************************************************************/
+void gst_tidmaitelemetry_report(GString *report, gboolean json)
+{
+    GList *e;
+
+    pthread_mutex_lock(&pools_mutex);
+    if (json)
+        g_string_append(report, "[");
+
+    for (e = pools; e; e = g_list_next(e)) {
+        GstTIDmaiPoolStats *pool = (GstTIDmaiPoolStats *)e->data;
+
+        if (json) {
+            g_string_append_printf(report, "%s{\"name\": \"%s\", "
+                "\"unit\": \"%s\", \"capacity\": %u, \"used\": %u, "
+                "\"high_water\": %u, \"largest_free\": %u, "
+                "\"min_largest_free\": %u, \"blocked_us\": %" G_GUINT64_FORMAT
+                ", \"blocked_count\": %u, \"failures\": %u}",
+                e == pools ? "" : ", ", pool->name, pool->unit,
+                (guint)pool->capacity, (guint)pool->used,
+                (guint)pool->highWater, (guint)pool->largestFree,
+                (guint)pool->minLargestFree,
+                GST_TIME_AS_USECONDS(pool->blockedTime),
+                pool->blockedCount, pool->failures);
+        } else {
+            g_string_append_printf(report, "pool: %s; used: %u/%u %s; "
+                "high-water: %u; largest-free: %u (min %u); "
+                "blocked: %u.%03u ms (%u); failures: %u; ",
+                pool->name, (guint)pool->used, (guint)pool->capacity,
+                pool->unit, (guint)pool->highWater, (guint)pool->largestFree,
+                (guint)pool->minLargestFree,
+                (guint)(pool->blockedTime / GST_MSECOND),
+                (guint)((pool->blockedTime % GST_MSECOND) / GST_USECOND),
+                pool->blockedCount, pool->failures);
+        }
+    }
+
+    if (json)
+        g_string_append(report, "]");
+    pthread_mutex_unlock(&pools_mutex);
+}
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
@@ -0,0 +1,78 @@
+/*
+ * gsttidmaitelemetry.h
+ *
+ * Occupancy tracking of the contiguous buffer pools used by the DMAI
+ * elements.
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as
+ * published by the Free Software Foundation version 2.1 of the License.
+ *
+ * This program is distributed #as is# WITHOUT ANY WARRANTY of any kind,
+ * whether express or implied; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ * Lesser General Public License for more details.
+ *
+ */
+
+#ifndef __GST_TIDMAITELEMETRY_H__
+#define __GST_TIDMAITELEMETRY_H__
+
+#include <gst/gst.h>
+
+#include <xdc/std.h>
+#include <ti/sdo/dmai/Dmai.h>
+#include <ti/sdo/dmai/BufTab.h>
+
+G_BEGIN_DECLS
+
+typedef struct _GstTIDmaiPoolStats GstTIDmaiPoolStats;
+
+/* Occupancy of a pool of buffers (BufTab) or bytes (CMEM slices) */
+struct _GstTIDmaiPoolStats {
+    gchar          *name;
+    const gchar    *unit;
+    gint           refcount;
+    gboolean       registered;
+
+    gsize          capacity;
+    gsize          used;
+    gsize          highWater;
+    gsize          largestFree;
+    gsize          minLargestFree;
+    GstClockTime   blockedTime;
+    guint          blockedCount;
+    guint          failures;
+};
+
+/* External function declarations */
+GstTIDmaiPoolStats *gst_tidmaitelemetry_pool_new(const gchar *name,
+    const gchar *unit, gsize capacity);
+void gst_tidmaitelemetry_pool_ref(GstTIDmaiPoolStats *pool);
+void gst_tidmaitelemetry_pool_unref(GstTIDmaiPoolStats *pool);
+void gst_tidmaitelemetry_pool_release(GstTIDmaiPoolStats *pool);
+
+void gst_tidmaitelemetry_set_used(GstTIDmaiPoolStats *pool, gsize capacity,
+    gsize used, gsize largestFree);
+void gst_tidmaitelemetry_update_buftab(GstTIDmaiPoolStats *pool,
+    BufTab_Handle hBufTab);
+void gst_tidmaitelemetry_blocked(GstTIDmaiPoolStats *pool,
+    GstClockTime time);
+void gst_tidmaitelemetry_failed(GstTIDmaiPoolStats *pool);
+
+void gst_tidmaitelemetry_report(GString *report, gboolean json);
+
+G_END_DECLS
+
+#endif /* __GST_TIDMAITELEMETRY_H__ */
+
+
+/******************************************************************************
+ * Custom ViM Settings for editing this file
+ ******************************************************************************/
+#if 0
+ Tabs (use 4 spaces for indentation)
+ vim:set tabstop=4:      /* Use 4 spaces for tabs          */
+ vim:set shiftwidth=4:   /* Use 4 spaces for >> operations */
+ vim:set expandtab:      /* Expand tabs into white spaces  */
+#endif
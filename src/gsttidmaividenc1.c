@@ -71,10 +71,12 @@ gst_tidmai_videnc1_control (GstTIDmaiBaseDualEncoder * base_dualencoder, GstTIDm
 	encStatus->data.buf = NULL;
     
 
+    gst_ti_engine_lock (base_dualencoder->engine_handle);
     ret = VIDENC1_control (encoder_instance->codec_handle,
         cmd_id,
         (VIDENC1_DynamicParams *) base_dualencoder->codec_dynamic_params,
         encStatus);
+    gst_ti_engine_unlock (base_dualencoder->engine_handle);
 
     if (ret != VIDENC1_EOK) {
       GST_WARNING_OBJECT (GST_TI_DMAI_VIDENC1(base_dualencoder),
@@ -148,7 +150,9 @@ gst_tidmai_videnc1_delete (GstTIDmaiBaseDualEncoder * base_dualencoder, GstTIDma
   GST_DEBUG_OBJECT (base_dualencoder, "ENTER");
 
   if (encoder_instance != NULL) {
+    gst_ti_engine_lock (base_dualencoder->engine_handle);
     VIDENC1_delete (encoder_instance->codec_handle);
+    gst_ti_engine_unlock (base_dualencoder->engine_handle);
   }
   encoder_instance->codec_handle = NULL;
 
@@ -178,9 +182,11 @@ gst_tidmai_videnc1_create (GstTIDmaiBaseDualEncoder * base_dualencoder, GstTIDma
   }
 
   /* Create the codec handle */
+  gst_ti_engine_lock (base_dualencoder->engine_handle);
   encoder_instance->codec_handle = VIDENC1_create (base_dualencoder->engine_handle,
       (Char *) base_dualencoder->codec_name,
       (VIDENC1_Params *) base_dualencoder->codec_params);
+  gst_ti_engine_unlock (base_dualencoder->engine_handle);
 
   if (encoder_instance->codec_handle == NULL) {
 
@@ -272,9 +278,11 @@ gst_tidmai_videnc1_process_sync (GstTIDmaiBaseDualEncoder * base_dualencoder,
   outArgs.size = sizeof (VIDENC1_OutArgs); /* TODO: Maybe can change */
 
   /* Procees la encode and check for errors */
+  gst_ti_engine_lock (base_dualencoder->engine_handle);
   status =
       VIDENC1_process (encoder_instance->codec_handle, &inBufDesc, &outBufDesc,
       &inArgs, &outArgs);
+  gst_ti_engine_unlock (base_dualencoder->engine_handle);
 
   
   if (status != VIDENC1_EOK) {
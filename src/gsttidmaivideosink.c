@@ -31,7 +31,11 @@
 
 #include <gst/gstmarshal.h>
 
+#include <ti/sdo/ce/osal/Memory.h>
+
 #include <unistd.h>
+#include <errno.h>
+#include <sys/time.h>
 
 /* Define sink (input) pad capabilities.
  *
@@ -45,38 +49,52 @@
  * NOTE:  This pad must be named "sink" in order to be used with the
  * Base Sink class.
  */
-static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE (
-    "sink",
-    GST_PAD_SINK,
-    GST_PAD_ALWAYS,
-    GST_STATIC_CAPS
-    (
 #if PLATFORM == dm365
-    "video/x-raw-yuv, "
-         "format=(fourcc)NV12, "
-         "framerate=(fraction)[ 0, MAX ], "
-         "width=(int)[ 1, MAX ], "
+#  define SINK_CAPS_NV12 \
+    "video/x-raw-yuv, " \
+         "format=(fourcc)NV12, " \
+         "framerate=(fraction)[ 0, MAX ], " \
+         "width=(int)[ 1, MAX ], " \
          "height=(int)[ 1, MAX ];"
+#else
+#  define SINK_CAPS_NV12
 #endif
 #if PLATFORM == omapl138
-    "video/x-raw-rgb, "
-        "bpp=(int)16, "
-        "depth=(int)16, "
-        "endianness=(int)1234, "
-        "red_mask=(int)63488, "
-        "green_mask=(int)2016, "
-        "blue_mask=(int)31, "
-        "framerate=(fraction)[ 0, MAX ], "
-        "width=(int)[ 1, MAX ], "
+#  define SINK_CAPS SINK_CAPS_NV12 \
+    "video/x-raw-rgb, " \
+        "bpp=(int)16, " \
+        "depth=(int)16, " \
+        "endianness=(int)1234, " \
+        "red_mask=(int)63488, " \
+        "green_mask=(int)2016, " \
+        "blue_mask=(int)31, " \
+        "framerate=(fraction)[ 0, MAX ], " \
+        "width=(int)[ 1, MAX ], " \
         "height=(int)[1, MAX ] "
 #else
-    "video/x-raw-yuv, "
-         "format=(fourcc)UYVY, "
-         "framerate=(fraction)[ 0, MAX ], "
-         "width=(int)[ 1, MAX ], "
+#  define SINK_CAPS SINK_CAPS_NV12 \
+    "video/x-raw-yuv, " \
+         "format=(fourcc)UYVY, " \
+         "framerate=(fraction)[ 0, MAX ], " \
+         "width=(int)[ 1, MAX ], " \
          "height=(int)[ 1, MAX ]"
 #endif
-)
+
+static GstStaticPadTemplate sink_factory = GST_STATIC_PAD_TEMPLATE (
+    "sink",
+    GST_PAD_SINK,
+    GST_PAD_ALWAYS,
+    GST_STATIC_CAPS (SINK_CAPS)
+);
+
+/* Request pads for the mosaic mode, each one is composed on its own
+ * rectangle of the display.
+ */
+static GstStaticPadTemplate mosaic_sink_factory = GST_STATIC_PAD_TEMPLATE (
+    "sink_%d",
+    GST_PAD_SINK,
+    GST_PAD_REQUEST,
+    GST_STATIC_CAPS (SINK_CAPS)
 );
 
 GST_DEBUG_CATEGORY_STATIC (gst_tidmaivideosink_debug);
@@ -102,7 +120,20 @@ enum
   PROP_ACCEL_FRAME_COPY,
   PROP_NOMEMCPY,
   PROP_X_POSITION,
-  PROP_Y_POSITION
+  PROP_Y_POSITION,
+  PROP_ASYNC_DISPLAY,
+  PROP_FRAMES_LATE,
+  PROP_FRAMES_EARLY,
+  PROP_FRAMES_REPEATED
+};
+
+enum
+{
+  PROP_PAD_0,
+  PROP_PAD_X_POSITION,
+  PROP_PAD_Y_POSITION,
+  PROP_PAD_WIDTH,
+  PROP_PAD_HEIGHT
 };
 
 enum
@@ -124,6 +155,8 @@ static void
 static void
  gst_tidmaivideosink_get_property(GObject * object, guint prop_id,
      GValue * value, GParamSpec * pspec);
+static void
+ gst_tidmaivideosink_finalize(GObject * object);
 static gboolean
  gst_tidmaivideosink_set_caps(GstBaseSink * bsink, GstCaps * caps);
 static gboolean 
@@ -147,6 +180,32 @@ static GstFlowReturn
  gst_tidmaivideosink_preroll(GstBaseSink * bsink, GstBuffer * buffer);
 static GstFlowReturn
  gst_tidmaivideosink_render(GstBaseSink * bsink, GstBuffer * buffer);
+static void
+ gst_tidmaivideosink_get_times(GstBaseSink * bsink, GstBuffer * buffer,
+     GstClockTime * start, GstClockTime * end);
+static gboolean
+ gst_tidmaivideosink_unlock(GstBaseSink * bsink);
+static gboolean
+ gst_tidmaivideosink_unlock_stop(GstBaseSink * bsink);
+static gboolean
+ gst_tidmaivideosink_event(GstBaseSink * bsink, GstEvent * event);
+static gboolean
+ gst_tidmaivideosink_start_display_thread(GstTIDmaiVideoSink * sink);
+static void
+ gst_tidmaivideosink_stop_display_thread(GstTIDmaiVideoSink * sink);
+static GstPad *
+ gst_tidmaivideosink_request_new_pad(GstElement * element,
+     GstPadTemplate * templ, const gchar * name);
+static void
+ gst_tidmaivideosink_release_pad(GstElement * element, GstPad * pad);
+static void
+ gst_tidmaivideosink_stop_mosaic_thread(GstTIDmaiVideoSink * sink);
+static void
+ gst_tidmaivideosink_mosaic_unlock(GstTIDmaiVideoSink * sink,
+     gboolean unlocked);
+static GstStateChangeReturn
+ gst_tidmaivideosink_change_state(GstElement * element,
+     GstStateChange transition);
 
 static void  gst_tidmaivideosink_clean_DisplayBuf(GstTIDmaiVideoSink *sink);
 
@@ -159,6 +218,8 @@ static void gst_tidmaivideosink_base_init(gpointer g_class)
 
     gst_element_class_add_pad_template (gstelement_class,
       gst_static_pad_template_get (&sink_factory));
+    gst_element_class_add_pad_template (gstelement_class,
+      gst_static_pad_template_get (&mosaic_sink_factory));
     gst_element_class_set_details (gstelement_class,
       &gst_tidmaivideosink_details);
 }
@@ -181,6 +242,15 @@ static void gst_tidmaivideosink_class_init(GstTIDmaiVideoSinkClass * klass)
         (gst_tidmaivideosink_set_property);
     gobject_class->get_property = GST_DEBUG_FUNCPTR
         (gst_tidmaivideosink_get_property);
+    gobject_class->finalize = GST_DEBUG_FUNCPTR
+        (gst_tidmaivideosink_finalize);
+
+    gstelement_class->change_state = GST_DEBUG_FUNCPTR
+        (gst_tidmaivideosink_change_state);
+    gstelement_class->request_new_pad = GST_DEBUG_FUNCPTR
+        (gst_tidmaivideosink_request_new_pad);
+    gstelement_class->release_pad = GST_DEBUG_FUNCPTR
+        (gst_tidmaivideosink_release_pad);
 
     g_object_class_install_property(gobject_class, PROP_DISPLAYSTD,
         g_param_spec_string("displayStd", "Display Standard",
@@ -239,6 +309,28 @@ static void gst_tidmaivideosink_class_init(GstTIDmaiVideoSinkClass * klass)
         g_param_spec_int("y", "y position", "Y positioning of"
         " frame in display", G_MININT, G_MAXINT, -1, G_PARAM_READWRITE));
 
+    /* Asynchronous display */
+    g_object_class_install_property(gobject_class, PROP_ASYNC_DISPLAY,
+        g_param_spec_boolean("asyncDisplay", "Asynchronous display",
+            "Queue the frames to a display thread that puts them on the "
+            "screen at their presentation time, instead of waiting for the "
+            "vsync on the streaming thread", FALSE, G_PARAM_READWRITE));
+
+    g_object_class_install_property(gobject_class, PROP_FRAMES_LATE,
+        g_param_spec_uint("framesLate", "Late frames",
+            "Number of frames put on display after their presentation time "
+            "(asyncDisplay only)", 0, G_MAXUINT, 0, G_PARAM_READABLE));
+
+    g_object_class_install_property(gobject_class, PROP_FRAMES_EARLY,
+        g_param_spec_uint("framesEarly", "Early frames",
+            "Number of frames held until their presentation time "
+            "(asyncDisplay only)", 0, G_MAXUINT, 0, G_PARAM_READABLE));
+
+    g_object_class_install_property(gobject_class, PROP_FRAMES_REPEATED,
+        g_param_spec_uint("framesRepeated", "Repeated frames",
+            "Number of vsyncs that showed a frame again for lack of a new "
+            "one while playing (asyncDisplay only)", 0, G_MAXUINT, 0, G_PARAM_READABLE));
+
     gstbase_sink_class->set_caps =
         GST_DEBUG_FUNCPTR(gst_tidmaivideosink_set_caps);
     gstbase_sink_class->start    =
@@ -251,6 +343,14 @@ static void gst_tidmaivideosink_class_init(GstTIDmaiVideoSinkClass * klass)
         GST_DEBUG_FUNCPTR(gst_tidmaivideosink_render);
     gstbase_sink_class->buffer_alloc =
         GST_DEBUG_FUNCPTR(gst_tidmaivideosink_buffer_alloc);
+    gstbase_sink_class->get_times =
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_get_times);
+    gstbase_sink_class->unlock   =
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_unlock);
+    gstbase_sink_class->unlock_stop =
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_unlock_stop);
+    gstbase_sink_class->event    =
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_event);
 }
 
 
@@ -274,6 +374,7 @@ static void gst_tidmaivideosink_init(GstTIDmaiVideoSink * dmaisink,
     dmaisink->numBufs        = -1;
     dmaisink->rotation       = -1;
     dmaisink->tempDmaiBuf    = NULL;
+    dmaisink->importDmaiBuf  = NULL;
     dmaisink->accelFrameCopy = TRUE;
     dmaisink->autoselect     = FALSE;
     dmaisink->prevVideoStd   = 0;
@@ -291,11 +392,41 @@ static void gst_tidmaivideosink_init(GstTIDmaiVideoSink * dmaisink,
     dmaisink->dmaiElementUpstream  = FALSE;
     dmaisink->zeromemcpy = FALSE;
     dmaisink->lastAllocatedBuffer = NULL;
+    dmaisink->asyncDisplay = FALSE;
+    dmaisink->dispQueue = NULL;
+    dmaisink->dispThreadRunning = FALSE;
+    dmaisink->dispFlushing = FALSE;
+    dmaisink->dispUnlocked = FALSE;
+    dmaisink->dispDropped = NULL;
+    dmaisink->dispDroppedCount = 0;
+    pthread_mutex_init(&dmaisink->dispMutex, NULL);
+    pthread_cond_init(&dmaisink->dispCond, NULL);
+    dmaisink->mosaicPads = NULL;
+    dmaisink->mosaicNextPad = 0;
+    dmaisink->mosaicThreadRunning = FALSE;
+    dmaisink->mosaicThreadStarted = FALSE;
+    dmaisink->hRsz = NULL;
+    pthread_mutex_init(&dmaisink->mosaicMutex, NULL);
 
     gst_base_sink_set_max_lateness((GstBaseSink *)dmaisink,-1);
 }
 
 
+/******************************************************************************
+ * gst_tidmaivideosink_finalize
+ ******************************************************************************/
+static void gst_tidmaivideosink_finalize(GObject * object)
+{
+    GstTIDmaiVideoSink *dmaisink = GST_TIDMAIVIDEOSINK(object);
+
+    pthread_mutex_destroy(&dmaisink->dispMutex);
+    pthread_cond_destroy(&dmaisink->dispCond);
+    pthread_mutex_destroy(&dmaisink->mosaicMutex);
+
+    G_OBJECT_CLASS(parent_class)->finalize(object);
+}
+
+
 /*******************************************************************************
  * gst_tidmaivideosink_clean_DisplayBuf
  * This function paint completely of black the display buffers after change 
@@ -361,6 +492,9 @@ static void gst_tidmaivideosink_set_property(GObject * object, guint prop_id,
             sink->yPosition = g_value_get_int(value);
             gst_tidmaivideosink_clean_DisplayBuf(sink);
             break;
+        case PROP_ASYNC_DISPLAY:
+            sink->asyncDisplay = g_value_get_boolean(value);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
             break;
@@ -412,6 +546,18 @@ static void gst_tidmaivideosink_get_property(GObject * object, guint prop_id,
         case PROP_Y_POSITION:
             g_value_set_int(value, sink->yPosition);
             break;
+        case PROP_ASYNC_DISPLAY:
+            g_value_set_boolean(value, sink->asyncDisplay);
+            break;
+        case PROP_FRAMES_LATE:
+            g_value_set_uint(value, sink->framesLate);
+            break;
+        case PROP_FRAMES_EARLY:
+            g_value_set_uint(value, sink->framesEarly);
+            break;
+        case PROP_FRAMES_REPEATED:
+            g_value_set_uint(value, sink->framesRepeated);
+            break;
         default:
             G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
             break;
@@ -494,6 +640,12 @@ static gboolean gst_tidmaivideosink_set_caps(GstBaseSink * bsink,
         sink->tempDmaiBuf = NULL;
     }
 
+    if (sink->importDmaiBuf) {
+        GST_DEBUG("Freeing import reference buffer\n");
+        Buffer_delete(sink->importDmaiBuf);
+        sink->importDmaiBuf = NULL;
+    }
+
     gst_tidmaivideosink_clean_DisplayBuf(sink);
     sink->capsAreSet = TRUE;
 
@@ -906,12 +1058,28 @@ static gboolean gst_tidmaivideosink_exit_display(GstTIDmaiVideoSink * sink)
 {
     GST_DEBUG("Begin\n");
 
+    /* The display threads must be gone before the display is deleted */
+    gst_tidmaivideosink_stop_display_thread(sink);
+    gst_tidmaivideosink_stop_mosaic_thread(sink);
+
+    if (sink->hRsz) {
+        GST_DEBUG("closing Resize\n");
+        Resize_delete(sink->hRsz);
+        sink->hRsz = NULL;
+    }
+
     if (sink->tempDmaiBuf) {
         GST_DEBUG("Freeing temporary DMAI buffer\n");
         Buffer_delete(sink->tempDmaiBuf);
         sink->tempDmaiBuf = NULL;
     }
 
+    if (sink->importDmaiBuf) {
+        GST_DEBUG("Freeing import reference buffer\n");
+        Buffer_delete(sink->importDmaiBuf);
+        sink->importDmaiBuf = NULL;
+    }
+
     if (sink->hFc) {
         GST_DEBUG("closing Framecopy\n");
         Framecopy_delete(sink->hFc);
@@ -1037,6 +1205,14 @@ static gboolean gst_tidmaivideosink_init_display(GstTIDmaiVideoSink * sink,
     }
     GST_DEBUG("Frame Copy Device Created\n");
 
+    /* On mosaic mode the display is driven by the mosaic thread instead */
+    if (sink->asyncDisplay && !sink->mosaicPads &&
+        !gst_tidmaivideosink_start_display_thread(sink)) {
+        GST_ELEMENT_ERROR(sink,RESOURCE,FAILED,(NULL),
+            ("Failed to start the display thread\n"));
+        return FALSE;
+    }
+
     GST_DEBUG("Finish\n");
     return TRUE;
 }
@@ -1063,12 +1239,22 @@ static gboolean gst_tidmaivideosink_start(GstBaseSink *sink)
     dmaisink->prerolledBuffer = NULL;
 
     dmaisink->tempDmaiBuf = NULL;
+    dmaisink->importDmaiBuf = NULL;
     dmaisink->hFc = NULL;
     dmaisink->hDisplay = NULL;
     dmaisink->cleanBufCtrl = NULL;
     dmaisink->allocatedBuffers = NULL;
     dmaisink->unusedBuffers = NULL;
 
+    dmaisink->dispQueue = NULL;
+    dmaisink->dispFlushing = FALSE;
+    dmaisink->dispUnlocked = FALSE;
+    dmaisink->dispDropped = NULL;
+    dmaisink->dispDroppedCount = 0;
+    dmaisink->framesLate = 0;
+    dmaisink->framesEarly = 0;
+    dmaisink->framesRepeated = 0;
+
     return TRUE;
 }
 
@@ -1092,6 +1278,359 @@ static gboolean gst_tidmaivideosink_stop(GstBaseSink *sink)
     return TRUE;
 }
 
+/*******************************************************************************
+ * gst_tidmaivideosink_timed_wait
+ *
+ * Wait on the display queue condition for at most timeout nanoseconds.
+ * Must be called with the dispMutex held.
+*******************************************************************************/
+static int gst_tidmaivideosink_timed_wait(GstTIDmaiVideoSink *sink,
+    GstClockTime timeout)
+{
+    struct timeval  now;
+    struct timespec abstime;
+
+    gettimeofday(&now, NULL);
+    GST_TIME_TO_TIMESPEC(GST_TIMEVAL_TO_TIME(now) + timeout, abstime);
+
+    return pthread_cond_timedwait(&sink->dispCond, &sink->dispMutex, &abstime);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_display_thread
+ *
+ * Services the display queue: holds each frame until the vsync before its
+ * presentation time, and puts it on the display. Display_put waits for the
+ * vsync, so this is what keeps the output paced.
+*******************************************************************************/
+static void *gst_tidmaivideosink_display_thread(void *arg)
+{
+    GstTIDmaiVideoSink  *sink = (GstTIDmaiVideoSink *)arg;
+    DisplayQueue_Entry  *entry;
+    Buffer_Handle       hDispBuf;
+    GstClock            *clock;
+    GstClockTime        now;
+    struct timeval      now_tv;
+    gint                ret;
+
+    GST_DEBUG("Display thread started");
+
+    pthread_mutex_lock(&sink->dispMutex);
+    while (sink->dispThreadRunning) {
+        if (sink->dispQueueCount == 0) {
+            /* A frame kept on screen while paused or flushing isn't late
+             * content, so don't count the gap as repeats */
+            if (sink->dispFlushing || GST_STATE(sink) != GST_STATE_PLAYING)
+                sink->dispLastPut = GST_CLOCK_TIME_NONE;
+            gst_tidmaivideosink_timed_wait(sink, sink->dispPeriod);
+            continue;
+        }
+
+        entry = &sink->dispQueue[sink->dispQueueHead];
+
+        /* While flushing we don't wait, just give the frames to the driver */
+        if (GST_CLOCK_TIME_IS_VALID(entry->deadline) && !sink->dispFlushing &&
+            (clock = gst_element_get_clock(GST_ELEMENT(sink)))) {
+            now = gst_clock_get_time(clock);
+            gst_object_unref(clock);
+
+            if (now + sink->dispPeriod < entry->deadline) {
+                if (!sink->dispHeld) {
+                    sink->framesEarly++;
+                    sink->dispHeld = TRUE;
+                }
+                GST_LOG("Holding frame %" GST_TIME_FORMAT " until %"
+                    GST_TIME_FORMAT, GST_TIME_ARGS(now),
+                    GST_TIME_ARGS(entry->deadline - sink->dispPeriod));
+                gst_tidmaivideosink_timed_wait(sink,
+                    entry->deadline - sink->dispPeriod - now);
+                /* Check again, we may be flushing or stopping now */
+                continue;
+            } else if (now > entry->deadline + sink->dispPeriod) {
+                GST_LOG("Frame is late by %" GST_TIME_FORMAT,
+                    GST_TIME_ARGS(now - entry->deadline));
+                sink->framesLate++;
+            }
+        }
+
+        hDispBuf = entry->hBuf;
+        sink->dispHeld = FALSE;
+        sink->dispQueueHead = (sink->dispQueueHead + 1) % sink->numBuffers;
+        sink->dispQueueCount--;
+        /* Let render know there is space in the queue again */
+        pthread_cond_broadcast(&sink->dispCond);
+        pthread_mutex_unlock(&sink->dispMutex);
+
+        ret = Display_put(sink->hDisplay, hDispBuf);
+
+        pthread_mutex_lock(&sink->dispMutex);
+        if (ret < 0) {
+            sink->dispError = TRUE;
+            pthread_cond_broadcast(&sink->dispCond);
+            pthread_mutex_unlock(&sink->dispMutex);
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("Failed to put the buffer on display"));
+            pthread_mutex_lock(&sink->dispMutex);
+            break;
+        }
+
+        /* Display_put returned on the vsync showing the new frame, every
+         * vsync since the previous put showed the previous frame again */
+        gettimeofday(&now_tv, NULL);
+        now = GST_TIMEVAL_TO_TIME(now_tv);
+        if (GST_CLOCK_TIME_IS_VALID(sink->dispLastPut) &&
+            now > sink->dispLastPut + sink->dispPeriod * 3 / 2) {
+            sink->framesRepeated += (now - sink->dispLastPut +
+                sink->dispPeriod / 2) / sink->dispPeriod - 1;
+        }
+        sink->dispLastPut = now;
+    }
+    pthread_mutex_unlock(&sink->dispMutex);
+
+    GST_DEBUG("Display thread finished");
+    return NULL;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_start_display_thread
+ *
+ * Creates the display queue and the thread servicing it. The queue never
+ * holds more than numBuffers - 2 frames, so the driver always keeps enough
+ * buffers queued for Display_get to return.
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_start_display_thread(
+    GstTIDmaiVideoSink *sink)
+{
+    sink->dispQueue = g_malloc0(sink->numBuffers * sizeof(DisplayQueue_Entry));
+    sink->dispDropped = g_malloc0(sink->numBuffers * sizeof(Buffer_Handle));
+    sink->dispDroppedCount = 0;
+    sink->dispQueueHead = 0;
+    sink->dispQueueCount = 0;
+    sink->dispQueueMax = MAX(sink->numBuffers - 2, 1);
+    sink->dispPeriod = GST_SECOND /
+        (sink->oattrs.framerate > 0 ? sink->oattrs.framerate : 30);
+    sink->dispError = FALSE;
+    sink->dispHeld = FALSE;
+    sink->dispLastPut = GST_CLOCK_TIME_NONE;
+    sink->dispThreadRunning = TRUE;
+
+    if (pthread_create(&sink->dispThread, NULL,
+            gst_tidmaivideosink_display_thread, sink)) {
+        sink->dispThreadRunning = FALSE;
+        g_free(sink->dispQueue);
+        sink->dispQueue = NULL;
+        g_free(sink->dispDropped);
+        sink->dispDropped = NULL;
+        return FALSE;
+    }
+
+    GST_DEBUG("Display queue of %d frames, display period %" GST_TIME_FORMAT,
+        sink->dispQueueMax, GST_TIME_ARGS(sink->dispPeriod));
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_stop_display_thread
+*******************************************************************************/
+static void gst_tidmaivideosink_stop_display_thread(GstTIDmaiVideoSink *sink)
+{
+    if (!sink->dispQueue)
+        return;
+
+    pthread_mutex_lock(&sink->dispMutex);
+    sink->dispThreadRunning = FALSE;
+    pthread_cond_broadcast(&sink->dispCond);
+    pthread_mutex_unlock(&sink->dispMutex);
+
+    pthread_join(sink->dispThread, NULL);
+
+    GST_INFO("Display queue stats: %u late, %u early, %u repeated",
+        sink->framesLate, sink->framesEarly, sink->framesRepeated);
+
+    g_free(sink->dispQueue);
+    sink->dispQueue = NULL;
+    sink->dispQueueCount = 0;
+    g_free(sink->dispDropped);
+    sink->dispDropped = NULL;
+    sink->dispDroppedCount = 0;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_queue_wait_space
+ *
+ * Blocks until the display queue can take another frame. When the base
+ * class unlocks us without flushing (i.e. going to PAUSED) we wait for the
+ * preroll like any other render would, and try again once we are back.
+ * Must be called with the preroll lock held, as render is.
+*******************************************************************************/
+static GstFlowReturn gst_tidmaivideosink_queue_wait_space(
+    GstTIDmaiVideoSink *sink)
+{
+    GstFlowReturn ret = GST_FLOW_OK;
+
+    pthread_mutex_lock(&sink->dispMutex);
+    while (sink->dispQueueCount >= sink->dispQueueMax) {
+        if (sink->dispError) {
+            ret = GST_FLOW_ERROR;
+            break;
+        }
+        if (sink->dispFlushing) {
+            ret = GST_FLOW_WRONG_STATE;
+            break;
+        }
+        if (sink->dispUnlocked) {
+            pthread_mutex_unlock(&sink->dispMutex);
+            ret = gst_base_sink_wait_preroll(GST_BASE_SINK_CAST(sink));
+            if (ret != GST_FLOW_OK)
+                return ret;
+            pthread_mutex_lock(&sink->dispMutex);
+            continue;
+        }
+        pthread_cond_wait(&sink->dispCond, &sink->dispMutex);
+    }
+    pthread_mutex_unlock(&sink->dispMutex);
+
+    return ret;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_queue_push
+*******************************************************************************/
+static void gst_tidmaivideosink_queue_push(GstTIDmaiVideoSink *sink,
+    Buffer_Handle hDispBuf, GstBuffer *buf)
+{
+    GstBaseSink  *bsink = GST_BASE_SINK_CAST(sink);
+    GstClockTime deadline = GST_CLOCK_TIME_NONE;
+    GstClockTime running_time;
+    DisplayQueue_Entry *entry;
+
+    /* Prerolled frames (and frames without timestamp) are shown right away,
+     * as is everything when not syncing to the clock */
+    if (GST_BUFFER_TIMESTAMP_IS_VALID(buf) && gst_base_sink_get_sync(bsink) &&
+        GST_STATE(sink) == GST_STATE_PLAYING) {
+        running_time = gst_segment_to_running_time(&bsink->segment,
+            GST_FORMAT_TIME, GST_BUFFER_TIMESTAMP(buf));
+        if (GST_CLOCK_TIME_IS_VALID(running_time)) {
+            deadline = running_time +
+                gst_element_get_base_time(GST_ELEMENT(sink)) +
+                gst_base_sink_get_latency(bsink);
+        }
+    }
+
+    pthread_mutex_lock(&sink->dispMutex);
+    entry = &sink->dispQueue[(sink->dispQueueHead + sink->dispQueueCount) %
+        sink->numBuffers];
+    entry->hBuf = hDispBuf;
+    entry->deadline = deadline;
+    sink->dispQueueCount++;
+    pthread_cond_broadcast(&sink->dispCond);
+    pthread_mutex_unlock(&sink->dispMutex);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_get_times
+ *
+ * With the asynchronous display the display thread does the clock sync, so
+ * we don't let the base class wait for it on the streaming thread.
+*******************************************************************************/
+static void gst_tidmaivideosink_get_times(GstBaseSink * bsink,
+    GstBuffer * buf, GstClockTime * start, GstClockTime * end)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK_CAST(bsink);
+
+    if (sink->dispQueue) {
+        *start = GST_CLOCK_TIME_NONE;
+        *end = GST_CLOCK_TIME_NONE;
+        return;
+    }
+
+    GST_BASE_SINK_CLASS(parent_class)->get_times(bsink, buf, start, end);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_unlock
+ *
+ * Wakes up a render blocked waiting for space on the display queue
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_unlock(GstBaseSink * bsink)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK_CAST(bsink);
+
+    pthread_mutex_lock(&sink->dispMutex);
+    sink->dispUnlocked = TRUE;
+    pthread_cond_broadcast(&sink->dispCond);
+    pthread_mutex_unlock(&sink->dispMutex);
+
+    /* And the mosaic pads waiting for the clock */
+    gst_tidmaivideosink_mosaic_unlock(sink, TRUE);
+
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_unlock_stop
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_unlock_stop(GstBaseSink * bsink)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK_CAST(bsink);
+
+    pthread_mutex_lock(&sink->dispMutex);
+    sink->dispUnlocked = FALSE;
+    pthread_mutex_unlock(&sink->dispMutex);
+
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_event
+ *
+ * On FLUSH_START the frames waiting on the display queue are dropped, their
+ * display buffers are kept to be reused after the flush.
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_event(GstBaseSink * bsink,
+    GstEvent * event)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK_CAST(bsink);
+
+    switch (GST_EVENT_TYPE(event)) {
+        case GST_EVENT_FLUSH_START:
+            pthread_mutex_lock(&sink->dispMutex);
+            sink->dispFlushing = TRUE;
+            while (sink->dispQueue && sink->dispQueueCount > 0) {
+                sink->dispDropped[sink->dispDroppedCount++] =
+                    sink->dispQueue[sink->dispQueueHead].hBuf;
+                sink->dispQueueHead =
+                    (sink->dispQueueHead + 1) % sink->numBuffers;
+                sink->dispQueueCount--;
+            }
+            sink->dispHeld = FALSE;
+            pthread_cond_broadcast(&sink->dispCond);
+            pthread_mutex_unlock(&sink->dispMutex);
+            break;
+        case GST_EVENT_FLUSH_STOP:
+            pthread_mutex_lock(&sink->dispMutex);
+            sink->dispFlushing = FALSE;
+            pthread_mutex_unlock(&sink->dispMutex);
+            break;
+        default:
+            break;
+    }
+
+    if (GST_BASE_SINK_CLASS(parent_class)->event)
+        return GST_BASE_SINK_CLASS(parent_class)->event(bsink, event);
+
+    return TRUE;
+}
+
 /*******************************************************************************
  * gst_tidmaivideosink_get_display_buffer
  *
@@ -1104,7 +1643,17 @@ static Buffer_Handle gst_tidmaivideosink_get_display_buffer(
     BufferGfx_Dimensions dim, inDim;
     int i;
 
-    if (sink->numUnusedBuffers > 0){
+    /* Frames dropped from the display queue on a flush go first */
+    if (sink->dispQueue) {
+        pthread_mutex_lock(&sink->dispMutex);
+        if (sink->dispDroppedCount > 0)
+            hDispBuf = sink->dispDropped[--sink->dispDroppedCount];
+        pthread_mutex_unlock(&sink->dispMutex);
+    }
+
+    if (hDispBuf) {
+        GST_DEBUG("Re-using buffer dropped on flush");
+    } else if (sink->numUnusedBuffers > 0){
         /* Recicle some unused buffer */
         for (i = 0; i < sink->numBuffers ; i++){
             if (sink->unusedBuffers[i] != NULL){
@@ -1313,6 +1862,8 @@ static GstFlowReturn gst_tidmaivideosink_render(GstBaseSink * bsink,
     Buffer_Handle         inBuf     = NULL;
     BufferGfx_Dimensions  inDimSave;
     GstTIDmaiVideoSink   *sink      = GST_TIDMAIVIDEOSINK_CAST(bsink);
+    GstFlowReturn         ret       = GST_FLOW_OK;
+    Bool                  isContiguous = FALSE;
 
     GST_DEBUG("Begin, buffer %p",buf);
 
@@ -1327,11 +1878,59 @@ static GstFlowReturn gst_tidmaivideosink_render(GstBaseSink * bsink,
     }
     sink->prerolledBuffer = NULL;
 
-    /* If the input buffer is non dmai buffer, then allocate dmai buffer and
-     *  copy input buffer in dmai buffer using memcpy routine.
+    /* On mosaic mode the display buffers belong to the mosaic thread */
+    if (sink->mosaicThreadStarted) {
+        GST_WARNING("Dropping buffer on the sink pad while on mosaic mode");
+        return GST_FLOW_OK;
+    }
+
+    /* Don't take a display buffer until the display queue has room for it */
+    if (sink->dispQueue &&
+        (ret = gst_tidmaivideosink_queue_wait_space(sink)) != GST_FLOW_OK) {
+        return ret;
+    }
+
+    /* If the input buffer is non dmai buffer but lives on contiguous memory
+     * (i.e. a capture element allocating from CMEM), wrap it on a reference
+     * dmai buffer so the frame copy can read straight from it. Otherwise
+     * allocate a dmai buffer and copy the input buffer using memcpy.
+     * Memory already known to be contiguous doesn't need to be registered
+     * with Memory_registerContigBuf for the frame copy to translate it.
      */
+    if (!GST_IS_TIDMAIBUFFERTRANSPORT(buf) && sink->width) {
+        Memory_getBufferPhysicalAddress(
+                        GST_BUFFER_DATA(buf),
+                        GST_BUFFER_SIZE(buf),
+                        &isContiguous);
+    }
+
     if (GST_IS_TIDMAIBUFFERTRANSPORT(buf)) {
         inBuf = GST_TIDMAIBUFFERTRANSPORT_DMAIBUF(buf);
+    } else if (isContiguous) {
+        GST_DEBUG("Input buffer is contiguous, importing it without copy");
+
+        /* The reference buffer is created once per caps, only the data
+         * pointer changes from frame to frame
+         */
+        if (sink->importDmaiBuf == NULL) {
+            gfxAttrs.bAttrs.reference   = TRUE;
+            gfxAttrs.dim.width          = sink->width;
+            gfxAttrs.dim.height         = sink->height;
+            gfxAttrs.dim.lineLength     = BufferGfx_calcLineLength(sink->width,
+                                            sink->colorSpace);
+            gfxAttrs.colorSpace         = sink->colorSpace;
+            sink->importDmaiBuf         = Buffer_create(GST_BUFFER_SIZE(buf),
+                                           BufferGfx_getBufferAttrs(&gfxAttrs));
+
+            if (sink->importDmaiBuf == NULL) {
+                GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                    ("Failed to create reference buffer for the input buffer"));
+                return GST_FLOW_UNEXPECTED;
+            }
+        }
+        inBuf = sink->importDmaiBuf;
+        Buffer_setUserPtr(inBuf, (Int8*)GST_BUFFER_DATA(buf));
+        Buffer_setNumBytesUsed(inBuf, GST_BUFFER_SIZE(buf));
     } else {
         /* allocate DMAI buffer */
         if (sink->tempDmaiBuf == NULL) {
@@ -1377,33 +1976,39 @@ static GstFlowReturn gst_tidmaivideosink_render(GstBaseSink * bsink,
             GST_ELEMENT_WARNING(sink,RESOURCE,NO_SPACE_LEFT,(NULL),
                 ("Dropping incoming buffers because no display buffer"
                     " available"));
-            return GST_FLOW_OK;
+            goto drop_frame;
         } else {
             GST_DEBUG("Obtaining display buffer");
             hDispBuf = gst_tidmaivideosink_get_display_buffer(sink,inBuf);
             if (!hDispBuf){
-                return GST_FLOW_UNEXPECTED;
+                ret = GST_FLOW_UNEXPECTED;
+                goto drop_frame;
             }
         }
 
         if (Framecopy_config(sink->hFc, inBuf, hDispBuf) < 0) {
             GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
                 ("Failed to configure the frame copy"));
-            return GST_FLOW_UNEXPECTED;
+            ret = GST_FLOW_UNEXPECTED;
+            goto drop_frame;
         }
 
         if (Framecopy_execute(sink->hFc, inBuf, hDispBuf) < 0) {
             GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
                 ("Failed to execute the frame copy"));
-            return GST_FLOW_UNEXPECTED;
+            ret = GST_FLOW_UNEXPECTED;
+            goto drop_frame;
         }
 
         BufferGfx_resetDimensions(hDispBuf);
         BufferGfx_setDimensions(inBuf, &inDimSave);
     }
 
-    /* Send filled buffer to display device driver to be displayed */
-    if (Display_put(sink->hDisplay, hDispBuf) < 0) {
+    /* Hand the buffer to the display thread, or send it to the display
+     * device driver ourselves */
+    if (sink->dispQueue) {
+        gst_tidmaivideosink_queue_push(sink, hDispBuf, buf);
+    } else if (Display_put(sink->hDisplay, hDispBuf) < 0) {
         GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
             ("Failed to put the buffer on display"));
         return GST_FLOW_UNEXPECTED;
@@ -1412,6 +2017,811 @@ static GstFlowReturn gst_tidmaivideosink_render(GstBaseSink * bsink,
     GST_DEBUG("Finish");
 
     return GST_FLOW_OK;
+
+drop_frame:
+    return ret;
+}
+
+/*******************************************************************************
+ * Mosaic mode
+ *
+ * Every request pad keeps the last frame it received. The mosaic thread
+ * takes each display buffer as the driver releases it, blits the tiles
+ * whose frame is not already on that buffer into their rectangle (with
+ * Framecopy, or Resize when the rectangle size differs from the input)
+ * and puts it back, so there is one Display_put per display period and
+ * no intermediate full screen buffer.
+*******************************************************************************/
+
+G_DEFINE_TYPE (GstTIDmaiVideoSinkPad, gst_tidmaivideosink_pad, GST_TYPE_PAD);
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_set_property
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_set_property(GObject * object,
+    guint prop_id, const GValue * value, GParamSpec * pspec)
+{
+    GstTIDmaiVideoSinkPad *pad = GST_TIDMAIVIDEOSINK_PAD(object);
+    GstTIDmaiVideoSink *sink =
+        (GstTIDmaiVideoSink *)gst_pad_get_parent_element(GST_PAD(pad));
+
+    if (sink)
+        pthread_mutex_lock(&sink->mosaicMutex);
+
+    switch (prop_id) {
+        case PROP_PAD_X_POSITION:
+            /* Keep it even, so it is valid for the 422 color spaces */
+            pad->xPosition = g_value_get_int(value) & ~0x1;
+            break;
+        case PROP_PAD_Y_POSITION:
+            pad->yPosition = g_value_get_int(value);
+            break;
+        case PROP_PAD_WIDTH:
+            pad->width = g_value_get_int(value) & ~0x1;
+            break;
+        case PROP_PAD_HEIGHT:
+            pad->height = g_value_get_int(value);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+            break;
+    }
+
+    if (sink) {
+        /* The old rectangle needs to be painted black */
+        gst_tidmaivideosink_clean_DisplayBuf(sink);
+        pthread_mutex_unlock(&sink->mosaicMutex);
+        gst_object_unref(sink);
+    }
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_get_property
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_get_property(GObject * object,
+    guint prop_id, GValue * value, GParamSpec * pspec)
+{
+    GstTIDmaiVideoSinkPad *pad = GST_TIDMAIVIDEOSINK_PAD(object);
+
+    switch (prop_id) {
+        case PROP_PAD_X_POSITION:
+            g_value_set_int(value, pad->xPosition);
+            break;
+        case PROP_PAD_Y_POSITION:
+            g_value_set_int(value, pad->yPosition);
+            break;
+        case PROP_PAD_WIDTH:
+            g_value_set_int(value, pad->width);
+            break;
+        case PROP_PAD_HEIGHT:
+            g_value_set_int(value, pad->height);
+            break;
+        default:
+            G_OBJECT_WARN_INVALID_PROPERTY_ID(object, prop_id, pspec);
+            break;
+    }
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_release_frame
+ *    Drops the frame held by the pad. Called with the mosaicMutex held.
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_release_frame(GstTIDmaiVideoSinkPad *pad)
+{
+    if (pad->frame) {
+        gst_buffer_unref(pad->frame);
+        pad->frame = NULL;
+    }
+    pad->hFrame = NULL;
+
+    if (pad->tempDmaiBuf) {
+        Buffer_delete(pad->tempDmaiBuf);
+        pad->tempDmaiBuf = NULL;
+    }
+
+    if (pad->blitSeq) {
+        g_free(pad->blitSeq);
+        pad->blitSeq = NULL;
+    }
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_finalize
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_finalize(GObject * object)
+{
+    gst_tidmaivideosink_pad_release_frame(GST_TIDMAIVIDEOSINK_PAD(object));
+
+    G_OBJECT_CLASS(gst_tidmaivideosink_pad_parent_class)->finalize(object);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_class_init
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_class_init(
+    GstTIDmaiVideoSinkPadClass * klass)
+{
+    GObjectClass *gobject_class = G_OBJECT_CLASS(klass);
+
+    gobject_class->set_property = gst_tidmaivideosink_pad_set_property;
+    gobject_class->get_property = gst_tidmaivideosink_pad_get_property;
+    gobject_class->finalize     = gst_tidmaivideosink_pad_finalize;
+
+    g_object_class_install_property(gobject_class, PROP_PAD_X_POSITION,
+        g_param_spec_int("x", "x position", "X position of the tile "
+            "in the display", 0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+    g_object_class_install_property(gobject_class, PROP_PAD_Y_POSITION,
+        g_param_spec_int("y", "y position", "Y position of the tile "
+            "in the display", 0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+    g_object_class_install_property(gobject_class, PROP_PAD_WIDTH,
+        g_param_spec_int("width", "width", "Width of the tile in the "
+            "display, the input is resized to it (0 = input width)",
+            0, G_MAXINT, 0, G_PARAM_READWRITE));
+
+    g_object_class_install_property(gobject_class, PROP_PAD_HEIGHT,
+        g_param_spec_int("height", "height", "Height of the tile in the "
+            "display, the input is resized to it (0 = input height)",
+            0, G_MAXINT, 0, G_PARAM_READWRITE));
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_init
+*******************************************************************************/
+static void gst_tidmaivideosink_pad_init(GstTIDmaiVideoSinkPad * pad)
+{
+    pad->xPosition = 0;
+    pad->yPosition = 0;
+    pad->width = 0;
+    pad->height = 0;
+    pad->frame = NULL;
+    pad->hFrame = NULL;
+    pad->tempDmaiBuf = NULL;
+    pad->seq = 0;
+    pad->blitSeq = NULL;
+    pad->negotiated = FALSE;
+    pad->inWidth = 0;
+    pad->inHeight = 0;
+    pad->framerate = 0;
+    pad->clockId = NULL;
+    pad->flushing = FALSE;
+    pad->unlocked = FALSE;
+    pad->eos = FALSE;
+    gst_segment_init(&pad->segment, GST_FORMAT_TIME);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_mosaic_blit
+ *
+ * Copies the last frame of the pad into its rectangle of the display buffer.
+ * The rectangle is clipped to the display: unscaled tiles are cropped, and
+ * resized tiles are fit into the visible part. Called with the mosaicMutex
+ * held.
+*******************************************************************************/
+static void gst_tidmaivideosink_mosaic_blit(GstTIDmaiVideoSink *sink,
+    GstTIDmaiVideoSinkPad *pad, Buffer_Handle hDispBuf)
+{
+    BufferGfx_Dimensions dim, inDim, inDimSave;
+    gint width  = pad->width  ? pad->width  : pad->inWidth;
+    gint height = pad->height ? pad->height : pad->inHeight;
+    gboolean resize = (width != pad->inWidth) || (height != pad->inHeight);
+
+    BufferGfx_resetDimensions(hDispBuf);
+    BufferGfx_getDimensions(hDispBuf, &dim);
+
+    if (pad->xPosition >= dim.width || pad->yPosition >= dim.height) {
+        GST_LOG("Tile %s is outside of the display",GST_PAD_NAME(pad));
+        return;
+    }
+    if (pad->xPosition + width > dim.width)
+        width = dim.width - pad->xPosition;
+    if (pad->yPosition + height > dim.height)
+        height = dim.height - pad->yPosition;
+
+    BufferGfx_getDimensions(pad->hFrame, &inDimSave);
+    inDim = inDimSave;
+
+    dim.x      = pad->xPosition;
+    dim.y      = pad->yPosition;
+    dim.width  = width;
+    dim.height = height;
+    BufferGfx_setDimensions(hDispBuf, &dim);
+
+    if (!resize) {
+        inDim.width  = width;
+        inDim.height = height;
+        BufferGfx_setDimensions(pad->hFrame, &inDim);
+
+        if (Framecopy_config(sink->hFc, pad->hFrame, hDispBuf) < 0 ||
+            Framecopy_execute(sink->hFc, pad->hFrame, hDispBuf) < 0) {
+            GST_WARNING("Failed to copy tile %s",GST_PAD_NAME(pad));
+        }
+    } else {
+        if (!sink->hRsz) {
+            Resize_Attrs rszAttrs = Resize_Attrs_DEFAULT;
+
+            sink->hRsz = Resize_create(&rszAttrs);
+            if (!sink->hRsz) {
+                GST_ELEMENT_WARNING(sink,RESOURCE,FAILED,(NULL),
+                    ("Failed to create the resizer, tiles can't be scaled"));
+            }
+        }
+
+        if (!sink->hRsz ||
+            Resize_config(sink->hRsz, pad->hFrame, hDispBuf) < 0 ||
+            Resize_execute(sink->hRsz, pad->hFrame, hDispBuf) < 0) {
+            GST_WARNING("Failed to resize tile %s",GST_PAD_NAME(pad));
+        }
+    }
+
+    BufferGfx_setDimensions(pad->hFrame, &inDimSave);
+    BufferGfx_resetDimensions(hDispBuf);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_mosaic_thread
+*******************************************************************************/
+static void *gst_tidmaivideosink_mosaic_thread(void *arg)
+{
+    GstTIDmaiVideoSink    *sink = (GstTIDmaiVideoSink *)arg;
+    GstTIDmaiVideoSinkPad *pad;
+    Buffer_Handle         hDispBuf;
+    GList                 *l;
+    gint                  id;
+
+    GST_DEBUG("Mosaic thread started");
+
+    while (g_atomic_int_get(&sink->mosaicThreadRunning)) {
+        /* Blocks until the driver releases a buffer */
+        if (Display_get(sink->hDisplay, &hDispBuf) < 0 || !hDispBuf) {
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("Failed to get display buffer"));
+            break;
+        }
+        id = Buffer_getId(hDispBuf);
+
+        pthread_mutex_lock(&sink->mosaicMutex);
+        if (sink->cleanBufCtrl[id] == DIRTY) {
+            if (!gst_ti_blackFill(hDispBuf)) {
+                GST_ELEMENT_WARNING(sink, RESOURCE, SETTINGS, (NULL),
+                    ("Unsupported color space, buffers not painted\n"));
+            }
+            sink->cleanBufCtrl[id] = CLEAN;
+            for (l = sink->mosaicPads; l; l = l->next) {
+                pad = (GstTIDmaiVideoSinkPad *)l->data;
+                if (pad->blitSeq)
+                    pad->blitSeq[id] = 0;
+            }
+        }
+
+        for (l = sink->mosaicPads; l; l = l->next) {
+            pad = (GstTIDmaiVideoSinkPad *)l->data;
+            if (pad->hFrame && pad->blitSeq && pad->blitSeq[id] != pad->seq) {
+                gst_tidmaivideosink_mosaic_blit(sink, pad, hDispBuf);
+                pad->blitSeq[id] = pad->seq;
+            }
+        }
+        pthread_mutex_unlock(&sink->mosaicMutex);
+
+        if (Display_put(sink->hDisplay, hDispBuf) < 0) {
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("Failed to put the buffer on display"));
+            break;
+        }
+    }
+
+    /* Also when bailing out on an error, so the next frame starts it again */
+    g_atomic_int_set(&sink->mosaicThreadRunning, FALSE);
+
+    GST_DEBUG("Mosaic thread finished");
+    return NULL;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_stop_mosaic_thread
+ *    Stops the mosaic thread and drops the frames held by the pads, since
+ *    they refer to the display being closed. The caps of the pads are kept,
+ *    the next frame opens the display again.
+*******************************************************************************/
+static void gst_tidmaivideosink_stop_mosaic_thread(GstTIDmaiVideoSink *sink)
+{
+    GList *l;
+
+    /* The thread may have stopped on its own, it still has to be joined */
+    if (sink->mosaicThreadStarted) {
+        g_atomic_int_set(&sink->mosaicThreadRunning, FALSE);
+        pthread_join(sink->mosaicThread, NULL);
+        sink->mosaicThreadStarted = FALSE;
+    }
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    for (l = sink->mosaicPads; l; l = l->next) {
+        gst_tidmaivideosink_pad_release_frame(
+            (GstTIDmaiVideoSinkPad *)l->data);
+    }
+    pthread_mutex_unlock(&sink->mosaicMutex);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_mosaic_start
+ *
+ * Opens the display, sized to fit the tiles negotiated so far, and starts
+ * the mosaic thread if they are not running yet. Called with the
+ * mosaicMutex held.
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_mosaic_start(GstTIDmaiVideoSink *sink)
+{
+    GstTIDmaiVideoSinkPad *pad;
+    GList *l;
+
+    if (!sink->hDisplay) {
+        sink->iattrs.width = 0;
+        sink->iattrs.height = 0;
+        sink->iattrs.framerate = 0;
+        for (l = sink->mosaicPads; l; l = l->next) {
+            pad = (GstTIDmaiVideoSinkPad *)l->data;
+            if (!pad->negotiated)
+                continue;
+            sink->iattrs.width = MAX(sink->iattrs.width, pad->xPosition +
+                (pad->width ? pad->width : pad->inWidth));
+            sink->iattrs.height = MAX(sink->iattrs.height, pad->yPosition +
+                (pad->height ? pad->height : pad->inHeight));
+            sink->iattrs.framerate = MAX(sink->iattrs.framerate,
+                pad->framerate);
+        }
+
+        GST_DEBUG("Mosaic of %ldx%ld, frame rate %d", sink->iattrs.width,
+            sink->iattrs.height, sink->iattrs.framerate);
+
+        if (!gst_tidmaivideosink_init_display(sink, sink->colorSpace)) {
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("Failed to initialize display"));
+            return FALSE;
+        }
+        gst_tidmaivideosink_clean_DisplayBuf(sink);
+    }
+
+    if (!g_atomic_int_get(&sink->mosaicThreadRunning)) {
+        /* Reap a thread that stopped on an error before starting anew */
+        if (sink->mosaicThreadStarted) {
+            pthread_join(sink->mosaicThread, NULL);
+            sink->mosaicThreadStarted = FALSE;
+        }
+        g_atomic_int_set(&sink->mosaicThreadRunning, TRUE);
+        if (pthread_create(&sink->mosaicThread, NULL,
+                gst_tidmaivideosink_mosaic_thread, sink)) {
+            g_atomic_int_set(&sink->mosaicThreadRunning, FALSE);
+            GST_ELEMENT_ERROR(sink,RESOURCE,FAILED,(NULL),
+                ("Failed to start the mosaic thread"));
+            return FALSE;
+        }
+        sink->mosaicThreadStarted = TRUE;
+    }
+
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_setcaps
+ *
+ * The first mosaic pad to get caps opens the display and starts the mosaic
+ * thread. All the tiles need to use the color space of the display.
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_pad_setcaps(GstPad * pad, GstCaps * caps)
+{
+    GstTIDmaiVideoSinkPad *mpad = GST_TIDMAIVIDEOSINK_PAD(pad);
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(GST_OBJECT_PARENT(pad));
+    GstStructure *structure = gst_caps_get_structure(caps, 0);
+    GstTIDmaiVideoSinkPad *other;
+    ColorSpace_Type colorSpace;
+    guint32 fourcc;
+    gint width = 0, height = 0;
+    gint framerateNum = 0, framerateDen = 1;
+    gboolean ret = TRUE;
+    GList *l;
+
+    gst_structure_get_int(structure, "width", &width);
+    gst_structure_get_int(structure, "height", &height);
+    gst_structure_get_fourcc(structure, "format", &fourcc);
+    gst_structure_get_fraction(structure, "framerate",
+        &framerateNum, &framerateDen);
+
+    switch (fourcc) {
+        case GST_MAKE_FOURCC('U', 'Y', 'V', 'Y'):
+            colorSpace = ColorSpace_UYVY;
+            break;
+        case GST_MAKE_FOURCC('Y', '8', 'C', '8'):
+            colorSpace = ColorSpace_YUV422PSEMI;
+            break;
+        case GST_MAKE_FOURCC('N', 'V', '1', '2'):
+            colorSpace = ColorSpace_YUV420PSEMI;
+            break;
+        default:
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("unsupported fourcc"));
+            return FALSE;
+    }
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    for (l = sink->mosaicPads; l; l = l->next) {
+        other = (GstTIDmaiVideoSinkPad *)l->data;
+        if (other != mpad && other->negotiated &&
+            other->colorSpace != colorSpace) {
+            GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                ("All the mosaic tiles must use the display color space"));
+            ret = FALSE;
+            goto done;
+        }
+    }
+
+    GST_DEBUG("Tile %s: colorspace %d, width %d, height %d",
+        GST_PAD_NAME(pad), colorSpace, width, height);
+
+    gst_tidmaivideosink_pad_release_frame(mpad);
+    mpad->inWidth = width;
+    mpad->inHeight = height;
+    mpad->framerate = framerateDen ?
+        (gint)(((gdouble) framerateNum / framerateDen) + .5) : 0;
+    mpad->colorSpace = colorSpace;
+    mpad->negotiated = TRUE;
+    mpad->seq = 1;
+    sink->colorSpace = colorSpace;
+
+    if (!gst_tidmaivideosink_mosaic_start(sink)) {
+        ret = FALSE;
+        goto done;
+    }
+    mpad->blitSeq = g_malloc0(sink->numBuffers * sizeof(guint));
+
+done:
+    pthread_mutex_unlock(&sink->mosaicMutex);
+    return ret;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_wait
+ *
+ * Waits for the presentation time of the buffer. Returns
+ * GST_FLOW_WRONG_STATE if we are flushing. When the wait is interrupted by
+ * going to PAUSED the frame is taken right away, as prerolled frames are.
+*******************************************************************************/
+static GstFlowReturn gst_tidmaivideosink_pad_wait(GstTIDmaiVideoSink *sink,
+    GstTIDmaiVideoSinkPad *pad, GstBuffer *buf)
+{
+    GstClock *clock;
+    GstClockTime running_time;
+    GstFlowReturn ret;
+
+    if (!GST_BUFFER_TIMESTAMP_IS_VALID(buf) ||
+        GST_STATE(sink) != GST_STATE_PLAYING)
+        return GST_FLOW_OK;
+
+    running_time = gst_segment_to_running_time(&pad->segment,
+        GST_FORMAT_TIME, GST_BUFFER_TIMESTAMP(buf));
+    if (!GST_CLOCK_TIME_IS_VALID(running_time))
+        return GST_FLOW_OK;
+
+    clock = gst_element_get_clock(GST_ELEMENT(sink));
+    if (!clock)
+        return GST_FLOW_OK;
+
+    GST_OBJECT_LOCK(pad);
+    if (pad->flushing || pad->unlocked) {
+        GST_OBJECT_UNLOCK(pad);
+        gst_object_unref(clock);
+        return pad->flushing ? GST_FLOW_WRONG_STATE : GST_FLOW_OK;
+    }
+    pad->clockId = gst_clock_new_single_shot_id(clock, running_time +
+        gst_element_get_base_time(GST_ELEMENT(sink)));
+    GST_OBJECT_UNLOCK(pad);
+
+    gst_clock_id_wait(pad->clockId, NULL);
+
+    GST_OBJECT_LOCK(pad);
+    gst_clock_id_unref(pad->clockId);
+    pad->clockId = NULL;
+    ret = pad->flushing ? GST_FLOW_WRONG_STATE : GST_FLOW_OK;
+    GST_OBJECT_UNLOCK(pad);
+    gst_object_unref(clock);
+
+    return ret;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_mosaic_unlock
+ *
+ * Sets whether the mosaic pads wait for the clock, and wakes up those
+ * waiting now when they should not.
+*******************************************************************************/
+static void gst_tidmaivideosink_mosaic_unlock(GstTIDmaiVideoSink *sink,
+    gboolean unlocked)
+{
+    GstTIDmaiVideoSinkPad *pad;
+    GList *l;
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    for (l = sink->mosaicPads; l; l = l->next) {
+        pad = (GstTIDmaiVideoSinkPad *)l->data;
+        GST_OBJECT_LOCK(pad);
+        pad->unlocked = unlocked;
+        if (unlocked && pad->clockId)
+            gst_clock_id_unschedule(pad->clockId);
+        GST_OBJECT_UNLOCK(pad);
+    }
+    pthread_mutex_unlock(&sink->mosaicMutex);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_change_state
+*******************************************************************************/
+static GstStateChangeReturn gst_tidmaivideosink_change_state(
+    GstElement * element, GstStateChange transition)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(element);
+
+    /* Mosaic pads wait for the clock again once we are back on PLAYING,
+     * the base class unlock takes care of the PLAYING to PAUSED case */
+    if (transition == GST_STATE_CHANGE_PAUSED_TO_PLAYING)
+        gst_tidmaivideosink_mosaic_unlock(sink, FALSE);
+
+    return GST_ELEMENT_CLASS(parent_class)->change_state(element, transition);
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_activate_push
+ *
+ * A pad being deactivated must not stay blocked on the clock, or the
+ * deactivation never gets the stream lock.
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_pad_activate_push(GstPad * pad,
+    gboolean active)
+{
+    GstTIDmaiVideoSinkPad *mpad = GST_TIDMAIVIDEOSINK_PAD(pad);
+
+    GST_OBJECT_LOCK(pad);
+    mpad->flushing = !active;
+    mpad->unlocked = FALSE;
+    if (!active && mpad->clockId)
+        gst_clock_id_unschedule(mpad->clockId);
+    GST_OBJECT_UNLOCK(pad);
+
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_chain
+ *
+ * Keeps the incoming frame as the current one of the tile. Dmai buffers are
+ * just referenced, other buffers are copied into a contiguous buffer.
+*******************************************************************************/
+static GstFlowReturn gst_tidmaivideosink_pad_chain(GstPad * pad,
+    GstBuffer * buf)
+{
+    GstTIDmaiVideoSinkPad *mpad = GST_TIDMAIVIDEOSINK_PAD(pad);
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(GST_OBJECT_PARENT(pad));
+    BufferGfx_Attrs gfxAttrs = BufferGfx_Attrs_DEFAULT;
+    GstBuffer *old = NULL;
+    GstFlowReturn ret;
+
+    if ((ret = gst_tidmaivideosink_pad_wait(sink, mpad, buf)) !=
+        GST_FLOW_OK) {
+        gst_buffer_unref(buf);
+        return ret;
+    }
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    if (!mpad->negotiated) {
+        pthread_mutex_unlock(&sink->mosaicMutex);
+        gst_buffer_unref(buf);
+        GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+            ("Tile %s got a buffer before caps", GST_PAD_NAME(pad)));
+        return GST_FLOW_NOT_NEGOTIATED;
+    }
+
+    /* The display is closed when going to READY, reopen it */
+    if (!gst_tidmaivideosink_mosaic_start(sink)) {
+        pthread_mutex_unlock(&sink->mosaicMutex);
+        gst_buffer_unref(buf);
+        return GST_FLOW_ERROR;
+    }
+    if (!mpad->blitSeq)
+        mpad->blitSeq = g_malloc0(sink->numBuffers * sizeof(guint));
+
+    old = mpad->frame;
+    if (GST_IS_TIDMAIBUFFERTRANSPORT(buf)) {
+        mpad->frame = buf;
+        mpad->hFrame = GST_TIDMAIBUFFERTRANSPORT_DMAIBUF(buf);
+    } else {
+        if (mpad->tempDmaiBuf &&
+            Buffer_getSize(mpad->tempDmaiBuf) < GST_BUFFER_SIZE(buf)) {
+            Buffer_delete(mpad->tempDmaiBuf);
+            mpad->tempDmaiBuf = NULL;
+        }
+        if (!mpad->tempDmaiBuf) {
+            gfxAttrs.dim.width      = mpad->inWidth;
+            gfxAttrs.dim.height     = mpad->inHeight;
+            gfxAttrs.dim.lineLength = BufferGfx_calcLineLength(mpad->inWidth,
+                                        mpad->colorSpace);
+            gfxAttrs.colorSpace     = mpad->colorSpace;
+            mpad->tempDmaiBuf = Buffer_create(GST_BUFFER_SIZE(buf),
+                                    BufferGfx_getBufferAttrs(&gfxAttrs));
+            if (!mpad->tempDmaiBuf) {
+                mpad->frame = NULL;
+                mpad->hFrame = NULL;
+                pthread_mutex_unlock(&sink->mosaicMutex);
+                if (old)
+                    gst_buffer_unref(old);
+                gst_buffer_unref(buf);
+                GST_ELEMENT_ERROR(sink,STREAM,FAILED,(NULL),
+                    ("Failed to allocate memory for the input buffer"));
+                return GST_FLOW_UNEXPECTED;
+            }
+        }
+        memcpy(Buffer_getUserPtr(mpad->tempDmaiBuf), GST_BUFFER_DATA(buf),
+            GST_BUFFER_SIZE(buf));
+        mpad->frame = NULL;
+        mpad->hFrame = mpad->tempDmaiBuf;
+        /* Already copied, the buffer can go */
+        gst_buffer_unref(buf);
+    }
+    mpad->seq++;
+    pthread_mutex_unlock(&sink->mosaicMutex);
+
+    if (old)
+        gst_buffer_unref(old);
+
+    return GST_FLOW_OK;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_pad_event
+*******************************************************************************/
+static gboolean gst_tidmaivideosink_pad_event(GstPad * pad, GstEvent * event)
+{
+    GstTIDmaiVideoSinkPad *mpad = GST_TIDMAIVIDEOSINK_PAD(pad);
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(GST_OBJECT_PARENT(pad));
+    gboolean eos = TRUE;
+    GList *l;
+
+    switch (GST_EVENT_TYPE(event)) {
+        case GST_EVENT_NEWSEGMENT:
+        {
+            gboolean update;
+            gdouble rate, applied_rate;
+            GstFormat format;
+            gint64 start, stop, position;
+
+            gst_event_parse_new_segment_full(event, &update, &rate,
+                &applied_rate, &format, &start, &stop, &position);
+            if (format == GST_FORMAT_TIME) {
+                gst_segment_set_newsegment_full(&mpad->segment, update, rate,
+                    applied_rate, format, start, stop, position);
+            }
+            break;
+        }
+        case GST_EVENT_FLUSH_START:
+            GST_OBJECT_LOCK(pad);
+            mpad->flushing = TRUE;
+            if (mpad->clockId)
+                gst_clock_id_unschedule(mpad->clockId);
+            GST_OBJECT_UNLOCK(pad);
+            break;
+        case GST_EVENT_FLUSH_STOP:
+            GST_OBJECT_LOCK(pad);
+            mpad->flushing = FALSE;
+            mpad->eos = FALSE;
+            gst_segment_init(&mpad->segment, GST_FORMAT_TIME);
+            GST_OBJECT_UNLOCK(pad);
+            break;
+        case GST_EVENT_EOS:
+            /* The element is EOS once all the tiles are */
+            pthread_mutex_lock(&sink->mosaicMutex);
+            mpad->eos = TRUE;
+            for (l = sink->mosaicPads; l; l = l->next) {
+                if (!((GstTIDmaiVideoSinkPad *)l->data)->eos)
+                    eos = FALSE;
+            }
+            pthread_mutex_unlock(&sink->mosaicMutex);
+            if (eos) {
+                GST_DEBUG("All the tiles are EOS");
+                gst_element_post_message(GST_ELEMENT(sink),
+                    gst_message_new_eos(GST_OBJECT(sink)));
+            }
+            break;
+        default:
+            break;
+    }
+
+    gst_event_unref(event);
+    return TRUE;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_request_new_pad
+ *
+ * Requesting a pad switches the sink into mosaic mode. The always sink pad
+ * is left unlinked, so we don't wait for it to preroll.
+*******************************************************************************/
+static GstPad *gst_tidmaivideosink_request_new_pad(GstElement * element,
+    GstPadTemplate * templ, const gchar * name)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(element);
+    GstPad *pad;
+    gchar *padname;
+
+    if (templ->direction != GST_PAD_SINK) {
+        GST_WARNING("Request for a non sink pad");
+        return NULL;
+    }
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    padname = name ? g_strdup(name) :
+        g_strdup_printf("sink_%d", sink->mosaicNextPad);
+    sink->mosaicNextPad++;
+    pthread_mutex_unlock(&sink->mosaicMutex);
+
+    pad = g_object_new(GST_TYPE_TIDMAIVIDEOSINK_PAD, "name", padname,
+        "direction", templ->direction, "template", templ, NULL);
+    g_free(padname);
+
+    gst_pad_set_setcaps_function(pad,
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_pad_setcaps));
+    gst_pad_set_chain_function(pad,
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_pad_chain));
+    gst_pad_set_event_function(pad,
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_pad_event));
+    gst_pad_set_activatepush_function(pad,
+        GST_DEBUG_FUNCPTR(gst_tidmaivideosink_pad_activate_push));
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    sink->mosaicPads = g_list_append(sink->mosaicPads, pad);
+    pthread_mutex_unlock(&sink->mosaicMutex);
+
+    gst_base_sink_set_async_enabled(GST_BASE_SINK(sink), FALSE);
+
+    if (GST_STATE(element) > GST_STATE_READY)
+        gst_pad_set_active(pad, TRUE);
+    gst_element_add_pad(element, pad);
+
+    GST_DEBUG("Added mosaic pad %s",GST_PAD_NAME(pad));
+    return pad;
+}
+
+
+/*******************************************************************************
+ * gst_tidmaivideosink_release_pad
+*******************************************************************************/
+static void gst_tidmaivideosink_release_pad(GstElement * element, GstPad * pad)
+{
+    GstTIDmaiVideoSink *sink = GST_TIDMAIVIDEOSINK(element);
+
+    GST_DEBUG("Releasing mosaic pad %s",GST_PAD_NAME(pad));
+
+    pthread_mutex_lock(&sink->mosaicMutex);
+    sink->mosaicPads = g_list_remove(sink->mosaicPads, pad);
+    /* Paint black the area the tile was using */
+    gst_tidmaivideosink_clean_DisplayBuf(sink);
+    pthread_mutex_unlock(&sink->mosaicMutex);
+
+    gst_element_remove_pad(element, pad);
 }
 
 
@@ -25,6 +25,7 @@
 #include <gst/gst.h>
 #include <string.h>
 #include <ctype.h>
+#include <pthread.h>
 
 //#include <gst/base/gstbasesink.h>
 #include <gst/video/gstvideosink.h>
@@ -58,6 +59,13 @@ G_BEGIN_DECLS
   (G_TYPE_CHECK_CLASS_TYPE((klass),GST_TYPE_TIDMAIVIDEOSINK))
 #define GST_TIDMAIVIDEOSINK_CAST(obj) ((GstTIDmaiVideoSink *)obj)
 
+#define GST_TYPE_TIDMAIVIDEOSINK_PAD \
+  (gst_tidmaivideosink_pad_get_type())
+#define GST_TIDMAIVIDEOSINK_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_CAST((obj),GST_TYPE_TIDMAIVIDEOSINK_PAD,GstTIDmaiVideoSinkPad))
+#define GST_IS_TIDMAIVIDEOSINK_PAD(obj) \
+  (G_TYPE_CHECK_INSTANCE_TYPE((obj),GST_TYPE_TIDMAIVIDEOSINK_PAD))
+
 typedef struct _VideoStd_Attrs VideoStd_Attrs;
 struct _VideoStd_Attrs {
   VideoStd_Type     videostd;
@@ -66,8 +74,66 @@ struct _VideoStd_Attrs {
   int               framerate;
 };
 
+/* Entry of the asynchronous display queue: a display buffer ready to be
+ * put, and the clock time it should be shown at (GST_CLOCK_TIME_NONE to
+ * show it as soon as possible).
+ */
+typedef struct _DisplayQueue_Entry DisplayQueue_Entry;
+struct _DisplayQueue_Entry {
+  Buffer_Handle     hBuf;
+  GstClockTime      deadline;
+};
+
 typedef struct _GstTIDmaiVideoSink GstTIDmaiVideoSink;
 typedef struct _GstTIDmaiVideoSinkClass GstTIDmaiVideoSinkClass;
+typedef struct _GstTIDmaiVideoSinkPad GstTIDmaiVideoSinkPad;
+typedef struct _GstTIDmaiVideoSinkPadClass GstTIDmaiVideoSinkPadClass;
+
+/**
+ * GstTIDmaiVideoSinkPad:
+ *
+ * Request pad of the mosaic mode. The last frame received on the pad is
+ * blitted into its target rectangle of every display buffer.
+ */
+struct _GstTIDmaiVideoSinkPad {
+  GstPad            pad;
+
+  /* Target rectangle, a width or height of 0 means the input size */
+  gint              xPosition;
+  gint              yPosition;
+  gint              width;
+  gint              height;
+
+  /* Input attributes, kept across a restart of the display */
+  gboolean          negotiated;
+  gint              inWidth;
+  gint              inHeight;
+  gint              framerate;
+  ColorSpace_Type   colorSpace;
+  GstSegment        segment;
+
+  /* Last frame received and the dmai buffer holding it */
+  GstBuffer         *frame;
+  Buffer_Handle     hFrame;
+  Buffer_Handle     tempDmaiBuf;
+
+  /* seq is increased on every new frame, blitSeq tracks which frame is
+   * already on each display buffer so unchanged tiles are not copied again
+   */
+  guint             seq;
+  guint             *blitSeq;
+
+  /* unlocked is set while the element goes from PLAYING to PAUSED, the
+   * frames are not waited for then */
+  GstClockID        clockId;
+  gboolean          flushing;
+  gboolean          unlocked;
+  gboolean          eos;
+};
+
+struct _GstTIDmaiVideoSinkPadClass {
+  GstPadClass parent_class;
+};
 
 /**
  * GstDmaiVideoSink:
@@ -99,6 +165,8 @@ struct _GstTIDmaiVideoSink {
   Framecopy_Handle  hFc;
   Cpu_Device        cpu_dev;
   Buffer_Handle     tempDmaiBuf;
+  /* Reference buffer wrapping contiguous input buffers, per caps */
+  Buffer_Handle     importDmaiBuf;
   gint              numBuffers;
   GstBuffer         **allocatedBuffers;
   Buffer_Handle     *unusedBuffers;
@@ -127,6 +195,48 @@ struct _GstTIDmaiVideoSink {
 
   /* Hardware accelerated copy */
   gboolean      accelFrameCopy;
+
+  /* Asynchronous display queue, serviced by dispThread which does the
+   * Display_put (and thus waits for the vsync) instead of render.
+   */
+  gboolean            asyncDisplay;
+  DisplayQueue_Entry  *dispQueue;
+  gint                dispQueueHead;
+  gint                dispQueueCount;
+  gint                dispQueueMax;
+  pthread_t           dispThread;
+  pthread_mutex_t     dispMutex;
+  pthread_cond_t      dispCond;
+  gboolean            dispThreadRunning;
+  /* dispFlushing is only set between FLUSH_START and FLUSH_STOP,
+   * dispUnlocked whenever the base class asks render to unblock */
+  gboolean            dispFlushing;
+  gboolean            dispUnlocked;
+  /* Display buffers dropped from the queue on a flush, reused before
+   * asking the driver for a new one */
+  Buffer_Handle       *dispDropped;
+  gint                dispDroppedCount;
+  gboolean            dispError;
+  gboolean            dispHeld;
+  /* Time of the last Display_put, to count the vsyncs in between */
+  GstClockTime        dispLastPut;
+  GstClockTime        dispPeriod;
+  guint               framesLate;
+  guint               framesEarly;
+  guint               framesRepeated;
+
+  /* Mosaic mode: frames from the request pads are composed by mosaicThread
+   * on the display buffers, with one Display_put per display period.
+   */
+  GList               *mosaicPads;
+  gint                mosaicNextPad;
+  pthread_mutex_t     mosaicMutex;
+  pthread_t           mosaicThread;
+  /* Running is cleared by the thread when it exits, Started until the
+   * thread is joined */
+  gint                mosaicThreadRunning;
+  gboolean            mosaicThreadStarted;
+  Resize_Handle       hRsz;
 };
 
 struct _GstTIDmaiVideoSinkClass {
@@ -134,6 +244,7 @@ struct _GstTIDmaiVideoSinkClass {
 };
 
 GType gst_tidmaivideosink_get_type (void);
+GType gst_tidmaivideosink_pad_get_type (void);
 
 G_END_DECLS
 
@@ -24,9 +24,52 @@
 #define __GST_TIPARSERS_H__
 
 #include <gst/gst.h>
-#include <ti/sdo/dmai/BufTab.h>
-#include "gsttidmaidec.h"
-#include "gsttidmaienc.h"
+
+/* Byte range of the input stream scanned by a parser.  The data pending to
+ * be handed to the codec is data[tail, head), and the scan resumes at marker,
+ * where the previous call left it.  Parsers only see this range, so the
+ * scanning code doesn't depend on how the element buffers the stream.
+ */
+struct gstti_parser_range {
+    const guint8    *data;
+    gint            tail;
+    gint            marker;
+    gint            head;
+    /* Size of the chunks to hand out on streams without framing */
+    gint            chunkSize;
+    /* Set by parsers that know the playback duration of the data they
+     * return, so every frame gets its own timestamp
+     */
+    GstClockTime    duration;
+    /* Set by parsers that know the coding type of the frame they return */
+    gint            frameType;
+};
+
+/* Coding type of a frame returned by a parser */
+enum gstti_frame_type {
+    GSTTI_FRAME_UNKNOWN,
+    GSTTI_FRAME_I,
+    GSTTI_FRAME_P,
+    GSTTI_FRAME_B,
+};
+
+/* What a parser gets to know about the stream when it starts.  Parsers
+ * don't see the element, so they can be driven by anything that fills
+ * this in.
+ */
+struct gstti_parser_params {
+    /* Caps of the stream (codec_data, stream-format...), may be NULL */
+    GstCaps         *caps;
+    /* Name of the codec the frames go to, may be NULL */
+    const gchar     *codecName;
+    /* Sample rate and channels of audio streams, 0 when unknown */
+    gint            rate;
+    gint            channels;
+    /* Size of the input buffer in output buffers, 0 for the default.
+     * Parsers may set it when they need a specific size.
+     */
+    gint            numInputBufs;
+};
 
 struct gstti_parser_ops {
     /* Defines the size of the input circular buffer required by this parser 
@@ -39,18 +82,21 @@ struct gstti_parser_ops {
     gboolean        trustme;
     /*
      * Parser init
-     * This function initializes any data structures required by the parser
+     * This function initializes any data structures required by the parser,
+     * returns the private data to pass to the other functions or NULL
+     * on failure
      */
-    gboolean        (* init) (GstTIDmaidec *dec);
+    void *          (* init) (struct gstti_parser_params *params);
     /*
      * Cleans any data structure allocated by the parser
      */
-    gboolean        (* clean) (GstTIDmaidec *);
+    void            (* clean) (void *);
     /*
      * Parser function
-     * Identifies where the start or end of a frame is
+     * Identifies where the start or end of a frame is on the range, returns
+     * its position or -1 if no full frame is available yet
      */
-    gint            (* parse) (GstTIDmaidec *);
+    gint            (* parse) (void *, struct gstti_parser_range *);
     /*
      * Parser flush start
      * This function flushes the parser internal state
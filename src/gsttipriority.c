@@ -25,10 +25,16 @@
 #  include <config.h>
 #endif
 
+#ifndef _GNU_SOURCE
+#  define _GNU_SOURCE
+#endif
+
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <errno.h>
 #include <unistd.h>
+#include <sys/syscall.h>
 #include <sys/time.h>
 #include <sys/resource.h>
 #include <sched.h>
@@ -56,6 +62,32 @@ enum
   ARG_NICE,
   ARG_SCHEDULER,
   ARG_RTPRIORITY,
+  ARG_RT_PRIORITY,
+  ARG_CPU_AFFINITY,
+  ARG_DEADLINE_RUNTIME,
+  ARG_DEADLINE_DEADLINE,
+  ARG_DEADLINE_PERIOD,
+};
+
+/* Value of the scheduler property for SCHED_DEADLINE */
+#define TIPRIORITY_SCHEDULER_DEADLINE 3
+
+#ifndef SCHED_DEADLINE
+#define SCHED_DEADLINE 6
+#endif
+
+/* Parameters of the sched_setattr system call, which has no wrapper on
+ * the C libraries we build against */
+struct tipriority_sched_attr
+{
+  guint32 size;
+  guint32 sched_policy;
+  guint64 sched_flags;
+  gint32 sched_nice;
+  guint32 sched_priority;
+  guint64 sched_runtime;
+  guint64 sched_deadline;
+  guint64 sched_period;
 };
 
 /* Static Function Declarations */
@@ -64,6 +96,7 @@ static void gst_tipriority_class_init (GstTIPriorityClass * g_class);
 static GstFlowReturn gst_tipriority_transform_ip (GstBaseTransform * trans,
     GstBuffer * buf);
 static gboolean gst_tipriority_start (GstBaseTransform * trans);
+static gboolean gst_tipriority_stop (GstBaseTransform * trans);
 static void gst_tipriority_set_property (GObject * object,
     guint prop_id, const GValue * value, GParamSpec * pspec);
 static void gst_tipriority_get_property (GObject * object,
@@ -80,6 +113,13 @@ gst_tipriority_init (GstTIPriority * priority)
   priority->rt_changed = FALSE;
   priority->rtmin = 0;
   priority->rtmax = 0;
+  priority->cpu_affinity = NULL;
+  priority->cpu_mask = 0;
+  priority->dl_runtime = 0;
+  priority->dl_deadline = 0;
+  priority->dl_period = 0;
+  priority->threads = NULL;
+  priority->generation = 0;
 }
 
 GType
@@ -149,6 +189,7 @@ gst_tipriority_class_init (GstTIPriorityClass * klass)
   GST_LOG ("Begin\n");
   trans_class->transform_ip = GST_DEBUG_FUNCPTR (gst_tipriority_transform_ip);
   trans_class->start = GST_DEBUG_FUNCPTR (gst_tipriority_start);
+  trans_class->stop = GST_DEBUG_FUNCPTR (gst_tipriority_stop);
   trans_class->passthrough_on_same_caps = TRUE;
   gobject_class->set_property = gst_tipriority_set_property;
   gobject_class->get_property = gst_tipriority_get_property;
@@ -163,8 +204,9 @@ gst_tipriority_class_init (GstTIPriorityClass * klass)
       ARG_SCHEDULER,
       g_param_spec_int ("scheduler",
           "scheduler",
-          "Scheduler to use: 0 - OTHER, 1 - RT FIFO, 2 - RT RoundRobin",
-          0, 2, 0, G_PARAM_READWRITE));
+          "Scheduler to use: 0 - OTHER, 1 - RT FIFO, 2 - RT RoundRobin, "
+          "3 - DEADLINE",
+          0, 3, 0, G_PARAM_READWRITE));
   g_object_class_install_property (G_OBJECT_CLASS (klass),
       ARG_RTPRIORITY,
       g_param_spec_int ("rtpriority",
@@ -172,6 +214,41 @@ gst_tipriority_class_init (GstTIPriorityClass * klass)
           "Real time priority: 1 (lower), 99 (higher). "
           "Only valid for scheduler RT FIFO or RT RR ",
           1, 99, 1, G_PARAM_READWRITE));
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      ARG_RT_PRIORITY,
+      g_param_spec_int ("rt-priority",
+          "rt-priority",
+          "Use the RT FIFO scheduler with this priority: 1 (lower), "
+          "99 (higher)",
+          1, 99, 1, G_PARAM_READWRITE));
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      ARG_CPU_AFFINITY,
+      g_param_spec_string ("cpu-affinity",
+          "cpu-affinity",
+          "CPUs the thread may run on, as a list of CPUs or ranges, "
+          "e.g. \"0\" or \"0,2-3\"",
+          NULL, G_PARAM_READWRITE));
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      ARG_DEADLINE_RUNTIME,
+      g_param_spec_uint64 ("deadline-runtime",
+          "deadline-runtime",
+          "Runtime in nanoseconds granted every period, selects the DEADLINE "
+          "scheduler",
+          0, G_MAXUINT64, 0, G_PARAM_READWRITE));
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      ARG_DEADLINE_DEADLINE,
+      g_param_spec_uint64 ("deadline-deadline",
+          "deadline-deadline",
+          "Relative deadline in nanoseconds for the DEADLINE scheduler, "
+          "0 uses the period",
+          0, G_MAXUINT64, 0, G_PARAM_READWRITE));
+  g_object_class_install_property (G_OBJECT_CLASS (klass),
+      ARG_DEADLINE_PERIOD,
+      g_param_spec_uint64 ("deadline-period",
+          "deadline-period",
+          "Period in nanoseconds for the DEADLINE scheduler, usually the "
+          "frame duration",
+          0, G_MAXUINT64, 0, G_PARAM_READWRITE));
 
   GST_LOG ("Finish\n");
 }
@@ -182,7 +259,9 @@ gst_tipriority_start (GstBaseTransform * trans)
   GstTIPriority *priority = GST_TIPRIORITY (trans);
   struct sched_param param;
 
-  priority->nice = getpriority (PRIO_PROCESS, 0);
+  if (!priority->nice_changed) {
+    priority->nice = getpriority (PRIO_PROCESS, 0);
+  }
   priority->rtmin = sched_get_priority_min (SCHED_FIFO);
   priority->rtmax = sched_get_priority_max (SCHED_FIFO);
   if (!priority->scheduler) {
@@ -199,9 +278,58 @@ gst_tipriority_start (GstBaseTransform * trans)
   }
   GST_INFO ("RT priorities: min %d, max %d", priority->rtmin, priority->rtmax);
 
+  priority->threads = g_hash_table_new (g_direct_hash, g_direct_equal);
+
   return TRUE;
 }
 
+static gboolean
+gst_tipriority_stop (GstBaseTransform * trans)
+{
+  GstTIPriority *priority = GST_TIPRIORITY (trans);
+
+  if (priority->threads) {
+    g_hash_table_destroy (priority->threads);
+    priority->threads = NULL;
+  }
+
+  return TRUE;
+}
+
+/* Parses a list of CPUs like "0,2-3" into a mask, 0 on errors */
+static guint64
+gst_tipriority_parse_cpus (const gchar * cpus)
+{
+  guint64 mask = 0;
+  gchar *end;
+
+  while (cpus && *cpus) {
+    gulong first, last;
+
+    first = last = strtoul (cpus, &end, 10);
+    if (end == cpus)
+      return 0;
+    if (*end == '-') {
+      cpus = end + 1;
+      last = strtoul (cpus, &end, 10);
+      if (end == cpus || last < first)
+        return 0;
+    }
+    if (last >= 64)
+      return 0;
+    for (; first <= last; first++)
+      mask |= G_GUINT64_CONSTANT (1) << first;
+
+    if (*end == ',')
+      end++;
+    else if (*end)
+      return 0;
+    cpus = end;
+  }
+
+  return mask;
+}
+
 static void
 gst_tipriority_get_property (GObject * object, guint prop_id,
     GValue * value, GParamSpec * pspec)
@@ -217,10 +345,27 @@ gst_tipriority_get_property (GObject * object, guint prop_id,
       g_value_set_int (value, priority->scheduler);
       break;
     }
-    case ARG_RTPRIORITY:{
+    case ARG_RTPRIORITY:
+    case ARG_RT_PRIORITY:{
       g_value_set_int (value, priority->rtpriority);
       break;
     }
+    case ARG_CPU_AFFINITY:{
+      g_value_set_string (value, priority->cpu_affinity);
+      break;
+    }
+    case ARG_DEADLINE_RUNTIME:{
+      g_value_set_uint64 (value, priority->dl_runtime);
+      break;
+    }
+    case ARG_DEADLINE_DEADLINE:{
+      g_value_set_uint64 (value, priority->dl_deadline);
+      break;
+    }
+    case ARG_DEADLINE_PERIOD:{
+      g_value_set_uint64 (value, priority->dl_period);
+      break;
+    }
 
     default:{
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
@@ -237,10 +382,8 @@ gst_tipriority_set_property (GObject * object, guint prop_id,
 
   switch (prop_id) {
     case ARG_NICE:{
-      gint a = g_value_get_int (value) + 20;
-      gint b = getpriority (PRIO_PROCESS, 0) + 20;
-      priority->nice_changed = a - b;
-      GST_WARNING_OBJECT(priority,"Nice values: a %d, b %d, nice change %d",a,b,priority->nice_changed);
+      priority->nice = g_value_get_int (value);
+      priority->nice_changed = TRUE;
       break;
     }
     case ARG_SCHEDULER:{
@@ -253,57 +396,196 @@ gst_tipriority_set_property (GObject * object, guint prop_id,
       priority->rt_changed = TRUE;
       break;
     }
+    case ARG_RT_PRIORITY:{
+      priority->scheduler = 1;
+      priority->rtpriority = g_value_get_int (value);
+      priority->rt_changed = TRUE;
+      break;
+    }
+    case ARG_CPU_AFFINITY:{
+      g_free (priority->cpu_affinity);
+      priority->cpu_affinity = g_value_dup_string (value);
+      priority->cpu_mask = gst_tipriority_parse_cpus (priority->cpu_affinity);
+      if (priority->cpu_affinity && !priority->cpu_mask) {
+        GST_WARNING_OBJECT (priority, "Invalid cpu-affinity \"%s\"",
+            priority->cpu_affinity);
+      }
+      break;
+    }
+    case ARG_DEADLINE_RUNTIME:{
+      priority->dl_runtime = g_value_get_uint64 (value);
+      priority->scheduler = TIPRIORITY_SCHEDULER_DEADLINE;
+      priority->rt_changed = TRUE;
+      break;
+    }
+    case ARG_DEADLINE_DEADLINE:{
+      priority->dl_deadline = g_value_get_uint64 (value);
+      break;
+    }
+    case ARG_DEADLINE_PERIOD:{
+      priority->dl_period = g_value_get_uint64 (value);
+      break;
+    }
 
     default:{
       G_OBJECT_WARN_INVALID_PROPERTY_ID (object, prop_id, pspec);
-      break;
+      return;
     }
   }
+
+  /* Make the streaming threads pick up the new settings */
+  g_atomic_int_inc (&priority->generation);
 }
 
-static GstFlowReturn
-gst_tipriority_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+/* Applies the affinity to the thread, TRUE if the kernel granted it */
+static gboolean
+gst_tipriority_set_affinity (GstTIPriority * priority, pid_t tid)
 {
-  gint newnice;
-  GstTIPriority *priority = GST_TIPRIORITY (trans);
+  cpu_set_t set, granted;
+  gint cpu;
+
+  CPU_ZERO (&set);
+  for (cpu = 0; cpu < 64; cpu++) {
+    if (priority->cpu_mask & (G_GUINT64_CONSTANT (1) << cpu))
+      CPU_SET (cpu, &set);
+  }
+
+  if (sched_setaffinity (tid, sizeof (set), &set) == -1) {
+    GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
+        ("Failed to set the cpu affinity to %s, errno %d",
+            priority->cpu_affinity, errno));
+    return FALSE;
+  }
+
+  /* The kernel silently drops offline CPUs from the mask */
+  if (sched_getaffinity (tid, sizeof (granted), &granted) == -1)
+    return FALSE;
+  return CPU_EQUAL (&set, &granted);
+}
+
+/* Applies the scheduler to the thread, TRUE if the kernel granted it */
+static gboolean
+gst_tipriority_set_scheduler (GstTIPriority * priority, pid_t tid)
+{
+  int policy;
+  struct sched_param param;
+
+  if (priority->scheduler == TIPRIORITY_SCHEDULER_DEADLINE) {
+#ifdef SYS_sched_setattr
+    struct tipriority_sched_attr attr;
+
+    memset (&attr, 0, sizeof (attr));
+    attr.size = sizeof (attr);
+    attr.sched_policy = SCHED_DEADLINE;
+    attr.sched_runtime = priority->dl_runtime;
+    attr.sched_period = priority->dl_period;
+    attr.sched_deadline = priority->dl_deadline ?
+        priority->dl_deadline : priority->dl_period;
+    if (syscall (SYS_sched_setattr, tid, &attr, 0) == -1) {
+      GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
+          ("Failed to set the deadline scheduler (runtime %" G_GUINT64_FORMAT
+              ", deadline %" G_GUINT64_FORMAT ", period %" G_GUINT64_FORMAT
+              "), errno %d", priority->dl_runtime, priority->dl_deadline,
+              priority->dl_period, errno));
+      return FALSE;
+    }
+    return sched_getscheduler (tid) == SCHED_DEADLINE;
+#else
+    GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
+        ("The deadline scheduler is not supported by this system"));
+    return FALSE;
+#endif
+  }
+
+  switch (priority->scheduler) {
+    case 2:
+      policy = SCHED_RR;
+      break;
+    case 1:
+      policy = SCHED_FIFO;
+      break;
+    case 0:
+    default:
+      policy = SCHED_OTHER;
+      break;
+  }
+  param.sched_priority = policy == SCHED_OTHER ? 0 : priority->rtpriority;
+  if (sched_setscheduler (tid, policy, &param) == -1) {
+    GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
+        ("Failed to set the request rt scheduler (%d) or priority (%d),"
+            " errno %d", priority->scheduler, priority->rtpriority, errno));
+    return FALSE;
+  }
+
+  if (sched_getscheduler (tid) != policy || sched_getparam (tid, &param) == -1)
+    return FALSE;
+  return param.sched_priority == (policy == SCHED_OTHER ? 0 :
+      priority->rtpriority);
+}
+
+/* Applies the settings to a streaming thread, and reports what the kernel
+ * granted with an element message */
+static void
+gst_tipriority_apply (GstTIPriority * priority, pid_t tid)
+{
+  GstStructure *result;
+  gboolean granted;
+
+  if (!priority->nice_changed && !priority->cpu_mask && !priority->rt_changed)
+    return;
+
+  result = gst_structure_new ("tipriority", "tid", G_TYPE_INT, (gint) tid,
+      NULL);
 
   if (priority->nice_changed) {
-    errno = 0;
-    newnice = nice (priority->nice_changed);
-    if ((newnice == -1) && (errno)) {
+    granted = setpriority (PRIO_PROCESS, tid, priority->nice) == 0;
+    if (!granted) {
       GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
           ("Failed to set the request nice level, errno %d", errno));
     } else {
-      GST_INFO ("%s: nice value is now %d",
-          gst_element_get_name (priority), newnice);
+      errno = 0;
+      granted = getpriority (PRIO_PROCESS, tid) == priority->nice && !errno;
     }
-    priority->nice_changed = 0;
-    priority->nice = newnice;
+    gst_structure_set (result, "nice", G_TYPE_INT, priority->nice,
+        "nice-granted", G_TYPE_BOOLEAN, granted, NULL);
+  }
+
+  if (priority->cpu_mask) {
+    granted = gst_tipriority_set_affinity (priority, tid);
+    gst_structure_set (result, "cpu-affinity", G_TYPE_STRING,
+        priority->cpu_affinity, "cpu-affinity-granted", G_TYPE_BOOLEAN,
+        granted, NULL);
   }
 
   if (priority->rt_changed) {
-    int policy;
-    struct sched_param param;
-
-    switch (priority->scheduler) {
-      case 2:
-        policy = SCHED_RR;
-        break;
-      case 1:
-        policy = SCHED_FIFO;
-        break;
-      case 0:
-      default:
-        policy = SCHED_OTHER;
-        break;
-    }
-    param.sched_priority = priority->rtpriority;
-    if (sched_setscheduler (0, policy, &param) == -1) {
-      GST_ELEMENT_WARNING (priority, RESOURCE, FAILED, (NULL),
-          ("Failed to set the request rt scheduler (%d) or priority (%d),"
-              " errno %d", priority->scheduler,priority->rtpriority,errno));
-    }
-    priority->rt_changed = FALSE;
+    granted = gst_tipriority_set_scheduler (priority, tid);
+    gst_structure_set (result, "scheduler", G_TYPE_INT, priority->scheduler,
+        "rt-priority", G_TYPE_INT, priority->rtpriority,
+        "scheduler-granted", G_TYPE_BOOLEAN, granted, NULL);
   }
+
+  GST_INFO_OBJECT (priority, "Applied settings: %" GST_PTR_FORMAT, result);
+  gst_element_post_message (GST_ELEMENT (priority),
+      gst_message_new_element (GST_OBJECT (priority), result));
+}
+
+static GstFlowReturn
+gst_tipriority_transform_ip (GstBaseTransform * trans, GstBuffer * buf)
+{
+  GstTIPriority *priority = GST_TIPRIORITY (trans);
+  pid_t tid = syscall (SYS_gettid);
+  gint generation = g_atomic_int_get (&priority->generation);
+  gpointer applied;
+
+  /* Only apply the settings the first time a thread goes through, or
+   * after they change */
+  if (g_hash_table_lookup_extended (priority->threads, GINT_TO_POINTER (tid),
+          NULL, &applied) && GPOINTER_TO_INT (applied) == generation)
+    return GST_FLOW_OK;
+
+  gst_tipriority_apply (priority, tid);
+  g_hash_table_insert (priority->threads, GINT_TO_POINTER (tid),
+      GINT_TO_POINTER (generation));
+
   return GST_FLOW_OK;
 }
@@ -51,12 +51,26 @@ struct _GstTIPriority
   GstPad *srcpad;
 
   gint nice;
-  gint nice_changed;
+  gboolean nice_changed;
   gint rtpriority;
   gint scheduler;
   gboolean rt_changed;
   gint rtmin;
   gint rtmax;
+
+  /* CPUs to run on, as a mask of up to 64 CPUs, 0 leaves it untouched */
+  gchar *cpu_affinity;
+  guint64 cpu_mask;
+
+  /* SCHED_DEADLINE parameters, in nanoseconds */
+  guint64 dl_runtime;
+  guint64 dl_deadline;
+  guint64 dl_period;
+
+  /* The settings are applied once on each streaming thread going through
+   * the element: thread id -> generation of the settings applied on it */
+  GHashTable *threads;
+  gint generation;
 };
 
 /* _GstTIPriorityClass object */
@@ -29,6 +29,7 @@
 #include <gst/gst.h>
 
 #include "gsttidmaidec.h"
+#include "gsttidmaienc.h"
 #include "gsttiparsers.h"
 #include "gsttisupport_aac.h"
 #include "gsttidmaibuffertransport.h"
@@ -121,7 +122,7 @@ static GstBuffer *aac_generate_codec_data (GstTIDmaienc *dmaienc,
     return codec_data;
 }
 
-static gboolean aac_init(GstTIDmaidec *dmaidec){
+static void *aac_init(struct gstti_parser_params *params){
     struct gstti_aac_parser_private *priv;
 
     /* Initialize GST_LOG for this object */
@@ -134,46 +135,116 @@ static gboolean aac_init(GstTIDmaidec *dmaidec){
     priv->flushing = FALSE;
     priv->framed = FALSE;
     priv->codecdata_inserted = FALSE;
+    priv->adts = FALSE;
+    priv->locked = FALSE;
 
-    if (dmaidec->parser_private){
-        g_free(dmaidec->parser_private);
-    }
-    dmaidec->parser_private = priv;
 
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
-static gboolean aac_clean(GstTIDmaidec *dmaidec){
-    if (dmaidec->parser_private){
+static void aac_clean(void *private){
+    if (private){
         GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
+        g_free(private);
     }
+}
+
+/*
+ * Decodes the ADTS header at data, returns the length of the frame or 0 if
+ * it isn't a valid header
+ */
+static gint aac_adts_header(const guint8 *data, gint *rate, gint *samples){
+    gint idx, len;
+
+    /* Sync word and layer 0 */
+    if (data[0] != 0xFF || (data[1] & 0xF6) != 0xF0)
+        return 0;
+
+    idx = (data[2] >> 2) & 0xF;
+    if (idx >= 13)
+        return 0;
+
+    len = ((data[3] & 0x3) << 11) | (data[4] << 3) | (data[5] >> 5);
+    /* The header is 7 bytes long, 9 with CRC */
+    if (len < ((data[1] & 0x1) ? 7 : 9))
+        return 0;
 
-    return TRUE;
+    *rate = rateIdx[idx];
+    *samples = ((data[6] & 0x3) + 1) * 1024;
+
+    return len;
 }
 
-static gint aac_parse(GstTIDmaidec *dmaidec){
+/*
+ * Returns the end of the next whole ADTS frame on the range.  The codecs
+ * decode a single frame per process call, so frames are never batched.
+ */
+static gint aac_adts_parse(struct gstti_aac_parser_private *priv,
+    struct gstti_parser_range *range){
+    const guint8 *data = range->data;
+    gint pos, len, rate, samples, nextRate, nextSamples;
+
+    pos = (range->marker < range->tail) ? range->tail : range->marker;
+
+    while (pos + 7 <= range->head) {
+        len = aac_adts_header(&data[pos], &rate, &samples);
+        if (!len) {
+            if (priv->locked) {
+                GST_DEBUG("Lost ADTS sync at %d",pos);
+                priv->locked = FALSE;
+            }
+            pos++;
+            continue;
+        }
+
+        if (!priv->locked) {
+            /* Wait for the next header to confirm the sync */
+            if (pos + len + 7 > range->head)
+                break;
+            if (aac_adts_header(&data[pos + len], &nextRate,
+                    &nextSamples) == 0 || nextRate != rate) {
+                pos++;
+                continue;
+            }
+            GST_DEBUG("Found ADTS sync at %d, rate %d",pos,rate);
+            priv->locked = TRUE;
+        }
+
+        if (pos + len > range->head)
+            break;
+
+        range->marker = pos + len;
+        range->duration = gst_util_uint64_scale_int(samples, GST_SECOND, rate);
+        return pos + len;
+    }
+
+    range->marker = pos;
+    return -1;
+}
+
+static gint aac_parse(void *private, struct gstti_parser_range *range){
     struct gstti_aac_parser_private *priv =
-        (struct gstti_aac_parser_private *) dmaidec->parser_private;
+        (struct gstti_aac_parser_private *) private;
 
     if (priv->flushing){
         return -1;
     }
-    
-    if (priv->framed){
+
+    if (priv->adts){
+        return aac_adts_parse(priv, range);
+    } else if (priv->framed){
         /*
          * When we have a codec_data structure we know we got full frames
          */
-        if (dmaidec->head != dmaidec->tail){
-            return dmaidec->head;
+        if (range->head != range->tail){
+            return range->head;
         }
     } else {
-        gint avail = dmaidec->head - dmaidec->tail;
+        gint avail = range->head - range->tail;
         
-        return (avail >= dmaidec->inBufSize) ? 
-            (dmaidec->inBufSize + dmaidec->tail) : -1;
+        return (avail >= range->chunkSize) ? 
+            (range->chunkSize + range->tail) : -1;
     }
     
     return -1;
@@ -184,6 +255,7 @@ static void aac_flush_start(void *private){
         (struct gstti_aac_parser_private *) private;
 
     priv->flushing = TRUE;
+    priv->locked = FALSE;
     GST_DEBUG("Parser flushed");
     return;
 }
@@ -287,6 +359,12 @@ check_header:
              ret = GST_BUFFER_SIZE(aac_header_buf);
              priv->codecdata_inserted = TRUE;
          } else {
+            /* The stream carries its own headers */
+            if (data[0] == 0xff) {
+                GST_INFO("ADTS stream, framing it");
+                priv->adts = TRUE;
+            }
+            priv->codecdata_inserted = TRUE;
             ret = 0;
          }
     }
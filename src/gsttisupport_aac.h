@@ -34,6 +34,9 @@ struct gstti_aac_parser_private {
     gboolean flushing;
     gboolean framed;
     gboolean codecdata_inserted;
+    /* ADTS stream, framed by the parser */
+    gboolean adts;
+    gboolean locked;
 };
 
 extern struct gstti_parser_ops gstti_aac_parser;
@@ -1,7 +1,8 @@
 /*
- * gsttisupport_mp3.c
+ * gsttisupport_g711.c
  *
- * This file parses mp3 streams
+ * This file provides the companding tables of the native g711 elements
+ * (dmaidec_g711 and dmaienc_g711)
  *
  * Original Author:
  *     Diego Dompe, RidgeRun
@@ -22,23 +23,156 @@
  * Lesser General Public License for more details.
  */
 
-#include <stdio.h>
-#include <string.h>
 #include <gst/gst.h>
 
-#include "gsttidmaidec.h"
-#include "gsttiparsers.h"
-#include "gsttisupport_mp3.h"
-#include "gsttidmaibuffertransport.h"
-
-GstStaticCaps gstti_g711_caps = GST_STATIC_CAPS(
-    "audio/x-alaw,"
-	"  rate= (int) [ 8000, MAX], "
-	"  channels= (int)[ 1, 2 ]; "
-    "audio/x-mulaw,"
-    "   rate= (int) [ 8000, MAX], "
-    "   channels= (int)[ 1, 2 ]; "
-);
+#include "gsttisupport_g711.h"
+
+
+/******************************************************************************
+ * Companding
+ *    The encoders only look at the 13 (A-law) or 14 (u-law) most significant
+ *    bits of a sample, so both directions are a single table lookup.  The
+ *    tables are built once from the reference G.711 segment coding.
+ ******************************************************************************/
+static gint16 alaw_to_linear[256];
+static gint16 ulaw_to_linear[256];
+static guint8 linear_to_alaw[8192];
+static guint8 linear_to_ulaw[16384];
+
+static gint g711_segment(gint val, gint end){
+    gint seg;
+
+    for (seg = 0; seg < 8; seg++, end = (end << 1) | 1){
+        if (val <= end)
+            return seg;
+    }
+    return 8;
+}
+
+static guint8 g711_alaw_from_linear(gint pcm){
+    gint mask, seg;
+
+    pcm >>= 3;
+    if (pcm >= 0){
+        mask = 0xD5;
+    } else {
+        mask = 0x55;
+        pcm = -pcm - 1;
+    }
+
+    seg = g711_segment(pcm, 0x1F);
+    if (seg >= 8)
+        return 0x7F ^ mask;
+
+    return ((seg << 4) | ((pcm >> (seg < 2 ? 1 : seg)) & 0xF)) ^ mask;
+}
+
+static gint16 g711_alaw_to_linear(guint8 aval){
+    gint t, seg;
+
+    aval ^= 0x55;
+    t = (aval & 0xF) << 4;
+    seg = (aval & 0x70) >> 4;
+    switch (seg){
+    case 0:
+        t += 8;
+        break;
+    case 1:
+        t += 0x108;
+        break;
+    default:
+        t += 0x108;
+        t <<= seg - 1;
+    }
+
+    return (aval & 0x80) ? t : -t;
+}
+
+static guint8 g711_ulaw_from_linear(gint pcm){
+    gint mask, seg;
+
+    pcm >>= 2;
+    if (pcm < 0){
+        pcm = -pcm;
+        mask = 0x7F;
+    } else {
+        mask = 0xFF;
+    }
+    if (pcm > 8159)
+        pcm = 8159;
+    pcm += 0x84 >> 2;
+
+    seg = g711_segment(pcm, 0x3F);
+    if (seg >= 8)
+        return 0x7F ^ mask;
+
+    return ((seg << 4) | ((pcm >> (seg + 1)) & 0xF)) ^ mask;
+}
+
+static gint16 g711_ulaw_to_linear(guint8 uval){
+    gint t;
+
+    uval = ~uval;
+    t = ((uval & 0xF) << 3) + 0x84;
+    t <<= (uval & 0x70) >> 4;
+
+    return (uval & 0x80) ? (0x84 - t) : (t - 0x84);
+}
+
+static gpointer g711_build_tables(gpointer data){
+    gint i;
+
+    for (i = 0; i < 256; i++){
+        alaw_to_linear[i] = g711_alaw_to_linear(i);
+        ulaw_to_linear[i] = g711_ulaw_to_linear(i);
+    }
+    for (i = 0; i < 8192; i++){
+        linear_to_alaw[i] = g711_alaw_from_linear((gint16)(i << 3));
+    }
+    for (i = 0; i < 16384; i++){
+        linear_to_ulaw[i] = g711_ulaw_from_linear((gint16)(i << 2));
+    }
+
+    return NULL;
+}
+
+static void g711_tables_init(void){
+    static GOnce once = G_ONCE_INIT;
+
+    g_once(&once, g711_build_tables, NULL);
+}
+
+void gstti_g711_alaw_encode(guint8 *dst, const gint16 *src, gint samples){
+    gint i;
+
+    g711_tables_init();
+    for (i = 0; i < samples; i++)
+        dst[i] = linear_to_alaw[(guint16)src[i] >> 3];
+}
+
+void gstti_g711_alaw_decode(gint16 *dst, const guint8 *src, gint samples){
+    gint i;
+
+    g711_tables_init();
+    for (i = 0; i < samples; i++)
+        dst[i] = alaw_to_linear[src[i]];
+}
+
+void gstti_g711_ulaw_encode(guint8 *dst, const gint16 *src, gint samples){
+    gint i;
+
+    g711_tables_init();
+    for (i = 0; i < samples; i++)
+        dst[i] = linear_to_ulaw[(guint16)src[i] >> 2];
+}
+
+void gstti_g711_ulaw_decode(gint16 *dst, const guint8 *src, gint samples){
+    gint i;
+
+    g711_tables_init();
+    for (i = 0; i < samples; i++)
+        dst[i] = ulaw_to_linear[src[i]];
+}
 
 /******************************************************************************
  * Custom ViM Settings for editing this file
@@ -1,5 +1,5 @@
 /*
- * gsttisupport_mp3.h
+ * gsttisupport_g711.h
  *
  * Original Author:
  *     Diego Dompe, RidgeRun
@@ -23,8 +23,11 @@
 
 #include <gst/gst.h>
 
-/* Caps for g711 */
-extern GstStaticCaps gstti_g711_caps;
+/* Table driven companding of the native g711 elements */
+void gstti_g711_alaw_encode(guint8 *dst, const gint16 *src, gint samples);
+void gstti_g711_alaw_decode(gint16 *dst, const guint8 *src, gint samples);
+void gstti_g711_ulaw_encode(guint8 *dst, const gint16 *src, gint samples);
+void gstti_g711_ulaw_decode(gint16 *dst, const guint8 *src, gint samples);
 
 #endif /* __GSTTI_SUPPORT_G711_H__ */
 
@@ -30,10 +30,17 @@
 GST_DEBUG_CATEGORY_STATIC (gst_tisupport_generic_debug);
 #define GST_CAT_DEFAULT gst_tisupport_generic_debug
 
-static gboolean generic_init(GstTIDmaidec *dmaidec){
+/* Decoders known to consume a whole demuxed frame on each process call */
+static const gchar *generic_framed_codecs[] = {
+    "wmadec",
+    NULL,
+};
+
+static void *generic_init(struct gstti_parser_params *params){
     GstStructure *capStruct;
     struct gstti_generic_parser_private *priv;
-    GstCaps      *caps = GST_PAD_CAPS(dmaidec->sinkpad);
+    GstCaps      *caps = params->caps;
+    gint i;
 
     /* Initialize GST_LOG for this object */
     GST_DEBUG_CATEGORY_INIT(gst_tisupport_generic_debug, "TISupportGeneric", 0,
@@ -42,6 +49,7 @@ static gboolean generic_init(GstTIDmaidec *dmaidec){
     priv = g_malloc0(sizeof(struct gstti_generic_parser_private));
     g_assert(priv != NULL);
     priv->parsed = FALSE;
+    priv->framed = FALSE;
 
     if (!caps)
         goto done;
@@ -53,58 +61,68 @@ static gboolean generic_init(GstTIDmaidec *dmaidec){
     /* Read extra data passed via demuxer. */
     gst_structure_get_boolean(capStruct, "parsed",&priv->parsed);
 
-/* Disable optimization for now, seems like some decoders aren't
- * that happy with it
- */
-#if 0
-    /* If we have a parsed stream we don't behave as circular buffer,
-     * but instead we just pass the full frames we received down to the
-     * decoders.
+    /* If we have a parsed stream we don't re-chunk the data, but instead
+     * we just pass the full frames we received down to the decoders.
+     * Only for the codecs known to handle it, the rest keep the chunking.
      */
-    if (priv->parsed){
-        GST_INFO("Using parsed stream");
-        if (dmaidec->numInputBufs == 0) {
-            dmaidec->numInputBufs = 1;
+    if (priv->parsed && params->codecName){
+        for (i = 0; generic_framed_codecs[i]; i++) {
+            if (!strcmp(params->codecName, generic_framed_codecs[i])) {
+                priv->framed = TRUE;
+                break;
+            }
+        }
+    }
+
+    if (priv->framed){
+        GST_INFO("Using parsed stream, passing frames to %s",
+            params->codecName);
+        /* One buffer for the frame, and one of room in case we have to
+         * fall back to chunking
+         */
+        if (params->numInputBufs == 0) {
+            params->numInputBufs = 2;
         }
     }
-#endif
 
 done:
-    dmaidec->parser_private = priv;
-    
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
-static gboolean generic_clean(GstTIDmaidec *dmaidec){
-    if (dmaidec->parser_private){
+static void generic_clean(void *private){
+    if (private){
         GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
+        g_free(private);
     }
-    
-    return TRUE;
 }
 
-static gint generic_parse(GstTIDmaidec *dmaidec){
+static gint generic_parse(void *private, struct gstti_parser_range *range){
     struct gstti_generic_parser_private *priv =
-        (struct gstti_generic_parser_private *) dmaidec->parser_private;
-    
+        (struct gstti_generic_parser_private *) private;
+    gint avail;
+
     /* If we know from the caps that we have a parsed stream, then
      * we optimize our functionality
      */
-    if (priv->parsed) {
-        if (dmaidec->head != dmaidec->tail){
-            return dmaidec->head;
-        } else {
-            return -1;
+    if (priv->framed) {
+        /* Every frame handed to the codec is fully consumed and the
+         * circular buffer emptied, unless the codec didn't take the full
+         * frame.  Those codecs get chunked data from now on.
+         */
+        if (range->tail == 0) {
+            return (range->head != range->tail) ? range->head : -1;
         }
-    } else {
-        /* Not parsed stream, behave as circular buffer */
-        gint avail = dmaidec->head - dmaidec->tail;
-        return (avail >= dmaidec->inBufSize) ? 
-            (dmaidec->inBufSize + dmaidec->tail) : -1;
+
+        GST_WARNING("Codec left %d bytes of a frame, falling back to "
+            "chunked input", range->head - range->tail);
+        priv->framed = FALSE;
     }
+
+    /* Not parsed stream, behave as circular buffer */
+    avail = range->head - range->tail;
+    return (avail >= range->chunkSize) ? 
+        (range->chunkSize + range->tail) : -1;
 }
 
 static void generic_flush_start(void *private){
@@ -24,6 +24,8 @@ extern struct gstti_parser_ops gstti_generic_parser;
 
 struct gstti_generic_parser_private {
     gboolean parsed;
+    /* Frames from the demuxer go to the codec as they are */
+    gboolean framed;
 };
 
 #endif /* __GSTTI_SUPPORT_GENERIC_H__ */
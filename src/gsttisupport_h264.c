@@ -474,12 +474,12 @@ static GstBuffer * h264enc_buffer_transform(GstTIDmaienc *dmaienc, GstBuffer *bu
     return outBuf;
 }
 
-static gboolean h264_init(GstTIDmaidec *dmaidec){
+static void *h264_init(struct gstti_parser_params *params){
     struct gstti_h264_parser_private *priv;
     const GValue *value;
     GstStructure *capStruct;
     const gchar  *streamformat;
-    GstCaps      *caps = GST_PAD_CAPS(dmaidec->sinkpad);
+    GstCaps      *caps = params->caps;
 
     /* Initialize GST_LOG for this object */
     GST_DEBUG_CATEGORY_INIT(gst_tisupport_h264_debug, "TISupportH264", 0,
@@ -491,11 +491,6 @@ static gboolean h264_init(GstTIDmaidec *dmaidec){
     priv->codecdata = NULL;
     priv->packetized = FALSE;
 
-    if (dmaidec->parser_private){
-        g_free(dmaidec->parser_private);
-    }
-    dmaidec->parser_private = priv;
-
     /* Try to find the codec_data */
     if (!caps)
         goto done;
@@ -567,16 +562,20 @@ static gboolean h264_init(GstTIDmaidec *dmaidec){
     priv->nal_code_prefix = gst_h264_get_nal_prefix_code();
 done:
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
 
 /******************************************************************************
  * Clean the parser
  ******************************************************************************/
-static gboolean h264_clean(GstTIDmaidec *dmaidec){
+static void h264_clean(void *private){
     struct gstti_h264_parser_private *priv =
-        (struct gstti_h264_parser_private *) dmaidec->parser_private;
+        (struct gstti_h264_parser_private *) private;
+
+    if (!priv){
+        return;
+    }
 
     if (priv->sps_pps_data) {
         GST_DEBUG("freeing sps_pps buffers\n");
@@ -592,32 +591,27 @@ static gboolean h264_clean(GstTIDmaidec *dmaidec){
         gst_buffer_unref(priv->codecdata);
     }
 
-    if (dmaidec->parser_private){
-        GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
-    }
-
-    return TRUE;
+    GST_DEBUG("Freeing parser private");
+    g_free(priv);
 }
 
 
-static gint h264_parse(GstTIDmaidec *dmaidec){
+static gint h264_parse(void *private, struct gstti_parser_range *range){
     struct gstti_h264_parser_private *priv =
-        (struct gstti_h264_parser_private *) dmaidec->parser_private;
+        (struct gstti_h264_parser_private *) private;
     gint i;
 
     if (priv->packetized){
-        if (dmaidec->head != dmaidec->tail){
-            return dmaidec->head;
+        if (range->head != range->tail){
+            return range->head;
         }
     } else {
-        gchar *data = (gchar *)Buffer_getUserPtr(dmaidec->circBuf);
+        const guint8 *data = range->data;
 
-        GST_DEBUG("Marker is at %d",dmaidec->marker);
+        GST_DEBUG("Marker is at %d",range->marker);
         /* Find next VOP start header */
 
-        for (i = dmaidec->marker; i <= dmaidec->head - 5; i++) {
+        for (i = range->marker; i <= range->head - 5; i++) {
             if (priv->flushing){
                 priv->au_delimiters = FALSE;
                 return -1;
@@ -665,14 +659,14 @@ static gint h264_parse(GstTIDmaidec *dmaidec){
                 }
 
                 GST_DEBUG("Found second NAL at %d, type %d",i,nal_type);
-                dmaidec->marker = i;
+                range->marker = i;
                 priv->access_unit_found = FALSE;
                 return i;
             }
         }
 
         GST_DEBUG("Failed to find a full frame");
-        dmaidec->marker = i;
+        range->marker = i;
     }
 
     return -1;
@@ -683,6 +677,8 @@ static void h264_flush_start(void *private){
         (struct gstti_h264_parser_private *) private;
 
     priv->flushing = TRUE;
+    /* The decoder may be restarted, so send the SPS,PPS again */
+    priv->sps_pps_sent = FALSE;
     GST_DEBUG("Parser flushed");
     return;
 }
@@ -859,7 +855,7 @@ static int h264dec_custom_memcpy(GstTIDmaidec *dmaidec, void *target,
 
     if (priv->sps_pps_data){
         /*
-         * Prefix sps and pps header data into the buffer.
+         * Turn the packetized stream into a byte stream.
          *
          * H264 in quicktime is what we call in gstreamer 'packtized' h264.
          * A codec_data is exchanged in the caps that contains, among other
@@ -868,46 +864,93 @@ static int h264dec_custom_memcpy(GstTIDmaidec *dmaidec, void *target,
          * The data consists of a nal_length_size header containing the length
          * of the NAL unit that immediatly follows the size header.
 
-         * Inserting the SPS,PPS (after prefixing them with nal prefix codes)
-         * and exchanging the size header with nal prefix codes is a valid
-         * way to transform a packetized stream into a byte stream.
+         * Exchanging the size headers with nal prefix codes, and inserting
+         * the SPS,PPS (after prefixing them with nal prefix codes) ahead of
+         * each IDR frame is a valid way to transform a packetized stream
+         * into a byte stream.
          */
-        gint i, nal_size=0;
         guint8 *inBuf = GST_BUFFER_DATA(buf);
-        gint avail = GST_BUFFER_SIZE(buf);
+        gint size = GST_BUFFER_SIZE(buf);
         guint8 nal_length = priv->nal_length;
-        int offset = 0;
-
-        if (available < GST_BUFFER_SIZE(priv->sps_pps_data))
-            return -1;
+        guint nal_size = 0;
+        gboolean idr = FALSE, has_sps = FALSE;
+        gint i, offset;
 
-        memcpy(&dest[ret],GST_BUFFER_DATA(priv->sps_pps_data),
-            GST_BUFFER_SIZE(priv->sps_pps_data));
-        ret+=GST_BUFFER_SIZE(priv->sps_pps_data);
-
-        do {
+        /* Find the NAL units, and drop whatever doesn't fit on the buffer */
+        for (offset = 0; offset + nal_length < size;
+             offset += nal_length + nal_size) {
             nal_size = 0;
-            for (i=0; i < nal_length; i++) {
+            for (i = 0; i < nal_length; i++) {
                 nal_size = (nal_size << 8) | inBuf[offset + i];
             }
-            offset += nal_length;
+            if (nal_size > size - offset - nal_length) {
+                GST_WARNING("NAL unit of %u bytes overruns the buffer, "
+                    "dropping it", nal_size);
+                break;
+            }
+
+            switch (inBuf[offset + nal_length] & 0x1f) {
+            case 5:
+                idr = TRUE;
+                break;
+            case 7:
+                has_sps = TRUE;
+                break;
+            default:
+                break;
+            }
+        }
+        size = offset;
 
-            /* Put NAL prefix code */
-            if (available < (ret + GST_BUFFER_SIZE(priv->nal_code_prefix)))
+        /* The decoder needs the SPS,PPS once ahead of the first frame, and
+         * again on each IDR frame that doesn't carry them in-band
+         */
+        if (!has_sps && (idr || !priv->sps_pps_sent)) {
+            if (available < GST_BUFFER_SIZE(priv->sps_pps_data))
                 return -1;
-            memcpy(&dest[ret],GST_BUFFER_DATA(priv->nal_code_prefix),
-                GST_BUFFER_SIZE(priv->nal_code_prefix));
-            ret+=GST_BUFFER_SIZE(priv->nal_code_prefix);
 
-            /* Put the data */
-            if (available < (ret + nal_size))
+            memcpy(&dest[ret],GST_BUFFER_DATA(priv->sps_pps_data),
+                GST_BUFFER_SIZE(priv->sps_pps_data));
+            ret+=GST_BUFFER_SIZE(priv->sps_pps_data);
+        }
+        priv->sps_pps_sent = TRUE;
+
+        if (nal_length == NAL_START_CODE_LENGTH) {
+            /* The start codes take the place of the size headers, so the
+             * data goes in with a single copy
+             */
+            if (available < (ret + size))
                 return -1;
-            memcpy(&dest[ret],&inBuf[offset],nal_size);
-            ret+=nal_size;
+            memcpy(&dest[ret],inBuf,size);
+
+            for (offset = 0; offset < size;
+                 offset += NAL_START_CODE_LENGTH + nal_size) {
+                nal_size = GST_READ_UINT32_BE(&inBuf[offset]);
+                memcpy(&dest[ret + offset],
+                    GST_BUFFER_DATA(priv->nal_code_prefix),
+                    NAL_START_CODE_LENGTH);
+            }
+            ret += size;
+        } else {
+            /* Shorter size headers grow into start codes, so each NAL unit
+             * moves up on the same pass
+             */
+            for (offset = 0; offset < size; offset += nal_length + nal_size) {
+                nal_size = 0;
+                for (i = 0; i < nal_length; i++) {
+                    nal_size = (nal_size << 8) | inBuf[offset + i];
+                }
 
-            offset += nal_size;
-            avail -= (nal_size + nal_length);
-        } while (avail > 0);
+                if (available <
+                        (ret + NAL_START_CODE_LENGTH + (gint)nal_size))
+                    return -1;
+                memcpy(&dest[ret],GST_BUFFER_DATA(priv->nal_code_prefix),
+                    NAL_START_CODE_LENGTH);
+                ret += NAL_START_CODE_LENGTH;
+                memcpy(&dest[ret],&inBuf[offset + nal_length],nal_size);
+                ret += nal_size;
+            }
+        }
     } else {
         /* Byte stream, just pass it on */
         if (available < GST_BUFFER_SIZE(buf))
@@ -920,6 +963,426 @@ static int h264dec_custom_memcpy(GstTIDmaidec *dmaidec, void *target,
     return ret;
 }
 
+/******************************************************************************
+ * Sequence parameter set parsing
+ *    Only what sizes the decoder is kept: the display size, the level limits
+ *    and the VUI bitstream restrictions.
+ *****************************************************************************/
+struct h264_bit_reader {
+    guint8              *data;
+    gint                size;
+    gint                bit;
+    gboolean            overflow;
+};
+
+static guint32 h264_read_bits(struct h264_bit_reader *br, gint n){
+    guint32 val = 0;
+
+    while (n--){
+        if (br->bit >= br->size * 8){
+            br->overflow = TRUE;
+            return 0;
+        }
+        val = (val << 1) |
+            ((br->data[br->bit >> 3] >> (7 - (br->bit & 7))) & 1);
+        br->bit++;
+    }
+    return val;
+}
+
+/* Exp-Golomb codes */
+static guint32 h264_read_ue(struct h264_bit_reader *br){
+    gint zeros = 0;
+
+    while (!h264_read_bits(br, 1)){
+        if (br->overflow || ++zeros > 31){
+            br->overflow = TRUE;
+            return 0;
+        }
+    }
+    return ((1 << zeros) - 1) + h264_read_bits(br, zeros);
+}
+
+static gint32 h264_read_se(struct h264_bit_reader *br){
+    guint32 val = h264_read_ue(br);
+
+    return (val & 1) ? (gint32)((val + 1) >> 1) : -(gint32)(val >> 1);
+}
+
+static void h264_skip_scaling_list(struct h264_bit_reader *br, gint size){
+    gint i, last = 8, next = 8;
+
+    for (i = 0; i < size; i++){
+        if (next != 0){
+            next = (last + h264_read_se(br) + 256) % 256;
+        }
+        last = (next == 0) ? last : next;
+    }
+}
+
+/* Returns the largest coded picture buffer the HRD declares, in bits */
+static gint64 h264_parse_hrd(struct h264_bit_reader *br){
+    gint i, cpb_cnt, cpb_size_scale;
+    gint64 cpb_size, max = 0;
+
+    cpb_cnt = h264_read_ue(br) + 1;
+    if (cpb_cnt > 32){
+        br->overflow = TRUE;
+        return 0;
+    }
+    h264_read_bits(br, 4);  /* bit_rate_scale */
+    cpb_size_scale = h264_read_bits(br, 4);
+    for (i = 0; i < cpb_cnt; i++){
+        h264_read_ue(br);   /* bit_rate_value_minus1 */
+        cpb_size = (gint64)(h264_read_ue(br) + 1) << (4 + cpb_size_scale);
+        h264_read_bits(br, 1);  /* cbr_flag */
+        max = MAX(max, cpb_size);
+    }
+    /* Delay lengths and time_offset_length */
+    h264_read_bits(br, 20);
+
+    return max;
+}
+
+/* Table A-1: MaxDpbMbs, and MaxCPB in units of 1200 bits (NAL HRD) */
+static const struct {
+    gint level_idc;
+    gint max_dpb_mbs;
+    gint max_cpb;
+} h264_levels[] = {
+    {  9,    396,    350 },  /* 1b */
+    { 10,    396,    175 },
+    { 11,    900,    500 },
+    { 12,   2376,   1000 },
+    { 13,   2376,   2000 },
+    { 20,   2376,   2000 },
+    { 21,   4752,   4000 },
+    { 22,   8100,   4000 },
+    { 30,   8100,  10000 },
+    { 31,  18000,  14000 },
+    { 32,  20480,  20000 },
+    { 40,  32768,  25000 },
+    { 41,  32768,  62500 },
+    { 42,  34816,  62500 },
+    { 50, 110400, 135000 },
+    { 51, 184320, 240000 },
+    { 52, 184320, 240000 },
+};
+
+gboolean gstti_h264_parse_sps(const guint8 *nal, gint size,
+    struct gstti_h264_sps *sps){
+    struct h264_bit_reader br;
+    gint i, level, chroma_format_idc = 1, separate_colour_plane = 0;
+    gint constraint_flags, max_num_ref_frames, frame_mbs_only;
+    gint width_mbs, height_mbs, max_dpb_frames;
+    gint crop_left = 0, crop_right = 0, crop_top = 0, crop_bottom = 0;
+    gint crop_x, crop_y, cpb_factor;
+    gint64 cpb_size = 0;
+    gboolean intra_profile;
+
+    if (size < 4 || (nal[0] & 0x1f) != 7){
+        return FALSE;
+    }
+
+    /* Strip the emulation prevention bytes */
+    br.data = g_malloc(size);
+    br.size = 0;
+    br.bit = 0;
+    br.overflow = FALSE;
+    for (i = 1; i < size; i++){
+        if (i >= 3 && nal[i] == 3 && nal[i-1] == 0 && nal[i-2] == 0){
+            continue;
+        }
+        br.data[br.size++] = nal[i];
+    }
+
+    memset(sps, 0, sizeof(struct gstti_h264_sps));
+    sps->profile_idc = h264_read_bits(&br, 8);
+    constraint_flags = h264_read_bits(&br, 8);
+    sps->level_idc = h264_read_bits(&br, 8);
+    h264_read_ue(&br);  /* seq_parameter_set_id */
+
+    switch (sps->profile_idc){
+    case 100: case 110: case 122: case 244: case 44:
+    case 83: case 86: case 118: case 128: case 138:
+    case 139: case 134: case 135:
+        chroma_format_idc = h264_read_ue(&br);
+        if (chroma_format_idc == 3){
+            separate_colour_plane = h264_read_bits(&br, 1);
+        }
+        h264_read_ue(&br);  /* bit_depth_luma_minus8 */
+        h264_read_ue(&br);  /* bit_depth_chroma_minus8 */
+        h264_read_bits(&br, 1);
+        if (h264_read_bits(&br, 1)){
+            /* seq_scaling_matrix_present_flag */
+            for (i = 0; i < ((chroma_format_idc != 3) ? 8 : 12); i++){
+                if (h264_read_bits(&br, 1)){
+                    h264_skip_scaling_list(&br, (i < 6) ? 16 : 64);
+                }
+            }
+        }
+        break;
+    default:
+        break;
+    }
+
+    h264_read_ue(&br);  /* log2_max_frame_num_minus4 */
+    switch (h264_read_ue(&br)){
+    case 0:
+        h264_read_ue(&br);
+        break;
+    case 1:
+    {
+        gint cycle;
+
+        h264_read_bits(&br, 1);
+        h264_read_se(&br);
+        h264_read_se(&br);
+        cycle = h264_read_ue(&br);
+        if (cycle > 255){
+            br.overflow = TRUE;
+            break;
+        }
+        for (i = 0; i < cycle; i++){
+            h264_read_se(&br);
+        }
+        break;
+    }
+    default:
+        break;
+    }
+
+    max_num_ref_frames = h264_read_ue(&br);
+    h264_read_bits(&br, 1);  /* gaps_in_frame_num_value_allowed_flag */
+    width_mbs = h264_read_ue(&br) + 1;
+    height_mbs = h264_read_ue(&br) + 1;
+    frame_mbs_only = h264_read_bits(&br, 1);
+    if (!frame_mbs_only){
+        h264_read_bits(&br, 1);  /* mb_adaptive_frame_field_flag */
+        height_mbs *= 2;
+    }
+    h264_read_bits(&br, 1);  /* direct_8x8_inference_flag */
+    if (h264_read_bits(&br, 1)){
+        crop_left = h264_read_ue(&br);
+        crop_right = h264_read_ue(&br);
+        crop_top = h264_read_ue(&br);
+        crop_bottom = h264_read_ue(&br);
+    }
+
+    /* Level limits, used unless the VUI says better */
+    if (sps->level_idc == 11 && (constraint_flags & 0x10) &&
+        (sps->profile_idc == 66 || sps->profile_idc == 77 ||
+         sps->profile_idc == 88)){
+        level = 0;  /* level 1b */
+    } else {
+        for (level = 0; level < (gint)G_N_ELEMENTS(h264_levels); level++){
+            if (h264_levels[level].level_idc == sps->level_idc)
+                break;
+        }
+        if (level == (gint)G_N_ELEMENTS(h264_levels)){
+            GST_WARNING("Unknown level %d, assuming 5.2",sps->level_idc);
+            level = G_N_ELEMENTS(h264_levels) - 1;
+        }
+    }
+    max_dpb_frames = MIN(h264_levels[level].max_dpb_mbs /
+        (width_mbs * height_mbs), 16);
+
+    switch (sps->profile_idc){
+    case 100:
+        cpb_factor = 1500;
+        break;
+    case 110:
+        cpb_factor = 3600;
+        break;
+    case 122: case 244: case 44:
+        cpb_factor = 4800;
+        break;
+    default:
+        cpb_factor = 1200;
+        break;
+    }
+
+    /* Intra profiles have no reordering at all */
+    intra_profile = (constraint_flags & 0x10) &&
+        (sps->profile_idc == 44 || sps->profile_idc == 86 ||
+         sps->profile_idc == 100 || sps->profile_idc == 110 ||
+         sps->profile_idc == 122 || sps->profile_idc == 244);
+    sps->max_dec_frame_buffering = intra_profile ? 0 : max_dpb_frames;
+    sps->num_reorder_frames = sps->max_dec_frame_buffering;
+
+    if (h264_read_bits(&br, 1)){
+        /* vui_parameters_present_flag */
+        gboolean hrd = FALSE;
+
+        if (h264_read_bits(&br, 1)){
+            /* aspect_ratio_info_present_flag */
+            if (h264_read_bits(&br, 8) == 255){
+                h264_read_bits(&br, 32);  /* Extended_SAR */
+            }
+        }
+        if (h264_read_bits(&br, 1)){
+            h264_read_bits(&br, 1);  /* overscan_appropriate_flag */
+        }
+        if (h264_read_bits(&br, 1)){
+            /* video_signal_type_present_flag */
+            h264_read_bits(&br, 4);
+            if (h264_read_bits(&br, 1)){
+                h264_read_bits(&br, 24);  /* colour description */
+            }
+        }
+        if (h264_read_bits(&br, 1)){
+            /* chroma_loc_info_present_flag */
+            h264_read_ue(&br);
+            h264_read_ue(&br);
+        }
+        if (h264_read_bits(&br, 1)){
+            /* timing_info_present_flag */
+            h264_read_bits(&br, 32);
+            h264_read_bits(&br, 32);
+            h264_read_bits(&br, 1);
+        }
+        if (h264_read_bits(&br, 1)){
+            /* nal_hrd_parameters_present_flag */
+            cpb_size = h264_parse_hrd(&br);
+            hrd = TRUE;
+        }
+        if (h264_read_bits(&br, 1)){
+            /* vcl_hrd_parameters_present_flag */
+            h264_parse_hrd(&br);
+            hrd = TRUE;
+        }
+        if (hrd){
+            h264_read_bits(&br, 1);  /* low_delay_hrd_flag */
+        }
+        h264_read_bits(&br, 1);  /* pic_struct_present_flag */
+        if (h264_read_bits(&br, 1)){
+            /* bitstream_restriction_flag */
+            gint reorder, buffering;
+
+            h264_read_bits(&br, 1);
+            h264_read_ue(&br);  /* max_bytes_per_pic_denom */
+            h264_read_ue(&br);  /* max_bits_per_mb_denom */
+            h264_read_ue(&br);  /* log2_max_mv_length_horizontal */
+            h264_read_ue(&br);  /* log2_max_mv_length_vertical */
+            reorder = h264_read_ue(&br);
+            buffering = h264_read_ue(&br);
+            if (!br.overflow && buffering <= 16 && reorder <= buffering){
+                sps->num_reorder_frames = reorder;
+                sps->max_dec_frame_buffering = buffering;
+            }
+        }
+    }
+
+    g_free(br.data);
+    if (br.overflow){
+        GST_WARNING("Truncated or corrupt SPS");
+        return FALSE;
+    }
+
+    /* The DPB holds at least the reference frames */
+    sps->max_dec_frame_buffering =
+        MAX(sps->max_dec_frame_buffering, MIN(max_num_ref_frames, 16));
+
+    /* Display size */
+    if (separate_colour_plane || chroma_format_idc == 0){
+        crop_x = 1;
+        crop_y = 2 - frame_mbs_only;
+    } else {
+        crop_x = (chroma_format_idc == 3) ? 1 : 2;
+        crop_y = ((chroma_format_idc == 1) ? 2 : 1) * (2 - frame_mbs_only);
+    }
+    sps->width = width_mbs * 16 - crop_x * (crop_left + crop_right);
+    sps->height = height_mbs * 16 - crop_y * (crop_top + crop_bottom);
+    if (sps->width <= 0 || sps->height <= 0){
+        GST_WARNING("Invalid cropping on the SPS");
+        sps->width = width_mbs * 16;
+        sps->height = height_mbs * 16;
+    }
+
+    /* No access unit is bigger than the coded picture buffer */
+    if (!cpb_size){
+        cpb_size = (gint64)h264_levels[level].max_cpb * cpb_factor;
+    }
+    sps->max_au_size = (gint)MIN(cpb_size / 8, G_MAXINT / 4);
+
+    GST_DEBUG("SPS: profile %d, level %d, %dx%d, dpb %d frames, "
+        "reorder %d frames, access units up to %d bytes",
+        sps->profile_idc, sps->level_idc, sps->width, sps->height,
+        sps->max_dec_frame_buffering, sps->num_reorder_frames,
+        sps->max_au_size);
+    return TRUE;
+}
+
+/******************************************************************************
+ * Find the SPS, either on the codec_data or on the first buffer of a byte
+ * stream, to size the decoder ahead of creating it
+ *****************************************************************************/
+static void h264dec_probe(GstTIDmaidec *dmaidec, GstBuffer *buf){
+    struct gstti_h264_sps sps;
+    GstCaps *caps = GST_PAD_CAPS(dmaidec->sinkpad);
+    GstStructure *capStruct;
+    const GValue *value;
+    GstBuffer *codec_data = NULL;
+    const guint8 *data;
+    gint i, size, extra = 0;
+    gboolean found = FALSE;
+
+    if (!gst_tisupport_h264_debug){
+        GST_DEBUG_CATEGORY_INIT(gst_tisupport_h264_debug, "TISupportH264", 0,
+            "DMAI plugins H264 Support functions");
+    }
+
+    if (caps && (capStruct = gst_caps_get_structure(caps,0)) &&
+        (value = gst_structure_get_value(capStruct, "codec_data"))){
+        codec_data = gst_value_get_buffer(value);
+    }
+
+    if (codec_data && GST_BUFFER_SIZE(codec_data) >= 7){
+        /* avcC atom, see h264_init */
+        data = GST_BUFFER_DATA(codec_data);
+        size = GST_BUFFER_SIZE(codec_data);
+        if (AVCC_ATOM_GET_NUM_SPS(codec_data, 5) &&
+            8 + (AVCC_ATOM_GET_SPS_NAL_LENGTH(codec_data, 6)) <= size){
+            found = gstti_h264_parse_sps(&data[8],
+                AVCC_ATOM_GET_SPS_NAL_LENGTH(codec_data, 6), &sps);
+        }
+        /* The SPS and PPS are prefixed on every buffer */
+        extra = gst_h264_sps_pps_calBufSize(codec_data);
+    } else if (buf) {
+        data = GST_BUFFER_DATA(buf);
+        size = GST_BUFFER_SIZE(buf);
+        for (i = 0; i <= size - 4 && !found; i++){
+            if (data[i] == 0 && data[i + 1] == 0 && data[i + 2] == 1 &&
+                (data[i + 3] & 0x1f) == 7){
+                gint end;
+
+                /* The SPS runs up to the next start code */
+                for (end = i + 3; end <= size - 3; end++){
+                    if (data[end] == 0 && data[end + 1] == 0 &&
+                        data[end + 2] <= 1)
+                        break;
+                }
+                if (end > size - 3)
+                    end = size;
+                found = gstti_h264_parse_sps(&data[i + 3], end - i - 3, &sps);
+            }
+        }
+    }
+
+    if (!found){
+        GST_DEBUG("No SPS ahead of the stream, using the default sizes");
+        return;
+    }
+
+    if (!dmaidec->width || !dmaidec->height){
+        dmaidec->width = sps.width;
+        dmaidec->height = sps.height;
+    }
+    dmaidec->dpbFrames = sps.max_dec_frame_buffering;
+    dmaidec->reorderFrames = sps.num_reorder_frames;
+    dmaidec->maxFrameSize = sps.max_au_size + extra;
+}
+
 struct gstti_parser_ops gstti_h264_parser = {
     .numInputBufs = 1,
     .trustme = TRUE,
@@ -932,6 +1395,7 @@ struct gstti_parser_ops gstti_h264_parser = {
 
 struct gstti_stream_decoder_ops gstti_h264_stream_dec_ops = {
     .custom_memcpy = h264dec_custom_memcpy,
+    .probe = h264dec_probe,
 };
 
 struct gstti_stream_encoder_ops gstti_h264_stream_enc_ops = {
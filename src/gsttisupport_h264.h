@@ -40,9 +40,29 @@ struct gstti_h264_parser_private {
     gboolean            pps_found;
     gboolean            au_delimiters;
     gboolean            packetized;
+    /* Whether the SPS,PPS from the codec_data went to the decoder yet */
+    gboolean            sps_pps_sent;
     GstBuffer           *codecdata;
 };
 
+/* Sequence parameter set fields that size the decoder */
+struct gstti_h264_sps {
+    gint                profile_idc;
+    gint                level_idc;
+    /* Display size, after the frame cropping */
+    gint                width;
+    gint                height;
+    /* Frames the decoder holds, and frames it may output late
+       (from the VUI, or the level limits when it isn't present) */
+    gint                max_dec_frame_buffering;
+    gint                num_reorder_frames;
+    /* Largest access unit the stream may carry, in bytes */
+    gint                max_au_size;
+};
+
+gboolean gstti_h264_parse_sps(const guint8 *nal, gint size,
+    struct gstti_h264_sps *sps);
+
 extern struct gstti_parser_ops gstti_h264_parser;
 extern struct gstti_stream_decoder_ops gstti_h264_stream_dec_ops;
 extern struct gstti_stream_encoder_ops gstti_h264_stream_enc_ops;
@@ -39,7 +39,7 @@ GstStaticCaps gstti_jpeg_caps = GST_STATIC_CAPS(
         )
 );
 
-static gboolean jpeg_init(GstTIDmaidec *dmaidec){
+static void *jpeg_init(struct gstti_parser_params *params){
     struct gstti_jpeg_parser_private *priv;
 
     /* Initialize GST_LOG for this object */
@@ -49,57 +49,152 @@ static gboolean jpeg_init(GstTIDmaidec *dmaidec){
     priv = g_malloc0(sizeof(struct gstti_jpeg_parser_private));
     g_assert(priv != NULL);
 
-    priv->firstSOI = FALSE;
+    priv->state = JPEG_SEARCH_SOI;
     priv->flushing = FALSE;
 
-    if (dmaidec->parser_private){
-        g_free(dmaidec->parser_private);
-    }
-    dmaidec->parser_private = priv;
 
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
-static gboolean jpeg_clean(GstTIDmaidec *dmaidec){
-    if (dmaidec->parser_private){
+static void jpeg_clean(void *private){
+    if (private){
         GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
+        g_free(private);
+    }
+}
+
+/*
+ * Whether there is an EOI marker in data[start, end)
+ */
+static gboolean jpeg_find_eoi(const guint8 *data, gint start, gint end){
+    const guint8 *ff;
+
+    while (start < end - 1) {
+        ff = memchr(data + start, 0xFF, end - 1 - start);
+        if (!ff)
+            return FALSE;
+        if (ff[1] == 0xD9)
+            return TRUE;
+        start = ff - data + 1;
     }
 
-    return TRUE;
+    return FALSE;
 }
 
-static gint jpeg_parse(GstTIDmaidec *dmaidec){
+/*
+ * The image ends at the EOI marker, or at an unexpected SOI marker for a
+ * broken image.  Marker segments are skipped by their length, only the
+ * entropy coded data is searched for the next marker.
+ */
+static gint jpeg_parse(void *private, struct gstti_parser_range *range){
     struct gstti_jpeg_parser_private *priv =
-        (struct gstti_jpeg_parser_private *) dmaidec->parser_private;
-    gint i;
-    gchar *data = (gchar *)Buffer_getUserPtr(dmaidec->circBuf);
+        (struct gstti_jpeg_parser_private *) private;
+    const guint8 *data = range->data;
+    const guint8 *ff;
+    gint i, marker;
 
     if (priv->flushing){
         return -1;
     }
 
-    GST_DEBUG("Marker is at %d",dmaidec->marker);
-    /* Find next Start of Image header */
-    for (i = dmaidec->marker; i <= dmaidec->head - 2; i++) {
-        if (data[i + 0] == 0xFF && data[i + 1] == 0xD8) {
-            if (!priv->firstSOI){
-                GST_DEBUG("Found first marker at %d",i);
-                priv->firstSOI = TRUE;
-                continue;
+    /* Framed input (from a demuxer or depayloader): take the whole buffer,
+       unless other EOI markers show several images were concatenated */
+    if (priv->state == JPEG_SEARCH_SOI && range->tail == 0 &&
+        range->head >= 4 && data[0] == 0xFF && data[1] == 0xD8 &&
+        data[range->head - 2] == 0xFF && data[range->head - 1] == 0xD9 &&
+        !jpeg_find_eoi(data, 2, range->head - 2)){
+        GST_DEBUG("Got a full image");
+        range->marker = range->head;
+        return range->head;
+    }
+
+    i = MAX(range->marker, range->tail);
+    GST_DEBUG("Marker is at %d",i);
+
+    while (TRUE) {
+        switch (priv->state) {
+        case JPEG_SEARCH_SOI:
+            for (; i <= range->head - 2; i++) {
+                if (data[i] == 0xFF && data[i + 1] == 0xD8)
+                    break;
+            }
+            if (i > range->head - 2)
+                goto need_data;
+
+            GST_DEBUG("Found start of image at %d",i);
+            priv->state = JPEG_SEGMENTS;
+            i += 2;
+            break;
+        case JPEG_SEGMENTS:
+            if (i > range->head - 2)
+                goto need_data;
+
+            if (data[i] != 0xFF){
+                GST_WARNING("Lost sync at %d, looking for the next image",i);
+                priv->state = JPEG_SEARCH_SOI;
+                break;
             }
 
-            GST_DEBUG("Found second marker");
-            dmaidec->marker = i;
-            priv->firstSOI = FALSE;
-            return i;
+            marker = data[i + 1];
+            if (marker == 0xFF){
+                /* Fill byte */
+                i++;
+            } else if (marker == 0xD9){
+                GST_DEBUG("Found end of image at %d",i);
+                priv->state = JPEG_SEARCH_SOI;
+                range->marker = i + 2;
+                return i + 2;
+            } else if (marker == 0xD8){
+                /* A new image starts before this one ended: hand out the
+                   broken image up to it, and go on with the new one */
+                GST_WARNING("Unexpected start of image at %d, ending the "
+                    "image there",i);
+                priv->state = JPEG_SEGMENTS;
+                range->marker = i + 2;
+                return i;
+            } else if (marker == 0x01 || (marker >= 0xD0 && marker <= 0xD7)){
+                /* Markers without a segment */
+                i += 2;
+            } else {
+                if (i > range->head - 4)
+                    goto need_data;
+
+                /* Start of scan, entropy coded data follows its header */
+                if (marker == 0xDA)
+                    priv->state = JPEG_ENTROPY;
+                i += 2 + ((data[i + 2] << 8) | data[i + 3]);
+            }
+            break;
+        case JPEG_ENTROPY:
+            if (i >= range->head)
+                goto need_data;
+
+            ff = memchr(data + i, 0xFF, range->head - i);
+            if (!ff){
+                i = range->head;
+                goto need_data;
+            }
+            i = ff - data;
+            if (i > range->head - 2)
+                goto need_data;
+
+            marker = data[i + 1];
+            if (marker == 0xFF){
+                i++;
+            } else if (marker == 0x00 || (marker >= 0xD0 && marker <= 0xD7)){
+                /* Stuffed byte or restart marker */
+                i += 2;
+            } else {
+                priv->state = JPEG_SEGMENTS;
+            }
+            break;
         }
     }
 
+need_data:
     GST_DEBUG("Failed to find a full frame");
-    dmaidec->marker = i;
+    range->marker = i;
 
     return -1;
 }
@@ -109,7 +204,7 @@ static void jpeg_flush_start(void *private){
         (struct gstti_jpeg_parser_private *) private;
 
     priv->flushing = TRUE;
-    priv->firstSOI = FALSE;
+    priv->state = JPEG_SEARCH_SOI;
     GST_DEBUG("Parser flushed");
     return;
 }
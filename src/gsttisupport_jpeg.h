@@ -23,9 +23,15 @@
 /* Caps for jpeg */
 extern GstStaticCaps gstti_jpeg_caps;
 
-/* JPEG Parser */
+/* JPEG Parser: where the scan of the current image stands */
+enum gstti_jpeg_parser_state {
+    JPEG_SEARCH_SOI,
+    JPEG_SEGMENTS,
+    JPEG_ENTROPY,
+};
+
 struct gstti_jpeg_parser_private {
-    gboolean firstSOI;
+    enum gstti_jpeg_parser_state state;
     gboolean flushing;
 };
 
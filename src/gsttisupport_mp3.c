@@ -31,6 +31,9 @@
 #include "gsttisupport_mp3.h"
 #include "gsttidmaibuffertransport.h"
 
+GST_DEBUG_CATEGORY_STATIC (gst_tisupport_mp3_debug);
+#define GST_CAT_DEFAULT gst_tisupport_mp3_debug
+
 GstStaticCaps gstti_mp3_sink_caps = GST_STATIC_CAPS(
     "audio/mpeg, "
 	"mpegversion= (int) 1, "
@@ -47,6 +50,184 @@ GstStaticCaps gstti_mp3_src_caps = GST_STATIC_CAPS(
 	"channels= (int)[ 1, 2 ]; "
 );
 
+/* Bitrates in kbps, indexed by [MPEG-1 or not][layer - 1][index] */
+static const gint mp3_bitrates[2][3][15] = {
+    {
+        {0,32,64,96,128,160,192,224,256,288,320,352,384,416,448},
+        {0,32,48,56,64,80,96,112,128,160,192,224,256,320,384},
+        {0,32,40,48,56,64,80,96,112,128,160,192,224,256,320},
+    },
+    {
+        {0,32,48,56,64,80,96,112,128,144,160,176,192,224,256},
+        {0,8,16,24,32,40,48,56,64,80,96,112,128,144,160},
+        {0,8,16,24,32,40,48,56,64,80,96,112,128,144,160},
+    },
+};
+
+/* Sample rates, indexed by [MPEG-1, 2, 2.5][index] */
+static const gint mp3_rates[3][3] = {
+    {44100, 48000, 32000},
+    {22050, 24000, 16000},
+    {11025, 12000, 8000},
+};
+
+/*
+ * Decodes the MPEG audio frame header at data, returns the length of the
+ * frame or 0 if it isn't a valid header
+ */
+static gint mp3_frame_header(const guint8 *data, gint *rate, gint *samples){
+    gint version, layer, bitrate, rateIdx, padding;
+
+    /* Frame sync */
+    if (data[0] != 0xFF || (data[1] & 0xE0) != 0xE0)
+        return 0;
+
+    /* 0: MPEG-2.5, 1: reserved, 2: MPEG-2, 3: MPEG-1 */
+    version = (data[1] >> 3) & 0x3;
+    /* 1: layer III, 2: layer II, 3: layer I */
+    layer = 4 - ((data[1] >> 1) & 0x3);
+    bitrate = data[2] >> 4;
+    rateIdx = (data[2] >> 2) & 0x3;
+    padding = (data[2] >> 1) & 0x1;
+
+    /* Free format streams are not supported */
+    if (version == 1 || layer == 4 || bitrate == 0 || bitrate == 15 ||
+        rateIdx == 3)
+        return 0;
+
+    bitrate = mp3_bitrates[version == 3 ? 0 : 1][layer - 1][bitrate] * 1000;
+    *rate = mp3_rates[version == 3 ? 0 : (version == 2 ? 1 : 2)][rateIdx];
+
+    switch (layer) {
+    case 1:
+        *samples = 384;
+        return (12 * bitrate / *rate + padding) * 4;
+    case 2:
+        *samples = 1152;
+        return 144 * bitrate / *rate + padding;
+    default:
+        *samples = (version == 3) ? 1152 : 576;
+        return ((version == 3) ? 144 : 72) * bitrate / *rate + padding;
+    }
+}
+
+static void *mp3_init(struct gstti_parser_params *params){
+    struct gstti_mp3_parser_private *priv;
+
+    /* Initialize GST_LOG for this object */
+    GST_DEBUG_CATEGORY_INIT(gst_tisupport_mp3_debug, "TISupportmp3", 0,
+        "DMAI plugins mp3 Support functions");
+
+    priv = g_malloc0(sizeof(struct gstti_mp3_parser_private));
+    g_assert(priv != NULL);
+
+    priv->locked = FALSE;
+    priv->flushing = FALSE;
+
+
+    GST_DEBUG("Parser initialized");
+    return priv;
+}
+
+static void mp3_clean(void *private){
+    if (private){
+        GST_DEBUG("Freeing parser private");
+        g_free(private);
+    }
+}
+
+/*
+ * Returns the end of the next whole frame on the range.  The codecs decode
+ * a single frame per process call and the parser is trusted on the bytes
+ * consumed, so frames are never batched.  The sync is only trusted once
+ * a header is followed by another one of the same stream, garbage before
+ * it goes with the first frame and the codec skips it.
+ */
+static gint mp3_parse(void *private, struct gstti_parser_range *range){
+    struct gstti_mp3_parser_private *priv =
+        (struct gstti_mp3_parser_private *) private;
+    const guint8 *data = range->data;
+    gint pos, len = 0, rate, samples, nextRate, nextSamples;
+
+    if (priv->flushing){
+        return -1;
+    }
+
+    pos = MAX(range->marker, range->tail);
+
+    /* Find the next frame header.  Out of sync, a header only counts when
+       the one of the following frame confirms it */
+    for (; pos + 4 <= range->head; pos++) {
+        len = mp3_frame_header(&data[pos], &rate, &samples);
+        if (!len) {
+            if (priv->locked) {
+                GST_DEBUG("Lost sync at %d",pos);
+                priv->locked = FALSE;
+            }
+            continue;
+        }
+
+        if (priv->locked)
+            break;
+
+        if (pos + len + 4 > range->head)
+            goto need_data;
+        if (mp3_frame_header(&data[pos + len], &nextRate,
+                &nextSamples) == 0 || nextRate != rate ||
+            nextSamples != samples) {
+            continue;
+        }
+        GST_DEBUG("Found sync at %d, rate %d",pos,rate);
+        priv->locked = TRUE;
+        break;
+    }
+
+    /* Only whole frames */
+    if (pos + 4 > range->head || pos + len > range->head)
+        goto need_data;
+
+    range->marker = pos + len;
+    range->duration = gst_util_uint64_scale_int(samples, GST_SECOND, rate);
+    GST_DEBUG("Returning a frame, until %d",pos + len);
+
+    return pos + len;
+
+need_data:
+    GST_DEBUG("Failed to find a full frame");
+    range->marker = pos;
+
+    return -1;
+}
+
+static void mp3_flush_start(void *private){
+    struct gstti_mp3_parser_private *priv =
+        (struct gstti_mp3_parser_private *) private;
+
+    priv->flushing = TRUE;
+    priv->locked = FALSE;
+    GST_DEBUG("Parser flushed");
+    return;
+}
+
+static void mp3_flush_stop(void *private){
+    struct gstti_mp3_parser_private *priv =
+        (struct gstti_mp3_parser_private *) private;
+
+    priv->flushing = FALSE;
+    GST_DEBUG("Parser flush stopped");
+    return;
+}
+
+struct gstti_parser_ops gstti_mp3_parser = {
+    .numInputBufs = 2,
+    .trustme = TRUE,
+    .init  = mp3_init,
+    .clean = mp3_clean,
+    .parse = mp3_parse,
+    .flush_start = mp3_flush_start,
+    .flush_stop = mp3_flush_stop,
+};
+
 /******************************************************************************
  * Custom ViM Settings for editing this file
  ******************************************************************************/
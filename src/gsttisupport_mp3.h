@@ -27,6 +27,13 @@
 extern GstStaticCaps gstti_mp3_src_caps;
 extern GstStaticCaps gstti_mp3_sink_caps;
 
+struct gstti_mp3_parser_private {
+    gboolean flushing;
+    gboolean locked;
+};
+
+extern struct gstti_parser_ops gstti_mp3_parser;
+
 #endif /* __GSTTI_SUPPORT_MP3_H__ */
 
 
@@ -18,7 +18,9 @@
  * Lesser General Public License for more details.
  *
  * This parser breaks down elementary mpeg2 streams, or mpeg2 streams from
- * qtdemuxer into mpeg2 streams to pass into the decoder.
+ * qtdemuxer into mpeg2 streams to pass into the decoder.  Frames start with
+ * the sequence header or GOP that precedes a picture, so an I frame carries
+ * its headers with it.
  */
 
 #include <stdio.h>
@@ -42,7 +44,7 @@ GstStaticCaps gstti_mpeg2_caps = GST_STATIC_CAPS(
     "   height=(int)[ 1, MAX ] ;"
 );
 
-static gboolean mpeg2_init(GstTIDmaidec *dmaidec){
+static void *mpeg2_init(struct gstti_parser_params *params){
     struct gstti_mpeg2_parser_private *priv;
 
     /* Initialize GST_LOG for this object */
@@ -53,73 +55,108 @@ static gboolean mpeg2_init(GstTIDmaidec *dmaidec){
     g_assert(priv != NULL);
 
     priv->firstPicture = FALSE;
+    priv->frameType = GSTTI_FRAME_UNKNOWN;
     priv->flushing = FALSE;
-    priv->firstIFrame = FALSE;
+    priv->header = NULL;
+    /* Start decoding on the first I frame */
+    priv->resync = TRUE;
 
-    if (dmaidec->parser_private){
-        g_free(dmaidec->parser_private);
-    }
-    dmaidec->parser_private = priv;
 
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
-static gboolean mpeg2_clean(GstTIDmaidec *dmaidec){
-    if (dmaidec->parser_private){
+static void mpeg2_clean(void *private){
+    struct gstti_mpeg2_parser_private *priv =
+        (struct gstti_mpeg2_parser_private *) private;
+
+    if (priv && priv->header){
+        gst_buffer_unref(priv->header);
+    }
+    if (priv){
         GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
+        g_free(priv);
     }
+}
+
+/* Coding type of a picture, from picture_coding_type */
+static const gint mpeg2_frame_types[8] = {
+    GSTTI_FRAME_UNKNOWN, GSTTI_FRAME_I, GSTTI_FRAME_P, GSTTI_FRAME_B,
+    GSTTI_FRAME_I, GSTTI_FRAME_UNKNOWN, GSTTI_FRAME_UNKNOWN,
+    GSTTI_FRAME_UNKNOWN,
+};
+
+#define mpeg2_start_code(data,i) \
+    ((data)[(i)] == 0 && (data)[(i) + 1] == 0 && (data)[(i) + 2] == 1)
 
-    return TRUE;
+/* Keep the sequence header (with its extensions) at the start of a frame */
+static void mpeg2_store_header(struct gstti_mpeg2_parser_private *priv,
+    const guint8 *data, gint size){
+    gint i;
+
+    /* The header ends on the GOP or picture start code */
+    for (i = 4; i <= size - 4; i++) {
+        if (mpeg2_start_code(data,i) &&
+            (data[i + 3] == 0xB8 || data[i + 3] == 0x00))
+            break;
+    }
+    if (i <= size - 4)
+        size = i;
+
+    if (priv->header && GST_BUFFER_SIZE(priv->header) == size &&
+        !memcmp(GST_BUFFER_DATA(priv->header), data, size))
+        return;
+
+    GST_DEBUG("Storing a sequence header of %d bytes",size);
+    if (priv->header)
+        gst_buffer_unref(priv->header);
+    priv->header = gst_buffer_new_and_alloc(size);
+    memcpy(GST_BUFFER_DATA(priv->header), data, size);
 }
 
-static gint mpeg2_parse(GstTIDmaidec *dmaidec){
+static gint mpeg2_parse(void *private, struct gstti_parser_range *range){
     struct gstti_mpeg2_parser_private *priv =
-        (struct gstti_mpeg2_parser_private *) dmaidec->parser_private;
+        (struct gstti_mpeg2_parser_private *) private;
+    const guint8 *data = range->data;
     gint i;
 
     if (priv->flushing){
         return -1;
     }
 
-    gchar *data = (gchar *)Buffer_getUserPtr(dmaidec->circBuf);
+    GST_DEBUG("Marker is at %d",range->marker);
+    /* Find the picture of this frame, then the start of the next one */
+    for (i = range->marker; i <= range->head - 6; i++) {
+        if (!mpeg2_start_code(data,i))
+            continue;
 
-    GST_DEBUG("Marker is at %d",dmaidec->marker);
-    /* Find next Picture start header */
-
-    for (i = dmaidec->marker; i <= dmaidec->head - 4; i++) {
-        if (data[i + 0] == 0 && data[i + 3] == 0 && data[i + 2] == 1
-            && data[i + 1] == 0) {
-            if (!priv->firstIFrame &&
-                ((data[i + 5] & 0x38) >> 3) == 1) {
-                priv->firstIFrame = TRUE;
-            }
-
-            if (!priv->firstPicture){
-                GST_DEBUG("Found first marker at %d",i);
+        if (!priv->firstPicture){
+            if (data[i + 3] == 0x00){
                 priv->firstPicture = TRUE;
-                continue;
-            }
-
-            /* Wait until we have at least one I-Frame
-               this is very helpful when decoding a network
-               stream
-             */
-            if (!priv->firstIFrame) {
-                GST_DEBUG("Found second marker, but not I-Frame yet");
-                continue;
+                priv->frameType = mpeg2_frame_types[(data[i + 5] >> 3) & 0x7];
+                GST_DEBUG("Found picture of type %d at %d",priv->frameType,i);
+
+                if (mpeg2_start_code(data,range->tail) &&
+                    data[range->tail + 3] == 0xB3){
+                    mpeg2_store_header(priv, &data[range->tail],
+                        i - range->tail);
+                }
             }
+            continue;
+        }
 
-            GST_DEBUG("Found second marker");
+        /* A sequence header, GOP or picture starts the next frame */
+        if (data[i + 3] == 0xB3 || data[i + 3] == 0xB8 || data[i + 3] == 0x00){
+            GST_DEBUG("Found start of next frame at %d",i);
             priv->firstPicture = FALSE;
+            range->marker = i;
+            range->frameType = priv->frameType;
             return i;
         }
     }
 
     GST_DEBUG("Failed to find a full frame");
-    dmaidec->marker = i;
+    range->marker = i;
 
     return -1;
 }
@@ -130,7 +167,7 @@ static void mpeg2_flush_start(void *private){
 
     priv->flushing = TRUE;
     priv->firstPicture = FALSE;
-    priv->firstIFrame = FALSE;
+    priv->resync = TRUE;
     GST_DEBUG("Parser flushed");
     return;
 }
@@ -144,6 +181,52 @@ static void mpeg2_flush_stop(void *private){
     return;
 }
 
+/*
+ * After a flush, drop the data until a sequence header, GOP or I picture.
+ * The last sequence header is put back in front of an I picture that
+ * doesn't have its own.
+ */
+static int mpeg2_custom_memcpy(GstTIDmaidec *dmaidec, void *target,
+    int available, GstBuffer *buf){
+    struct gstti_mpeg2_parser_private *priv =
+        (struct gstti_mpeg2_parser_private *) dmaidec->parser_private;
+    const guint8 *data = GST_BUFFER_DATA(buf);
+    gint size = GST_BUFFER_SIZE(buf);
+    gchar *dest = (gchar *)target;
+    gboolean insertHeader = FALSE;
+    gint i = 0, ret = 0;
+
+    if (priv->resync){
+        for (i = 0; i <= size - 6; i++) {
+            if (mpeg2_start_code(data,i) &&
+                (data[i + 3] == 0xB3 || data[i + 3] == 0xB8 ||
+                 (data[i + 3] == 0x00 && ((data[i + 5] >> 3) & 0x7) == 1)))
+                break;
+        }
+        if (i > size - 6){
+            GST_DEBUG("Dropping %d bytes, waiting for an I frame",size);
+            return 0;
+        }
+        insertHeader = (data[i + 3] != 0xB3) && priv->header;
+    }
+
+    if (available < size - i +
+        (insertHeader ? GST_BUFFER_SIZE(priv->header) : 0))
+        return -1;
+
+    if (insertHeader){
+        GST_DEBUG("Restarting with the stored sequence header");
+        memcpy(dest,GST_BUFFER_DATA(priv->header),
+            GST_BUFFER_SIZE(priv->header));
+        ret = GST_BUFFER_SIZE(priv->header);
+    }
+    memcpy(&dest[ret],&data[i],size - i);
+    ret += size - i;
+    priv->resync = FALSE;
+
+    return ret;
+}
+
 struct gstti_parser_ops gstti_mpeg2_parser = {
     .numInputBufs = 1,
     .trustme = TRUE,
@@ -154,6 +237,10 @@ struct gstti_parser_ops gstti_mpeg2_parser = {
     .flush_stop = mpeg2_flush_stop,
 };
 
+struct gstti_stream_decoder_ops gstti_mpeg2_stream_dec_ops = {
+    .custom_memcpy = mpeg2_custom_memcpy,
+};
+
 /******************************************************************************
  * Custom ViM Settings for editing this file
  ******************************************************************************/
@@ -26,11 +26,16 @@ extern GstStaticCaps gstti_mpeg2_caps;
 /* MPEG2 Parser */
 struct gstti_mpeg2_parser_private {
     gboolean firstPicture;
-    gboolean firstIFrame;
+    gint frameType;
     gboolean flushing;
+    /* Last sequence header seen, inserted again when decoding restarts
+       after a flush, and whether we wait for the next I frame */
+    GstBuffer *header;
+    gboolean resync;
 };
 
 extern struct gstti_parser_ops gstti_mpeg2_parser;
+extern struct gstti_stream_decoder_ops gstti_mpeg2_stream_dec_ops;
 
 #endif /* __GSTTI_SUPPORT_MPEG2_H__ */
 
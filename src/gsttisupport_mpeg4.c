@@ -31,6 +31,7 @@
 #include <gst/gst.h>
 
 #include "gsttidmaidec.h"
+#include "gsttidmaienc.h"
 #include "gsttiparsers.h"
 #include "gsttisupport_mpeg4.h"
 #include "gsttidmaibuffertransport.h"
@@ -96,11 +97,11 @@ static GstBuffer *mpeg4_generate_codec_data (GstTIDmaienc *dmaienc,
     return codec_data;
 }
 
-static gboolean mpeg4_init(GstTIDmaidec *dmaidec){
+static void *mpeg4_init(struct gstti_parser_params *params){
     struct gstti_mpeg4_parser_private *priv;
     const GValue *value;
     GstStructure *capStruct;
-    GstCaps      *caps = GST_PAD_CAPS(dmaidec->sinkpad);
+    GstCaps      *caps = params->caps;
 
     /* Initialize GST_LOG for this object */
     GST_DEBUG_CATEGORY_INIT(gst_tisupport_mpeg4_debug, "TISupportMPEG4", 0,
@@ -114,11 +115,10 @@ static gboolean mpeg4_init(GstTIDmaidec *dmaidec){
     priv->parsed = FALSE;
     priv->codecdata = NULL;
     priv->codecdata_inserted = FALSE;
-
-    if (dmaidec->parser_private){
-        g_free(dmaidec->parser_private);
-    }
-    dmaidec->parser_private = priv;
+    priv->frameType = GSTTI_FRAME_UNKNOWN;
+    priv->header = NULL;
+    /* Start decoding on the first I frame */
+    priv->resync = TRUE;
 
     /* Try to find the codec_data */
     if (!caps)
@@ -142,28 +142,68 @@ static gboolean mpeg4_init(GstTIDmaidec *dmaidec){
 
 done:
     GST_DEBUG("Parser initialized");
-    return TRUE;
+    return priv;
 }
 
-static gboolean mpeg4_clean(GstTIDmaidec *dmaidec){
+static void mpeg4_clean(void *private){
     struct gstti_mpeg4_parser_private *priv =
-        (struct gstti_mpeg4_parser_private *) dmaidec->parser_private;
+        (struct gstti_mpeg4_parser_private *) private;
+
+    if (!priv){
+        return;
+    }
 
     if (priv->codecdata){
         gst_buffer_unref(priv->codecdata);
     }
-    if (dmaidec->parser_private){
-        GST_DEBUG("Freeing parser private");
-        g_free(dmaidec->parser_private);
-        dmaidec->parser_private = NULL;
+    if (priv->header){
+        gst_buffer_unref(priv->header);
     }
+    GST_DEBUG("Freeing parser private");
+    g_free(priv);
+}
+
+/* Coding type of a VOP, from vop_coding_type (S-VOPs are predicted) */
+static const gint mpeg4_frame_types[4] = {
+    GSTTI_FRAME_I, GSTTI_FRAME_P, GSTTI_FRAME_B, GSTTI_FRAME_P,
+};
+
+#define mpeg4_start_code(data,i) \
+    ((data)[(i)] == 0 && (data)[(i) + 1] == 0 && (data)[(i) + 2] == 1)
 
-    return TRUE;
+/* Visual object sequence, visual object, video object or VOL start codes */
+#define mpeg4_header_code(code) \
+    ((code) == 0xB0 || (code) == 0xB5 || (code) <= 0x2F)
+
+/* Keep the configuration headers at the start of a frame */
+static void mpeg4_store_header(struct gstti_mpeg4_parser_private *priv,
+    const guint8 *data, gint size){
+    gint i;
+
+    /* The headers end on the GOV or VOP start code */
+    for (i = 4; i <= size - 4; i++) {
+        if (mpeg4_start_code(data,i) &&
+            (data[i + 3] == 0xB3 || data[i + 3] == 0xB6))
+            break;
+    }
+    if (i <= size - 4)
+        size = i;
+
+    if (priv->header && GST_BUFFER_SIZE(priv->header) == size &&
+        !memcmp(GST_BUFFER_DATA(priv->header), data, size))
+        return;
+
+    GST_DEBUG("Storing a VOL header of %d bytes",size);
+    if (priv->header)
+        gst_buffer_unref(priv->header);
+    priv->header = gst_buffer_new_and_alloc(size);
+    memcpy(GST_BUFFER_DATA(priv->header), data, size);
 }
 
-static gint mpeg4_parse(GstTIDmaidec *dmaidec){
+static gint mpeg4_parse(void *private, struct gstti_parser_range *range){
     struct gstti_mpeg4_parser_private *priv =
-        (struct gstti_mpeg4_parser_private *) dmaidec->parser_private;
+        (struct gstti_mpeg4_parser_private *) private;
+    const guint8 *data = range->data;
     gint i;
 
     if (priv->flushing){
@@ -171,36 +211,53 @@ static gint mpeg4_parse(GstTIDmaidec *dmaidec){
     }
 
     if (priv->parsed){
-        if (dmaidec->head != dmaidec->tail){
-            return dmaidec->head;
+        if (range->head != range->tail){
+            /* Each buffer is a frame, look up its VOP for the type */
+            for (i = range->tail; i <= range->head - 5; i++) {
+                if (mpeg4_start_code(data,i) && data[i + 3] == 0xB6){
+                    range->frameType = mpeg4_frame_types[data[i + 4] >> 6];
+                    break;
+                }
+            }
+            return range->head;
         }
     } else {
-        gchar *data = (gchar *)Buffer_getUserPtr(dmaidec->circBuf);
-
-        GST_DEBUG("Marker is at %d",dmaidec->marker);
-        /* Find next VOP start header */
-            
-        for (i = dmaidec->marker; i <= dmaidec->head - 4; i++) {
-            if (data[i + 0] == 0 && data[i + 1] == 0 && data[i + 2] == 1
-                && data[i + 3] == 0xB6) {
-                
-                if (!priv->firstVOP){
-                    GST_DEBUG("Found first marker at %d",i);
+        GST_DEBUG("Marker is at %d",range->marker);
+        /* Find the VOP of this frame, then the start of the next one */
+        for (i = range->marker; i <= range->head - 5; i++) {
+            if (!mpeg4_start_code(data,i))
+                continue;
+
+            if (!priv->firstVOP){
+                if (data[i + 3] == 0xB6){
                     priv->firstVOP = TRUE;
-                    continue;
+                    priv->frameType = mpeg4_frame_types[data[i + 4] >> 6];
+                    GST_DEBUG("Found VOP of type %d at %d",priv->frameType,i);
+
+                    if (mpeg4_start_code(data,range->tail) &&
+                        mpeg4_header_code(data[range->tail + 3])){
+                        mpeg4_store_header(priv, &data[range->tail],
+                            i - range->tail);
+                    }
                 }
+                continue;
+            }
 
-                GST_DEBUG("Found second marker");
-                dmaidec->marker = i;
+            /* Headers, GOV or the next VOP start the next frame */
+            if (mpeg4_header_code(data[i + 3]) || data[i + 3] == 0xB3 ||
+                data[i + 3] == 0xB6){
+                GST_DEBUG("Found start of next frame at %d",i);
+                range->marker = i;
+                range->frameType = priv->frameType;
                 priv->firstVOP = FALSE;
                 return i;
             }
         }
-        
+
         GST_DEBUG("Failed to find a full frame");
-        dmaidec->marker = i;
+        range->marker = i;
     }
-    
+
     return -1;
 }
 
@@ -211,6 +268,7 @@ static void mpeg4_flush_start(void *private){
     priv->flushing = TRUE;
     priv->firstVOP = FALSE;
     priv->codecdata_inserted = FALSE;
+    priv->resync = TRUE;
     GST_DEBUG("Parser flushed");
     return;
 }
@@ -224,6 +282,49 @@ static void mpeg4_flush_stop(void *private){
     return;
 }
 
+/*
+ * Elementary streams: after a flush, drop the data until the configuration
+ * headers, a GOV or an I-VOP.  The last VOL header is put back in front of
+ * a GOV or I-VOP that doesn't have its own.
+ */
+static int mpeg4_resync_memcpy(struct gstti_mpeg4_parser_private *priv,
+    gchar *dest, int available, GstBuffer *buf){
+    const guint8 *data = GST_BUFFER_DATA(buf);
+    gint size = GST_BUFFER_SIZE(buf);
+    gboolean insertHeader = FALSE;
+    gint i = 0, ret = 0;
+
+    if (priv->resync){
+        for (i = 0; i <= size - 5; i++) {
+            if (mpeg4_start_code(data,i) &&
+                (mpeg4_header_code(data[i + 3]) || data[i + 3] == 0xB3 ||
+                 (data[i + 3] == 0xB6 && (data[i + 4] >> 6) == 0)))
+                break;
+        }
+        if (i > size - 5){
+            GST_DEBUG("Dropping %d bytes, waiting for an I frame",size);
+            return 0;
+        }
+        insertHeader = !mpeg4_header_code(data[i + 3]) && priv->header;
+    }
+
+    if (available < size - i +
+        (insertHeader ? GST_BUFFER_SIZE(priv->header) : 0))
+        return -1;
+
+    if (insertHeader){
+        GST_DEBUG("Restarting with the stored VOL header");
+        memcpy(dest,GST_BUFFER_DATA(priv->header),
+            GST_BUFFER_SIZE(priv->header));
+        ret = GST_BUFFER_SIZE(priv->header);
+    }
+    memcpy(&dest[ret],&data[i],size - i);
+    ret += size - i;
+    priv->resync = FALSE;
+
+    return ret;
+}
+
 static int mpeg4_custom_memcpy(GstTIDmaidec *dmaidec, void *target, 
     int available, GstBuffer *buf){
     struct gstti_mpeg4_parser_private *priv =
@@ -232,6 +333,10 @@ static int mpeg4_custom_memcpy(GstTIDmaidec *dmaidec, void *target,
     int ret = 0;
 
     GST_DEBUG("MPEG4 memcpy, buffer %d, avail %d",GST_BUFFER_SIZE(buf),available);
+    if (!priv->parsed){
+        return mpeg4_resync_memcpy(priv, dest, available, buf);
+    }
+
     if (priv->codecdata_inserted || !priv->codecdata){
         if (available < GST_BUFFER_SIZE(buf))
             return -1;
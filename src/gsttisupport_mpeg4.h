@@ -31,6 +31,12 @@ struct gstti_mpeg4_parser_private {
     gboolean flushing;
     GstBuffer *codecdata;
     gboolean codecdata_inserted;
+    gint frameType;
+    /* Last VOL header seen on elementary streams, inserted again when
+       decoding restarts after a flush, and whether we wait for the next
+       I frame */
+    GstBuffer *header;
+    gboolean resync;
 };
 
 extern struct gstti_parser_ops gstti_mpeg4_parser;
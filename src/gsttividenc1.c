@@ -107,17 +107,24 @@ static void gstti_videnc1_install_properties(GObjectClass *gobject_class){
 static void gstti_videnc1_set_dynamic_params(GstTIDmaienc *dmaienc) {
     XDAS_Int32 status;
     VIDENC1_Status encStatus;
-    VIDENC1_DynamicParams *dynParams = (VIDENC1_DynamicParams *)dmaienc->dynParams;
+    VIDENC1_DynamicParams *dynParams;
+
+    if (dmaienc->hCodec == NULL)
+        return;
+
+    /* Set video encoder dynamic parameters from a copy taken under the
+       object lock, so set_property isn't blocked during the codec call */
+    GST_OBJECT_LOCK(dmaienc);
+    dynParams = g_memdup(dmaienc->dynParams,
+        ((VIDENC1_DynamicParams *)dmaienc->dynParams)->size);
+    GST_OBJECT_UNLOCK(dmaienc);
 
-    /* Set video encoder dynamic parameters */
     encStatus.size = sizeof(VIDENC1_Status);
     encStatus.data.buf = NULL;
 
-    if(dmaienc->hCodec != NULL) {
-        status = VIDENC1_control(Venc1_getVisaHandle(dmaienc->hCodec), 
-            XDM_SETPARAMS, dynParams, &encStatus);
-    } else
-        return;
+    status = VIDENC1_control(Venc1_getVisaHandle(dmaienc->hCodec), 
+        XDM_SETPARAMS, dynParams, &encStatus);
+    g_free(dynParams);
 
     if (status != VIDENC1_EOK) {
         GST_WARNING("Failed to set dynamic params");
@@ -142,16 +149,21 @@ static void gstti_videnc1_set_property(GObject *object, guint prop_id,
         params->maxBitRate = g_value_get_int(value);
         break;
     case PROP_TARGETBITRATE:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->targetBitRate = g_value_get_int(value);
-        gstti_videnc1_set_dynamic_params(dmaienc);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_INTRAFRAMEINTERVAL:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->intraFrameInterval = g_value_get_int(value);
-        gstti_videnc1_set_dynamic_params(dmaienc);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_FORCEINTRA:
-        dynParams->forceFrame = dmaienc->keyFrameType;
-        gstti_videnc1_set_dynamic_params(dmaienc);
+        if (g_value_get_boolean(value)) {
+            g_atomic_int_set(&dmaienc->forceKeyFrame, TRUE);
+        }
         break;
     default:
         break;
@@ -182,8 +194,7 @@ static void gstti_videnc1_get_property(GObject *object, guint prop_id,
         g_value_set_int(value,dynParams->intraFrameInterval);
         break;
     case PROP_FORCEINTRA:
-        g_value_set_boolean(value,dynParams->forceFrame == dmaienc->keyFrameType?
-            TRUE:FALSE);
+        g_value_set_boolean(value,g_atomic_int_get(&dmaienc->forceKeyFrame));
         break;
     default:
         break;
@@ -266,7 +277,6 @@ static void gstti_videnc1_set_codec_caps(GstTIDmaienc *dmaienc){
 static void gstti_videnc1_flush (GstTIDmaienc *dmaienc)
 {
     Int ret;
-    VIDENC1_DynamicParams *dynParams = (VIDENC1_DynamicParams *)dmaienc->dynParams;
 
     ret = Venc1_flush(dmaienc->hCodec);
     if (ret < 0) {
@@ -275,8 +285,7 @@ static void gstti_videnc1_flush (GstTIDmaienc *dmaienc)
     }
 
     /* Force next frame to be key frame */
-    dynParams->forceFrame = dmaienc->keyFrameType;
-    gstti_videnc1_set_dynamic_params(dmaienc);
+    g_atomic_int_set(&dmaienc->forceKeyFrame, TRUE);
 }
 
 /******************************************************************************
@@ -329,14 +338,39 @@ static gint gstti_videnc1_get_outBufSize(GstTIDmaienc *dmaienc){
 static gboolean gstti_videnc1_process(GstTIDmaienc *dmaienc, Buffer_Handle hSrcBuf,
                     Buffer_Handle hDstBuf){
     Int             ret;
+    gboolean        forced;
     VIDENC1_DynamicParams *dynParams = (VIDENC1_DynamicParams *)dmaienc->dynParams;
 
+    /* Apply the changes requested since the last frame, from the streaming
+       thread so they don't race with the process call.  dynParams is only
+       written under the object lock */
+    if (g_atomic_int_compare_and_exchange(&dmaienc->forceKeyFrame,
+            TRUE, FALSE)) {
+        GST_DEBUG("forcing a key frame\n");
+        GST_OBJECT_LOCK(dmaienc);
+        dynParams->forceFrame = dmaienc->keyFrameType;
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
+    }
+    if (g_atomic_int_compare_and_exchange(&dmaienc->dynParamsChanged,
+            TRUE, FALSE)) {
+        gstti_videnc1_set_dynamic_params(dmaienc);
+    }
+
     /* Invoke the video encoder */
     GST_DEBUG("invoking the video encoder,(%p, %p)\n",
         Buffer_getUserPtr(hSrcBuf),Buffer_getUserPtr(hDstBuf));
     ret = Venc1_process(dmaienc->hCodec, hSrcBuf, hDstBuf);
-    /* Remove any previously forced value */
+
+    /* Remove any previously forced value, or the codec keeps producing
+       key frames */
+    GST_OBJECT_LOCK(dmaienc);
+    forced = (dynParams->forceFrame != IVIDEO_NA_FRAME);
     dynParams->forceFrame = IVIDEO_NA_FRAME;
+    GST_OBJECT_UNLOCK(dmaienc);
+    if (forced) {
+        gstti_videnc1_set_dynamic_params(dmaienc);
+    }
 
     if (ret < 0) {
         GST_ELEMENT_ERROR(dmaienc,STREAM,DECODE,(NULL),
@@ -350,6 +384,7 @@ static gboolean gstti_videnc1_process(GstTIDmaienc *dmaienc, Buffer_Handle hSrcB
 struct gstti_encoder_ops gstti_videnc1_ops = {
     .xdmversion = "xDM 1.0",
     .codec_type = VIDEO,
+    .force_key_frame = TRUE,
     .default_setup_params = gstti_videnc1_setup_params,
     .set_codec_caps = gstti_videnc1_set_codec_caps,
     .install_properties = gstti_videnc1_install_properties,
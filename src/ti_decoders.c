@@ -68,17 +68,31 @@ gboolean ti_dm36x_h264dec_params(GstElement *element){
 void ti_dm36x_h264dec_set_codec_caps(GstElement *element){
     GstTIDmaidec *dmaidec = (GstTIDmaidec *)element;
     IVIDDEC2_Params *params = (IVIDDEC2_Params *)dmaidec->params;
+    IH264VDEC_Params *h264params = (IH264VDEC_Params *)dmaidec->params;
 
     params->maxWidth = dmaidec->width;
     params->maxHeight = dmaidec->height;
+
+    /* Unless told otherwise, hold back only the frames the stream
+     * reorders, instead of the whole 16 frame window
+     */
+    if (dmaidec->displayDelay >= 0) {
+        h264params->displayDelay = dmaidec->displayDelay;
+    } else {
+        h264params->displayDelay = (dmaidec->reorderFrames >= 0) ?
+            dmaidec->reorderFrames : IH264VDEC_PARAMS.displayDelay;
+    }
+    GST_INFO("Using a display delay of %d frames",
+        (int)h264params->displayDelay);
 }
 
 void ti_dm36x_h264dec_install_properties(GObjectClass *gobject_class){
     g_object_class_install_property(gobject_class, PROP_DISPDELAY,
         g_param_spec_int("dispdelay",
             "Display Delay",
-            "Display delay before which the decoder starts to output frames for display",
-            0, 16, 16, G_PARAM_READWRITE));
+            "Display delay before which the decoder starts to output frames for display\n"
+            "\t\t\t (-1: the reordering depth given by the stream SPS)",
+            -1, 16, -1, G_PARAM_READWRITE));
      g_object_class_install_property(gobject_class, PROP_CLOSEDLOOP,
         g_param_spec_int("closedloop",
             "Frame closed loop flag",
@@ -97,7 +111,7 @@ void ti_dm36x_h264dec_set_property(GObject *object, guint prop_id,
 
     switch (prop_id) {
     case PROP_DISPDELAY:
-        params->displayDelay = g_value_get_int(value);
+        dmaidec->displayDelay = g_value_get_int(value);
         break;
     case PROP_CLOSEDLOOP:
         params->frame_closedloop_flag =  g_value_get_int(value);
@@ -116,7 +130,7 @@ void ti_dm36x_h264dec_get_property(GObject *object, guint prop_id,
 
     switch (prop_id) {
     case PROP_DISPDELAY:
-        g_value_set_int(value,params->displayDelay);
+        g_value_set_int(value,dmaidec->displayDelay);
         break;
     case PROP_CLOSEDLOOP:
         g_value_set_int(value,params->frame_closedloop_flag);
@@ -252,32 +252,59 @@ void ti_mpeg4enc_set_property(GObject *object, guint prop_id,
         params->useRVLC = g_value_get_boolean(value)?1:0;
         break;
     case PROP_RSYNCINTERVAL:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->resyncInterval = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_HECINTERVAL:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->hecInterval = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_AIRRATE:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->airRate = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_MIRRATE:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->mirRate = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_QPINTRA:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->qpIntra = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_QPINTER:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->qpInter = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         GST_INFO("QPINTER is %d",(int)dynParams->qpInter);
         break;
     case PROP_FCODE:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->fCode = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_USEACPRED:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->useAcPred = g_value_get_boolean(value)?1:0;
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_USEUMV:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->useUMV = g_value_get_boolean(value)?1:0;
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     default:
         break;
@@ -575,19 +602,34 @@ void ti_dm36x_h264enc_set_property(GObject *object, guint prop_id,
         params->seqScalingFlag = g_value_get_int(value);
         break;
     case PROP_QPINTRA:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->intraFrameQP = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_QPINTER:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->interPFrameQP = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_RCALGO:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->rcAlgo = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_AIRRATE:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->airRate = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     case PROP_IDRINTERVAL:
+        GST_OBJECT_LOCK(dmaienc);
         dynParams->idrFrameInterval = g_value_get_int(value);
+        GST_OBJECT_UNLOCK(dmaienc);
+        g_atomic_int_set(&dmaienc->dynParamsChanged, TRUE);
         break;
     default:
         break;